@@ -0,0 +1,139 @@
+// lmjcore_env_pool.h
+#ifndef LMJCORE_ENV_POOL_H
+#define LMJCORE_ENV_POOL_H
+
+#include "lmjcore.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 租户编号最大长度（不含结尾 0）
+#define LMJCORE_ENV_POOL_MAX_TENANT_LEN 255
+
+/**
+ * @brief 多租户环境池（不透明类型）
+ *
+ * 按租户编号惰性打开各自的 lmjcore 环境，同时打开的环境数不超过上限。
+ * 达到上限时按 LRU 关闭空闲的环境；仍有句柄（即仍有事务在用）的环境
+ * 不会被关闭。
+ */
+typedef struct lmjcore_env_pool lmjcore_env_pool;
+
+/**
+ * @brief 环境句柄（不透明类型）
+ *
+ * 每个句柄持有一次引用，释放前对应环境不会被关闭。
+ */
+typedef struct lmjcore_pooled_env lmjcore_pooled_env;
+
+/**
+ * @brief 租户路径回调
+ *
+ * @param ctx 用户上下文
+ * @param tenant_id 租户编号
+ * @param path_buf 输出路径缓冲区
+ * @param buf_size 缓冲区大小
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+typedef int (*lmjcore_env_pool_path_fn)(void *ctx, const char *tenant_id,
+                                        char *path_buf, size_t buf_size);
+
+// 环境池配置
+typedef struct {
+  size_t max_open;                  // 同时打开的环境数上限
+  const char *base_dir;             // 默认路径的根目录（path_fn 为 NULL 时使用）
+  lmjcore_env_pool_path_fn path_fn; // 自定义租户路径（可为 NULL）
+  void *path_ctx;                   // path_fn 的上下文
+  size_t map_size;                  // 各环境的映射大小
+  unsigned int env_flags;           // 各环境的 LMJCORE_ENV_* 标志
+  lmjcore_ptr_generator_fn ptr_gen; // 各环境共用的指针生成器
+  void *ptr_gen_ctx;                // 指针生成器上下文
+  uint32_t wait_timeout_ms;         // 全部在用时等待的毫秒数（0 表示不等待）
+} lmjcore_env_pool_opts;
+
+// 环境池统计
+typedef struct {
+  size_t open;      // 当前打开的环境数
+  size_t in_use;    // 持有句柄的环境数
+  size_t hits;      // 命中已打开环境的次数
+  size_t opens;     // 打开环境的次数
+  size_t evictions; // LRU 关闭空闲环境的次数
+  size_t waits;     // 因达到上限而等待的次数
+} lmjcore_env_pool_stats;
+
+/**
+ * @brief 创建环境池
+ *
+ * 默认路径：带 LMJCORE_ENV_NOSUBDIR 时为 base_dir/<租户>.mdb，
+ * 否则为目录 base_dir/<租户>（不存在时自动创建）。
+ *
+ * @param opts 配置
+ * @param pool_out 输出环境池
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_env_pool_create(const lmjcore_env_pool_opts *opts,
+                            lmjcore_env_pool **pool_out);
+
+/**
+ * @brief 获取租户环境
+ *
+ * 已打开则直接增加引用；否则在需要时先关闭最久未用的空闲环境再打开。
+ * 全部环境都在用时最多等待 wait_timeout_ms，超时返回 LMJCORE_ERROR_POOL_FULL。
+ * 打开环境期间不持有池锁，其他租户的获取不受影响。
+ *
+ * @param pool 环境池
+ * @param tenant_id 租户编号（不能包含 '/'）
+ * @param handle_out 输出句柄
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_env_pool_acquire(lmjcore_env_pool *pool, const char *tenant_id,
+                             lmjcore_pooled_env **handle_out);
+
+/**
+ * @brief 取得句柄对应的环境
+ *
+ * @param handle 句柄
+ * @return lmjcore_env* 环境（句柄释放后不可再使用）
+ */
+lmjcore_env *lmjcore_pooled_env_get(lmjcore_pooled_env *handle);
+
+/**
+ * @brief 释放句柄
+ *
+ * 引用归零后环境进入 LRU 空闲队列，调用前应结束该环境上的所有事务。
+ *
+ * @param pool 环境池
+ * @param handle 句柄
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_env_pool_release(lmjcore_env_pool *pool,
+                             lmjcore_pooled_env *handle);
+
+/**
+ * @brief 读取环境池统计
+ *
+ * @param pool 环境池
+ * @param stats_out 输出统计
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_env_pool_stats_get(lmjcore_env_pool *pool,
+                               lmjcore_env_pool_stats *stats_out);
+
+/**
+ * @brief 关闭所有环境并销毁环境池
+ *
+ * 先等待其他线程中进行中的 lmjcore_env_pool_acquire（正在池锁外淘汰环境
+ * 或等待同一租户）退出，这些调用返回 LMJCORE_ERROR_INVALID_PARAM。
+ *
+ * @param pool 环境池
+ * @return int 错误码（仍有未释放的句柄或正在销毁时返回
+ *         LMJCORE_ERROR_INVALID_PARAM）
+ */
+int lmjcore_env_pool_destroy(lmjcore_env_pool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LMJCORE_ENV_POOL_H
@@ -0,0 +1,366 @@
+// lmjcore_env_pool.c
+#include "lmjcore_env_pool.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define POOL_PATH_MAX 4096
+
+// 池中环境的状态
+typedef enum {
+  POOL_OPENING, // 正在打开（不持有池锁）
+  POOL_READY,   // 可用
+  POOL_CLOSING, // 正在关闭（不持有池锁）
+} pool_state;
+
+// 池中的一个租户环境，同时作为句柄返回给调用方
+struct lmjcore_pooled_env {
+  char tenant[LMJCORE_ENV_POOL_MAX_TENANT_LEN + 1];
+  uint64_t hash;
+  lmjcore_env *env;
+  pool_state state;
+  size_t refs;
+  struct lmjcore_pooled_env *hash_next;
+  // 空闲队列（refs 为 0 且可用时）：表头最近使用，表尾最久未用
+  struct lmjcore_pooled_env *lru_prev;
+  struct lmjcore_pooled_env *lru_next;
+};
+
+struct lmjcore_env_pool {
+  lmjcore_env_pool_opts opts;
+  char base_dir[POOL_PATH_MAX];
+
+  pthread_mutex_t lock;
+  pthread_cond_t cond; // 状态变化、句柄释放时广播
+  lmjcore_pooled_env **buckets;
+  size_t bucket_count;
+  lmjcore_pooled_env *lru_head;
+  lmjcore_pooled_env *lru_tail;
+  lmjcore_env_pool_stats stats;
+  size_t busy;  // 正在 acquire 中的线程数（可能临时释放池锁）
+  bool closing; // 正在销毁，新的 acquire 直接失败
+};
+
+// FNV-1a
+static uint64_t tenant_hash(const char *tenant) {
+  uint64_t h = 14695981039346656037ULL;
+  for (const unsigned char *p = (const unsigned char *)tenant; *p; p++) {
+    h = (h ^ *p) * 1099511628211ULL;
+  }
+  return h;
+}
+
+static lmjcore_pooled_env *pool_find(lmjcore_env_pool *pool,
+                                     const char *tenant, uint64_t hash) {
+  lmjcore_pooled_env *e = pool->buckets[hash & (pool->bucket_count - 1)];
+  for (; e; e = e->hash_next) {
+    if (e->hash == hash && strcmp(e->tenant, tenant) == 0) {
+      return e;
+    }
+  }
+  return NULL;
+}
+
+static void pool_insert(lmjcore_env_pool *pool, lmjcore_pooled_env *e) {
+  lmjcore_pooled_env **bucket =
+      &pool->buckets[e->hash & (pool->bucket_count - 1)];
+  e->hash_next = *bucket;
+  *bucket = e;
+  pool->stats.open++;
+}
+
+static void pool_remove(lmjcore_env_pool *pool, lmjcore_pooled_env *e) {
+  lmjcore_pooled_env **p = &pool->buckets[e->hash & (pool->bucket_count - 1)];
+  while (*p != e) {
+    p = &(*p)->hash_next;
+  }
+  *p = e->hash_next;
+  pool->stats.open--;
+}
+
+static void lru_push_front(lmjcore_env_pool *pool, lmjcore_pooled_env *e) {
+  e->lru_prev = NULL;
+  e->lru_next = pool->lru_head;
+  if (pool->lru_head) {
+    pool->lru_head->lru_prev = e;
+  } else {
+    pool->lru_tail = e;
+  }
+  pool->lru_head = e;
+}
+
+static void lru_unlink(lmjcore_env_pool *pool, lmjcore_pooled_env *e) {
+  if (e->lru_prev) {
+    e->lru_prev->lru_next = e->lru_next;
+  } else {
+    pool->lru_head = e->lru_next;
+  }
+  if (e->lru_next) {
+    e->lru_next->lru_prev = e->lru_prev;
+  } else {
+    pool->lru_tail = e->lru_prev;
+  }
+  e->lru_prev = e->lru_next = NULL;
+}
+
+// 生成租户路径（默认规则或用户回调）
+static int pool_tenant_path(lmjcore_env_pool *pool, const char *tenant,
+                            char *path, size_t size) {
+  if (pool->opts.path_fn) {
+    return pool->opts.path_fn(pool->opts.path_ctx, tenant, path, size);
+  }
+
+  bool nosubdir = (pool->opts.env_flags & LMJCORE_ENV_NOSUBDIR) != 0;
+  int n = snprintf(path, size, nosubdir ? "%s/%s.mdb" : "%s/%s",
+                   pool->base_dir, tenant);
+  if (n < 0 || (size_t)n >= size) {
+    return LMJCORE_ERROR_BUFFER_TOO_SMALL;
+  }
+  if (!nosubdir && mkdir(path, 0775) != 0 && errno != EEXIST) {
+    return errno;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 打开租户环境（调用时不持有池锁）
+static int pool_open_env(lmjcore_env_pool *pool, lmjcore_pooled_env *e) {
+  char path[POOL_PATH_MAX];
+  int rc = pool_tenant_path(pool, e->tenant, path, sizeof(path));
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  return lmjcore_init(path, pool->opts.map_size, pool->opts.env_flags,
+                      pool->opts.ptr_gen, pool->opts.ptr_gen_ctx, &e->env);
+}
+
+// 关闭最久未用的空闲环境（需持有池锁，期间会临时释放）
+static void pool_evict_locked(lmjcore_env_pool *pool,
+                              lmjcore_pooled_env *victim) {
+  lru_unlink(pool, victim);
+  victim->state = POOL_CLOSING;
+  pthread_mutex_unlock(&pool->lock);
+  lmjcore_cleanup(victim->env);
+  pthread_mutex_lock(&pool->lock);
+
+  pool_remove(pool, victim);
+  free(victim);
+  pool->stats.evictions++;
+  pthread_cond_broadcast(&pool->cond);
+}
+
+int lmjcore_env_pool_create(const lmjcore_env_pool_opts *opts,
+                            lmjcore_env_pool **pool_out) {
+  if (!opts || !pool_out || !opts->ptr_gen) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (opts->max_open == 0 || (!opts->path_fn && !opts->base_dir)) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  lmjcore_env_pool *pool = calloc(1, sizeof(lmjcore_env_pool));
+  if (!pool) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  pool->opts = *opts;
+  if (opts->base_dir) {
+    snprintf(pool->base_dir, sizeof(pool->base_dir), "%s", opts->base_dir);
+  }
+
+  // 桶数取不小于 2 * max_open 的 2 的幂
+  pool->bucket_count = 16;
+  while (pool->bucket_count < opts->max_open * 2) {
+    pool->bucket_count <<= 1;
+  }
+  pool->buckets = calloc(pool->bucket_count, sizeof(lmjcore_pooled_env *));
+  if (!pool->buckets) {
+    free(pool);
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->cond, NULL);
+  *pool_out = pool;
+  return LMJCORE_SUCCESS;
+}
+
+// 获取租户环境（需持有池锁，返回时仍持有；打开或关闭环境时临时释放）
+static int pool_acquire_locked(lmjcore_env_pool *pool, const char *tenant_id,
+                               size_t len, uint64_t hash,
+                               lmjcore_pooled_env **handle_out) {
+  struct timespec deadline;
+  bool has_deadline = false;
+
+  for (;;) {
+    if (pool->closing) {
+      return LMJCORE_ERROR_INVALID_PARAM;
+    }
+    lmjcore_pooled_env *e = pool_find(pool, tenant_id, hash);
+    if (e && e->state == POOL_READY) {
+      if (e->refs++ == 0) {
+        lru_unlink(pool, e);
+        pool->stats.in_use++;
+      }
+      pool->stats.hits++;
+      *handle_out = e;
+      return LMJCORE_SUCCESS;
+    }
+    if (e) {
+      // 同一租户正在打开或关闭：LMDB 不允许同一进程重复打开同一环境
+      pthread_cond_wait(&pool->cond, &pool->lock);
+      continue;
+    }
+
+    if (pool->stats.open >= pool->opts.max_open) {
+      if (pool->lru_tail) {
+        pool_evict_locked(pool, pool->lru_tail);
+        continue;
+      }
+      // 全部在用：等待句柄释放
+      if (pool->opts.wait_timeout_ms == 0) {
+        return LMJCORE_ERROR_POOL_FULL;
+      }
+      if (!has_deadline) {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += pool->opts.wait_timeout_ms / 1000;
+        deadline.tv_nsec += (long)(pool->opts.wait_timeout_ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000L) {
+          deadline.tv_sec++;
+          deadline.tv_nsec -= 1000000000L;
+        }
+        has_deadline = true;
+        pool->stats.waits++;
+      }
+      if (pthread_cond_timedwait(&pool->cond, &pool->lock, &deadline) ==
+          ETIMEDOUT) {
+        return LMJCORE_ERROR_POOL_FULL;
+      }
+      continue;
+    }
+
+    // 占位后在池锁外打开环境
+    e = calloc(1, sizeof(lmjcore_pooled_env));
+    if (!e) {
+      return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    memcpy(e->tenant, tenant_id, len + 1);
+    e->hash = hash;
+    e->state = POOL_OPENING;
+    e->refs = 1;
+    pool_insert(pool, e);
+    pool->stats.in_use++;
+    pthread_mutex_unlock(&pool->lock);
+
+    int rc = pool_open_env(pool, e);
+
+    pthread_mutex_lock(&pool->lock);
+    if (rc != LMJCORE_SUCCESS) {
+      pool_remove(pool, e);
+      pool->stats.in_use--;
+      free(e);
+    } else {
+      e->state = POOL_READY;
+      pool->stats.opens++;
+      *handle_out = e;
+    }
+    pthread_cond_broadcast(&pool->cond);
+    return rc;
+  }
+}
+
+int lmjcore_env_pool_acquire(lmjcore_env_pool *pool, const char *tenant_id,
+                             lmjcore_pooled_env **handle_out) {
+  if (!pool || !tenant_id || !handle_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  size_t len = strlen(tenant_id);
+  if (len == 0 || len > LMJCORE_ENV_POOL_MAX_TENANT_LEN ||
+      strchr(tenant_id, '/')) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  uint64_t hash = tenant_hash(tenant_id);
+  pthread_mutex_lock(&pool->lock);
+  pool->busy++;
+  int rc = pool_acquire_locked(pool, tenant_id, len, hash, handle_out);
+  if (--pool->busy == 0 && pool->closing) {
+    pthread_cond_broadcast(&pool->cond); // 唤醒等待的 destroy
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return rc;
+}
+
+lmjcore_env *lmjcore_pooled_env_get(lmjcore_pooled_env *handle) {
+  return handle ? handle->env : NULL;
+}
+
+int lmjcore_env_pool_release(lmjcore_env_pool *pool,
+                             lmjcore_pooled_env *handle) {
+  if (!pool || !handle) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  pthread_mutex_lock(&pool->lock);
+  if (handle->state != POOL_READY || handle->refs == 0) {
+    pthread_mutex_unlock(&pool->lock);
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  if (--handle->refs == 0) {
+    lru_push_front(pool, handle);
+    pool->stats.in_use--;
+    pthread_cond_broadcast(&pool->cond);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_env_pool_stats_get(lmjcore_env_pool *pool,
+                               lmjcore_env_pool_stats *stats_out) {
+  if (!pool || !stats_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  pthread_mutex_lock(&pool->lock);
+  *stats_out = pool->stats;
+  pthread_mutex_unlock(&pool->lock);
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_env_pool_destroy(lmjcore_env_pool *pool) {
+  if (!pool) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  pthread_mutex_lock(&pool->lock);
+  if (pool->stats.in_use > 0 || pool->closing) {
+    pthread_mutex_unlock(&pool->lock);
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  // 正在打开的环境计入 in_use，不会出现在这里；其他线程可能在池锁外关闭
+  // 被淘汰的环境，或在条件变量上等待。置位 closing 让它们退出，等全部
+  // 离开后才能释放池
+  pool->closing = true;
+  pthread_cond_broadcast(&pool->cond);
+  while (pool->busy > 0) {
+    pthread_cond_wait(&pool->cond, &pool->lock);
+  }
+  // 没有句柄时所有环境都在空闲队列中
+  while (pool->lru_tail) {
+    lmjcore_pooled_env *e = pool->lru_tail;
+    lru_unlink(pool, e);
+    pool_remove(pool, e);
+    lmjcore_cleanup(e->env);
+    free(e);
+  }
+  pthread_mutex_unlock(&pool->lock);
+
+  pthread_cond_destroy(&pool->cond);
+  pthread_mutex_destroy(&pool->lock);
+  free(pool->buckets);
+  free(pool);
+  return LMJCORE_SUCCESS;
+}
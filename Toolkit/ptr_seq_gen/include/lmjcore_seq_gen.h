@@ -0,0 +1,94 @@
+// lmjcore_seq_gen.h
+#ifndef LMJCORE_SEQ_GEN_H
+#define LMJCORE_SEQ_GEN_H
+
+#include "lmjcore.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 默认每次预留的编号数
+#define LMJCORE_SEQ_GEN_DEFAULT_BLOCK 4096
+
+// 默认计数器成员名（位于配置对象 LMJCORE_CONFIG_OBJECT_PTR 中）
+#define LMJCORE_SEQ_GEN_DEFAULT_NAME "ptr_seq_next"
+
+/**
+ * @brief 顺序指针生成器（不透明类型）
+ *
+ * 从配置对象的计数器成员中按块预留编号区间（通过 lmjcore_config_set 持久化），
+ * 之后在内存中用原子操作无锁分配。指针布局：out[1..8] 为 64 位大端序号，
+ * 其余字节为 0。序号从 1 开始，不会与配置对象指针冲突。
+ *
+ * 生成器同时持有“当前块”和“备用块”：当前块用尽时切换到备用块，
+ * 并由后台线程在独立写事务中预留下一块。区间在分配前已提交，
+ * 重启后不会重复发放；未用完的编号会被跳过（留下空洞）。
+ */
+typedef struct lmjcore_seq_gen lmjcore_seq_gen;
+
+/**
+ * @brief 创建顺序指针生成器
+ *
+ * 创建后将 lmjcore_seq_gen_ptr 与生成器作为指针生成器传给 lmjcore_init，
+ * 再调用 lmjcore_seq_gen_attach 绑定环境。
+ *
+ * @param name 计数器成员名（NULL 表示 LMJCORE_SEQ_GEN_DEFAULT_NAME）
+ * @param name_len 成员名长度
+ * @param block_size 每次预留的编号数（0 表示 LMJCORE_SEQ_GEN_DEFAULT_BLOCK）
+ * @param gen_out 输出生成器
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_seq_gen_create(const uint8_t *name, size_t name_len,
+                           uint32_t block_size, lmjcore_seq_gen **gen_out);
+
+/**
+ * @brief 绑定环境：同步预留当前块与备用块，并启动后台预留线程
+ *
+ * 会在独立写事务中写入计数器，调用线程不能持有写事务。
+ *
+ * @param gen 生成器
+ * @param env 环境
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_seq_gen_attach(lmjcore_seq_gen *gen, lmjcore_env *env);
+
+/**
+ * @brief 同步确保备用块可用
+ *
+ * 写事务中生成器返回 LMJCORE_ERROR_PTR_EXHAUSTED 时（单个事务消耗超过
+ * 两个块，后台线程在等待写锁），中止或提交事务后调用本函数再重试。
+ * 调用线程不能持有写事务。
+ *
+ * @param gen 生成器
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_seq_gen_reserve(lmjcore_seq_gen *gen);
+
+/**
+ * @brief 顺序指针生成器函数（符合 lmjcore_ptr_generator_fn 签名）
+ *
+ * @param ctx 必须指向 lmjcore_seq_gen
+ * @param out 输出缓冲区（17 字节），out[0] = 0（由核心填入类型）, out[1..8] = 序号
+ * @return int
+ *   - LMJCORE_SUCCESS: 成功
+ *   - LMJCORE_ERROR_INVALID_PARAM: ctx 或 out 为 NULL
+ *   - LMJCORE_ERROR_PTR_EXHAUSTED: 当前块与备用块均已用尽
+ */
+int lmjcore_seq_gen_ptr(void *ctx, uint8_t out[LMJCORE_PTR_LEN]);
+
+/**
+ * @brief 销毁生成器并停止后台线程
+ *
+ * 应在 lmjcore_cleanup 之前、且不持有写事务时调用。
+ *
+ * @param gen 生成器
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_seq_gen_destroy(lmjcore_seq_gen *gen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LMJCORE_SEQ_GEN_H
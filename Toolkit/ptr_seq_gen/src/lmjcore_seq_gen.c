@@ -0,0 +1,303 @@
+// lmjcore_seq_gen.c
+#include "lmjcore_seq_gen.h"
+#include "lmjcore_config.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 单块编号数上限：块内偏移占 state 低 32 位，留出溢出余量
+#define SEQ_MAX_BLOCK (1u << 30)
+// 槽位被回收或尚未填充时的代数标记
+#define SEQ_GEN_INVALID UINT64_MAX
+
+// 已预留的编号区间：第 gen 代块的起始序号
+typedef struct {
+  atomic_uint_fast64_t gen;
+  atomic_uint_fast64_t start;
+} seq_block;
+
+struct lmjcore_seq_gen {
+  lmjcore_env *env;
+  uint8_t name[LMJCORE_MAX_MEMBER_NAME_LEN];
+  size_t name_len;
+  uint32_t block_size;
+
+  // 高 32 位为当前块代数，低 32 位为块内下一个偏移
+  atomic_uint_fast64_t state;
+  // 第 g 代块存放于 blocks[g & 1]，另一槽位即备用块
+  seq_block blocks[2];
+
+  // 以下字段由 lock 保护
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  pthread_t thread;
+  bool standby_ready;    // 备用块已预留
+  bool refill_requested; // 等待后台线程预留
+  bool refilling;        // 正在预留（同一时刻只有一个预留者）
+  bool running;
+  bool stopping;
+  int last_error; // 最近一次预留的结果
+};
+
+// 从配置对象预留 block_size 个编号，返回区间起点（独立写事务）
+static int seq_reserve_range(lmjcore_seq_gen *gen, uint64_t *start_out) {
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(gen->env, NULL, 0, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  uint8_t buf[8];
+  size_t size = 0;
+  uint64_t next = 1; // 序号 0 留给配置对象
+  rc = lmjcore_config_get(txn, gen->name, gen->name_len, buf, sizeof(buf),
+                          &size);
+  if (rc == LMJCORE_SUCCESS && size == sizeof(buf)) {
+    next = 0;
+    for (int i = 0; i < 8; i++) {
+      next = (next << 8) | buf[i];
+    }
+  } else if (rc != LMJCORE_SUCCESS && rc != LMJCORE_ERROR_ENTITY_NOT_FOUND &&
+             rc != LMJCORE_ERROR_MEMBER_NOT_FOUND) {
+    lmjcore_txn_abort(txn);
+    return rc;
+  }
+
+  if (next > UINT64_MAX - gen->block_size) {
+    lmjcore_txn_abort(txn);
+    return LMJCORE_ERROR_PTR_EXHAUSTED;
+  }
+  uint64_t end = next + gen->block_size;
+  for (int i = 0; i < 8; i++) {
+    buf[i] = (uint8_t)(end >> (56 - i * 8));
+  }
+  rc = lmjcore_config_set(txn, gen->name, gen->name_len, buf, sizeof(buf));
+  if (rc != LMJCORE_SUCCESS) {
+    lmjcore_txn_abort(txn);
+    return rc;
+  }
+  rc = lmjcore_txn_commit(txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  *start_out = next;
+  return LMJCORE_SUCCESS;
+}
+
+// 填充槽位（顺序锁写端：先作废代数，再写起点，最后发布代数）
+static void seq_block_publish(seq_block *block, uint64_t gen, uint64_t start) {
+  atomic_store(&block->gen, SEQ_GEN_INVALID);
+  atomic_store(&block->start, start);
+  atomic_store(&block->gen, gen);
+}
+
+// 为当前块的下一代预留备用块（需持有 lock，期间会临时释放）
+static int seq_refill_locked(lmjcore_seq_gen *gen) {
+  gen->refilling = true;
+  pthread_mutex_unlock(&gen->lock);
+  uint64_t start = 0;
+  int rc = seq_reserve_range(gen, &start);
+  pthread_mutex_lock(&gen->lock);
+
+  if (rc == LMJCORE_SUCCESS) {
+    uint64_t next_gen = (atomic_load(&gen->state) >> 32) + 1;
+    seq_block_publish(&gen->blocks[next_gen & 1], next_gen, start);
+    gen->standby_ready = true;
+  }
+  gen->refilling = false;
+  gen->refill_requested = false;
+  gen->last_error = rc;
+  pthread_cond_broadcast(&gen->cond);
+  return rc;
+}
+
+// 后台预留线程：收到请求后在独立写事务中预留下一块
+static void *seq_refill_thread(void *arg) {
+  lmjcore_seq_gen *gen = arg;
+  pthread_mutex_lock(&gen->lock);
+  while (!gen->stopping) {
+    if (gen->refill_requested && !gen->standby_ready && !gen->refilling) {
+      seq_refill_locked(gen);
+      continue;
+    }
+    pthread_cond_wait(&gen->cond, &gen->lock);
+  }
+  pthread_mutex_unlock(&gen->lock);
+  return NULL;
+}
+
+// 第 g 代块用尽：切换到备用块并请求预留下一块
+static int seq_advance(lmjcore_seq_gen *gen, uint64_t g) {
+  int rc = LMJCORE_SUCCESS;
+  pthread_mutex_lock(&gen->lock);
+  if ((atomic_load(&gen->state) >> 32) != g) {
+    // 其他线程已完成切换
+  } else if (gen->standby_ready) {
+    atomic_store(&gen->state, (g + 1) << 32);
+    gen->standby_ready = false;
+    gen->refill_requested = true;
+    pthread_cond_broadcast(&gen->cond);
+  } else {
+    if (gen->running) {
+      gen->refill_requested = true;
+      pthread_cond_broadcast(&gen->cond);
+    }
+    rc = LMJCORE_ERROR_PTR_EXHAUSTED;
+  }
+  pthread_mutex_unlock(&gen->lock);
+  return rc;
+}
+
+int lmjcore_seq_gen_create(const uint8_t *name, size_t name_len,
+                           uint32_t block_size, lmjcore_seq_gen **gen_out) {
+  if (!gen_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (!name) {
+    name = (const uint8_t *)LMJCORE_SEQ_GEN_DEFAULT_NAME;
+    name_len = strlen(LMJCORE_SEQ_GEN_DEFAULT_NAME);
+  }
+  if (name_len == 0 || block_size > SEQ_MAX_BLOCK) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  if (name_len > LMJCORE_MAX_MEMBER_NAME_LEN) {
+    return LMJCORE_ERROR_MEMBER_TOO_LONG;
+  }
+
+  lmjcore_seq_gen *gen = calloc(1, sizeof(lmjcore_seq_gen));
+  if (!gen) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  memcpy(gen->name, name, name_len);
+  gen->name_len = name_len;
+  gen->block_size = block_size ? block_size : LMJCORE_SEQ_GEN_DEFAULT_BLOCK;
+
+  // 绑定环境前第 0 代块视为已用尽
+  atomic_init(&gen->state, gen->block_size);
+  for (int i = 0; i < 2; i++) {
+    atomic_init(&gen->blocks[i].gen, SEQ_GEN_INVALID);
+    atomic_init(&gen->blocks[i].start, 0);
+  }
+  pthread_mutex_init(&gen->lock, NULL);
+  pthread_cond_init(&gen->cond, NULL);
+
+  *gen_out = gen;
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_seq_gen_attach(lmjcore_seq_gen *gen, lmjcore_env *env) {
+  if (!gen || !env) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  pthread_mutex_lock(&gen->lock);
+  if (gen->env) {
+    pthread_mutex_unlock(&gen->lock);
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  gen->env = env;
+
+  // 先预留第 0 代作为当前块，再预留第 1 代作为备用块
+  uint64_t start = 0;
+  pthread_mutex_unlock(&gen->lock);
+  int rc = seq_reserve_range(gen, &start);
+  pthread_mutex_lock(&gen->lock);
+  if (rc == LMJCORE_SUCCESS) {
+    seq_block_publish(&gen->blocks[0], 0, start);
+    atomic_store(&gen->state, 0);
+    rc = seq_refill_locked(gen);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    gen->running = true;
+    if (pthread_create(&gen->thread, NULL, seq_refill_thread, gen) != 0) {
+      gen->running = false;
+      rc = LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+  }
+  if (rc != LMJCORE_SUCCESS) {
+    gen->env = NULL;
+  }
+  pthread_mutex_unlock(&gen->lock);
+  return rc;
+}
+
+int lmjcore_seq_gen_reserve(lmjcore_seq_gen *gen) {
+  if (!gen) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  pthread_mutex_lock(&gen->lock);
+  if (!gen->env) {
+    pthread_mutex_unlock(&gen->lock);
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  // 后台线程正在预留时等待其结果，失败或未在预留则由当前线程同步预留
+  while (gen->refilling) {
+    pthread_cond_wait(&gen->cond, &gen->lock);
+  }
+  int rc = LMJCORE_SUCCESS;
+  if (!gen->standby_ready) {
+    rc = seq_refill_locked(gen);
+  }
+  pthread_mutex_unlock(&gen->lock);
+  return rc;
+}
+
+int lmjcore_seq_gen_ptr(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  lmjcore_seq_gen *gen = ctx;
+  if (!gen || !out) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  for (;;) {
+    uint64_t state = atomic_fetch_add(&gen->state, 1);
+    uint64_t g = state >> 32;
+    uint64_t offset = state & 0xFFFFFFFFu;
+    if (offset >= gen->block_size) {
+      int rc = seq_advance(gen, g);
+      if (rc != LMJCORE_SUCCESS) {
+        return rc;
+      }
+      continue;
+    }
+
+    // 顺序锁读端：槽位在读取期间被回收则放弃该编号（留下空洞）
+    seq_block *block = &gen->blocks[g & 1];
+    uint64_t g1 = atomic_load(&block->gen);
+    uint64_t start = atomic_load(&block->start);
+    uint64_t g2 = atomic_load(&block->gen);
+    if (g1 != g || g2 != g) {
+      continue;
+    }
+
+    uint64_t seq = start + offset;
+    memset(out, 0, LMJCORE_PTR_LEN);
+    for (int i = 0; i < 8; i++) {
+      out[1 + i] = (uint8_t)(seq >> (56 - i * 8));
+    }
+    return LMJCORE_SUCCESS;
+  }
+}
+
+int lmjcore_seq_gen_destroy(lmjcore_seq_gen *gen) {
+  if (!gen) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  pthread_mutex_lock(&gen->lock);
+  bool running = gen->running;
+  gen->stopping = true;
+  pthread_cond_broadcast(&gen->cond);
+  pthread_mutex_unlock(&gen->lock);
+  if (running) {
+    pthread_join(gen->thread, NULL);
+  }
+
+  pthread_cond_destroy(&gen->cond);
+  pthread_mutex_destroy(&gen->lock);
+  free(gen);
+  return LMJCORE_SUCCESS;
+}
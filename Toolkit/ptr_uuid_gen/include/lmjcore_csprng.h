@@ -0,0 +1,32 @@
+// lmjcore_csprng.h
+#ifndef LMJCORE_CSPRNG_H
+#define LMJCORE_CSPRNG_H
+
+#include "lmjcore.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 从线程私有的 ChaCha20 随机流中读取随机字节
+ *
+ * 每个线程首次调用时通过 getrandom() 取种子，之后从预先生成的缓冲区取数，
+ * 缓冲区耗尽时才重新计算，不再每次都打开 /dev/urandom。
+ * 每次补充缓冲区都会用新生成的数据替换密钥（快速密钥擦除），
+ * 输出一定量后还会重新混入系统熵；fork 后子进程会自动重新取种子。
+ *
+ * @param buf 输出缓冲区
+ * @param len 需要的字节数
+ * @return int
+ *   - LMJCORE_SUCCESS: 成功
+ *   - LMJCORE_ERROR_NULL_POINTER: buf 为 NULL
+ *   - LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED: 无法从系统获取种子
+ */
+int lmjcore_csprng_bytes(uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LMJCORE_CSPRNG_H
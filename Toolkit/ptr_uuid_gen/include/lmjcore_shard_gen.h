@@ -0,0 +1,42 @@
+// lmjcore_shard_gen.h
+#ifndef LMJCORE_SHARD_GEN_H
+#define LMJCORE_SHARD_GEN_H
+
+#include "lmjcore.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 分片指针生成器上下文结构
+ *
+ * 指针布局：out[0] = 类型, out[1..2] = 分片编号（大端）,
+ * out[3..16] = 内层生成器输出的 out[1..14]（丢弃末尾 2 字节）。
+ * 内层为时间有序或顺序生成器时，同一分片内的指针仍保持有序。
+ */
+typedef struct {
+  uint16_t shard_id;              // 分片/租户编号
+  lmjcore_ptr_generator_fn inner; // 内层生成器（NULL 为 UUIDv7）
+  void *inner_ctx;                // 内层生成器上下文
+} lmjcore_shard_gen_ctx;
+
+/**
+ * @brief 分片指针生成器函数（符合 lmjcore_ptr_generator_fn 签名）
+ *
+ * 生成的指针可用 lmjcore_ptr_shard_get 直接取出分片编号进行路由。
+ *
+ * @param ctx 必须指向 lmjcore_shard_gen_ctx 结构
+ * @param out 输出缓冲区（17 字节）
+ * @return int
+ *   - LMJCORE_SUCCESS: 成功
+ *   - LMJCORE_ERROR_INVALID_PARAM: ctx 或 out 为 NULL
+ *   - 其他错误码: 内层生成器失败
+ */
+int lmjcore_shard_ptr_gen(void *ctx, uint8_t out[LMJCORE_PTR_LEN]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LMJCORE_SHARD_GEN_H
@@ -29,6 +29,25 @@ typedef struct {
  */
 int lmjcore_uuidv4_ptr_gen(void *ctx, uint8_t out[LMJCORE_PTR_LEN]);
 
+/**
+ * @brief 时间有序（UUIDv7 布局）指针生成器（符合 lmjcore_ptr_generator_fn 签名）
+ *
+ * out[1..6] 为 48 位毫秒级 Unix 时间戳（大端），out[7..8] 中除版本位外的
+ * 12 位为单调计数器，其余 62 位为随机数。进程内所有线程共享同一个
+ * 时间戳+计数器状态，生成的指针严格递增：新实体总是落在 B 树最右侧，
+ * 避免 UUIDv4 随机插入引起的页分裂。
+ * 同一毫秒内计数器耗尽时借用下一毫秒，时钟回拨时沿用上次的时间戳，
+ * 两种情况下都保持单调。
+ *
+ * @param ctx 未使用，可为 NULL
+ * @param out 输出缓冲区（17 字节），out[0] = 0（由核心填入类型）, out[1..16] = UUIDv7
+ * @return int
+ *   - LMJCORE_SUCCESS: 成功
+ *   - LMJCORE_ERROR_INVALID_PARAM: out 为 NULL
+ *   - LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED: 随机数生成失败
+ */
+int lmjcore_uuidv7_ptr_gen(void *ctx, uint8_t out[LMJCORE_PTR_LEN]);
+
 #ifdef __cplusplus
 }
 #endif
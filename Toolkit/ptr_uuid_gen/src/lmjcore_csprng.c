@@ -0,0 +1,200 @@
+// lmjcore_csprng.c
+#include "lmjcore_csprng.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/random.h>
+#endif
+
+#define CHACHA_KEY_LEN 32
+#define CHACHA_BLOCK_LEN 64
+// 每次补充生成的块数：前 32 字节作为下一把密钥，其余作为输出
+#define RNG_BLOCKS 16
+#define RNG_BUF_LEN (RNG_BLOCKS * CHACHA_BLOCK_LEN)
+// 输出达到该字节数后重新混入系统熵
+#define RNG_RESEED_BYTES (1024 * 1024)
+
+// 线程私有的随机流状态
+typedef struct {
+  uint8_t key[CHACHA_KEY_LEN];
+  uint8_t buf[RNG_BUF_LEN];
+  size_t available;      // buf 末尾剩余未使用的字节数
+  size_t since_reseed;   // 上次取种后已输出的字节数
+  unsigned int fork_gen; // 取种时的 fork 代数
+  bool seeded;
+} rng_state;
+
+static __thread rng_state tls_rng;
+
+// fork 代数：子进程中递增，使继承下来的线程状态失效
+static atomic_uint fork_generation = 1;
+static pthread_once_t atfork_once = PTHREAD_ONCE_INIT;
+
+static void on_fork_child(void) { atomic_fetch_add(&fork_generation, 1); }
+
+static void register_atfork(void) {
+  pthread_atfork(NULL, NULL, on_fork_child);
+}
+
+// 从系统获取熵
+static int system_entropy(uint8_t *buf, size_t len) {
+  size_t total = 0;
+#if defined(__linux__)
+  while (total < len) {
+    ssize_t n = getrandom(buf + total, len - total, 0);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break; // ENOSYS 等情况退回 /dev/urandom
+    }
+    total += (size_t)n;
+  }
+  if (total == len) {
+    return LMJCORE_SUCCESS;
+  }
+#endif
+  int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  while (total < len) {
+    ssize_t n = read(fd, buf + total, len - total);
+    if (n <= 0) {
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      close(fd);
+      return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    total += (size_t)n;
+  }
+  close(fd);
+  return LMJCORE_SUCCESS;
+}
+
+/*
+ *==========================================
+ * ChaCha20（RFC 8439）
+ *==========================================
+ */
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+#define QUARTER_ROUND(a, b, c, d)                                              \
+  do {                                                                         \
+    a += b;                                                                    \
+    d ^= a;                                                                    \
+    d = ROTL32(d, 16);                                                         \
+    c += d;                                                                    \
+    b ^= c;                                                                    \
+    b = ROTL32(b, 12);                                                         \
+    a += b;                                                                    \
+    d ^= a;                                                                    \
+    d = ROTL32(d, 8);                                                          \
+    c += d;                                                                    \
+    b ^= c;                                                                    \
+    b = ROTL32(b, 7);                                                          \
+  } while (0)
+
+static uint32_t load32_le(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+static void store32_le(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+// 以全零 nonce 生成一个 64 字节密钥流块
+static void chacha20_block(const uint8_t key[CHACHA_KEY_LEN], uint32_t counter,
+                           uint8_t out[CHACHA_BLOCK_LEN]) {
+  uint32_t input[16] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+  for (int i = 0; i < 8; i++) {
+    input[4 + i] = load32_le(key + i * 4);
+  }
+  input[12] = counter;
+
+  uint32_t x[16];
+  memcpy(x, input, sizeof(x));
+  for (int i = 0; i < 10; i++) {
+    QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+    QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+    QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+    QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+    QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+    QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+    QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+    QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+  }
+  for (int i = 0; i < 16; i++) {
+    store32_le(out + i * 4, x[i] + input[i]);
+  }
+}
+
+// 用系统熵（重新）取种：新熵与当前密钥异或，首次取种时即为新密钥
+static int rng_seed(rng_state *rng) {
+  uint8_t entropy[CHACHA_KEY_LEN];
+  int rc = system_entropy(entropy, sizeof(entropy));
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  for (int i = 0; i < CHACHA_KEY_LEN; i++) {
+    rng->key[i] = (rng->seeded ? rng->key[i] : 0) ^ entropy[i];
+  }
+  memset(entropy, 0, sizeof(entropy));
+
+  rng->available = 0;
+  rng->since_reseed = 0;
+  rng->fork_gen = atomic_load(&fork_generation);
+  rng->seeded = true;
+  return LMJCORE_SUCCESS;
+}
+
+// 补充缓冲区，并用输出的前 32 字节替换密钥
+static void rng_refill(rng_state *rng) {
+  for (uint32_t i = 0; i < RNG_BLOCKS; i++) {
+    chacha20_block(rng->key, i, rng->buf + i * CHACHA_BLOCK_LEN);
+  }
+  memcpy(rng->key, rng->buf, CHACHA_KEY_LEN);
+  memset(rng->buf, 0, CHACHA_KEY_LEN);
+  rng->available = RNG_BUF_LEN - CHACHA_KEY_LEN;
+}
+
+int lmjcore_csprng_bytes(uint8_t *buf, size_t len) {
+  if (!buf) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  pthread_once(&atfork_once, register_atfork);
+
+  rng_state *rng = &tls_rng;
+  if (!rng->seeded || rng->fork_gen != atomic_load(&fork_generation) ||
+      rng->since_reseed >= RNG_RESEED_BYTES) {
+    int rc = rng_seed(rng);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+  }
+
+  while (len > 0) {
+    if (rng->available == 0) {
+      rng_refill(rng);
+    }
+    size_t n = len < rng->available ? len : rng->available;
+    uint8_t *src = rng->buf + RNG_BUF_LEN - rng->available;
+    memcpy(buf, src, n);
+    memset(src, 0, n); // 已输出的字节不留在内存中
+    rng->available -= n;
+    rng->since_reseed += n;
+    buf += n;
+    len -= n;
+  }
+
+  return LMJCORE_SUCCESS;
+}
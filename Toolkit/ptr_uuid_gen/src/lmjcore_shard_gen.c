@@ -0,0 +1,27 @@
+// lmjcore_shard_gen.c
+#include "lmjcore_shard_gen.h"
+#include "lmjcore_uuid_gen.h"
+#include <string.h>
+
+int lmjcore_shard_ptr_gen(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  lmjcore_shard_gen_ctx *shard_ctx = ctx;
+  if (!shard_ctx || !out) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  lmjcore_ptr inner;
+  int rc = shard_ctx->inner
+               ? shard_ctx->inner(shard_ctx->inner_ctx, inner)
+               : lmjcore_uuidv7_ptr_gen(NULL, inner);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  // 内层输出整体后移，为分片字段腾出位置
+  out[0] = (uint8_t)0;
+  memcpy(out + LMJCORE_PTR_SHARD_OFFSET + LMJCORE_PTR_SHARD_LEN, inner + 1,
+         LMJCORE_PTR_LEN - LMJCORE_PTR_SHARD_OFFSET - LMJCORE_PTR_SHARD_LEN);
+  out[LMJCORE_PTR_SHARD_OFFSET] = (uint8_t)(shard_ctx->shard_id >> 8);
+  out[LMJCORE_PTR_SHARD_OFFSET + 1] = (uint8_t)shard_ctx->shard_id;
+  return LMJCORE_SUCCESS;
+}
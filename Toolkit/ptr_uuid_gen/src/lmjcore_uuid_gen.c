@@ -1,5 +1,6 @@
 // lmjcore_uuid_gen.c
 #include "lmjcore_uuid_gen.h"
+#include <stdatomic.h>
 #include <string.h>
 
 // 平台检测
@@ -14,13 +15,20 @@
 #include <objbase.h> // CoCreateGuid
 #pragma comment(lib, "ole32.lib")
 #endif
-#else
-#include <fcntl.h>
-#include <unistd.h>
-#if defined(__APPLE__) || defined(__FreeBSD__)
+#elif defined(__APPLE__) || defined(__FreeBSD__)
 #include <stdlib.h> // arc4random_buf
+#include <time.h>   // clock_gettime
+#else
+#include "lmjcore_csprng.h"
+#include <time.h> // clock_gettime
 #endif
-#endif
+
+// UUIDv7 计数器位数（rand_a 字段）
+#define UUIDV7_SEQ_BITS 12
+#define UUIDV7_SEQ_MASK ((1u << UUIDV7_SEQ_BITS) - 1)
+
+// UUIDv7 全局状态：高 52 位为毫秒时间戳，低 12 位为同一毫秒内的计数器
+static atomic_uint_fast64_t uuidv7_state = 0;
 
 // 内部：生成 16 字节随机数据到 buf
 static int generate_random_bytes(uint8_t *buf, size_t len) {
@@ -44,24 +52,29 @@ static int generate_random_bytes(uint8_t *buf, size_t len) {
 #elif defined(__APPLE__) || defined(__FreeBSD__)
   arc4random_buf(buf, len);
 #else
-  int fd = open("/dev/urandom", O_RDONLY);
-  if (fd == -1) {
-    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  // 线程私有的缓冲 ChaCha20 随机流，避免每个指针都打开 /dev/urandom
+  int rc = lmjcore_csprng_bytes(buf, len);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
   }
-  ssize_t total = 0;
-  while (total < (ssize_t)len) {
-    ssize_t n = read(fd, buf + total, len - total);
-    if (n <= 0) {
-      close(fd);
-      return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
-    }
-    total += n;
-  }
-  close(fd);
 #endif
   return LMJCORE_SUCCESS;
 }
 
+// 内部：当前 Unix 毫秒时间戳
+static uint64_t unix_time_ms(void) {
+#if defined(LMJCORE_WINDOWS)
+  FILETIME ft;
+  GetSystemTimeAsFileTime(&ft);
+  uint64_t t = ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+  return (t - 116444736000000000ULL) / 10000; // 1601 -> 1970，100ns -> ms
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+#endif
+}
+
 // 主函数：UUIDv4 生成器
 int lmjcore_uuidv4_ptr_gen(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
   (void)ctx;
@@ -82,5 +95,44 @@ int lmjcore_uuidv4_ptr_gen(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
   // 强制设置 variant 位（第 9 字节高 2 位 = 10xx）
   out[9] = (out[9] & 0x3F) | 0x80;
 
+  return LMJCORE_SUCCESS;
+}
+
+// 主函数：UUIDv7 生成器
+int lmjcore_uuidv7_ptr_gen(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  (void)ctx;
+  if (!out) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  // 低位先填随机数，时间戳与计数器随后覆盖高位
+  int ret = generate_random_bytes(&out[9], 8);
+  if (ret != LMJCORE_SUCCESS) {
+    return ret;
+  }
+
+  // 取下一个 (时间戳, 计数器)：时间前进则计数器归零，否则在上一值基础上加一，
+  // 计数器溢出自然进位到时间戳，保证全进程严格递增
+  uint64_t now = unix_time_ms() << UUIDV7_SEQ_BITS;
+  uint64_t prev = atomic_load_explicit(&uuidv7_state, memory_order_relaxed);
+  uint64_t next;
+  do {
+    next = now > prev ? now : prev + 1;
+  } while (!atomic_compare_exchange_weak_explicit(
+      &uuidv7_state, &prev, next, memory_order_relaxed, memory_order_relaxed));
+
+  uint64_t ms = next >> UUIDV7_SEQ_BITS;
+  uint32_t seq = (uint32_t)(next & UUIDV7_SEQ_MASK);
+
+  out[0] = (uint8_t)0;
+  for (int i = 0; i < 6; i++) {
+    out[1 + i] = (uint8_t)(ms >> (40 - i * 8));
+  }
+  // 版本位 0111 + 计数器高 4 位
+  out[7] = (uint8_t)(0x70 | (seq >> 8));
+  out[8] = (uint8_t)(seq & 0xFF);
+  // variant 位 10xx
+  out[9] = (out[9] & 0x3F) | 0x80;
+
   return LMJCORE_SUCCESS;
 }
\ No newline at end of file
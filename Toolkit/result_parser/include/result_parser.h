@@ -13,6 +13,12 @@ extern "C" {
 /**
  * @brief 在对象结果中查找成员值
  *
+ * result->sorted 为 true 时（lmjcore 读取函数的结果，按 LMDB 的 dup 顺序
+ * 排列：逐字节比较，前缀较短者在前）二分查找；其他方式构造的结果
+ * sorted 为 false，线性扫描。
+ * 对同一结果反复查找（尤其是查找不存在的成员）时请使用
+ * lmjcore_parser_obj_find_member_indexed。
+ *
  * @param result 结果结构体指针
  * @param result_buf 结果缓冲区
  * @param member_name 成员名称（二进制安全）
@@ -81,6 +87,9 @@ int lmjcore_parser_arr_get_element(const lmjcore_result_set *result,
 /**
  * @brief 在数组中查找元素（精确字节匹配）
  *
+ * 与 lmjcore_parser_obj_find_member 相同：按 result->sorted 二分查找或
+ * 线性扫描。
+ *
  * @param result 结果结构体指针
  * @param result_buf 结果缓冲区
  * @param element 要查找的元素数据
@@ -103,6 +112,184 @@ int lmjcore_parser_arr_find_element(const lmjcore_result_set *result,
  */
 size_t lmjcore_parser_arr_element_count(const lmjcore_result_set *result);
 
+// ==================== 查找索引 ====================
+
+// 索引槽位（调用方无需直接访问）
+typedef struct {
+  uint32_t hash; // 名称哈希
+  uint32_t pos;  // 条目下标 + 1，0 表示空槽
+} lmjcore_parser_slot;
+
+// 开放寻址哈希索引，槽位存放在调用方提供的内存中
+typedef struct {
+  lmjcore_parser_slot *slots; // 槽位数组（位于 arena）
+  size_t capacity;            // 槽位数（2 的幂）
+  size_t count;               // 建立索引时的条目数
+} lmjcore_parser_index;
+
+/**
+ * @brief 计算为 count 个条目建立索引所需的 arena 字节数
+ *
+ * @param count 条目数（成员数或元素数）
+ * @return size_t 所需字节数
+ */
+size_t lmjcore_parser_index_size(size_t count);
+
+/**
+ * @brief 为对象结果的成员名建立哈希索引
+ *
+ * 索引只引用 arena 与结果缓冲区，二者在索引使用期间必须保持不变。
+ * 同名成员只索引第一个，与线性查找的结果一致。
+ *
+ * @param result 结果结构体指针
+ * @param result_buf 结果缓冲区
+ * @param arena 槽位内存，需按 4 字节对齐
+ * @param arena_size arena 字节数，至少为 lmjcore_parser_index_size 的返回值
+ * @param index 输出参数，索引
+ * @return int
+ *   - LMJCORE_SUCCESS: 建立成功
+ *   - LMJCORE_ERROR_BUFFER_TOO_SMALL: arena 不足
+ *   - LMJCORE_ERROR_INVALID_PARAM: 参数无效
+ */
+int lmjcore_parser_obj_index_build(const lmjcore_result_obj *result,
+                                   const uint8_t *result_buf, void *arena,
+                                   size_t arena_size,
+                                   lmjcore_parser_index *index);
+
+/**
+ * @brief 为数组结果的元素建立哈希索引
+ *
+ * 参数与返回值同 lmjcore_parser_obj_index_build。
+ */
+int lmjcore_parser_arr_index_build(const lmjcore_result_set *result,
+                                   const uint8_t *result_buf, void *arena,
+                                   size_t arena_size,
+                                   lmjcore_parser_index *index);
+
+/**
+ * @brief 通过索引在对象结果中查找成员值
+ *
+ * 命中与未命中均为常数次比较。
+ *
+ * @param result 结果结构体指针
+ * @param result_buf 结果缓冲区
+ * @param index 由 lmjcore_parser_obj_index_build 建立的索引
+ * @param member_name 成员名称（二进制安全）
+ * @param member_name_len 成员名称长度
+ * @param value_data 输出参数，值数据指针
+ * @param value_len 输出参数，值数据长度
+ * @return int
+ *   - LMJCORE_SUCCESS: 找到成员
+ *   - LMJCORE_ERROR_ENTITY_NOT_FOUND: 成员不存在
+ *   - LMJCORE_ERROR_INVALID_PARAM: 参数无效或索引与结果不匹配
+ */
+int lmjcore_parser_obj_find_member_indexed(const lmjcore_result_obj *result,
+                                           const uint8_t *result_buf,
+                                           const lmjcore_parser_index *index,
+                                           const uint8_t *member_name,
+                                           size_t member_name_len,
+                                           const uint8_t **value_data,
+                                           size_t *value_len);
+
+/**
+ * @brief 通过索引在数组中查找元素
+ *
+ * @param result 结果结构体指针
+ * @param result_buf 结果缓冲区
+ * @param index 由 lmjcore_parser_arr_index_build 建立的索引
+ * @param element 要查找的元素数据
+ * @param element_len 元素数据长度
+ * @param found_index 输出参数，找到的索引位置
+ * @return int
+ *   - LMJCORE_SUCCESS: 找到元素
+ *   - LMJCORE_ERROR_ENTITY_NOT_FOUND: 元素不存在
+ *   - LMJCORE_ERROR_INVALID_PARAM: 参数无效或索引与结果不匹配
+ */
+int lmjcore_parser_arr_find_element_indexed(const lmjcore_result_set *result,
+                                            const uint8_t *result_buf,
+                                            const lmjcore_parser_index *index,
+                                            const uint8_t *element,
+                                            size_t element_len,
+                                            size_t *found_index);
+
+// ==================== 批量扫描 ====================
+
+// 容纳 n 个元素的位图所需的 uint64_t 个数；元素 i 对应第 i / 64 个字的
+// 第 i % 64 位
+#define LMJCORE_PARSER_BITMAP_WORDS(n) (((n) + 63) / 64)
+
+// 扫描内核的指令集级别
+typedef enum {
+  LMJCORE_PARSER_SIMD_AUTO = 0,   // 按 CPU 自动选择
+  LMJCORE_PARSER_SIMD_SCALAR = 1, // 逐字节比较（memcmp）
+  LMJCORE_PARSER_SIMD_SSE2 = 2,   // 16 字节向量比较
+  LMJCORE_PARSER_SIMD_AVX2 = 3,   // 32 字节向量比较
+} lmjcore_parser_simd;
+
+/**
+ * @brief 指定扫描内核的指令集级别
+ *
+ * 默认在首次扫描时按 CPU 自动选择（AVX2 > SSE2 > 标量），非 x86 平台
+ * 只有标量实现。主要用于测试和基准对比，影响整个进程。
+ *
+ * @param level 指令集级别，LMJCORE_PARSER_SIMD_AUTO 恢复自动选择
+ * @return int
+ *   - LMJCORE_SUCCESS: 设置成功
+ *   - LMJCORE_ERROR_INVALID_PARAM: 当前 CPU 不支持该级别
+ */
+int lmjcore_parser_simd_set(lmjcore_parser_simd level);
+
+/**
+ * @brief 获取当前生效的扫描内核级别
+ *
+ * @return lmjcore_parser_simd 当前级别（不会返回 AUTO）
+ */
+lmjcore_parser_simd lmjcore_parser_simd_get(void);
+
+/**
+ * @brief 找出数组中与给定数据完全相等的所有元素
+ *
+ * @param result 结果结构体指针
+ * @param result_buf 结果缓冲区
+ * @param element 要匹配的元素数据
+ * @param element_len 元素数据长度
+ * @param bitmap 输出参数，匹配位图（先被清零）
+ * @param bitmap_words 位图字数，至少为 LMJCORE_PARSER_BITMAP_WORDS(元素数)
+ * @param match_count 输出参数，匹配个数（可为 NULL）
+ * @return int
+ *   - LMJCORE_SUCCESS: 扫描完成（可能没有匹配）
+ *   - LMJCORE_ERROR_BUFFER_TOO_SMALL: 位图不足
+ *   - LMJCORE_ERROR_INVALID_PARAM: 参数无效
+ */
+int lmjcore_parser_arr_match_equal(const lmjcore_result_set *result,
+                                   const uint8_t *result_buf,
+                                   const uint8_t *element, size_t element_len,
+                                   uint64_t *bitmap, size_t bitmap_words,
+                                   size_t *match_count);
+
+/**
+ * @brief 找出数组中以给定前缀开头的所有元素
+ *
+ * 前缀长度为 0 时匹配全部元素。参数与返回值同
+ * lmjcore_parser_arr_match_equal。
+ */
+int lmjcore_parser_arr_match_prefix(const lmjcore_result_set *result,
+                                    const uint8_t *result_buf,
+                                    const uint8_t *prefix, size_t prefix_len,
+                                    uint64_t *bitmap, size_t bitmap_words,
+                                    size_t *match_count);
+
+/**
+ * @brief 找出数组中等于给定实体指针的所有元素
+ *
+ * 长度不是 LMJCORE_PTR_LEN 的元素直接跳过。参数与返回值同
+ * lmjcore_parser_arr_match_equal。
+ */
+int lmjcore_parser_arr_match_ptr(const lmjcore_result_set *result,
+                                 const uint8_t *result_buf,
+                                 const lmjcore_ptr ptr, uint64_t *bitmap,
+                                 size_t bitmap_words, size_t *match_count);
+
 // ==================== 错误信息解析 ====================
 
 /**
@@ -0,0 +1,142 @@
+// result_serializer.h
+#ifndef LMJCORE_RESULT_SERIALIZER_H
+#define LMJCORE_RESULT_SERIALIZER_H
+
+#include "lmjcore.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ==================== 输出缓冲区 ====================
+
+// 可增长的输出缓冲区；reset 后保留容量，复用时不再分配内存
+typedef struct {
+  uint8_t *data; // 输出数据
+  size_t len;    // 已写入字节数
+  size_t cap;    // 已分配容量
+} lmjcore_ser_buf;
+
+/**
+ * @brief 初始化输出缓冲区
+ *
+ * @param buf 缓冲区
+ * @param initial_cap 预分配容量（0 表示首次写入时再分配）
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_ser_buf_init(lmjcore_ser_buf *buf, size_t initial_cap);
+
+/**
+ * @brief 清空已写入的数据，保留容量
+ *
+ * @param buf 缓冲区
+ */
+void lmjcore_ser_buf_reset(lmjcore_ser_buf *buf);
+
+/**
+ * @brief 释放输出缓冲区
+ *
+ * @param buf 缓冲区
+ */
+void lmjcore_ser_buf_free(lmjcore_ser_buf *buf);
+
+// ==================== 序列化 ====================
+
+// 输出格式
+typedef enum {
+  LMJCORE_SER_JSON = 0,    // JSON 文本
+  LMJCORE_SER_MSGPACK = 1, // MessagePack
+} lmjcore_ser_format;
+
+// 值的输出方式
+typedef enum {
+  LMJCORE_SER_VALUE_AUTO = 0, // 自动判断（见 lmjcore_ser_opts）
+  LMJCORE_SER_VALUE_STRING,   // UTF-8 文本
+  LMJCORE_SER_VALUE_PTR,      // 实体指针，输出 lmjcore_ptr_to_string 的结果
+  LMJCORE_SER_VALUE_BINARY,   // 二进制：JSON 为 base64 字符串，MessagePack 为 bin
+  LMJCORE_SER_VALUE_RAW,      // 值本身已是目标格式的编码，原样写入
+} lmjcore_ser_value;
+
+/**
+ * @brief 值分类回调
+ *
+ * @param ctx 用户上下文
+ * @param name 成员名（集合元素为 NULL）
+ * @param name_len 成员名长度
+ * @param value 值数据
+ * @param value_len 值长度
+ * @return lmjcore_ser_value 输出方式，返回 AUTO 时按默认规则判断
+ */
+typedef lmjcore_ser_value (*lmjcore_ser_classify_fn)(void *ctx,
+                                                     const uint8_t *name,
+                                                     size_t name_len,
+                                                     const uint8_t *value,
+                                                     size_t value_len);
+
+// 序列化选项
+//
+// 默认规则：长度为 LMJCORE_PTR_LEN 且首字节为实体类型的值视为指针，
+// 合法 UTF-8 视为文本，其余视为二进制。缺失值的成员输出为 null / nil。
+// 成员名含非法 UTF-8 时，MessagePack 输出为 bin 类型的键，保留原始字节；
+// JSON 的键只能是字符串，非法字节逐个按 \u00XX 输出。这一映射有损：
+// 解码后与 U+0080~U+00FF 的合法字符无法区分（名字为单字节 0xE9 与
+// "é" 都得到 "\u00e9" 对应的字符），需要原样往返时应使用 MessagePack。
+typedef struct {
+  lmjcore_ser_format format;        // 输出格式
+  lmjcore_ser_classify_fn classify; // 值分类回调（可为 NULL）
+  void *classify_ctx;               // 回调上下文
+} lmjcore_ser_opts;
+
+/**
+ * @brief 将对象结果序列化为 JSON 对象或 MessagePack map，追加到 out
+ *
+ * 直接遍历结果描述符写出，不构建中间结构。失败时 out 中已追加的
+ * 内容被撤销。
+ *
+ * @param result 对象结果
+ * @param result_buf 结果缓冲区
+ * @param opts 序列化选项（NULL 表示 JSON + 默认规则）
+ * @param out 输出缓冲区
+ * @return int
+ *   - LMJCORE_SUCCESS: 序列化成功
+ *   - LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED: 输出缓冲区扩容失败
+ *   - LMJCORE_ERROR_INVALID_PARAM: 参数无效
+ */
+int lmjcore_ser_obj(const lmjcore_result_obj *result,
+                    const uint8_t *result_buf, const lmjcore_ser_opts *opts,
+                    lmjcore_ser_buf *out);
+
+/**
+ * @brief 将集合结果序列化为 JSON 数组或 MessagePack array，追加到 out
+ *
+ * 参数与返回值同 lmjcore_ser_obj。
+ */
+int lmjcore_ser_set(const lmjcore_result_set *result,
+                    const uint8_t *result_buf, const lmjcore_ser_opts *opts,
+                    lmjcore_ser_buf *out);
+
+// ==================== 形态分析报告 ====================
+
+/**
+ * @brief 将 lmjcore_env_shape 的分析报告序列化为 JSON 对象，追加到 out
+ *
+ * 直方图输出 count、sum、min、max、mean 与非空的桶（lo 为下界，hi 为
+ * 不含的上界，最后一个桶的 hi 为 null）；高频成员名按 count 降序输出为
+ * {"name", "count", "error"}，名字中的非法 UTF-8 字节按 \u00XX 输出。
+ * 失败时 out 中已追加的内容被撤销。
+ *
+ * @param report 分析报告
+ * @param out 输出缓冲区
+ * @return int
+ *   - LMJCORE_SUCCESS: 序列化成功
+ *   - LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED: 输出缓冲区扩容失败
+ *   - LMJCORE_ERROR_INVALID_PARAM: 参数无效
+ */
+int lmjcore_ser_shape_report(const lmjcore_shape_report *report,
+                             lmjcore_ser_buf *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LMJCORE_RESULT_SERIALIZER_H
@@ -0,0 +1,185 @@
+// result_wire.h
+#ifndef LMJCORE_RESULT_WIRE_H
+#define LMJCORE_RESULT_WIRE_H
+
+#include "lmjcore.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ==================== 线上格式 ====================
+//
+// 与平台无关的结果编码：所有整数为小端序，偏移量相对编码起始位置，
+// 无结构体填充，可以直接 mmap、跨进程传递或缓存到磁盘。
+//
+//  [ 头部 24B | 错误表 32B × error_count | 条目表 | 数据区 ]
+//
+// 头部：
+//   0  magic "LMJW"      8  error_count u32    16 total_len u32
+//   4  version u8        12 entry_count u32    20 保留 u32（0）
+//   5  kind u8（1 对象 / 2 集合）
+//   6  保留 u16（0）
+// 错误：code i32、element_offset u32、element_len u32、entity_ptr 17B、
+//       填充 3B
+// 条目：对象为 name_offset、name_len、value_offset、value_len（各 u32），
+//       集合为 offset、len（各 u32）；value_offset 为 0 表示成员缺失值
+
+#define LMJCORE_WIRE_VERSION 1
+#define LMJCORE_WIRE_HEADER_SIZE 24
+#define LMJCORE_WIRE_ERROR_SIZE 32
+#define LMJCORE_WIRE_KIND_OBJ 1
+#define LMJCORE_WIRE_KIND_SET 2
+
+// 已校验的编码视图，读取函数直接访问原始字节
+typedef struct {
+  const uint8_t *data;  // 编码起始位置
+  size_t len;           // 编码总长度
+  uint8_t kind;         // LMJCORE_WIRE_KIND_OBJ / LMJCORE_WIRE_KIND_SET
+  uint32_t error_count; // 错误数
+  uint32_t entry_count; // 成员数或元素数
+  bool sorted;          // 条目按 dup 顺序严格递增（打开时检查）
+} lmjcore_wire_view;
+
+// ==================== 编码 ====================
+
+/**
+ * @brief 将对象结果编码为线上格式
+ *
+ * @param result 对象结果
+ * @param result_buf 结果缓冲区
+ * @param out 输出缓冲区（out_size 为 0 时可为 NULL）
+ * @param out_size 输出缓冲区大小
+ * @param out_len 输出参数，编码长度；空间不足时为所需大小
+ * @return int
+ *   - LMJCORE_SUCCESS: 编码成功
+ *   - LMJCORE_ERROR_BUFFER_TOO_SMALL: 输出缓冲区不足
+ *   - LMJCORE_ERROR_INVALID_PARAM: 参数无效或结果超过 4 GiB
+ */
+int lmjcore_wire_encode_obj(const lmjcore_result_obj *result,
+                            const uint8_t *result_buf, uint8_t *out,
+                            size_t out_size, size_t *out_len);
+
+/**
+ * @brief 将集合结果编码为线上格式
+ *
+ * 参数与返回值同 lmjcore_wire_encode_obj。
+ */
+int lmjcore_wire_encode_set(const lmjcore_result_set *result,
+                            const uint8_t *result_buf, uint8_t *out,
+                            size_t out_size, size_t *out_len);
+
+// ==================== 零拷贝读取 ====================
+
+/**
+ * @brief 校验编码并建立视图
+ *
+ * 一次性检查头部、版本以及所有偏移量的范围，并判断条目是否按 dup 顺序
+ * 排列（决定查找方式），之后的读取不再校验。
+ * 视图只引用 data，data 在使用期间必须保持不变。
+ *
+ * @param data 编码数据
+ * @param len 数据长度（可大于编码长度）
+ * @param view 输出参数，视图
+ * @return int
+ *   - LMJCORE_SUCCESS: 校验通过
+ *   - LMJCORE_ERROR_INVALID_PARAM: 格式错误、版本不支持或数据被截断
+ */
+int lmjcore_wire_open(const uint8_t *data, size_t len,
+                      lmjcore_wire_view *view);
+
+/**
+ * @brief 按索引获取对象成员
+ *
+ * @param view 对象视图
+ * @param index 成员索引（0-based）
+ * @param name_data 输出参数，名称数据指针
+ * @param name_len 输出参数，名称数据长度
+ * @param value_data 输出参数，值数据指针（缺失值时为 NULL）
+ * @param value_len 输出参数，值数据长度
+ * @return int
+ *   - LMJCORE_SUCCESS: 获取成功
+ *   - LMJCORE_ERROR_ENTITY_NOT_FOUND: 索引越界
+ *   - LMJCORE_ERROR_ENTITY_TYPE_MISMATCH: 视图不是对象
+ */
+int lmjcore_wire_obj_get_member(const lmjcore_wire_view *view, size_t index,
+                                const uint8_t **name_data, size_t *name_len,
+                                const uint8_t **value_data,
+                                size_t *value_len);
+
+/**
+ * @brief 在对象视图中查找成员值
+ *
+ * view->sorted 为 true 时按 dup 顺序二分查找，否则线性扫描；是否有序由
+ * lmjcore_wire_open 在校验时一并判断，查找时不再回退。
+ *
+ * @param view 对象视图
+ * @param member_name 成员名称
+ * @param member_name_len 成员名称长度
+ * @param value_data 输出参数，值数据指针（缺失值时为 NULL）
+ * @param value_len 输出参数，值数据长度
+ * @return int
+ *   - LMJCORE_SUCCESS: 找到成员
+ *   - LMJCORE_ERROR_ENTITY_NOT_FOUND: 成员不存在
+ *   - LMJCORE_ERROR_ENTITY_TYPE_MISMATCH: 视图不是对象
+ *   - LMJCORE_ERROR_INVALID_PARAM: 参数无效
+ */
+int lmjcore_wire_obj_find_member(const lmjcore_wire_view *view,
+                                 const uint8_t *member_name,
+                                 size_t member_name_len,
+                                 const uint8_t **value_data,
+                                 size_t *value_len);
+
+/**
+ * @brief 按索引获取集合元素
+ *
+ * @param view 集合视图
+ * @param index 元素索引（0-based）
+ * @param element_data 输出参数，元素数据指针
+ * @param element_len 输出参数，元素数据长度
+ * @return int
+ *   - LMJCORE_SUCCESS: 获取成功
+ *   - LMJCORE_ERROR_ENTITY_NOT_FOUND: 索引越界
+ *   - LMJCORE_ERROR_ENTITY_TYPE_MISMATCH: 视图不是集合
+ */
+int lmjcore_wire_set_get_element(const lmjcore_wire_view *view, size_t index,
+                                 const uint8_t **element_data,
+                                 size_t *element_len);
+
+/**
+ * @brief 在集合视图中查找元素（精确字节匹配）
+ *
+ * @param view 集合视图
+ * @param element 要查找的元素数据
+ * @param element_len 元素数据长度
+ * @param found_index 输出参数，找到的索引位置
+ * @return int
+ *   - LMJCORE_SUCCESS: 找到元素
+ *   - LMJCORE_ERROR_ENTITY_NOT_FOUND: 元素不存在
+ *   - LMJCORE_ERROR_ENTITY_TYPE_MISMATCH: 视图不是集合
+ *   - LMJCORE_ERROR_INVALID_PARAM: 参数无效
+ */
+int lmjcore_wire_set_find_element(const lmjcore_wire_view *view,
+                                  const uint8_t *element, size_t element_len,
+                                  size_t *found_index);
+
+/**
+ * @brief 按索引读取错误信息
+ *
+ * element_offset 相对编码起始位置。
+ *
+ * @param view 视图
+ * @param index 错误索引（0-based）
+ * @param error 输出参数，解码后的错误信息
+ * @return int
+ *   - LMJCORE_SUCCESS: 获取成功
+ *   - LMJCORE_ERROR_ENTITY_NOT_FOUND: 索引越界
+ */
+int lmjcore_wire_get_error(const lmjcore_wire_view *view, size_t index,
+                           lmjcore_read_error *error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LMJCORE_RESULT_WIRE_H
@@ -0,0 +1,19 @@
+// result_key.h（内部头文件，不安装）
+#ifndef LMJCORE_RESULT_KEY_H
+#define LMJCORE_RESULT_KEY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// 与 LMDB 默认 dup 比较一致：逐字节比较公共前缀，相同时较短者在前
+static inline int result_key_cmp(const uint8_t *a, size_t a_len,
+                                 const uint8_t *b, size_t b_len) {
+  int diff = memcmp(a, b, a_len < b_len ? a_len : b_len);
+  if (diff != 0) {
+    return diff;
+  }
+  return a_len < b_len ? -1 : (a_len > b_len ? 1 : 0);
+}
+
+#endif // LMJCORE_RESULT_KEY_H
@@ -1,6 +1,53 @@
 #include "result_parser.h"
+#include "result_key.h"
+#include <stdint.h>
 #include <string.h>
 
+// ==================== 内部工具 ====================
+
+// 对象成员描述符以成员名开头，两类结果都按 (起始地址, 步长) 访问查找键
+static inline const lmjcore_descriptor *entry_key(const void *entries,
+                                                  size_t stride, size_t i) {
+  return (const lmjcore_descriptor *)((const uint8_t *)entries + i * stride);
+}
+
+static inline bool key_eq(const uint8_t *buf, const lmjcore_descriptor *desc,
+                          const uint8_t *key, size_t key_len) {
+  return desc->value_len == key_len &&
+         memcmp(buf + desc->value_offset, key, key_len) == 0;
+}
+
+// 有序结果二分查找，否则线性扫描；返回下标，不存在时返回 count
+static size_t entry_find(const void *entries, size_t stride, size_t count,
+                         bool sorted, const uint8_t *buf, const uint8_t *key,
+                         size_t key_len) {
+  if (!sorted) {
+    for (size_t i = 0; i < count; ++i) {
+      if (key_eq(buf, entry_key(entries, stride, i), key, key_len)) {
+        return i;
+      }
+    }
+    return count;
+  }
+
+  size_t lo = 0, hi = count;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    const lmjcore_descriptor *desc = entry_key(entries, stride, mid);
+    int cmp = result_key_cmp(buf + desc->value_offset, desc->value_len, key,
+                             key_len);
+    if (cmp == 0) {
+      return mid;
+    }
+    if (cmp < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return count;
+}
+
 // ==================== 对象结果解析 ====================
 
 int lmjcore_parser_obj_find_member(const lmjcore_result_obj *result,
@@ -13,20 +60,19 @@ int lmjcore_parser_obj_find_member(const lmjcore_result_obj *result,
     return LMJCORE_ERROR_INVALID_PARAM;
   }
 
-  for (size_t i = 0; i < result->member_count; ++i) {
-    const lmjcore_member_descriptor *desc = &result->members[i];
-    const uint8_t *name_ptr = result_buf + desc->member_name.value_offset;
-    if (desc->member_name.value_len == member_name_len &&
-        memcmp(name_ptr, member_name, member_name_len) == 0) {
-      if (value_data)
-        *value_data = result_buf + desc->member_value.value_offset;
-      if (value_len)
-        *value_len = desc->member_value.value_len;
-      return LMJCORE_SUCCESS;
-    }
+  size_t i = entry_find(result->members, sizeof(lmjcore_member_descriptor),
+                        result->member_count, result->sorted, result_buf,
+                        member_name, member_name_len);
+  if (i == result->member_count) {
+    return LMJCORE_ERROR_ENTITY_NOT_FOUND;
   }
 
-  return LMJCORE_ERROR_ENTITY_NOT_FOUND;
+  const lmjcore_member_descriptor *desc = &result->members[i];
+  if (value_data)
+    *value_data = result_buf + desc->member_value.value_offset;
+  if (value_len)
+    *value_len = desc->member_value.value_len;
+  return LMJCORE_SUCCESS;
 }
 
 int lmjcore_parser_obj_get_member(const lmjcore_result_obj *result,
@@ -82,23 +128,177 @@ int lmjcore_parser_arr_find_element(const lmjcore_result_set *result,
     return LMJCORE_ERROR_INVALID_PARAM;
   }
 
-  for (size_t i = 0; i < result->element_count; ++i) {
-    const lmjcore_descriptor *desc = &result->elements[i];
-    if (desc->value_len == element_len &&
-        memcmp(result_buf + desc->value_offset, element, element_len) == 0) {
-      if (found_index)
-        *found_index = i;
-      return LMJCORE_SUCCESS;
-    }
+  size_t i = entry_find(result->elements, sizeof(lmjcore_descriptor),
+                        result->element_count, result->sorted, result_buf,
+                        element, element_len);
+  if (i == result->element_count) {
+    return LMJCORE_ERROR_ENTITY_NOT_FOUND;
   }
 
-  return LMJCORE_ERROR_ENTITY_NOT_FOUND;
+  if (found_index)
+    *found_index = i;
+  return LMJCORE_SUCCESS;
 }
 
 size_t lmjcore_parser_arr_element_count(const lmjcore_result_set *result) {
   return result ? result->element_count : 0;
 }
 
+// ==================== 查找索引 ====================
+
+// 32 位 FNV-1a
+static uint32_t key_hash(const uint8_t *key, size_t key_len) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < key_len; ++i) {
+    h ^= key[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+// 槽位数取不小于条目数两倍的 2 的幂，负载因子不超过 0.5
+static size_t index_capacity(size_t count) {
+  size_t capacity = 8;
+  while (capacity < count * 2) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+size_t lmjcore_parser_index_size(size_t count) {
+  return index_capacity(count) * sizeof(lmjcore_parser_slot);
+}
+
+// 在索引中查找键，返回条目下标；不存在时返回 index->count
+static size_t index_probe(const lmjcore_parser_index *index,
+                          const void *entries, size_t stride,
+                          const uint8_t *buf, const uint8_t *key,
+                          size_t key_len, uint32_t hash) {
+  size_t mask = index->capacity - 1;
+  for (size_t s = hash & mask;; s = (s + 1) & mask) {
+    const lmjcore_parser_slot *slot = &index->slots[s];
+    if (slot->pos == 0) {
+      return index->count;
+    }
+    if (slot->hash == hash &&
+        key_eq(buf, entry_key(entries, stride, slot->pos - 1), key, key_len)) {
+      return slot->pos - 1;
+    }
+  }
+}
+
+static int index_build(const void *entries, size_t stride, size_t count,
+                       const uint8_t *buf, void *arena, size_t arena_size,
+                       lmjcore_parser_index *index) {
+  if (!buf || !arena || !index || count >= UINT32_MAX ||
+      (uintptr_t)arena % _Alignof(lmjcore_parser_slot) != 0) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  size_t capacity = index_capacity(count);
+  if (arena_size < capacity * sizeof(lmjcore_parser_slot)) {
+    return LMJCORE_ERROR_BUFFER_TOO_SMALL;
+  }
+
+  index->slots = arena;
+  index->capacity = capacity;
+  index->count = count;
+  memset(index->slots, 0, capacity * sizeof(lmjcore_parser_slot));
+
+  size_t mask = capacity - 1;
+  for (size_t i = 0; i < count; ++i) {
+    const lmjcore_descriptor *desc = entry_key(entries, stride, i);
+    const uint8_t *key = buf + desc->value_offset;
+    uint32_t hash = key_hash(key, desc->value_len);
+    // 同名条目只保留第一个
+    if (index_probe(index, entries, stride, buf, key, desc->value_len, hash) !=
+        count) {
+      continue;
+    }
+    size_t s = hash & mask;
+    while (index->slots[s].pos != 0) {
+      s = (s + 1) & mask;
+    }
+    index->slots[s].hash = hash;
+    index->slots[s].pos = (uint32_t)(i + 1);
+  }
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_parser_obj_index_build(const lmjcore_result_obj *result,
+                                   const uint8_t *result_buf, void *arena,
+                                   size_t arena_size,
+                                   lmjcore_parser_index *index) {
+  if (!result) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  return index_build(result->members, sizeof(lmjcore_member_descriptor),
+                     result->member_count, result_buf, arena, arena_size,
+                     index);
+}
+
+int lmjcore_parser_arr_index_build(const lmjcore_result_set *result,
+                                   const uint8_t *result_buf, void *arena,
+                                   size_t arena_size,
+                                   lmjcore_parser_index *index) {
+  if (!result) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  return index_build(result->elements, sizeof(lmjcore_descriptor),
+                     result->element_count, result_buf, arena, arena_size,
+                     index);
+}
+
+int lmjcore_parser_obj_find_member_indexed(const lmjcore_result_obj *result,
+                                           const uint8_t *result_buf,
+                                           const lmjcore_parser_index *index,
+                                           const uint8_t *member_name,
+                                           size_t member_name_len,
+                                           const uint8_t **value_data,
+                                           size_t *value_len) {
+  if (!result || !result_buf || !index || !index->slots || !member_name ||
+      member_name_len == 0 || index->count != result->member_count) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  size_t i = index_probe(index, result->members,
+                         sizeof(lmjcore_member_descriptor), result_buf,
+                         member_name, member_name_len,
+                         key_hash(member_name, member_name_len));
+  if (i == index->count) {
+    return LMJCORE_ERROR_ENTITY_NOT_FOUND;
+  }
+
+  const lmjcore_member_descriptor *desc = &result->members[i];
+  if (value_data)
+    *value_data = result_buf + desc->member_value.value_offset;
+  if (value_len)
+    *value_len = desc->member_value.value_len;
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_parser_arr_find_element_indexed(const lmjcore_result_set *result,
+                                            const uint8_t *result_buf,
+                                            const lmjcore_parser_index *index,
+                                            const uint8_t *element,
+                                            size_t element_len,
+                                            size_t *found_index) {
+  if (!result || !result_buf || !index || !index->slots || !element ||
+      element_len == 0 || index->count != result->element_count) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  size_t i = index_probe(index, result->elements, sizeof(lmjcore_descriptor),
+                         result_buf, element, element_len,
+                         key_hash(element, element_len));
+  if (i == index->count) {
+    return LMJCORE_ERROR_ENTITY_NOT_FOUND;
+  }
+
+  if (found_index)
+    *found_index = i;
+  return LMJCORE_SUCCESS;
+}
+
 // ==================== 错误信息解析 ====================
 
 size_t lmjcore_parser_error_count(const void *result) {
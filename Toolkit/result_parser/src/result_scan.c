@@ -0,0 +1,221 @@
+#include "result_parser.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__)
+#define SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// 逐元素比较：元素前 n 字节与 key 相同。key_pad 为 key 前 32 字节的副本
+// （不足补零），短 key 可以整块载入而不越界
+typedef bool (*scan_eq_fn)(const uint8_t *elem, const uint8_t *key,
+                           const uint8_t *key_pad, size_t n);
+
+// ==================== 标量内核 ====================
+
+static bool eq_scalar(const uint8_t *elem, const uint8_t *key,
+                      const uint8_t *key_pad, size_t n) {
+  (void)key_pad;
+  return memcmp(elem, key, n) == 0;
+}
+
+#ifdef SCAN_X86
+
+// ==================== SSE2 内核 ====================
+
+// 读取窗口不跨页时整块载入是安全的：同一页内的字节要么全部可读要么全不可读
+#define SCAN_PAGE_SIZE 4096
+
+static inline bool window_in_page(const uint8_t *p, size_t width) {
+  return ((uintptr_t)p & (SCAN_PAGE_SIZE - 1)) <= SCAN_PAGE_SIZE - width;
+}
+
+static inline bool eq16(const uint8_t *a, const uint8_t *b) {
+  __m128i va = _mm_loadu_si128((const __m128i *)a);
+  __m128i vb = _mm_loadu_si128((const __m128i *)b);
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) == 0xFFFF;
+}
+
+static bool eq_sse2(const uint8_t *elem, const uint8_t *key,
+                    const uint8_t *key_pad, size_t n) {
+  if (n < 16) {
+    // 短元素：载入 16 字节，只比较前 n 字节
+    if (!window_in_page(elem, 16)) {
+      return memcmp(elem, key, n) == 0;
+    }
+    __m128i va = _mm_loadu_si128((const __m128i *)elem);
+    __m128i vb = _mm_loadu_si128((const __m128i *)key_pad);
+    unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+    unsigned want = (1u << n) - 1;
+    return (mask & want) == want;
+  }
+
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    if (!eq16(elem + i, key + i)) {
+      return false;
+    }
+  }
+  // 剩余部分与最后 16 字节重叠比较（17 字节指针即两次载入）
+  return i == n || eq16(elem + n - 16, key + n - 16);
+}
+
+// ==================== AVX2 内核 ====================
+
+__attribute__((target("avx2"))) static inline bool eq32(const uint8_t *a,
+                                                        const uint8_t *b) {
+  __m256i va = _mm256_loadu_si256((const __m256i *)a);
+  __m256i vb = _mm256_loadu_si256((const __m256i *)b);
+  return _mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)) == -1;
+}
+
+__attribute__((target("avx2"))) static bool eq_avx2(const uint8_t *elem,
+                                                    const uint8_t *key,
+                                                    const uint8_t *key_pad,
+                                                    size_t n) {
+  if (n < 32) {
+    return eq_sse2(elem, key, key_pad, n);
+  }
+
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    if (!eq32(elem + i, key + i)) {
+      return false;
+    }
+  }
+  return i == n || eq32(elem + n - 32, key + n - 32);
+}
+
+#endif // SCAN_X86
+
+// ==================== 调度 ====================
+
+static atomic_int scan_level = LMJCORE_PARSER_SIMD_AUTO;
+
+static lmjcore_parser_simd scan_detect(void) {
+#ifdef SCAN_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return LMJCORE_PARSER_SIMD_AVX2;
+  }
+  return LMJCORE_PARSER_SIMD_SSE2; // x86-64 基线指令集
+#else
+  return LMJCORE_PARSER_SIMD_SCALAR;
+#endif
+}
+
+int lmjcore_parser_simd_set(lmjcore_parser_simd level) {
+  switch (level) {
+  case LMJCORE_PARSER_SIMD_AUTO:
+  case LMJCORE_PARSER_SIMD_SCALAR:
+    break;
+  case LMJCORE_PARSER_SIMD_SSE2:
+  case LMJCORE_PARSER_SIMD_AVX2:
+    if (level > scan_detect()) {
+      return LMJCORE_ERROR_INVALID_PARAM;
+    }
+    break;
+  default:
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  atomic_store(&scan_level, level);
+  return LMJCORE_SUCCESS;
+}
+
+lmjcore_parser_simd lmjcore_parser_simd_get(void) {
+  int level = atomic_load(&scan_level);
+  if (level == LMJCORE_PARSER_SIMD_AUTO) {
+    // 并发首次调用时重复检测无害
+    level = scan_detect();
+    int expected = LMJCORE_PARSER_SIMD_AUTO;
+    atomic_compare_exchange_strong(&scan_level, &expected, level);
+  }
+  return (lmjcore_parser_simd)level;
+}
+
+static scan_eq_fn scan_kernel(void) {
+  switch (lmjcore_parser_simd_get()) {
+#ifdef SCAN_X86
+  case LMJCORE_PARSER_SIMD_AVX2:
+    return eq_avx2;
+  case LMJCORE_PARSER_SIMD_SSE2:
+    return eq_sse2;
+#endif
+  default:
+    return eq_scalar;
+  }
+}
+
+// ==================== 扫描 ====================
+
+// prefix 为真时匹配以 key 开头的元素，否则匹配与 key 完全相等的元素
+static int scan(const lmjcore_result_set *result, const uint8_t *result_buf,
+                const uint8_t *key, size_t key_len, bool prefix,
+                uint64_t *bitmap, size_t bitmap_words, size_t *match_count) {
+  if (!result || !result_buf || (!key && key_len > 0) || !bitmap) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  size_t count = result->element_count;
+  if (bitmap_words < LMJCORE_PARSER_BITMAP_WORDS(count)) {
+    return LMJCORE_ERROR_BUFFER_TOO_SMALL;
+  }
+
+  uint8_t key_pad[32] = {0};
+  if (key_len > 0) {
+    memcpy(key_pad, key,
+           key_len < sizeof(key_pad) ? key_len : sizeof(key_pad));
+  }
+  scan_eq_fn eq = scan_kernel();
+
+  memset(bitmap, 0, LMJCORE_PARSER_BITMAP_WORDS(count) * sizeof(uint64_t));
+  size_t matches = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const lmjcore_descriptor *desc = &result->elements[i];
+    // 先按长度过滤，多数不匹配的元素不会触碰数据
+    if (prefix ? desc->value_len < key_len : desc->value_len != key_len) {
+      continue;
+    }
+    if (eq(result_buf + desc->value_offset, key, key_pad, key_len)) {
+      bitmap[i / 64] |= UINT64_C(1) << (i % 64);
+      matches++;
+    }
+  }
+
+  if (match_count)
+    *match_count = matches;
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_parser_arr_match_equal(const lmjcore_result_set *result,
+                                   const uint8_t *result_buf,
+                                   const uint8_t *element, size_t element_len,
+                                   uint64_t *bitmap, size_t bitmap_words,
+                                   size_t *match_count) {
+  if (!element || element_len == 0) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  return scan(result, result_buf, element, element_len, false, bitmap,
+              bitmap_words, match_count);
+}
+
+int lmjcore_parser_arr_match_prefix(const lmjcore_result_set *result,
+                                    const uint8_t *result_buf,
+                                    const uint8_t *prefix, size_t prefix_len,
+                                    uint64_t *bitmap, size_t bitmap_words,
+                                    size_t *match_count) {
+  return scan(result, result_buf, prefix, prefix_len, true, bitmap,
+              bitmap_words, match_count);
+}
+
+int lmjcore_parser_arr_match_ptr(const lmjcore_result_set *result,
+                                 const uint8_t *result_buf,
+                                 const lmjcore_ptr ptr, uint64_t *bitmap,
+                                 size_t bitmap_words, size_t *match_count) {
+  if (!ptr) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  return scan(result, result_buf, ptr, LMJCORE_PTR_LEN, false, bitmap,
+              bitmap_words, match_count);
+}
@@ -0,0 +1,668 @@
+#include "result_serializer.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__)
+#define SER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// ==================== 输出缓冲区 ====================
+
+#define SER_BUF_MIN_CAP 256
+
+// 确保还能写入 extra 字节，容量按倍数增长
+static int buf_reserve(lmjcore_ser_buf *buf, size_t extra) {
+  if (buf->cap - buf->len >= extra) {
+    return LMJCORE_SUCCESS;
+  }
+  if (extra > SIZE_MAX - buf->len) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  size_t need = buf->len + extra;
+  size_t cap = buf->cap ? buf->cap : SER_BUF_MIN_CAP;
+  while (cap < need) {
+    cap = cap > SIZE_MAX / 2 ? need : cap * 2;
+  }
+  uint8_t *data = realloc(buf->data, cap);
+  if (!data) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  buf->data = data;
+  buf->cap = cap;
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_ser_buf_init(lmjcore_ser_buf *buf, size_t initial_cap) {
+  if (!buf) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  buf->data = NULL;
+  buf->len = 0;
+  buf->cap = 0;
+  return initial_cap ? buf_reserve(buf, initial_cap) : LMJCORE_SUCCESS;
+}
+
+void lmjcore_ser_buf_reset(lmjcore_ser_buf *buf) {
+  if (buf) {
+    buf->len = 0;
+  }
+}
+
+void lmjcore_ser_buf_free(lmjcore_ser_buf *buf) {
+  if (buf) {
+    free(buf->data);
+    buf->data = NULL;
+    buf->len = 0;
+    buf->cap = 0;
+  }
+}
+
+// 以下写入函数假定调用方已通过 buf_reserve 预留空间
+static inline void put_byte(lmjcore_ser_buf *buf, uint8_t byte) {
+  buf->data[buf->len++] = byte;
+}
+
+static inline void put_bytes(lmjcore_ser_buf *buf, const void *data,
+                             size_t len) {
+  memcpy(buf->data + buf->len, data, len);
+  buf->len += len;
+}
+
+static inline void put_be16(lmjcore_ser_buf *buf, uint16_t v) {
+  put_byte(buf, (uint8_t)(v >> 8));
+  put_byte(buf, (uint8_t)v);
+}
+
+static inline void put_be32(lmjcore_ser_buf *buf, uint32_t v) {
+  put_be16(buf, (uint16_t)(v >> 16));
+  put_be16(buf, (uint16_t)v);
+}
+
+// ==================== UTF-8 ====================
+
+// 返回 s 开头一个合法 UTF-8 序列的长度，不合法时返回 0
+static size_t utf8_seq_len(const uint8_t *s, size_t n) {
+  uint8_t c = s[0];
+  if (c < 0x80) {
+    return 1;
+  }
+  size_t len;
+  uint8_t lo = 0x80, hi = 0xBF; // 第二个字节的范围
+  if (c >= 0xC2 && c <= 0xDF) {
+    len = 2;
+  } else if (c >= 0xE0 && c <= 0xEF) {
+    len = 3;
+    if (c == 0xE0)
+      lo = 0xA0; // 排除过长编码
+    else if (c == 0xED)
+      hi = 0x9F; // 排除代理区
+  } else if (c >= 0xF0 && c <= 0xF4) {
+    len = 4;
+    if (c == 0xF0)
+      lo = 0x90;
+    else if (c == 0xF4)
+      hi = 0x8F; // 不超过 U+10FFFF
+  } else {
+    return 0;
+  }
+  if (n < len || s[1] < lo || s[1] > hi) {
+    return 0;
+  }
+  for (size_t i = 2; i < len; ++i) {
+    if ((s[i] & 0xC0) != 0x80) {
+      return 0;
+    }
+  }
+  return len;
+}
+
+static bool utf8_valid(const uint8_t *s, size_t n) {
+  size_t i = 0;
+  while (i < n) {
+#ifdef SER_SSE2
+    // 16 字节全为 ASCII 时整块跳过
+    if (i + 16 <= n &&
+        _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(s + i))) == 0) {
+      i += 16;
+      continue;
+    }
+#endif
+    size_t len = utf8_seq_len(s + i, n - i);
+    if (len == 0) {
+      return false;
+    }
+    i += len;
+  }
+  return true;
+}
+
+// ==================== JSON ====================
+
+static const char hex_digits[] = "0123456789abcdef";
+
+// 写出带引号的 JSON 字符串；每个输入字节最多展开为 6 字节（\u00XX）
+static int json_string(lmjcore_ser_buf *out, const uint8_t *s, size_t n) {
+  if (n > (SIZE_MAX - 2) / 6) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  int rc = buf_reserve(out, n * 6 + 2);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  uint8_t *dst = out->data + out->len;
+  *dst++ = '"';
+  size_t i = 0;
+  while (i < n) {
+#ifdef SER_SSE2
+    // 找出需要处理的字节：控制字符、引号、反斜杠以及非 ASCII
+    // （有符号比较下 >= 0x80 的字节同样小于 0x20），其余整块复制
+    const __m128i space = _mm_set1_epi8(0x20);
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (i + 16 <= n) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+      __m128i special = _mm_or_si128(
+          _mm_cmplt_epi8(v, space),
+          _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)));
+      int mask = _mm_movemask_epi8(special);
+      if (mask == 0) {
+        _mm_storeu_si128((__m128i *)dst, v);
+        dst += 16;
+        i += 16;
+        continue;
+      }
+      int plain = __builtin_ctz(mask);
+      memcpy(dst, s + i, plain);
+      dst += plain;
+      i += plain;
+      break;
+    }
+    if (i >= n) {
+      break;
+    }
+#endif
+    uint8_t c = s[i];
+    if (c >= 0x20 && c < 0x80 && c != '"' && c != '\\') {
+      *dst++ = c;
+      i++;
+      continue;
+    }
+    if (c >= 0x80) {
+      size_t len = utf8_seq_len(s + i, n - i);
+      if (len > 0) {
+        memcpy(dst, s + i, len);
+        dst += len;
+        i += len;
+        continue;
+      }
+    }
+
+    *dst++ = '\\';
+    switch (c) {
+    case '"':
+    case '\\':
+      *dst++ = c;
+      break;
+    case '\n':
+      *dst++ = 'n';
+      break;
+    case '\r':
+      *dst++ = 'r';
+      break;
+    case '\t':
+      *dst++ = 't';
+      break;
+    case '\b':
+      *dst++ = 'b';
+      break;
+    case '\f':
+      *dst++ = 'f';
+      break;
+    default: // 其余控制字符与非法 UTF-8 字节
+      *dst++ = 'u';
+      *dst++ = '0';
+      *dst++ = '0';
+      *dst++ = hex_digits[c >> 4];
+      *dst++ = hex_digits[c & 0xF];
+      break;
+    }
+    i++;
+  }
+  *dst++ = '"';
+  out->len = dst - out->data;
+  return LMJCORE_SUCCESS;
+}
+
+static const char base64_digits[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// 写出带引号的 base64 字符串
+static int json_base64(lmjcore_ser_buf *out, const uint8_t *s, size_t n) {
+  if (n > (SIZE_MAX - 2) / 4 * 3 - 2) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  int rc = buf_reserve(out, (n + 2) / 3 * 4 + 2);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  put_byte(out, '"');
+  size_t i = 0;
+  for (; i + 3 <= n; i += 3) {
+    uint32_t v = (uint32_t)s[i] << 16 | (uint32_t)s[i + 1] << 8 | s[i + 2];
+    put_byte(out, base64_digits[v >> 18]);
+    put_byte(out, base64_digits[(v >> 12) & 0x3F]);
+    put_byte(out, base64_digits[(v >> 6) & 0x3F]);
+    put_byte(out, base64_digits[v & 0x3F]);
+  }
+  if (i < n) {
+    uint32_t v = (uint32_t)s[i] << 16;
+    if (i + 1 < n) {
+      v |= (uint32_t)s[i + 1] << 8;
+    }
+    put_byte(out, base64_digits[v >> 18]);
+    put_byte(out, base64_digits[(v >> 12) & 0x3F]);
+    put_byte(out, i + 1 < n ? base64_digits[(v >> 6) & 0x3F] : '=');
+    put_byte(out, '=');
+  }
+  put_byte(out, '"');
+  return LMJCORE_SUCCESS;
+}
+
+static int json_literal(lmjcore_ser_buf *out, const char *s) {
+  size_t len = strlen(s);
+  int rc = buf_reserve(out, len);
+  if (rc == LMJCORE_SUCCESS) {
+    put_bytes(out, s, len);
+  }
+  return rc;
+}
+
+// ==================== MessagePack ====================
+
+// 写出长度前缀，fix 为 fixstr/fixmap/fixarray 的类型标记（0 表示无 fix 形式）
+static int msgpack_header(lmjcore_ser_buf *out, size_t n, uint8_t fix,
+                          size_t fix_max, uint8_t tag8, uint8_t tag16,
+                          uint8_t tag32) {
+  if (n > UINT32_MAX) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  int rc = buf_reserve(out, 5);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  if (fix && n <= fix_max) {
+    put_byte(out, fix | (uint8_t)n);
+  } else if (tag8 && n <= UINT8_MAX) {
+    put_byte(out, tag8);
+    put_byte(out, (uint8_t)n);
+  } else if (n <= UINT16_MAX) {
+    put_byte(out, tag16);
+    put_be16(out, (uint16_t)n);
+  } else {
+    put_byte(out, tag32);
+    put_be32(out, (uint32_t)n);
+  }
+  return LMJCORE_SUCCESS;
+}
+
+static int msgpack_blob(lmjcore_ser_buf *out, const uint8_t *s, size_t n,
+                        bool binary) {
+  int rc = binary ? msgpack_header(out, n, 0, 0, 0xc4, 0xc5, 0xc6)
+                  : msgpack_header(out, n, 0xa0, 31, 0xd9, 0xda, 0xdb);
+  if (rc == LMJCORE_SUCCESS) {
+    rc = buf_reserve(out, n);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    put_bytes(out, s, n);
+  }
+  return rc;
+}
+
+// ==================== 值 ====================
+
+static lmjcore_ser_value classify_value(const lmjcore_ser_opts *opts,
+                                        const uint8_t *name, size_t name_len,
+                                        const uint8_t *value,
+                                        size_t value_len) {
+  lmjcore_ser_value kind = LMJCORE_SER_VALUE_AUTO;
+  if (opts->classify) {
+    kind = opts->classify(opts->classify_ctx, name, name_len, value,
+                          value_len);
+  }
+  if (kind == LMJCORE_SER_VALUE_AUTO) {
+    if (value_len == LMJCORE_PTR_LEN &&
+        (value[0] == LMJCORE_OBJ || value[0] == LMJCORE_SET)) {
+      kind = LMJCORE_SER_VALUE_PTR;
+    } else if (utf8_valid(value, value_len)) {
+      kind = LMJCORE_SER_VALUE_STRING;
+    } else {
+      kind = LMJCORE_SER_VALUE_BINARY;
+    }
+  }
+  if (kind == LMJCORE_SER_VALUE_PTR && value_len != LMJCORE_PTR_LEN) {
+    kind = LMJCORE_SER_VALUE_BINARY; // 长度不对无法按指针输出
+  }
+  return kind;
+}
+
+static int write_string(const lmjcore_ser_opts *opts, lmjcore_ser_buf *out,
+                        const uint8_t *s, size_t n) {
+  return opts->format == LMJCORE_SER_JSON ? json_string(out, s, n)
+                                          : msgpack_blob(out, s, n, false);
+}
+
+// 成员名：MessagePack 中非法 UTF-8 的名字输出为 bin 键，保持原始字节；
+// JSON 的键只能是字符串，非法字节按 \u00XX 输出（有损，见头文件说明）
+static int write_name(const lmjcore_ser_opts *opts, lmjcore_ser_buf *out,
+                      const uint8_t *name, size_t name_len) {
+  if (opts->format == LMJCORE_SER_JSON) {
+    return json_string(out, name, name_len);
+  }
+  return msgpack_blob(out, name, name_len, !utf8_valid(name, name_len));
+}
+
+static int write_value(const lmjcore_ser_opts *opts, lmjcore_ser_buf *out,
+                       const uint8_t *name, size_t name_len,
+                       const uint8_t *value, size_t value_len) {
+  bool json = opts->format == LMJCORE_SER_JSON;
+  switch (classify_value(opts, name, name_len, value, value_len)) {
+  case LMJCORE_SER_VALUE_PTR: {
+    char str[LMJCORE_PTR_STRING_BUF_SIZE];
+    int rc = lmjcore_ptr_to_string(value, str, sizeof(str));
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+    return write_string(opts, out, (const uint8_t *)str,
+                        LMJCORE_PTR_STRING_LEN);
+  }
+  case LMJCORE_SER_VALUE_BINARY:
+    return json ? json_base64(out, value, value_len)
+                : msgpack_blob(out, value, value_len, true);
+  case LMJCORE_SER_VALUE_RAW: {
+    int rc = buf_reserve(out, value_len);
+    if (rc == LMJCORE_SUCCESS) {
+      put_bytes(out, value, value_len);
+    }
+    return rc;
+  }
+  default:
+    return write_string(opts, out, value, value_len);
+  }
+}
+
+static int write_null(const lmjcore_ser_opts *opts, lmjcore_ser_buf *out) {
+  if (opts->format == LMJCORE_SER_JSON) {
+    return json_literal(out, "null");
+  }
+  int rc = buf_reserve(out, 1);
+  if (rc == LMJCORE_SUCCESS) {
+    put_byte(out, 0xc0);
+  }
+  return rc;
+}
+
+// ==================== 序列化 ====================
+
+static const lmjcore_ser_opts default_opts = {.format = LMJCORE_SER_JSON};
+
+static int ser_obj(const lmjcore_result_obj *result, const uint8_t *result_buf,
+                   const lmjcore_ser_opts *opts, lmjcore_ser_buf *out) {
+  bool json = opts->format == LMJCORE_SER_JSON;
+  int rc = json ? json_literal(out, "{")
+                : msgpack_header(out, result->member_count, 0x80, 15, 0, 0xde,
+                                 0xdf);
+  for (size_t i = 0; rc == LMJCORE_SUCCESS && i < result->member_count; ++i) {
+    const lmjcore_member_descriptor *desc = &result->members[i];
+    const uint8_t *name = result_buf + desc->member_name.value_offset;
+    size_t name_len = desc->member_name.value_len;
+
+    if (json && i > 0) {
+      rc = json_literal(out, ",");
+    }
+    if (rc == LMJCORE_SUCCESS) {
+      rc = write_name(opts, out, name, name_len);
+    }
+    if (rc == LMJCORE_SUCCESS && json) {
+      rc = json_literal(out, ":");
+    }
+    if (rc != LMJCORE_SUCCESS) {
+      break;
+    }
+    // 缺失值的成员偏移为 0（数据区不可能从缓冲区起始位置开始）
+    if (desc->member_value.value_offset == 0) {
+      rc = write_null(opts, out);
+    } else {
+      rc = write_value(opts, out, name, name_len,
+                       result_buf + desc->member_value.value_offset,
+                       desc->member_value.value_len);
+    }
+  }
+  if (rc == LMJCORE_SUCCESS && json) {
+    rc = json_literal(out, "}");
+  }
+  return rc;
+}
+
+static int ser_set(const lmjcore_result_set *result, const uint8_t *result_buf,
+                   const lmjcore_ser_opts *opts, lmjcore_ser_buf *out) {
+  bool json = opts->format == LMJCORE_SER_JSON;
+  int rc = json ? json_literal(out, "[")
+                : msgpack_header(out, result->element_count, 0x90, 15, 0,
+                                 0xdc, 0xdd);
+  for (size_t i = 0; rc == LMJCORE_SUCCESS && i < result->element_count;
+       ++i) {
+    const lmjcore_descriptor *desc = &result->elements[i];
+    if (json && i > 0) {
+      rc = json_literal(out, ",");
+    }
+    if (rc == LMJCORE_SUCCESS) {
+      rc = write_value(opts, out, NULL, 0, result_buf + desc->value_offset,
+                       desc->value_len);
+    }
+  }
+  if (rc == LMJCORE_SUCCESS && json) {
+    rc = json_literal(out, "]");
+  }
+  return rc;
+}
+
+int lmjcore_ser_obj(const lmjcore_result_obj *result,
+                    const uint8_t *result_buf, const lmjcore_ser_opts *opts,
+                    lmjcore_ser_buf *out) {
+  if (!result || !result_buf || !out) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  opts = opts ? opts : &default_opts;
+  size_t start = out->len;
+  int rc = ser_obj(result, result_buf, opts, out);
+  if (rc != LMJCORE_SUCCESS) {
+    out->len = start;
+  }
+  return rc;
+}
+
+int lmjcore_ser_set(const lmjcore_result_set *result,
+                    const uint8_t *result_buf, const lmjcore_ser_opts *opts,
+                    lmjcore_ser_buf *out) {
+  if (!result || !result_buf || !out) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  opts = opts ? opts : &default_opts;
+  size_t start = out->len;
+  int rc = ser_set(result, result_buf, opts, out);
+  if (rc != LMJCORE_SUCCESS) {
+    out->len = start;
+  }
+  return rc;
+}
+
+// ==================== 形态分析报告 ====================
+
+// 写出 "key":
+static int json_key(lmjcore_ser_buf *out, const char *key) {
+  int rc = json_string(out, (const uint8_t *)key, strlen(key));
+  return rc == LMJCORE_SUCCESS ? json_literal(out, ":") : rc;
+}
+
+// 写出 "key":n，非首个字段时前面加逗号
+static int json_field_u64(lmjcore_ser_buf *out, bool first, const char *key,
+                          uint64_t n) {
+  char num[24];
+  snprintf(num, sizeof(num), "%llu", (unsigned long long)n);
+  int rc = first ? LMJCORE_SUCCESS : json_literal(out, ",");
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_key(out, key);
+  }
+  return rc == LMJCORE_SUCCESS ? json_literal(out, num) : rc;
+}
+
+static int ser_shape_hist(const lmjcore_shape_hist *hist,
+                          lmjcore_ser_buf *out) {
+  char mean[32];
+  snprintf(mean, sizeof(mean), "%.3f",
+           hist->count ? (double)hist->sum / (double)hist->count : 0.0);
+  int rc = json_literal(out, "{");
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_field_u64(out, true, "count", hist->count);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_field_u64(out, false, "sum", hist->sum);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_field_u64(out, false, "min", hist->min);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_field_u64(out, false, "max", hist->max);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_literal(out, ",\"mean\":");
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_literal(out, mean);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_literal(out, ",\"buckets\":[");
+  }
+  // 桶 0 为 0，桶 i 为 [2^(i-1), 2^i)
+  bool first = true;
+  for (size_t i = 0; rc == LMJCORE_SUCCESS && i < LMJCORE_SHAPE_BUCKETS;
+       ++i) {
+    if (hist->buckets[i] == 0) {
+      continue;
+    }
+    uint64_t lo = i == 0 ? 0 : (uint64_t)1 << (i - 1);
+    rc = json_literal(out, first ? "{" : ",{");
+    first = false;
+    if (rc == LMJCORE_SUCCESS) {
+      rc = json_field_u64(out, true, "lo", lo);
+    }
+    if (rc == LMJCORE_SUCCESS) {
+      rc = i + 1 < LMJCORE_SHAPE_BUCKETS
+               ? json_field_u64(out, false, "hi", (uint64_t)1 << i)
+               : json_literal(out, ",\"hi\":null");
+    }
+    if (rc == LMJCORE_SUCCESS) {
+      rc = json_field_u64(out, false, "count", hist->buckets[i]);
+    }
+    if (rc == LMJCORE_SUCCESS) {
+      rc = json_literal(out, "}");
+    }
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_literal(out, "]}");
+  }
+  return rc;
+}
+
+static int ser_shape_report(const lmjcore_shape_report *report,
+                            lmjcore_ser_buf *out) {
+  int rc = json_literal(out, "{");
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_field_u64(out, true, "txn_id", report->txn_id);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_field_u64(out, false, "objects", report->objects);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_field_u64(out, false, "sets", report->sets);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_field_u64(out, false, "inline_limit", report->inline_limit);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_field_u64(out, false, "overflow_values",
+                        report->overflow_values);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_field_u64(out, false, "elapsed_ms", report->elapsed_ms);
+  }
+
+  const struct {
+    const char *key;
+    const lmjcore_shape_hist *hist;
+  } hists[] = {
+      {"obj_members", &report->obj_members},
+      {"member_name_len", &report->member_name_len},
+      {"value_size", &report->value_size},
+      {"set_cardinality", &report->set_cardinality},
+      {"element_size", &report->element_size},
+  };
+  for (size_t i = 0;
+       rc == LMJCORE_SUCCESS && i < sizeof(hists) / sizeof(hists[0]); ++i) {
+    rc = json_literal(out, ",");
+    if (rc == LMJCORE_SUCCESS) {
+      rc = json_key(out, hists[i].key);
+    }
+    if (rc == LMJCORE_SUCCESS) {
+      rc = ser_shape_hist(hists[i].hist, out);
+    }
+  }
+
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_literal(out, ",\"top_names\":[");
+  }
+  size_t top_count = report->top_count < LMJCORE_SHAPE_TOP_NAMES
+                         ? report->top_count
+                         : LMJCORE_SHAPE_TOP_NAMES;
+  for (size_t i = 0; rc == LMJCORE_SUCCESS && i < top_count; ++i) {
+    const lmjcore_shape_name *name = &report->top[i];
+    rc = json_literal(out, i > 0 ? ",{" : "{");
+    if (rc == LMJCORE_SUCCESS) {
+      rc = json_key(out, "name");
+    }
+    if (rc == LMJCORE_SUCCESS) {
+      rc = json_string(out, name->name, name->name_len);
+    }
+    if (rc == LMJCORE_SUCCESS) {
+      rc = json_field_u64(out, false, "count", name->count);
+    }
+    if (rc == LMJCORE_SUCCESS) {
+      rc = json_field_u64(out, false, "error", name->error);
+    }
+    if (rc == LMJCORE_SUCCESS) {
+      rc = json_literal(out, "}");
+    }
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = json_literal(out, "]}");
+  }
+  return rc;
+}
+
+int lmjcore_ser_shape_report(const lmjcore_shape_report *report,
+                             lmjcore_ser_buf *out) {
+  if (!report || !out) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  size_t start = out->len;
+  int rc = ser_shape_report(report, out);
+  if (rc != LMJCORE_SUCCESS) {
+    out->len = start;
+  }
+  return rc;
+}
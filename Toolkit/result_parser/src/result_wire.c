@@ -0,0 +1,353 @@
+#include "result_wire.h"
+#include "result_key.h"
+#include <string.h>
+
+static const uint8_t wire_magic[4] = {'L', 'M', 'J', 'W'};
+
+// ==================== 小端读写 ====================
+
+static inline void wr32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t rd32(const uint8_t *p) {
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 |
+         (uint32_t)p[3] << 24;
+}
+
+// 每个条目由 fields 个 (offset, len) 组成：对象为名称和值，集合为元素
+static inline size_t entry_fields(uint8_t kind) {
+  return kind == LMJCORE_WIRE_KIND_OBJ ? 2 : 1;
+}
+
+static inline size_t tables_end(uint32_t error_count, uint32_t entry_count,
+                                size_t fields) {
+  return LMJCORE_WIRE_HEADER_SIZE +
+         (size_t)error_count * LMJCORE_WIRE_ERROR_SIZE +
+         (size_t)entry_count * fields * 8;
+}
+
+// ==================== 编码 ====================
+
+// 对象成员描述符由名称、值两个 lmjcore_descriptor 组成，两类结果都按
+// descriptor 数组编码
+static int wire_encode(uint8_t kind, const lmjcore_read_error *errors,
+                       size_t error_count, const lmjcore_descriptor *descs,
+                       size_t entry_count, const uint8_t *result_buf,
+                       uint8_t *out, size_t out_size, size_t *out_len) {
+  if (!result_buf || !out_len || (!out && out_size > 0)) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  if (error_count > LMJCORE_MAX_READ_ERRORS) {
+    error_count = LMJCORE_MAX_READ_ERRORS;
+  }
+  size_t fields = entry_fields(kind);
+  if (entry_count > UINT32_MAX / (fields * 8)) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  // 计算编码长度，超过 u32 偏移量的表示范围时拒绝
+  uint64_t size = tables_end((uint32_t)error_count, (uint32_t)entry_count,
+                             fields);
+  for (size_t i = 0; i < error_count; ++i) {
+    size += errors[i].element.element_len;
+  }
+  for (size_t i = 0; i < entry_count * fields; ++i) {
+    size += descs[i].value_len;
+  }
+  if (size > UINT32_MAX) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  *out_len = (size_t)size;
+  if (out_size < size) {
+    return LMJCORE_ERROR_BUFFER_TOO_SMALL;
+  }
+
+  memset(out, 0, tables_end((uint32_t)error_count, (uint32_t)entry_count,
+                            fields));
+  memcpy(out, wire_magic, sizeof(wire_magic));
+  out[4] = LMJCORE_WIRE_VERSION;
+  out[5] = kind;
+  wr32(out + 8, (uint32_t)error_count);
+  wr32(out + 12, (uint32_t)entry_count);
+  wr32(out + 16, (uint32_t)size);
+
+  size_t data_off = tables_end((uint32_t)error_count, (uint32_t)entry_count,
+                               fields);
+  uint8_t *p = out + LMJCORE_WIRE_HEADER_SIZE;
+  for (size_t i = 0; i < error_count; ++i, p += LMJCORE_WIRE_ERROR_SIZE) {
+    const lmjcore_read_error *err = &errors[i];
+    size_t len = err->element.element_len;
+    wr32(p, (uint32_t)err->error_code);
+    if (len > 0) {
+      // 错误引用的名称单独复制一份，偏移量改为相对编码起始位置
+      memcpy(out + data_off, result_buf + err->element.element_offset, len);
+      wr32(p + 4, (uint32_t)data_off);
+      wr32(p + 8, (uint32_t)len);
+      data_off += len;
+    }
+    memcpy(p + 12, err->entity_ptr, LMJCORE_PTR_LEN);
+  }
+
+  for (size_t i = 0; i < entry_count * fields; ++i, p += 8) {
+    const lmjcore_descriptor *desc = &descs[i];
+    if (desc->value_offset == 0) {
+      continue; // 缺失值保持 (0, 0)
+    }
+    memcpy(out + data_off, result_buf + desc->value_offset, desc->value_len);
+    wr32(p, (uint32_t)data_off);
+    wr32(p + 4, (uint32_t)desc->value_len);
+    data_off += desc->value_len;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_wire_encode_obj(const lmjcore_result_obj *result,
+                            const uint8_t *result_buf, uint8_t *out,
+                            size_t out_size, size_t *out_len) {
+  if (!result) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  return wire_encode(LMJCORE_WIRE_KIND_OBJ, result->errors,
+                     result->error_count,
+                     (const lmjcore_descriptor *)result->members,
+                     result->member_count, result_buf, out, out_size,
+                     out_len);
+}
+
+int lmjcore_wire_encode_set(const lmjcore_result_set *result,
+                            const uint8_t *result_buf, uint8_t *out,
+                            size_t out_size, size_t *out_len) {
+  if (!result) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  return wire_encode(LMJCORE_WIRE_KIND_SET, result->errors,
+                     result->error_count, result->elements,
+                     result->element_count, result_buf, out, out_size,
+                     out_len);
+}
+
+// ==================== 校验 ====================
+
+// (offset, len) 为 (0, 0) 或完整落在数据区内
+static bool span_valid(const uint8_t *p, size_t data_start, size_t total) {
+  uint64_t off = rd32(p), len = rd32(p + 4);
+  if (off == 0) {
+    return len == 0;
+  }
+  return off >= data_start && off + len <= total;
+}
+
+int lmjcore_wire_open(const uint8_t *data, size_t len,
+                      lmjcore_wire_view *view) {
+  if (!data || !view || len < LMJCORE_WIRE_HEADER_SIZE ||
+      memcmp(data, wire_magic, sizeof(wire_magic)) != 0 ||
+      data[4] != LMJCORE_WIRE_VERSION ||
+      (data[5] != LMJCORE_WIRE_KIND_OBJ && data[5] != LMJCORE_WIRE_KIND_SET)) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  uint8_t kind = data[5];
+  uint32_t error_count = rd32(data + 8);
+  uint32_t entry_count = rd32(data + 12);
+  uint32_t total = rd32(data + 16);
+  size_t fields = entry_fields(kind);
+  if (total > len || error_count > LMJCORE_MAX_READ_ERRORS ||
+      (uint64_t)entry_count * fields * 8 > total) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  size_t data_start = tables_end(error_count, entry_count, fields);
+  if (data_start > total) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  const uint8_t *p = data + LMJCORE_WIRE_HEADER_SIZE;
+  for (uint32_t i = 0; i < error_count; ++i, p += LMJCORE_WIRE_ERROR_SIZE) {
+    if (!span_valid(p + 4, data_start, total)) {
+      return LMJCORE_ERROR_INVALID_PARAM;
+    }
+  }
+  // 校验的同时检查条目首个字段是否严格递增（dup 顺序），决定查找方式
+  bool sorted = true;
+  const uint8_t *prev = NULL;
+  size_t prev_len = 0;
+  for (size_t i = 0; i < (size_t)entry_count * fields; ++i, p += 8) {
+    if (!span_valid(p, data_start, total)) {
+      return LMJCORE_ERROR_INVALID_PARAM;
+    }
+    if (i % fields == 0 && sorted) {
+      uint32_t off = rd32(p);
+      size_t len = rd32(p + 4);
+      const uint8_t *cur = off ? data + off : data;
+      sorted = i == 0 || result_key_cmp(prev, prev_len, cur, len) < 0;
+      prev = cur;
+      prev_len = len;
+    }
+  }
+
+  view->data = data;
+  view->len = total;
+  view->kind = kind;
+  view->error_count = error_count;
+  view->entry_count = entry_count;
+  view->sorted = sorted;
+  return LMJCORE_SUCCESS;
+}
+
+// ==================== 读取 ====================
+
+static inline const uint8_t *entry_at(const lmjcore_wire_view *view,
+                                      size_t index) {
+  size_t fields = entry_fields(view->kind);
+  return view->data + tables_end(view->error_count, 0, fields) +
+         index * fields * 8;
+}
+
+// 读取一个 (offset, len)；(0, 0) 返回 NULL
+static inline const uint8_t *span_read(const lmjcore_wire_view *view,
+                                       const uint8_t *p, size_t *len) {
+  uint32_t off = rd32(p);
+  *len = rd32(p + 4);
+  return off ? view->data + off : NULL;
+}
+
+// 按条目首个字段查找：有序视图二分查找，否则线性扫描；不存在时返回
+// entry_count
+static size_t wire_find(const lmjcore_wire_view *view, const uint8_t *key,
+                        size_t key_len) {
+  if (!view->sorted) {
+    for (size_t i = 0; i < view->entry_count; ++i) {
+      size_t len;
+      const uint8_t *data = span_read(view, entry_at(view, i), &len);
+      if (len == key_len && data && memcmp(data, key, key_len) == 0) {
+        return i;
+      }
+    }
+    return view->entry_count;
+  }
+
+  size_t lo = 0, hi = view->entry_count;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    size_t len;
+    const uint8_t *data = span_read(view, entry_at(view, mid), &len);
+    int cmp = result_key_cmp(data ? data : key, len, key, key_len);
+    if (cmp == 0) {
+      return mid;
+    }
+    if (cmp < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return view->entry_count;
+}
+
+int lmjcore_wire_obj_get_member(const lmjcore_wire_view *view, size_t index,
+                                const uint8_t **name_data, size_t *name_len,
+                                const uint8_t **value_data,
+                                size_t *value_len) {
+  if (!view) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  if (view->kind != LMJCORE_WIRE_KIND_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+  if (index >= view->entry_count) {
+    return LMJCORE_ERROR_ENTITY_NOT_FOUND;
+  }
+
+  const uint8_t *entry = entry_at(view, index);
+  size_t len;
+  const uint8_t *data = span_read(view, entry, &len);
+  if (name_data)
+    *name_data = data;
+  if (name_len)
+    *name_len = len;
+  data = span_read(view, entry + 8, &len);
+  if (value_data)
+    *value_data = data;
+  if (value_len)
+    *value_len = len;
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_wire_obj_find_member(const lmjcore_wire_view *view,
+                                 const uint8_t *member_name,
+                                 size_t member_name_len,
+                                 const uint8_t **value_data,
+                                 size_t *value_len) {
+  if (!view || !member_name || member_name_len == 0) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  if (view->kind != LMJCORE_WIRE_KIND_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+
+  size_t i = wire_find(view, member_name, member_name_len);
+  if (i == view->entry_count) {
+    return LMJCORE_ERROR_ENTITY_NOT_FOUND;
+  }
+  return lmjcore_wire_obj_get_member(view, i, NULL, NULL, value_data,
+                                     value_len);
+}
+
+int lmjcore_wire_set_get_element(const lmjcore_wire_view *view, size_t index,
+                                 const uint8_t **element_data,
+                                 size_t *element_len) {
+  if (!view) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  if (view->kind != LMJCORE_WIRE_KIND_SET) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+  if (index >= view->entry_count) {
+    return LMJCORE_ERROR_ENTITY_NOT_FOUND;
+  }
+
+  size_t len;
+  const uint8_t *data = span_read(view, entry_at(view, index), &len);
+  if (element_data)
+    *element_data = data;
+  if (element_len)
+    *element_len = len;
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_wire_set_find_element(const lmjcore_wire_view *view,
+                                  const uint8_t *element, size_t element_len,
+                                  size_t *found_index) {
+  if (!view || !element || element_len == 0) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  if (view->kind != LMJCORE_WIRE_KIND_SET) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+
+  size_t i = wire_find(view, element, element_len);
+  if (i == view->entry_count) {
+    return LMJCORE_ERROR_ENTITY_NOT_FOUND;
+  }
+  if (found_index)
+    *found_index = i;
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_wire_get_error(const lmjcore_wire_view *view, size_t index,
+                           lmjcore_read_error *error) {
+  if (!view || !error || index >= view->error_count) {
+    return LMJCORE_ERROR_ENTITY_NOT_FOUND;
+  }
+
+  const uint8_t *p = view->data + LMJCORE_WIRE_HEADER_SIZE +
+                     index * LMJCORE_WIRE_ERROR_SIZE;
+  error->error_code = (int)rd32(p);
+  error->element.element_offset = rd32(p + 4);
+  error->element.element_len = rd32(p + 8);
+  memcpy(error->entity_ptr, p + 12, LMJCORE_PTR_LEN);
+  return LMJCORE_SUCCESS;
+}
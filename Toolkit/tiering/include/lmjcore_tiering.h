@@ -0,0 +1,177 @@
+// lmjcore_tiering.h
+#ifndef LMJCORE_TIERING_H
+#define LMJCORE_TIERING_H
+
+#include "lmjcore.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 位置索引对象：登记已迁往冷环境的对象（成员名为对象指针，存放于热环境）
+static const uint8_t LMJCORE_TIER_INDEX_PTR[LMJCORE_PTR_LEN] = {
+    LMJCORE_OBJ, // 类型前缀
+    0x00,        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00,        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01};
+
+/**
+ * @brief 冷热分层存储（不透明类型）
+ *
+ * 最近访问的对象留在热环境（快速存储、小而密的映射），空闲超过阈值的对象
+ * 被迁移到冷环境。读取先查热环境，未命中时经位置索引转到冷环境，
+ * 冷读可按配置把对象提升回热环境。
+ *
+ * 仅管理对象；类型字节之后 8 字节全为 0 的系统对象（如配置对象）不参与迁移。
+ * 访问热度只记录在内存中，重启后所有对象视为在启动时被访问过。
+ */
+typedef struct lmjcore_tier lmjcore_tier;
+
+// 分层配置
+typedef struct {
+  uint32_t idle_ms;     // 空闲超过该时长的对象迁往冷环境
+  uint32_t interval_ms; // 后台迁移间隔（0 表示不启动后台线程）
+  size_t batch;         // 每轮最多迁移的对象数（0 表示默认 256）
+  bool promote_on_read; // 冷读时把对象提升回热环境
+} lmjcore_tier_opts;
+
+// 分层统计
+typedef struct {
+  size_t hot_hits;   // 热环境命中次数
+  size_t cold_hits;  // 冷环境命中次数
+  size_t misses;     // 两层均未找到的次数
+  size_t migrations; // 迁往冷环境的对象数
+  size_t promotions; // 提升回热环境的对象数
+  size_t passes;     // 完成的迁移轮数
+  size_t tracked;    // 内存中记录热度的对象数
+} lmjcore_tier_stats;
+
+/**
+ * @brief 创建分层存储
+ *
+ * 两个环境由调用方打开和关闭，且在 lmjcore_tier_destroy 之前保持有效。
+ * 写入应通过本模块的接口进行，或在直接写入后调用 lmjcore_tier_touch。
+ *
+ * @param hot 热环境
+ * @param cold 冷环境
+ * @param opts 配置
+ * @param tier_out 输出分层存储
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_tier_create(lmjcore_env *hot, lmjcore_env *cold,
+                        const lmjcore_tier_opts *opts,
+                        lmjcore_tier **tier_out);
+
+/**
+ * @brief 停止后台迁移并销毁分层存储（不关闭环境）
+ *
+ * @param tier 分层存储
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_tier_destroy(lmjcore_tier *tier);
+
+/**
+ * @brief 读取对象（热环境优先，未命中时透明回落到冷环境）
+ *
+ * 缓冲区布局与 lmjcore_obj_get 相同。
+ *
+ * @param tier 分层存储
+ * @param obj_ptr 对象指针
+ * @param result_buf 输出缓冲区
+ * @param result_buf_size 缓冲区大小
+ * @param result_head 输出结果头部
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功，两层都不存在时返回
+ * LMJCORE_ERROR_ENTITY_NOT_FOUND）
+ */
+int lmjcore_tier_obj_get(lmjcore_tier *tier, const lmjcore_ptr obj_ptr,
+                         uint8_t *result_buf, size_t result_buf_size,
+                         lmjcore_result_obj **result_head);
+
+/**
+ * @brief 读取对象成员的值（热环境优先）
+ *
+ * @param tier 分层存储
+ * @param obj_ptr 对象指针
+ * @param member_name 成员名称
+ * @param member_name_len 成员名称长度
+ * @param value_buf 输出缓冲区
+ * @param value_buf_size 缓冲区大小
+ * @param value_size_out 输出值长度
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_tier_obj_member_get(lmjcore_tier *tier, const lmjcore_ptr obj_ptr,
+                                const uint8_t *member_name,
+                                size_t member_name_len, uint8_t *value_buf,
+                                size_t value_buf_size, size_t *value_size_out);
+
+/**
+ * @brief 写入对象成员的值（对象在冷环境时先提升回热环境）
+ *
+ * @param tier 分层存储
+ * @param obj_ptr 对象指针
+ * @param member_name 成员名称
+ * @param member_name_len 成员名称长度
+ * @param value 成员值
+ * @param value_len 值长度
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_tier_obj_member_put(lmjcore_tier *tier, const lmjcore_ptr obj_ptr,
+                                const uint8_t *member_name,
+                                size_t member_name_len, const uint8_t *value,
+                                size_t value_len);
+
+/**
+ * @brief 把冷环境中的对象提升回热环境
+ *
+ * @param tier 分层存储
+ * @param obj_ptr 对象指针
+ * @return int 错误码（已在热环境时直接返回 LMJCORE_SUCCESS）
+ */
+int lmjcore_tier_promote(lmjcore_tier *tier, const lmjcore_ptr obj_ptr);
+
+/**
+ * @brief 查询对象所在的层
+ *
+ * @param tier 分层存储
+ * @param obj_ptr 对象指针
+ * @return int 1 在热环境，2 在冷环境，0 不存在，<0 错误码
+ */
+int lmjcore_tier_locate(lmjcore_tier *tier, const lmjcore_ptr obj_ptr);
+
+/**
+ * @brief 记录一次对象访问（直接读写热环境后调用）
+ *
+ * @param tier 分层存储
+ * @param obj_ptr 对象指针
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_tier_touch(lmjcore_tier *tier, const lmjcore_ptr obj_ptr);
+
+/**
+ * @brief 执行一轮迁移
+ *
+ * 从上一轮停止的位置继续遍历热环境，把空闲超过 idle_ms 的对象迁往冷环境，
+ * 最多迁移 batch 个。每个对象在热环境写事务内完成复制与删除，
+ * 期间的应用写入会等待写锁，不会丢失。
+ *
+ * @note 调用线程不得持有热环境或冷环境的写事务。
+ *
+ * @param tier 分层存储
+ * @param moved_out 输出本轮迁移的对象数（可为 NULL）
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_tier_migrate(lmjcore_tier *tier, size_t *moved_out);
+
+/**
+ * @brief 读取分层统计
+ *
+ * @param tier 分层存储
+ * @param stats_out 输出统计
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_tier_stats_get(lmjcore_tier *tier, lmjcore_tier_stats *stats_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LMJCORE_TIERING_H
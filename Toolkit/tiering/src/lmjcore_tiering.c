@@ -0,0 +1,762 @@
+// lmjcore_tiering.c
+#include "lmjcore_tiering.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TIER_DEFAULT_BATCH 256
+#define TIER_INITIAL_BUCKETS 1024
+#define TIER_INITIAL_BUF 4096
+// 冷读时对象恰好被提升/迁移的重试次数
+#define TIER_READ_RETRIES 3
+
+// 位置索引中成员值：对象所在层
+static const uint8_t TIER_COLD_MARK = 2;
+
+// 内存热度表条目
+typedef struct tier_heat {
+  lmjcore_ptr ptr;
+  uint64_t last_ms;
+  struct tier_heat *next;
+} tier_heat;
+
+struct lmjcore_tier {
+  lmjcore_env *hot;
+  lmjcore_env *cold;
+  lmjcore_tier_opts opts;
+  uint64_t start_ms; // 未记录热度的对象视为此刻被访问
+
+  // 串行化本模块对热环境的写事务，并保护复制缓冲区和遍历位置
+  pthread_mutex_t write_lock;
+  uint8_t *buf;
+  size_t buf_size;
+  lmjcore_ptr resume;
+  bool has_resume;
+
+  // 以下字段由 lock 保护
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  tier_heat **buckets;
+  size_t bucket_count;
+  lmjcore_tier_stats stats;
+  pthread_t thread;
+  bool running;
+  bool stopping;
+};
+
+static uint64_t tier_now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+// 类型字节之后 8 字节全为 0 的指针留给系统对象，不参与迁移
+static bool tier_is_system_ptr(const lmjcore_ptr ptr) {
+  for (int i = 1; i <= 8; i++) {
+    if (ptr[i] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// FNV-1a
+static size_t tier_hash(const lmjcore_ptr ptr, size_t bucket_count) {
+  uint64_t h = 14695981039346656037ULL;
+  for (int i = 0; i < LMJCORE_PTR_LEN; i++) {
+    h = (h ^ ptr[i]) * 1099511628211ULL;
+  }
+  return (size_t)(h & (bucket_count - 1));
+}
+
+static tier_heat **tier_heat_find(lmjcore_tier *tier, const lmjcore_ptr ptr) {
+  tier_heat **slot = &tier->buckets[tier_hash(ptr, tier->bucket_count)];
+  while (*slot && memcmp((*slot)->ptr, ptr, LMJCORE_PTR_LEN) != 0) {
+    slot = &(*slot)->next;
+  }
+  return slot;
+}
+
+// 扩容热度表（需持有 lock，失败时保持原表）
+static void tier_heat_grow(lmjcore_tier *tier) {
+  size_t count = tier->bucket_count * 2;
+  tier_heat **buckets = calloc(count, sizeof(tier_heat *));
+  if (!buckets) {
+    return;
+  }
+  for (size_t i = 0; i < tier->bucket_count; i++) {
+    tier_heat *e = tier->buckets[i];
+    while (e) {
+      tier_heat *next = e->next;
+      size_t b = tier_hash(e->ptr, count);
+      e->next = buckets[b];
+      buckets[b] = e;
+      e = next;
+    }
+  }
+  free(tier->buckets);
+  tier->buckets = buckets;
+  tier->bucket_count = count;
+}
+
+// 记录访问时间（需持有 lock）
+static int tier_heat_touch(lmjcore_tier *tier, const lmjcore_ptr ptr) {
+  tier_heat **slot = tier_heat_find(tier, ptr);
+  if (*slot) {
+    (*slot)->last_ms = tier_now_ms();
+    return LMJCORE_SUCCESS;
+  }
+  tier_heat *e = malloc(sizeof(tier_heat));
+  if (!e) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  memcpy(e->ptr, ptr, LMJCORE_PTR_LEN);
+  e->last_ms = tier_now_ms();
+  e->next = NULL;
+  *slot = e;
+  if (++tier->stats.tracked > tier->bucket_count * 2) {
+    tier_heat_grow(tier);
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 对象已空闲超过阈值（需持有 lock）
+static bool tier_heat_idle(lmjcore_tier *tier, const lmjcore_ptr ptr,
+                           uint64_t now) {
+  tier_heat *e = *tier_heat_find(tier, ptr);
+  uint64_t last = e ? e->last_ms : tier->start_ms;
+  return now - last >= tier->opts.idle_ms;
+}
+
+static void tier_heat_forget(lmjcore_tier *tier, const lmjcore_ptr ptr) {
+  pthread_mutex_lock(&tier->lock);
+  tier_heat **slot = tier_heat_find(tier, ptr);
+  if (*slot) {
+    tier_heat *e = *slot;
+    *slot = e->next;
+    free(e);
+    tier->stats.tracked--;
+  }
+  pthread_mutex_unlock(&tier->lock);
+}
+
+// 记录一次命中并刷新热度
+static void tier_record(lmjcore_tier *tier, const lmjcore_ptr ptr,
+                        size_t *counter) {
+  pthread_mutex_lock(&tier->lock);
+  (*counter)++;
+  if (ptr) {
+    tier_heat_touch(tier, ptr);
+  }
+  pthread_mutex_unlock(&tier->lock);
+}
+
+// 对象是否已登记在冷环境
+static int tier_index_has(lmjcore_txn *hot_txn, const lmjcore_ptr ptr) {
+  return lmjcore_obj_member_value_exist(hot_txn, LMJCORE_TIER_INDEX_PTR, ptr,
+                                        LMJCORE_PTR_LEN);
+}
+
+// 读取完整对象到复制缓冲区（需持有 write_lock），不足时倍增
+static int tier_read_obj(lmjcore_tier *tier, lmjcore_txn *txn,
+                         const lmjcore_ptr ptr, lmjcore_result_obj **out) {
+  for (;;) {
+    int rc = lmjcore_obj_get(txn, ptr, tier->buf, tier->buf_size, out);
+    if (rc != LMJCORE_ERROR_BUFFER_TOO_SMALL) {
+      if (rc == LMJCORE_SUCCESS && (*out)->error_count > 0 &&
+          (*out)->errors[0].error_code == LMJCORE_ERROR_ENTITY_NOT_FOUND) {
+        return LMJCORE_ERROR_ENTITY_NOT_FOUND;
+      }
+      return rc;
+    }
+    uint8_t *buf = realloc(tier->buf, tier->buf_size * 2);
+    if (!buf) {
+      return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    tier->buf = buf;
+    tier->buf_size *= 2;
+  }
+}
+
+// 把对象从 src 复制到 dst（dst 中已有的同名对象先被删除）
+static int tier_copy_obj(lmjcore_tier *tier, lmjcore_txn *src,
+                         lmjcore_txn *dst, const lmjcore_ptr ptr) {
+  lmjcore_result_obj *obj = NULL;
+  int rc = tier_read_obj(tier, src, ptr, &obj);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  rc = lmjcore_entity_exist(dst, ptr);
+  if (rc == 1) {
+    rc = lmjcore_obj_del(dst, ptr);
+  }
+  if (rc < 0) {
+    return rc;
+  }
+  rc = lmjcore_obj_register(dst, ptr);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  for (size_t i = 0; i < obj->member_count; i++) {
+    const lmjcore_member_descriptor *m = &obj->members[i];
+    if (m->member_name.value_len == 0) {
+      continue; // 空对象占位
+    }
+    const uint8_t *name = tier->buf + m->member_name.value_offset;
+    if (m->member_value.value_offset == 0) {
+      // 缺失值成员只保留注册
+      rc = lmjcore_obj_member_register(dst, ptr, name,
+                                       m->member_name.value_len);
+    } else {
+      rc = lmjcore_obj_member_put(dst, ptr, name, m->member_name.value_len,
+                                  tier->buf + m->member_value.value_offset,
+                                  m->member_value.value_len);
+    }
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 在热环境写事务内把冷对象复制回来并撤销索引（需持有 write_lock）
+static int tier_promote_in(lmjcore_tier *tier, lmjcore_txn *hot_txn,
+                           const lmjcore_ptr ptr) {
+  lmjcore_txn *cold_txn = NULL;
+  int rc = lmjcore_txn_begin(tier->cold, NULL, LMJCORE_TXN_READONLY, &cold_txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  rc = tier_copy_obj(tier, cold_txn, hot_txn, ptr);
+  lmjcore_txn_abort(cold_txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  return lmjcore_obj_member_del(hot_txn, LMJCORE_TIER_INDEX_PTR, ptr,
+                                LMJCORE_PTR_LEN);
+}
+
+// 热环境提交后删除冷副本（失败只留下无索引的冷副本，下次迁移时覆盖）
+static void tier_drop_cold(lmjcore_tier *tier, const lmjcore_ptr ptr) {
+  lmjcore_txn *txn = NULL;
+  if (lmjcore_txn_begin(tier->cold, NULL, 0, &txn) != LMJCORE_SUCCESS) {
+    return;
+  }
+  if (lmjcore_obj_del(txn, ptr) == LMJCORE_SUCCESS) {
+    lmjcore_txn_commit(txn);
+  } else {
+    lmjcore_txn_abort(txn);
+  }
+}
+
+// 迁移单个对象：热环境写事务贯穿全程，期间应用写入等待写锁
+static int tier_migrate_one(lmjcore_tier *tier, const lmjcore_ptr ptr,
+                            bool *moved) {
+  *moved = false;
+  lmjcore_txn *hot_txn = NULL;
+  int rc = lmjcore_txn_begin(tier->hot, NULL, 0, &hot_txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  // 取得写锁后重新检查热度与存在性
+  pthread_mutex_lock(&tier->lock);
+  bool idle = tier_heat_idle(tier, ptr, tier_now_ms());
+  pthread_mutex_unlock(&tier->lock);
+  if (!idle || lmjcore_entity_exist(hot_txn, ptr) != 1) {
+    lmjcore_txn_abort(hot_txn);
+    return LMJCORE_SUCCESS;
+  }
+
+  lmjcore_txn *cold_txn = NULL;
+  rc = lmjcore_txn_begin(tier->cold, NULL, 0, &cold_txn);
+  if (rc != LMJCORE_SUCCESS) {
+    lmjcore_txn_abort(hot_txn);
+    return rc;
+  }
+  rc = tier_copy_obj(tier, hot_txn, cold_txn, ptr);
+  if (rc != LMJCORE_SUCCESS) {
+    lmjcore_txn_abort(cold_txn);
+    lmjcore_txn_abort(hot_txn);
+    return rc;
+  }
+  // 先提交冷环境：任何时刻对象至少在一层可见
+  rc = lmjcore_txn_commit(cold_txn);
+  if (rc != LMJCORE_SUCCESS) {
+    lmjcore_txn_abort(hot_txn);
+    return rc;
+  }
+
+  rc = lmjcore_obj_del(hot_txn, ptr);
+  if (rc == LMJCORE_SUCCESS) {
+    rc = lmjcore_obj_member_put(hot_txn, LMJCORE_TIER_INDEX_PTR, ptr,
+                                LMJCORE_PTR_LEN, &TIER_COLD_MARK, 1);
+  }
+  if (rc != LMJCORE_SUCCESS) {
+    lmjcore_txn_abort(hot_txn);
+    return rc;
+  }
+  rc = lmjcore_txn_commit(hot_txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  tier_heat_forget(tier, ptr);
+  *moved = true;
+  return LMJCORE_SUCCESS;
+}
+
+// 遍历热环境收集空闲对象
+typedef struct {
+  lmjcore_tier *tier;
+  uint64_t now;
+  lmjcore_ptr *candidates;
+  size_t count;
+  size_t limit;
+  lmjcore_ptr stop_at;
+} tier_scan_ctx;
+
+static int tier_scan_cb(void *ctx, const lmjcore_ptr ptr) {
+  tier_scan_ctx *scan = ctx;
+  if (ptr[0] != LMJCORE_OBJ || tier_is_system_ptr(ptr)) {
+    return 0;
+  }
+  if (scan->count == scan->limit) {
+    memcpy(scan->stop_at, ptr, LMJCORE_PTR_LEN);
+    return 1;
+  }
+  pthread_mutex_lock(&scan->tier->lock);
+  bool idle = tier_heat_idle(scan->tier, ptr, scan->now);
+  pthread_mutex_unlock(&scan->tier->lock);
+  if (idle) {
+    memcpy(scan->candidates[scan->count++], ptr, LMJCORE_PTR_LEN);
+  }
+  return 0;
+}
+
+// 后台迁移线程
+static void *tier_thread(void *arg) {
+  lmjcore_tier *tier = arg;
+  pthread_mutex_lock(&tier->lock);
+  while (!tier->stopping) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += tier->opts.interval_ms / 1000;
+    deadline.tv_nsec += (long)(tier->opts.interval_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
+    int rc = 0;
+    while (!tier->stopping && rc != ETIMEDOUT) {
+      rc = pthread_cond_timedwait(&tier->cond, &tier->lock, &deadline);
+    }
+    if (tier->stopping) {
+      break;
+    }
+    pthread_mutex_unlock(&tier->lock);
+    lmjcore_tier_migrate(tier, NULL);
+    pthread_mutex_lock(&tier->lock);
+  }
+  pthread_mutex_unlock(&tier->lock);
+  return NULL;
+}
+
+int lmjcore_tier_create(lmjcore_env *hot, lmjcore_env *cold,
+                        const lmjcore_tier_opts *opts,
+                        lmjcore_tier **tier_out) {
+  if (!hot || !cold || !opts || !tier_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (hot == cold) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  // 确保位置索引对象存在
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(hot, NULL, 0, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  rc = lmjcore_entity_exist(txn, LMJCORE_TIER_INDEX_PTR);
+  if (rc == 0) {
+    rc = lmjcore_obj_register(txn, LMJCORE_TIER_INDEX_PTR);
+  }
+  if (rc < 0) {
+    lmjcore_txn_abort(txn);
+    return rc;
+  }
+  rc = lmjcore_txn_commit(txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  lmjcore_tier *tier = calloc(1, sizeof(lmjcore_tier));
+  if (!tier) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  tier->hot = hot;
+  tier->cold = cold;
+  tier->opts = *opts;
+  if (tier->opts.batch == 0) {
+    tier->opts.batch = TIER_DEFAULT_BATCH;
+  }
+  tier->start_ms = tier_now_ms();
+  tier->bucket_count = TIER_INITIAL_BUCKETS;
+  tier->buckets = calloc(tier->bucket_count, sizeof(tier_heat *));
+  tier->buf_size = TIER_INITIAL_BUF;
+  tier->buf = malloc(tier->buf_size);
+  if (!tier->buckets || !tier->buf) {
+    free(tier->buckets);
+    free(tier->buf);
+    free(tier);
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  pthread_mutex_init(&tier->write_lock, NULL);
+  pthread_mutex_init(&tier->lock, NULL);
+  pthread_cond_init(&tier->cond, NULL);
+
+  if (tier->opts.interval_ms > 0) {
+    tier->running = true;
+    if (pthread_create(&tier->thread, NULL, tier_thread, tier) != 0) {
+      tier->running = false;
+      lmjcore_tier_destroy(tier);
+      return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+  }
+
+  *tier_out = tier;
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_tier_destroy(lmjcore_tier *tier) {
+  if (!tier) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  pthread_mutex_lock(&tier->lock);
+  bool running = tier->running;
+  tier->stopping = true;
+  pthread_cond_broadcast(&tier->cond);
+  pthread_mutex_unlock(&tier->lock);
+  if (running) {
+    pthread_join(tier->thread, NULL);
+  }
+
+  for (size_t i = 0; i < tier->bucket_count; i++) {
+    tier_heat *e = tier->buckets[i];
+    while (e) {
+      tier_heat *next = e->next;
+      free(e);
+      e = next;
+    }
+  }
+  free(tier->buckets);
+  free(tier->buf);
+  pthread_cond_destroy(&tier->cond);
+  pthread_mutex_destroy(&tier->lock);
+  pthread_mutex_destroy(&tier->write_lock);
+  free(tier);
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_tier_obj_get(lmjcore_tier *tier, const lmjcore_ptr obj_ptr,
+                         uint8_t *result_buf, size_t result_buf_size,
+                         lmjcore_result_obj **result_head) {
+  if (!tier || !obj_ptr || !result_buf || !result_head) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (obj_ptr[0] != LMJCORE_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+
+  for (int attempt = 0; attempt < TIER_READ_RETRIES; attempt++) {
+    lmjcore_txn *txn = NULL;
+    int rc = lmjcore_txn_begin(tier->hot, NULL, LMJCORE_TXN_READONLY, &txn);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+    rc = lmjcore_obj_get(txn, obj_ptr, result_buf, result_buf_size,
+                         result_head);
+    bool missing = rc == LMJCORE_SUCCESS && (*result_head)->error_count > 0 &&
+                   (*result_head)->errors[0].error_code ==
+                       LMJCORE_ERROR_ENTITY_NOT_FOUND;
+    int in_cold = missing ? tier_index_has(txn, obj_ptr) : 0;
+    lmjcore_txn_abort(txn);
+    if (rc != LMJCORE_SUCCESS || in_cold < 0) {
+      return rc != LMJCORE_SUCCESS ? rc : in_cold;
+    }
+    if (!missing) {
+      tier_record(tier, obj_ptr, &tier->stats.hot_hits);
+      return LMJCORE_SUCCESS;
+    }
+    if (!in_cold) {
+      break;
+    }
+
+    rc = lmjcore_txn_begin(tier->cold, NULL, LMJCORE_TXN_READONLY, &txn);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+    rc = lmjcore_obj_get(txn, obj_ptr, result_buf, result_buf_size,
+                         result_head);
+    missing = rc == LMJCORE_SUCCESS && (*result_head)->error_count > 0 &&
+              (*result_head)->errors[0].error_code ==
+                  LMJCORE_ERROR_ENTITY_NOT_FOUND;
+    lmjcore_txn_abort(txn);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+    if (missing) {
+      continue; // 读取期间被提升回热环境，重新从热环境读取
+    }
+    tier_record(tier, obj_ptr, &tier->stats.cold_hits);
+    if (tier->opts.promote_on_read) {
+      lmjcore_tier_promote(tier, obj_ptr); // 尽力而为，失败不影响本次读取
+    }
+    return LMJCORE_SUCCESS;
+  }
+
+  tier_record(tier, NULL, &tier->stats.misses);
+  return LMJCORE_ERROR_ENTITY_NOT_FOUND;
+}
+
+int lmjcore_tier_obj_member_get(lmjcore_tier *tier, const lmjcore_ptr obj_ptr,
+                                const uint8_t *member_name,
+                                size_t member_name_len, uint8_t *value_buf,
+                                size_t value_buf_size, size_t *value_size_out) {
+  if (!tier || !obj_ptr || !member_name || !value_buf || !value_size_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  for (int attempt = 0; attempt < TIER_READ_RETRIES; attempt++) {
+    lmjcore_txn *txn = NULL;
+    int rc = lmjcore_txn_begin(tier->hot, NULL, LMJCORE_TXN_READONLY, &txn);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+    rc = lmjcore_obj_member_get(txn, obj_ptr, member_name, member_name_len,
+                                value_buf, value_buf_size, value_size_out);
+    int in_cold =
+        rc == LMJCORE_ERROR_ENTITY_NOT_FOUND ? tier_index_has(txn, obj_ptr) : 0;
+    lmjcore_txn_abort(txn);
+    if (rc != LMJCORE_ERROR_ENTITY_NOT_FOUND) {
+      // 成员不存在、缓冲区不足等错误不计为命中
+      if (rc == LMJCORE_SUCCESS) {
+        tier_record(tier, obj_ptr, &tier->stats.hot_hits);
+      }
+      return rc;
+    }
+    if (in_cold <= 0) {
+      if (in_cold == 0) {
+        tier_record(tier, NULL, &tier->stats.misses);
+      }
+      return in_cold < 0 ? in_cold : rc;
+    }
+
+    rc = lmjcore_txn_begin(tier->cold, NULL, LMJCORE_TXN_READONLY, &txn);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+    rc = lmjcore_obj_member_get(txn, obj_ptr, member_name, member_name_len,
+                                value_buf, value_buf_size, value_size_out);
+    lmjcore_txn_abort(txn);
+    if (rc == LMJCORE_ERROR_ENTITY_NOT_FOUND) {
+      continue; // 读取期间被提升回热环境
+    }
+    if (rc == LMJCORE_SUCCESS) {
+      tier_record(tier, obj_ptr, &tier->stats.cold_hits);
+    }
+    if (tier->opts.promote_on_read) {
+      lmjcore_tier_promote(tier, obj_ptr);
+    }
+    return rc;
+  }
+
+  tier_record(tier, NULL, &tier->stats.misses);
+  return LMJCORE_ERROR_ENTITY_NOT_FOUND;
+}
+
+int lmjcore_tier_obj_member_put(lmjcore_tier *tier, const lmjcore_ptr obj_ptr,
+                                const uint8_t *member_name,
+                                size_t member_name_len, const uint8_t *value,
+                                size_t value_len) {
+  if (!tier || !obj_ptr || !member_name) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (obj_ptr[0] != LMJCORE_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+
+  // 在同一个热环境写事务内提升并写入，迁移无法插入其间
+  pthread_mutex_lock(&tier->write_lock);
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(tier->hot, NULL, 0, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    pthread_mutex_unlock(&tier->write_lock);
+    return rc;
+  }
+  int in_cold = tier_index_has(txn, obj_ptr);
+  rc = in_cold < 0 ? in_cold : LMJCORE_SUCCESS;
+  if (in_cold == 1) {
+    rc = tier_promote_in(tier, txn, obj_ptr);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = lmjcore_obj_member_put(txn, obj_ptr, member_name, member_name_len,
+                                value, value_len);
+  }
+  if (rc != LMJCORE_SUCCESS) {
+    lmjcore_txn_abort(txn);
+    pthread_mutex_unlock(&tier->write_lock);
+    return rc;
+  }
+  rc = lmjcore_txn_commit(txn);
+  if (rc == LMJCORE_SUCCESS && in_cold == 1) {
+    tier_drop_cold(tier, obj_ptr);
+  }
+  pthread_mutex_unlock(&tier->write_lock);
+
+  if (rc == LMJCORE_SUCCESS) {
+    tier_record(tier, obj_ptr,
+                in_cold == 1 ? &tier->stats.promotions : &tier->stats.hot_hits);
+  }
+  return rc;
+}
+
+int lmjcore_tier_promote(lmjcore_tier *tier, const lmjcore_ptr obj_ptr) {
+  if (!tier || !obj_ptr) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (obj_ptr[0] != LMJCORE_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+
+  pthread_mutex_lock(&tier->write_lock);
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(tier->hot, NULL, 0, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    pthread_mutex_unlock(&tier->write_lock);
+    return rc;
+  }
+  int in_cold = tier_index_has(txn, obj_ptr);
+  if (in_cold != 1) {
+    lmjcore_txn_abort(txn);
+    pthread_mutex_unlock(&tier->write_lock);
+    return in_cold < 0 ? in_cold : LMJCORE_SUCCESS;
+  }
+  rc = tier_promote_in(tier, txn, obj_ptr);
+  if (rc != LMJCORE_SUCCESS) {
+    lmjcore_txn_abort(txn);
+    pthread_mutex_unlock(&tier->write_lock);
+    return rc;
+  }
+  rc = lmjcore_txn_commit(txn);
+  if (rc == LMJCORE_SUCCESS) {
+    tier_drop_cold(tier, obj_ptr);
+  }
+  pthread_mutex_unlock(&tier->write_lock);
+
+  if (rc == LMJCORE_SUCCESS) {
+    tier_record(tier, obj_ptr, &tier->stats.promotions);
+  }
+  return rc;
+}
+
+int lmjcore_tier_locate(lmjcore_tier *tier, const lmjcore_ptr obj_ptr) {
+  if (!tier || !obj_ptr) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(tier->hot, NULL, LMJCORE_TXN_READONLY, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  rc = lmjcore_entity_exist(txn, obj_ptr);
+  if (rc == 0) {
+    rc = tier_index_has(txn, obj_ptr);
+    if (rc == 1) {
+      rc = 2;
+    }
+  }
+  lmjcore_txn_abort(txn);
+  return rc;
+}
+
+int lmjcore_tier_touch(lmjcore_tier *tier, const lmjcore_ptr obj_ptr) {
+  if (!tier || !obj_ptr) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  pthread_mutex_lock(&tier->lock);
+  int rc = tier_heat_touch(tier, obj_ptr);
+  pthread_mutex_unlock(&tier->lock);
+  return rc;
+}
+
+int lmjcore_tier_migrate(lmjcore_tier *tier, size_t *moved_out) {
+  if (!tier) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  lmjcore_ptr *candidates = malloc(tier->opts.batch * sizeof(lmjcore_ptr));
+  if (!candidates) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+
+  pthread_mutex_lock(&tier->write_lock);
+
+  // 从上一轮停止的位置继续收集空闲对象
+  tier_scan_ctx scan = {.tier = tier,
+                        .now = tier_now_ms(),
+                        .candidates = candidates,
+                        .limit = tier->opts.batch};
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(tier->hot, NULL, LMJCORE_TXN_READONLY, &txn);
+  if (rc == LMJCORE_SUCCESS) {
+    rc = lmjcore_entity_scan(txn, tier->has_resume ? tier->resume : NULL,
+                             tier_scan_cb, &scan);
+    lmjcore_txn_abort(txn);
+  }
+  bool finished = rc == LMJCORE_SUCCESS;
+  if (rc == 1) {
+    memcpy(tier->resume, scan.stop_at, LMJCORE_PTR_LEN);
+    tier->has_resume = true;
+    rc = LMJCORE_SUCCESS;
+  } else if (finished) {
+    tier->has_resume = false;
+  }
+
+  size_t moved = 0;
+  for (size_t i = 0; i < scan.count && rc == LMJCORE_SUCCESS; i++) {
+    bool ok = false;
+    rc = tier_migrate_one(tier, candidates[i], &ok);
+    moved += ok;
+  }
+  pthread_mutex_unlock(&tier->write_lock);
+  free(candidates);
+
+  pthread_mutex_lock(&tier->lock);
+  tier->stats.migrations += moved;
+  if (finished) {
+    tier->stats.passes++;
+  }
+  pthread_mutex_unlock(&tier->lock);
+
+  if (moved_out) {
+    *moved_out = moved;
+  }
+  return rc;
+}
+
+int lmjcore_tier_stats_get(lmjcore_tier *tier, lmjcore_tier_stats *stats_out) {
+  if (!tier || !stats_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  pthread_mutex_lock(&tier->lock);
+  *stats_out = tier->stats;
+  pthread_mutex_unlock(&tier->lock);
+  return LMJCORE_SUCCESS;
+}
@@ -31,6 +31,7 @@ pub const Error = error{
     // 事务相关 (-32020 ~ -32039)
     ReadonlyTxn, // -32020: 在只读事务中执行写操作
     ReadonlyParent, // -32021: 父事务是只读，不能开子事务
+    NotlsRequired, // -32022: 环境未启用 LMJCORE_ENV_NOTLS
 
     // 实体相关 (-32040 ~ -32059)
     EntityNotFound, // -32040: 实体不存在
@@ -44,6 +45,9 @@ pub const Error = error{
 
     // 资源相关 (-32080 ~ -32099)
     MemoryAllocationFailed, // -32080: 内存分配失败
+    PtrExhausted, // -32081: 指针生成器暂无可用编号
+    PoolFull, // -32082: 环境池已满且全部在用
+    Cancelled, // -32083: 后台任务被取消
 
     // 审计相关 (-32100 ~ -32119)
     GhostMember, // -32100: 存在幽灵成员
@@ -96,6 +100,7 @@ fn mapLmjcoreError(rc: c_int) ?Error {
         c.LMJCORE_ERROR_BUFFER_TOO_SMALL => Error.BufferTooSmall,
         c.LMJCORE_ERROR_READONLY_TXN => Error.ReadonlyTxn,
         c.LMJCORE_ERROR_READONLY_PARENT => Error.ReadonlyParent,
+        c.LMJCORE_ERROR_NOTLS_REQUIRED => Error.NotlsRequired,
         c.LMJCORE_ERROR_ENTITY_NOT_FOUND => Error.EntityNotFound,
         c.LMJCORE_ERROR_ENTITY_EXISTS => Error.EntityExists,
         c.LMJCORE_ERROR_ENTITY_TYPE_MISMATCH => Error.EntityTypeMismatch,
@@ -103,6 +108,9 @@ fn mapLmjcoreError(rc: c_int) ?Error {
         c.LMJCORE_ERROR_MEMBER_EXISTS => Error.MemberExists,
         c.LMJCORE_ERROR_MEMBER_MISSING => Error.MemberMissing,
         c.LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED => Error.MemoryAllocationFailed,
+        c.LMJCORE_ERROR_PTR_EXHAUSTED => Error.PtrExhausted,
+        c.LMJCORE_ERROR_POOL_FULL => Error.PoolFull,
+        c.LMJCORE_ERROR_CANCELLED => Error.Cancelled,
         c.LMJCORE_ERROR_GHOST_MEMBER => Error.GhostMember,
         else => null,
     };
@@ -361,6 +369,7 @@ pub const ResultObj = extern struct {
     error_count: usize,
     errors: [c.LMJCORE_MAX_READ_ERRORS]ReadError,
     member_count: usize,
+    sorted: bool, // 按 LMDB dup 顺序排列（读取函数置为 true）
     members: [0]MemberDescriptor, // 柔性数组
 
     // 获取成员描述符切片
@@ -403,6 +412,7 @@ pub const ResultSet = extern struct {
     error_count: usize,
     errors: [c.LMJCORE_MAX_READ_ERRORS]ReadError,
     element_count: usize,
+    sorted: bool, // 按 LMDB dup 顺序排列（读取函数置为 true）
     elements: [0]Descriptor, // 柔性数组
 
     // 获取元素描述符切片
@@ -879,3 +889,16 @@ pub fn ptrFromString(str: [:0]align(@alignOf(usize)) const u8) !Ptr {
     try throw(rc);
     return ptr;
 }
+
+// 分片指针布局
+pub fn ptrShardGet(ptr: *const Ptr) !u16 {
+    var shard: u16 = 0;
+    const rc = c.lmjcore_ptr_shard_get(ptrToC(ptr), &shard);
+    try throw(rc);
+    return shard;
+}
+
+pub fn ptrShardSet(ptr: *Ptr, shard: u16) !void {
+    const rc = c.lmjcore_ptr_shard_set(mutPtrToC(ptr), shard);
+    try throw(rc);
+}
@@ -25,6 +25,7 @@ extern "C" {
 // 事务相关 (-32020 ~ -32039)
 #define LMJCORE_ERROR_READONLY_TXN -32020    // 在只读事务中执行写操作
 #define LMJCORE_ERROR_READONLY_PARENT -32021 // 父事务是只读，不能开子事务
+#define LMJCORE_ERROR_NOTLS_REQUIRED -32022  // 环境未启用 LMJCORE_ENV_NOTLS
 
 // 实体相关 (-32040 ~ -32059)
 #define LMJCORE_ERROR_ENTITY_NOT_FOUND -32040     // 实体不存在
@@ -38,9 +39,14 @@ extern "C" {
 
 // 资源相关 (-32080 ~ -32099)
 #define LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED -32080 // 内存分配失败
+#define LMJCORE_ERROR_PTR_EXHAUSTED -32081            // 指针生成器暂无可用编号
+#define LMJCORE_ERROR_POOL_FULL -32082                // 环境池已满且全部在用
+#define LMJCORE_ERROR_CANCELLED -32083                // 后台任务被取消
+#define LMJCORE_ERROR_BUSY -32084                     // 与进行中的在线压缩冲突
 
 // 审计相关 (-32100 ~ -32119)
-#define LMJCORE_ERROR_GHOST_MEMBER -32100 // 存在幽灵成员
+#define LMJCORE_ERROR_GHOST_MEMBER -32100     // 存在幽灵成员
+#define LMJCORE_ERROR_JOURNAL_DISABLED -32101 // 未启用脏对象日志
 
 // ==================== 环境标志 ====================
 
@@ -255,6 +261,12 @@ typedef struct lmjcore_txn lmjcore_txn;
 // 环境句柄（不透明结构）
 typedef struct lmjcore_env lmjcore_env;
 
+// 读快照管理器（不透明结构）
+typedef struct lmjcore_snapshot_mgr lmjcore_snapshot_mgr;
+
+// 共享读快照（不透明结构）
+typedef struct lmjcore_shared_snapshot lmjcore_shared_snapshot;
+
 // 指针生成器函数类型
 typedef int (*lmjcore_ptr_generator_fn)(void *ctx,
                                         uint8_t out[LMJCORE_PTR_LEN]);
@@ -287,6 +299,7 @@ typedef struct {
   lmjcore_read_error errors[LMJCORE_MAX_READ_ERRORS]; // 错误数组
 
   size_t member_count; // 成员统计
+  bool sorted;         // 按 LMDB dup 顺序排列（读取函数置为 true）
   lmjcore_member_descriptor members[];
 
 } lmjcore_result_obj;
@@ -297,6 +310,7 @@ typedef struct {
   lmjcore_read_error errors[LMJCORE_MAX_READ_ERRORS]; // 错误数组
 
   size_t element_count; // 元素统计
+  bool sorted;          // 按 LMDB dup 顺序排列（读取函数置为 true）
   lmjcore_descriptor elements[];
 } lmjcore_result_set;
 
@@ -371,6 +385,573 @@ int lmjcore_txn_commit(lmjcore_txn *txn);
  */
 int lmjcore_txn_abort(lmjcore_txn *txn);
 
+/**
+ * @brief 事务批次回调
+ *
+ * @param txn 由 lmjcore_txn_exec 开启的事务句柄（回调内不得提交或中止）
+ * @param ctx 用户上下文
+ * @return int 错误码（LMJCORE_SUCCESS 表示提交）
+ */
+typedef int (*lmjcore_txn_fn)(lmjcore_txn *txn, void *ctx);
+
+/**
+ * @brief 在顶级事务中执行一个操作批次
+ *
+ * 回调返回成功则提交，否则中止并返回回调的错误码。若批次或提交因映射空间
+ * 不足（MDB_MAP_FULL）失败，且已通过 lmjcore_env_set_map_grow 启用自动扩容，
+ * 则中止事务、扩大映射并重新执行整个批次。
+ *
+ * @param env 环境句柄
+ * @param flags 事务标志（LMJCORE_TXN_* 组合）
+ * @param fn 批次回调（可能被多次调用，必须可重放）
+ * @param ctx 回调上下文
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ *
+ * @note 调用线程不得持有同一环境的其他事务，否则扩容时会等待超时。
+ */
+int lmjcore_txn_exec(lmjcore_env *env, unsigned int flags, lmjcore_txn_fn fn,
+                     void *ctx);
+
+// ==================== 映射扩容 ====================
+
+/**
+ * @brief 设置映射自动扩容策略
+ *
+ * @param env 环境句柄
+ * @param growth_factor 每次扩容的倍数（需大于 1；为 0 表示关闭自动扩容）
+ * @param max_map_size 映射大小上限（字节，0 表示不限制）
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_env_set_map_grow(lmjcore_env *env, double growth_factor,
+                             size_t max_map_size);
+
+/**
+ * @brief 按当前策略立即扩大一次映射
+ *
+ * 会阻止新事务开启并等待本进程内事务结束后调整映射。
+ *
+ * @param env 环境句柄（调用线程不得持有该环境的事务）
+ * @return int 错误码（未启用扩容或已达上限时返回 MDB_MAP_FULL）
+ */
+int lmjcore_env_map_grow(lmjcore_env *env);
+
+/**
+ * @brief 获取当前映射大小
+ *
+ * @param env 环境句柄
+ * @param map_size_out 输出参数，返回映射大小（字节）
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_env_get_map_size(lmjcore_env *env, size_t *map_size_out);
+
+// ==================== 读快照 ====================
+
+/**
+ * @brief 读快照管理器选项
+ */
+typedef struct {
+  unsigned int max_staleness_ms; // 快照最长复用时间，到期且有新提交时续期
+  unsigned int max_pin_ms; // 空闲快照最长保留时间，超过后由看门狗回收（0 表示不启用看门狗）
+  unsigned int watchdog_interval_ms; // 看门狗检查间隔（0 表示 max_pin_ms / 2）
+  bool renew_on_commit; // 本进程有新的写提交时立即续期（读己之写）
+} lmjcore_snapshot_opts;
+
+/**
+ * @brief 读快照统计
+ */
+typedef struct {
+  uint64_t acquires; // 获取次数（不含嵌套获取）
+  uint64_t renewals; // 实际开启或续期读事务的次数
+  uint64_t reclaims; // 被看门狗回收的空闲快照数
+  size_t threads;    // 持有快照槽的线程数
+} lmjcore_snapshot_stats;
+
+/**
+ * @brief 创建读快照管理器
+ *
+ * 每个线程持有一个长期复用的只读事务，获取时仅在快照过期（超过
+ * max_staleness_ms 且已有新提交）时续期，省去事务开启与结束的开销。
+ * 看门狗定期回收长时间空闲的旧快照，防止旧页被持续占用导致文件膨胀。
+ *
+ * @param env 环境句柄（必须以 LMJCORE_ENV_NOTLS 打开）
+ * @param opts 选项（NULL 表示默认：过期 5ms，空闲回收 1000ms）
+ * @param mgr_out 输出参数，返回管理器句柄
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_snapshot_mgr_create(lmjcore_env *env,
+                                const lmjcore_snapshot_opts *opts,
+                                lmjcore_snapshot_mgr **mgr_out);
+
+/**
+ * @brief 销毁读快照管理器，关闭所有线程的快照
+ *
+ * @param mgr 管理器句柄（调用前其他线程需停止使用）
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ * @note 必须在 lmjcore_cleanup 之前调用。
+ */
+int lmjcore_snapshot_mgr_destroy(lmjcore_snapshot_mgr *mgr);
+
+/**
+ * @brief 获取当前线程的读快照
+ *
+ * @param mgr 管理器句柄
+ * @param txn 输出参数，返回只读事务句柄（不能提交或中止，需用
+ *            lmjcore_snapshot_release 归还）
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ * @note 同一线程可嵌套获取，得到同一快照。
+ */
+int lmjcore_snapshot_acquire(lmjcore_snapshot_mgr *mgr, lmjcore_txn **txn);
+
+/**
+ * @brief 归还当前线程的读快照
+ *
+ * @param mgr 管理器句柄
+ * @param txn lmjcore_snapshot_acquire 返回的事务句柄
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_snapshot_release(lmjcore_snapshot_mgr *mgr, lmjcore_txn *txn);
+
+/**
+ * @brief 获取读快照统计
+ *
+ * @param mgr 管理器句柄
+ * @param stats_out 输出参数，返回统计数据
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_snapshot_mgr_stats(lmjcore_snapshot_mgr *mgr,
+                               lmjcore_snapshot_stats *stats_out);
+
+// ==================== 共享读快照 ====================
+
+/**
+ * @brief 创建供多个线程并行读取的共享快照
+ *
+ * 为每个工作线程开启一个只读事务，所有事务保证处于同一数据版本。
+ * 先乐观地直接开启并校验事务 ID，多次不一致时短暂持有写锁阻止提交后再开启。
+ *
+ * @param env 环境句柄（必须以 LMJCORE_ENV_NOTLS 打开）
+ * @param worker_count 工作事务数量（通常等于并行线程数）
+ * @param snap_out 输出参数，返回共享快照句柄
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ * @note 调用线程不能持有该环境的写事务。
+ */
+int lmjcore_shared_snapshot_create(lmjcore_env *env, size_t worker_count,
+                                   lmjcore_shared_snapshot **snap_out);
+
+/**
+ * @brief 获取共享快照中的某个工作事务
+ *
+ * @param snap 共享快照句柄
+ * @param index 工作事务下标（0 ~ worker_count-1）
+ * @param txn_out 输出参数，返回只读事务句柄（不能提交或中止）
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ * @note 同一工作事务同一时刻只能由一个线程使用。
+ */
+int lmjcore_shared_snapshot_txn(lmjcore_shared_snapshot *snap, size_t index,
+                                lmjcore_txn **txn_out);
+
+/**
+ * @brief 获取共享快照的数据版本（LMDB 事务 ID）
+ *
+ * @param snap 共享快照句柄
+ * @param txn_id_out 输出参数，返回事务 ID
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_shared_snapshot_txn_id(lmjcore_shared_snapshot *snap,
+                                   size_t *txn_id_out);
+
+/**
+ * @brief 销毁共享快照，关闭所有工作事务
+ *
+ * @param snap 共享快照句柄（调用前所有工作线程需停止使用）
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_shared_snapshot_destroy(lmjcore_shared_snapshot *snap);
+
+// ==================== 健康监控 ====================
+
+// 健康告警位
+#define LMJCORE_HEALTH_STALE_READERS 0x01 // 清理了已退出进程遗留的读槽
+#define LMJCORE_HEALTH_OLD_READER 0x02    // 最老读者持续时间超过阈值
+#define LMJCORE_HEALTH_FREE_BACKLOG 0x04  // 空闲页积压超过阈值
+#define LMJCORE_HEALTH_MAP_USAGE 0x08     // 映射使用率超过阈值
+
+/**
+ * @brief 读者表与映射健康统计
+ */
+typedef struct {
+  int stale_readers_cleared;     // 本次采样清理的失效读槽数
+  unsigned int readers_used;     // 已占用的读槽数
+  unsigned int max_readers;      // 读槽上限
+  size_t active_readers;         // 持有快照的活动读事务数
+  size_t last_txnid;             // 最新提交的事务 ID
+  size_t oldest_reader_txnid;    // 最老活动读者的事务 ID（无读者时为 0）
+  size_t oldest_reader_lag;      // 最老读者落后的事务数
+  uint64_t oldest_reader_age_ms; // 最老读者已持续的时间（按采样观测）
+  size_t free_pages;             // 空闲列表中等待复用的页数
+  size_t map_size;               // 映射大小（字节）
+  size_t map_used;               // 已使用的映射空间（字节）
+  unsigned int alerts;           // 按监控阈值计算的告警位（LMJCORE_HEALTH_*）
+} lmjcore_health_stats;
+
+/**
+ * @brief 健康告警回调（在监控线程中调用）
+ *
+ * @param env 环境句柄
+ * @param alerts 触发的告警位（LMJCORE_HEALTH_* 组合）
+ * @param stats 本次采样结果
+ * @param ctx 用户上下文
+ */
+typedef void (*lmjcore_health_alert_fn)(lmjcore_env *env, unsigned int alerts,
+                                        const lmjcore_health_stats *stats,
+                                        void *ctx);
+
+/**
+ * @brief 健康监控选项（阈值为 0 表示不检查该项）
+ */
+typedef struct {
+  unsigned int interval_ms;       // 采样间隔（毫秒，必须大于 0）
+  unsigned int max_reader_age_ms; // 最老读者持续时间阈值
+  size_t max_free_pages;          // 空闲页积压阈值
+  double max_map_use;             // 映射使用率阈值（0 ~ 1）
+  lmjcore_health_alert_fn alert;  // 告警回调（可为 NULL）
+  void *alert_ctx;                // 告警回调上下文
+} lmjcore_health_opts;
+
+/**
+ * @brief 立即执行一次健康检查
+ *
+ * 调用 mdb_reader_check 清理已退出进程遗留的读槽，并统计最老读者、
+ * 空闲页积压与映射使用量。
+ *
+ * @param env 环境句柄
+ * @param stats_out 输出参数，返回统计结果
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ * @note 内部会在调用线程上开启读事务，调用线程不能持有该环境的事务
+ *       （未启用 LMJCORE_ENV_NOTLS 时会因读槽冲突返回 MDB_BAD_RSLOT）。
+ */
+int lmjcore_env_health_check(lmjcore_env *env,
+                             lmjcore_health_stats *stats_out);
+
+/**
+ * @brief 启动后台健康监控线程
+ *
+ * @param env 环境句柄
+ * @param opts 监控选项
+ * @return int 错误码（已在运行时返回 LMJCORE_ERROR_INVALID_PARAM）
+ * @note lmjcore_cleanup 会自动停止监控线程。
+ */
+int lmjcore_health_monitor_start(lmjcore_env *env,
+                                 const lmjcore_health_opts *opts);
+
+/**
+ * @brief 停止后台健康监控线程
+ *
+ * @param env 环境句柄
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_health_monitor_stop(lmjcore_env *env);
+
+/**
+ * @brief 获取最近一次采样结果
+ *
+ * @param env 环境句柄
+ * @param stats_out 输出参数，返回统计结果
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_health_monitor_last(lmjcore_env *env,
+                                lmjcore_health_stats *stats_out);
+
+// ==================== 启动预热 ====================
+
+// 预热方式（可组合，按 RANGES、TREE、FILE 的顺序执行）
+#define LMJCORE_WARMUP_RANGES 0x01 // 回放 lmjcore_warmup_record 保存的热点区间
+#define LMJCORE_WARMUP_TREE 0x02   // 遍历 main/set 库的全部条目（触及分支页与叶子页）
+#define LMJCORE_WARMUP_FILE 0x04   // 顺序读取整个数据文件
+
+/**
+ * @brief 预热进度
+ */
+typedef struct {
+  unsigned int phase;   // 当前阶段（LMJCORE_WARMUP_* 之一，结束后为 0）
+  size_t bytes_total;   // 当前阶段需要读取的字节数（RANGES / FILE）
+  size_t bytes_done;    // 当前阶段已读取的字节数
+  size_t keys_total;    // 两个库的条目总数（TREE）
+  size_t keys_done;     // 已遍历的条目数
+  size_t slices_walked; // 遍历到条目的键区间片数（TREE，反映并行程度）
+  bool done;            // 预热已结束
+  int result;           // 结束时的错误码（取消时为 LMJCORE_ERROR_CANCELLED）
+} lmjcore_warmup_progress;
+
+/**
+ * @brief 预热进度回调（在预热协调线程中调用）
+ *
+ * @param env 环境句柄
+ * @param progress 当前进度
+ * @param ctx 用户上下文
+ */
+typedef void (*lmjcore_warmup_progress_fn)(
+    lmjcore_env *env, const lmjcore_warmup_progress *progress, void *ctx);
+
+/**
+ * @brief 预热选项
+ */
+typedef struct {
+  unsigned int modes;      // 预热方式（LMJCORE_WARMUP_* 组合）
+  const char *ranges_path; // 热点区间文件（RANGES 时必填，不存在视为空）
+  unsigned int threads;    // 并行读取线程数（0 表示 1）
+  size_t chunk_size;       // 单次读取的字节数（0 表示 1 MiB）
+  unsigned int report_ms;  // 进度回调间隔（0 表示 100 毫秒）
+  lmjcore_warmup_progress_fn progress; // 进度回调（可为 NULL）
+  void *progress_ctx;                  // 进度回调上下文
+} lmjcore_warmup_opts;
+
+/**
+ * @brief 在后台线程中开始预热
+ *
+ * 重启后映射中的页按访问逐个缺页载入，尾延迟会长时间偏高。预热把这一过程
+ * 变为有界的顺序读取：RANGES 只读取上次记录的热点区间，TREE 沿 B 树
+ * 遍历全部条目（不读取溢出页中的大值），FILE 读取整个数据文件。
+ * 文件读取经由页缓存，与 LMDB 的映射共享。
+ *
+ * @param env 环境句柄
+ * @param opts 预热选项
+ * @return int 错误码（已有预热在运行时返回 LMJCORE_ERROR_INVALID_PARAM）
+ * @note lmjcore_cleanup 会取消并等待未结束的预热。
+ */
+int lmjcore_warmup_start(lmjcore_env *env, const lmjcore_warmup_opts *opts);
+
+/**
+ * @brief 读取预热进度
+ *
+ * @param env 环境句柄
+ * @param progress_out 输出参数，返回当前进度
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_warmup_status(lmjcore_env *env,
+                          lmjcore_warmup_progress *progress_out);
+
+/**
+ * @brief 等待预热结束
+ *
+ * @param env 环境句柄
+ * @param progress_out 输出参数，返回最终进度（可为 NULL）
+ * @return int 预热结果（未启动预热时返回 LMJCORE_SUCCESS）
+ */
+int lmjcore_warmup_wait(lmjcore_env *env,
+                        lmjcore_warmup_progress *progress_out);
+
+/**
+ * @brief 取消预热并等待后台线程退出
+ *
+ * @param env 环境句柄
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_warmup_cancel(lmjcore_env *env);
+
+/**
+ * @brief 记录数据文件当前驻留在页缓存中的区间
+ *
+ * 通过 mincore 检查数据文件的每一页，把连续驻留的页合并为区间写入文件，
+ * 供下次启动时以 LMJCORE_WARMUP_RANGES 回放。应在关闭前、负载稳定时调用。
+ *
+ * @param env 环境句柄
+ * @param ranges_path 输出文件路径（先写临时文件再原子替换）
+ * @param bytes_out 输出参数，返回记录的驻留字节数（可为 NULL）
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_warmup_record(lmjcore_env *env, const char *ranges_path,
+                          size_t *bytes_out);
+
+// ==================== 在线压缩 ====================
+
+/**
+ * @brief 压缩选项（全部为 0 时使用默认值）
+ */
+typedef struct {
+  unsigned int max_rounds;       // 交换前最多追赶的轮数（0 表示 8）
+  size_t swap_threshold;         // 剩余脏键不超过该数时进入交换（0 表示 1024）
+  unsigned int drain_timeout_ms; // 交换时等待事务排空的毫秒数（0 表示 5000）
+} lmjcore_compact_opts;
+
+/**
+ * @brief 压缩统计
+ */
+typedef struct {
+  size_t size_before;  // 压缩前数据文件大小（字节）
+  size_t size_after;   // 压缩后数据文件大小（字节）
+  unsigned int rounds; // 追赶轮数（含交换前的最后一轮）
+  size_t keys_synced;  // 追赶时重新同步的键数
+} lmjcore_compact_stats;
+
+/**
+ * @brief 在线压缩数据文件并原子替换
+ *
+ * 大量删除后 LMDB 只把空闲页留在文件内复用，文件不会变小。本函数用
+ * mdb_env_copy2(MDB_CP_COMPACT) 在一个读事务上生成紧凑副本，期间其他线程
+ * 照常读写；写入经过的键被记录下来，复制完成后分轮把这些键的最新值同步到
+ * 副本。剩余脏键足够少时关闭事务闸门，排空本进程的事务，同步最后一批键，
+ * 再用 rename 把副本换成数据文件并重新打开，最后重新打开闸门。
+ * 读写线程只在交换的短暂窗口内阻塞。
+ *
+ * @note 调用线程不得持有事务，且环境中不能有存活的共享读快照（会阻止排空）。
+ *       只适用于由本进程独占打开的环境。交换时会取消未结束的预热、暂停并
+ *       恢复健康监控，空闲的读快照会在下次获取时重新开启。
+ *
+ * @param env 环境句柄
+ * @param opts 压缩选项（可为 NULL）
+ * @param stats_out 输出参数，返回压缩统计（可为 NULL）
+ * @return int 错误码（已有压缩在运行时返回 LMJCORE_ERROR_INVALID_PARAM，
+ * 排空超时返回 ETIMEDOUT，失败时原数据文件保持不变）
+ */
+int lmjcore_env_compact(lmjcore_env *env, const lmjcore_compact_opts *opts,
+                        lmjcore_compact_stats *stats_out);
+
+// ==================== 存储统计 ====================
+
+/**
+ * @brief 单个库的 B 树统计（来自 mdb_stat）
+ */
+typedef struct {
+  unsigned int depth;    // B 树深度
+  size_t branch_pages;   // 分支页数
+  size_t leaf_pages;     // 叶子页数
+  size_t overflow_pages; // 溢出页数（存放超长的值）
+  size_t entries;        // 条目数（set 库按重复值计数）
+} lmjcore_dbi_stats;
+
+/**
+ * @brief 环境存储统计
+ */
+typedef struct {
+  lmjcore_dbi_stats main; // main 库：对象成员值
+  lmjcore_dbi_stats set;  // set 库：实体登记、成员名与集合元素
+  unsigned int page_size; // 页大小（字节）
+  size_t map_size;        // 映射大小（字节）
+  size_t map_used;        // 已使用的映射空间（字节）
+  size_t free_pages;      // 空闲列表中等待复用的页数
+  size_t last_txnid;      // 最新提交的事务 ID
+} lmjcore_storage_stats;
+
+/**
+ * @brief 单类实体的采样结果
+ *
+ * 键与值按 LMDB 中的实际存储计算：对象为 main 库中的成员键（指针 + 成员名）
+ * 与成员值，集合为 set 库中的实体键与元素。
+ */
+typedef struct {
+  size_t entities;        // 该类实体总数（遍历计数，非估算）
+  size_t sampled;         // 采样的实体数
+  double avg_members;     // 平均每个实体的成员数（集合为元素数）
+  double avg_key_size;    // 平均键长（字节）
+  double avg_value_size;  // 平均值长（字节，缺失值不计入）
+  size_t overflow_values; // 采样中存放在溢出页的值数
+  double overflow_waste;  // 采样溢出页中未使用空间的占比
+} lmjcore_type_sample;
+
+/**
+ * @brief 存储采样分析结果
+ */
+typedef struct {
+  lmjcore_type_sample obj; // 对象
+  lmjcore_type_sample set; // 集合
+  double main_fill;        // main 库叶子页填充率估算（0 ~ 1）
+  double set_fill;         // set 库叶子页填充率估算（0 ~ 1）
+  size_t inline_limit;     // 键长加值长超过该值时，值放入溢出页
+} lmjcore_storage_sample;
+
+/**
+ * @brief 读取环境存储统计
+ *
+ * 在一个读事务中汇总 main、set 两个库的 mdb_stat、映射使用量与空闲页积压，
+ * 用于判断映射大小是否合适、B 树是否过深以及何时需要压缩。
+ *
+ * @param env 环境句柄
+ * @param stats_out 输出参数，返回统计结果
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ * @note 内部会在调用线程上开启读事务，调用线程不能持有该环境的事务
+ *       （未启用 LMJCORE_ENV_NOTLS 时会因读槽冲突返回 MDB_BAD_RSLOT）。
+ */
+int lmjcore_env_stats(lmjcore_env *env, lmjcore_storage_stats *stats_out);
+
+/**
+ * @brief 采样分析键值大小、页填充率与溢出页浪费
+ *
+ * 遍历全部实体并用蓄水池抽样均匀抽取最多 max_samples 个，读取其成员名与
+ * 成员值的长度，再按 LMDB 的节点布局估算叶子页填充率和溢出页中的空闲字节。
+ * 结果为估算值，用于选择映射大小、值内联阈值和压缩时机。
+ *
+ * @param env 环境句柄
+ * @param max_samples 最多采样的实体数（0 表示 1000）
+ * @param sample_out 输出参数，返回采样结果
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_env_sample(lmjcore_env *env, size_t max_samples,
+                       lmjcore_storage_sample *sample_out);
+
+// 驻留报告中每个库划分的键区间数
+#define LMJCORE_RESIDENCY_RANGES 16
+
+/**
+ * @brief 一段连续键区间的驻留情况
+ */
+typedef struct {
+  lmjcore_ptr start; // 区间内第一个采样键所属的实体指针
+  size_t sampled;    // 区间内采样的条目数
+  size_t resident;   // 其中所在页驻留在页缓存的条目数
+} lmjcore_residency_range;
+
+/**
+ * @brief 单个库的驻留情况（按采样条目所在的页统计）
+ */
+typedef struct {
+  size_t sampled;     // 采样的条目数
+  size_t mapped;      // 能定位到数据文件页的条目数
+  size_t resident;    // 所在页驻留在页缓存的条目数
+  size_t range_count; // 有效的区间数
+  lmjcore_residency_range ranges[LMJCORE_RESIDENCY_RANGES];
+} lmjcore_dbi_residency;
+
+/**
+ * @brief 页缓存驻留报告
+ */
+typedef struct {
+  size_t file_size;           // 数据文件大小（字节）
+  size_t page_size;           // 系统页大小（字节）
+  size_t file_pages;          // 数据文件的系统页数
+  size_t resident_pages;      // 驻留在页缓存中的页数
+  double resident_ratio;      // 驻留比例
+  lmjcore_dbi_residency main; // main 库
+  lmjcore_dbi_residency set;  // set 库
+} lmjcore_residency_report;
+
+/**
+ * @brief 报告数据文件在页缓存中的驻留情况
+ *
+ * 先用 mincore 检查整个数据文件，再在一个读事务中采样 main、set 两个库
+ * 的条目：LMDB 返回的值直接指向映射，由其地址可以换算出条目所在的
+ * 文件页（叶子页或溢出页），从而得到每个库以及每段键区间的驻留比例。
+ * 区间按采样顺序等分，每个库最多 LMJCORE_RESIDENCY_RANGES 段。
+ *
+ * 条目数不超过 max_samples 的库逐条遍历；更大的库按类型字节分段，在段内
+ * 首尾实体之间均匀取 max_samples 个指针前缀逐个定位（MDB_SET_RANGE）。
+ * 开销约为 max_samples × 树高 次页访问，与库的大小无关，也不会为统计
+ * 而把冷数据读进页缓存、挤出热页。指针分布很不均匀时采样点会集中在
+ * 稀疏处，相邻采样点落在同一条目上时只记一次，sampled 可能少于上限。
+ * 延迟抖动时可据此判断工作集是否已被换出，配合预热与冷热分层决定
+ * 何时扩充内存或重新分片。
+ *
+ * @note LMDB 无法提供映射地址时（me_mapaddr 为空），只统计整个文件，
+ *       各库的 mapped 为 0。
+ *
+ * @param env 环境句柄
+ * @param max_samples 每个库最多采样的条目数（0 表示 4096）
+ * @param report_out 输出参数，返回驻留报告
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_env_residency(lmjcore_env *env, size_t max_samples,
+                          lmjcore_residency_report *report_out);
+
 // ==================== 对象操作 ====================
 
 /**
@@ -539,6 +1120,7 @@ int lmjcore_obj_member_del(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
  * @brief 统计对象所有成员值的总长度和数量
  *
  * 注意：可能统计到幽灵成员，建议与审计函数配合进行完整性校验。
+ * 启用实体统计（lmjcore_entity_stats_set）时为一次查找。
  *
  * @param txn 有效的读事务句柄
  * @param obj_ptr 目标对象指针
@@ -553,6 +1135,8 @@ int lmjcore_obj_stat_values(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
 /**
  * @brief 统计对象的成员数量
  *
+ * 启用实体统计时为一次查找，否则遍历成员列表。
+ *
  * @param txn 有效的读事务句柄
  * @param obj_ptr 对象指针
  * @param total_member_len_out 输出参数，成员名总长度
@@ -653,6 +1237,8 @@ int lmjcore_set_contains(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
 /**
  * @brief 统计集合的元素总长度和数量
  *
+ * 启用实体统计时为一次查找，否则遍历全部元素。
+ *
  * @param txn 有效的读事务句柄
  * @param set_ptr 集合指针
  * @param total_value_len_out 输出参数，元素值总长度
@@ -662,6 +1248,20 @@ int lmjcore_set_contains(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
 int lmjcore_set_stat(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
                      size_t *total_value_len_out, size_t *element_count_out);
 
+/**
+ * @brief 统计集合的元素数量
+ *
+ * 与 lmjcore_set_stat 的数量一致，但不计算总长度：启用实体统计时读取记录，
+ * 否则由 mdb_cursor_count 直接给出，都不遍历元素。
+ *
+ * @param txn 有效的读事务句柄
+ * @param set_ptr 集合指针
+ * @param element_count_out 输出参数，元素总数量
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_set_count(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
+                      size_t *element_count_out);
+
 // ==================== 指针工具函数 ====================
 
 /**
@@ -684,6 +1284,32 @@ int lmjcore_ptr_to_string(const lmjcore_ptr ptr, char *str_buf,
  */
 int lmjcore_ptr_from_string(const char *str, lmjcore_ptr ptr_out);
 
+// 分片指针布局：类型字节之后的固定字节存放分片/租户编号（大端序）
+#define LMJCORE_PTR_SHARD_OFFSET 1
+#define LMJCORE_PTR_SHARD_LEN 2
+
+/**
+ * @brief 从分片布局的指针中取出分片编号
+ *
+ * 前端路由据此直接把指针转发到所属实例，无需按整个指针做哈希或查目录。
+ * 只检查类型字节，是否采用分片布局由部署约定（见工具包中的 lmjcore_shard_ptr_gen）。
+ *
+ * @param ptr 指针
+ * @param shard_out 输出分片编号
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功，类型字节非法时返回
+ * LMJCORE_ERROR_INVALID_POINTER）
+ */
+int lmjcore_ptr_shard_get(const lmjcore_ptr ptr, uint16_t *shard_out);
+
+/**
+ * @brief 将分片编号写入指针的分片字段
+ *
+ * @param ptr 指针（类型字节以外的其它字节保持不变）
+ * @param shard 分片编号
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_ptr_shard_set(lmjcore_ptr ptr, uint16_t shard);
+
 // ==================== 存在性检查 ====================
 
 /**
@@ -698,6 +1324,31 @@ int lmjcore_ptr_from_string(const char *str, lmjcore_ptr ptr_out);
  */
 int lmjcore_entity_exist(lmjcore_txn *txn, const lmjcore_ptr ptr);
 
+/**
+ * @brief 实体遍历回调
+ *
+ * @param ctx 用户上下文
+ * @param ptr 当前实体指针（仅在回调期间有效）
+ * @return int 0 继续遍历，非 0 停止遍历并作为 lmjcore_entity_scan 的返回值
+ */
+typedef int (*lmjcore_entity_scan_fn)(void *ctx, const lmjcore_ptr ptr);
+
+/**
+ * @brief 按指针字节序遍历所有实体（对象与集合）
+ *
+ * 使用独立游标逐个跳过成员列表，只访问每个实体一次；回调中可以在同一事务内
+ * 读取，但不应修改实体。start 不为 NULL 时从不小于 start 的第一个实体开始，
+ * 便于分批遍历。
+ *
+ * @param txn 有效的读事务句柄
+ * @param start 起始指针（含，NULL 表示从头开始）
+ * @param fn 回调
+ * @param ctx 回调上下文
+ * @return int 错误码（LMJCORE_SUCCESS 表示遍历完成，回调中止时返回其返回值）
+ */
+int lmjcore_entity_scan(lmjcore_txn *txn, const lmjcore_ptr start,
+                        lmjcore_entity_scan_fn fn, void *ctx);
+
 /**
  * @brief 检查对象成员的值是否存在
  *
@@ -757,6 +1408,341 @@ int lmjcore_audit_object(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
 int lmjcore_repair_object(lmjcore_txn *txn, uint8_t *report_buf,
                           size_t report_buf_size, lmjcore_audit_report *report);
 
+// 全库审计发现的问题类型（可按位组合为 report_mask）
+#define LMJCORE_AUDIT_GHOST_MEMBER 0x01  // main 中有值但未在 set 中登记的成员
+#define LMJCORE_AUDIT_MISSING_VALUE 0x02 // 已登记但 main 中没有值的成员
+#define LMJCORE_AUDIT_EMPTY_OBJECT 0x04  // 没有任何成员的对象
+#define LMJCORE_AUDIT_TYPE_MISMATCH 0x08 // 类型字节无效、键长异常或集合有成员值
+#define LMJCORE_AUDIT_ALL 0x0F
+
+// 一条审计发现（所有指针仅在回调期间有效）
+typedef struct {
+  unsigned int kind;          // LMJCORE_AUDIT_* 之一
+  const uint8_t *ptr;         // 实体指针（键长异常时为原始键）
+  size_t ptr_len;             // 通常为 LMJCORE_PTR_LEN
+  const uint8_t *member_name; // 成员名（不涉及成员时为 NULL）
+  size_t member_name_len;     // 成员名长度
+  const uint8_t *value;       // 幽灵成员或异常键的值（否则为 NULL）
+  size_t value_len;           // 值长度
+} lmjcore_audit_finding;
+
+/**
+ * @brief 审计发现回调
+ *
+ * 回调在工作线程中执行，但同一时刻只有一个回调在运行。
+ *
+ * @param ctx 用户上下文
+ * @param finding 审计发现
+ * @return int 0 继续扫描，非 0 停止扫描并作为 lmjcore_audit_scan 的返回值
+ */
+typedef int (*lmjcore_audit_fn)(void *ctx,
+                                const lmjcore_audit_finding *finding);
+
+// 全库审计选项
+typedef struct {
+  unsigned int threads;        // 工作线程数（0 表示 4）
+  unsigned int ranges;         // 指针区间数（0 表示线程数的 8 倍）
+  unsigned int report_mask;    // 回调的问题类型（0 表示全部）
+  lmjcore_audit_fn on_finding; // 审计发现回调（可为 NULL，只统计）
+  void *ctx;                   // 回调上下文
+} lmjcore_audit_scan_opts;
+
+// 全库审计统计
+typedef struct {
+  size_t txn_id;          // 扫描的数据版本
+  size_t dirty_objects;   // 增量审计复查的脏对象数（全库审计为 0）
+  size_t entities;        // 扫描的实体数
+  size_t set_entries;     // 扫描的 set 条目数（含登记占位）
+  size_t main_entries;    // 扫描的 main 条目数
+  size_t ghost_members;   // 幽灵成员数
+  size_t missing_values;  // 缺失值成员数
+  size_t empty_objects;   // 空对象数
+  size_t type_mismatches; // 类型异常数
+  uint64_t elapsed_ms;    // 耗时（毫秒）
+  double entries_per_sec; // 吞吐量（两个库的条目数 / 秒）
+} lmjcore_audit_scan_stats;
+
+/**
+ * @brief 并行审计整个数据库
+ *
+ * 在共享读快照上把指针空间切成若干区间，多个线程按区间以归并方式同时
+ * 顺序遍历 main 与 set 两个库，不再逐个成员探查；发现的问题实时交给回调。
+ * 区间边界按每种类型字节下首尾实体之间的键值插值，随机指针与递增指针
+ * 都能大致均分，线程按需领取区间。
+ *
+ * @param env 环境句柄（必须以 LMJCORE_ENV_NOTLS 打开）
+ * @param opts 审计选项（NULL 表示默认值）
+ * @param stats_out 输出参数，审计统计（可为 NULL）
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功，回调中止时返回其返回值）
+ * @note 调用线程不能持有该环境的写事务。
+ */
+int lmjcore_audit_scan(lmjcore_env *env, const lmjcore_audit_scan_opts *opts,
+                       lmjcore_audit_scan_stats *stats_out);
+
+// ==================== 增量审计 ====================
+
+/**
+ * @brief 启用或关闭脏对象日志
+ *
+ * 启用后，lmjcore_obj_member_put、lmjcore_obj_member_register、
+ * lmjcore_obj_member_value_del 与 lmjcore_obj_member_del（以及经由它们的
+ * lmjcore_obj_del）在同一写事务内把对象指针记入 journal 库，值为写事务 ID；
+ * 同一事务内连续修改同一对象只记录一次。journal 库存在即视为启用，重新
+ * 打开环境后继续记录。关闭时删除整个 journal 库：删除会关闭库句柄，
+ * 因此先关闭事务闸门、排空本进程内的事务后再删除。
+ *
+ * @param env 环境句柄
+ * @param enabled true 启用，false 关闭
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功，在线压缩进行中返回
+ *         LMJCORE_ERROR_BUSY，关闭时排空超时返回 ETIMEDOUT）
+ * @note 调用线程不能持有该环境的事务；不能与增量审计同时进行。切换期间
+ *       开始的在线压缩会等待切换完成。
+ */
+int lmjcore_journal_set(lmjcore_env *env, bool enabled);
+
+/**
+ * @brief 查询脏对象日志中尚未检查的对象数
+ *
+ * @param env 环境句柄
+ * @param count_out 输出参数，对象数
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ */
+int lmjcore_journal_pending(lmjcore_env *env, size_t *count_out);
+
+/**
+ * @brief 增量审计：只复查上次检查点之后被修改过的对象
+ *
+ * 在一个只读事务中按 journal 库的顺序，对每个脏对象执行与
+ * lmjcore_audit_scan 相同的比对，发现交给回调（在调用线程中执行），
+ * 开销与修改量成正比而与数据量无关。opts 中的 threads 与 ranges 被忽略。
+ * checkpoint 为 true 且审计完成时，删除本次快照及之前记录的脏对象；
+ * 审计期间再次被修改的对象保留到下次。
+ *
+ * @param env 环境句柄
+ * @param opts 审计选项（NULL 表示默认值）
+ * @param checkpoint 审计完成后是否清除已检查的脏对象
+ * @param stats_out 输出参数，审计统计（可为 NULL）
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功，回调中止时返回其返回值）
+ *   - LMJCORE_ERROR_JOURNAL_DISABLED: 未启用脏对象日志
+ * @note 调用线程不能持有该环境的写事务。
+ */
+int lmjcore_audit_incremental(lmjcore_env *env,
+                              const lmjcore_audit_scan_opts *opts,
+                              bool checkpoint,
+                              lmjcore_audit_scan_stats *stats_out);
+
+// ==================== 批量修复 ====================
+
+// 批量修复统计
+typedef struct {
+  size_t entities;       // 扫描的实体数（恢复或攒满重扫时可能重复计入）
+  size_t ghosts_found;   // 发现的幽灵成员数
+  size_t ghosts_deleted; // 删除的幽灵成员数
+  size_t skipped;        // 删除前已被登记或已被删除而跳过的数目
+  size_t chunks;         // 提交的写事务数
+  bool resumed;          // 从进度文件恢复
+  bool done;             // 已扫描到末尾
+  uint64_t elapsed_ms;   // 耗时（毫秒）
+  uint64_t throttle_ms;  // 限速让出的总时间（毫秒）
+} lmjcore_repair_stats;
+
+/**
+ * @brief 批量修复进度回调
+ *
+ * @param ctx 用户上下文
+ * @param stats 截至目前的统计
+ * @return int 0 继续，非 0 停止修复并作为 lmjcore_repair_ghosts 的返回值
+ */
+typedef int (*lmjcore_repair_fn)(void *ctx, const lmjcore_repair_stats *stats);
+
+// 批量修复选项
+typedef struct {
+  size_t chunk_keys;           // 每批最多删除的键数（0 表示 1000）
+  unsigned int chunk_ms;       // 每轮扫描与每个写事务的时长上限（0 表示 50）
+  unsigned int max_duty;       // 写锁占用百分比上限（0 表示 25，100 不限速）
+  const char *checkpoint_path; // 进度文件（NULL 表示不保存进度）
+  lmjcore_repair_fn on_chunk;  // 每批提交并保存进度后调用（可为 NULL）
+  void *ctx;                   // 回调上下文
+} lmjcore_repair_opts;
+
+/**
+ * @brief 分批删除整个数据库中的幽灵成员
+ *
+ * 按指针顺序扫描（与 lmjcore_audit_scan 相同的归并比对），发现的幽灵成员
+ * 攒满 chunk_keys 个或扫描超过 chunk_ms 毫秒后，用独立的短写事务删除，
+ * 删除前在写事务内确认该成员仍未登记。每批提交后把下一轮的起点写入
+ * checkpoint_path，进程崩溃或回调中止后再次调用会从该处继续；全部完成时
+ * 删除进度文件。修复是幂等的，重新扫描已处理的区间不会产生额外操作。
+ * 每个写事务之后按 max_duty 让出写锁，避免阻塞前台写入。
+ *
+ * @param env 环境句柄
+ * @param opts 修复选项（NULL 表示默认值）
+ * @param stats_out 输出参数，修复统计（可为 NULL）
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功，回调中止时返回其返回值）
+ *   - LMJCORE_ERROR_INVALID_PARAM: max_duty 超过 100 或进度文件格式错误
+ * @note 调用线程不能持有该环境的事务。
+ */
+int lmjcore_repair_ghosts(lmjcore_env *env, const lmjcore_repair_opts *opts,
+                          lmjcore_repair_stats *stats_out);
+
+// ==================== 垃圾回收 ====================
+
+// 垃圾回收选项
+typedef struct {
+  const lmjcore_ptr *roots;    // 根实体
+  size_t root_count;           // 根实体数
+  const char *spill_path;      // 标记集文件（NULL 表示使用匿名内存）
+  bool dry_run;                // 只统计不删除
+  size_t chunk_keys;           // 每个写事务最多删除的实体数（0 表示 256）
+  unsigned int chunk_ms;       // 每个写事务的时长上限（0 表示 50）
+  unsigned int max_duty;       // 写锁占用百分比上限（0 表示 25，100 不限速）
+} lmjcore_gc_opts;
+
+// 垃圾回收统计
+typedef struct {
+  size_t txn_id;        // 标记使用的数据版本
+  size_t entities;      // 快照中的实体数
+  size_t roots;         // 存在的根实体数（含隐含的保留实体）
+  size_t reachable;     // 可达实体数（含根）
+  size_t unreachable;   // 不可达实体数
+  size_t relinked;      // 标记后被重新引用而保留的实体数
+  size_t deleted;       // 删除的实体数
+  size_t chunks;        // 提交的写事务数
+  size_t spill_bytes;   // 指针表与标记位占用的字节数
+  uint64_t elapsed_ms;  // 耗时（毫秒）
+  uint64_t throttle_ms; // 限速让出的总时间（毫秒）
+} lmjcore_gc_stats;
+
+/**
+ * @brief 标记-清除回收从根不可达的实体
+ *
+ * 实体之间只通过指针值关联：长度为 LMJCORE_PTR_LEN 且首字节为实体类型的
+ * 对象成员值或集合元素视为引用。标记阶段在一个读快照中把全部实体指针按
+ * 键序写入映射（spill_path 不为 NULL 时映射到该文件，由内核按需换出），
+ * 每个实体附一个标记位，从根出发逐层扫描引用；清除阶段按 chunk_keys、
+ * chunk_ms 分批用 lmjcore_obj_del / lmjcore_set_del 删除未标记的实体，
+ * 每批之后按 max_duty 让出写锁。快照之后创建的实体不参与回收。
+ *
+ * 快照中不可达的实体仍可能在清除前被重新引用：持有其指针的写入者（例如
+ * 从另一个待回收的实体中读出指针）把它写进可达对象或集合。标记开始前起
+ * 记录本进程内写入的指针值，清除每一批之前在写事务内从这些值出发重新
+ * 标记，被重新引用的实体及其引用的实体都不会删除（计入 relinked）。
+ *
+ * 除 roots 外，第 1~8 字节全为 0 的指针（保留空间，包括配置对象
+ * LMJCORE_CONFIG_OBJECT_PTR 及其中顺序指针生成器的计数器）总是视为根，
+ * 不会被回收。
+ *
+ * @param env 环境句柄
+ * @param opts 回收选项（必须至少有一个根）
+ * @param stats_out 输出参数，回收统计（可为 NULL）
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ *   - LMJCORE_ERROR_INVALID_PARAM: 没有根、max_duty 超过 100 或已有回收
+ *     在运行
+ *   - LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED: 记录写入时内存不足，无法
+ *     确认被重新引用的实体，停止清除
+ * @note 只记录本进程内的写入：其他进程在回收期间写入的引用不会被发现，
+ *       这类进程中新实体必须与指向它的引用在同一写事务中写入，或本身是
+ *       根，且不能重新引用已不可达的实体。
+ *       调用线程不能持有该环境的事务。
+ */
+int lmjcore_gc(lmjcore_env *env, const lmjcore_gc_opts *opts,
+               lmjcore_gc_stats *stats_out);
+
+// ==================== 实体统计 ====================
+
+/**
+ * @brief 启用或关闭实体统计
+ *
+ * 启用后每个实体在 stats 库中有一条统计记录（成员或元素的数量与总字节数、
+ * 成员值的数量与总字节数），由写操作在同一写事务内更新，
+ * lmjcore_obj_stat_values、lmjcore_obj_stat_members、lmjcore_set_stat 与
+ * lmjcore_set_count 随之变为一次查找。启用时在一个写事务内按现有数据生成
+ * 全部记录；stats 库存在即视为启用，重新打开环境后继续维护。关闭时与
+ * lmjcore_journal_set 相同，排空本进程内的事务后删除整个 stats 库。
+ *
+ * 记录只反映经由 API 的写入：未登记实体下的成员值不计入，绕过 API 的
+ * 写入需要关闭后重新启用以重建记录。
+ *
+ * @param env 环境句柄
+ * @param enabled true 启用，false 关闭
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功，在线压缩进行中返回
+ *         LMJCORE_ERROR_BUSY，关闭时排空超时返回 ETIMEDOUT）
+ * @note 调用线程不能持有该环境的事务。切换期间开始的在线压缩会等待
+ *       切换完成。
+ */
+int lmjcore_entity_stats_set(lmjcore_env *env, bool enabled);
+
+// ==================== 形态分析 ====================
+
+// 直方图桶数：桶 0 为 0，桶 i 为 [2^(i-1), 2^i)，最后一个桶含更大的值
+#define LMJCORE_SHAPE_BUCKETS 32
+// 报告中的高频成员名个数
+#define LMJCORE_SHAPE_TOP_NAMES 32
+
+// 按 2 的幂分桶的直方图
+typedef struct {
+  size_t count; // 样本数
+  uint64_t sum; // 样本之和
+  uint64_t min; // 最小值（count 为 0 时为 0）
+  uint64_t max; // 最大值
+  size_t buckets[LMJCORE_SHAPE_BUCKETS];
+} lmjcore_shape_hist;
+
+// 一个高频成员名（count 为上界，count - error 为下界）
+typedef struct {
+  uint8_t name[LMJCORE_MAX_MEMBER_NAME_LEN];
+  size_t name_len;
+  size_t count; // 估计出现次数（不低于真实次数）
+  size_t error; // 估计误差上限
+} lmjcore_shape_name;
+
+// 形态分析选项
+typedef struct {
+  unsigned int threads;     // 工作线程数（0 表示 4）
+  unsigned int ranges;      // 指针区间数（0 表示线程数的 8 倍）
+  unsigned int sketch_size; // 每个线程跟踪的成员名个数（0 表示 1024）
+} lmjcore_shape_opts;
+
+// 形态分析报告
+typedef struct {
+  size_t txn_id;                      // 分析的数据版本
+  size_t objects;                     // 对象数
+  size_t sets;                        // 集合数
+  lmjcore_shape_hist obj_members;     // 每个对象的成员数
+  lmjcore_shape_hist member_name_len; // 成员名长度（字节）
+  lmjcore_shape_hist value_size;      // 成员值长度（字节）
+  lmjcore_shape_hist set_cardinality; // 每个集合的元素数
+  lmjcore_shape_hist element_size;    // 集合元素长度（字节）
+  size_t inline_limit;    // 键长加值长超过该值时，值放入溢出页
+  size_t overflow_values; // 存放在溢出页的成员值数
+  size_t top_count;       // top 中的有效个数
+  lmjcore_shape_name top[LMJCORE_SHAPE_TOP_NAMES]; // 按 count 降序
+  uint64_t elapsed_ms;                             // 耗时（毫秒）
+} lmjcore_shape_report;
+
+/**
+ * @brief 并行分析整个数据库的数据形态
+ *
+ * 与 lmjcore_audit_scan 相同，在共享读快照上按指针区间由多个线程同时遍历
+ * set 与 main 两个库，统计对象成员数、成员名长度、成员值长度、集合基数与
+ * 元素长度的直方图，并用 Space-Saving 草图流式统计出现最多的成员名：
+ * 每个线程只跟踪 sketch_size 个名字，内存与数据量无关，合并后报告
+ * LMJCORE_SHAPE_TOP_NAMES 个。结果用于决定成员名是否值得驻留为短编号、
+ * 值内联阈值与映射大小；可用 result_parser 工具包中的
+ * lmjcore_ser_shape_report 输出为 JSON。
+ *
+ * 报告的 count 不低于真实次数，两者之差不超过 error，error 又不超过总成员
+ * 数除以 sketch_size。
+ *
+ * @param env 环境句柄（必须以 LMJCORE_ENV_NOTLS 打开）
+ * @param opts 分析选项（NULL 表示默认值）
+ * @param report_out 输出参数，返回分析报告
+ * @return int 错误码（LMJCORE_SUCCESS 表示成功）
+ * @note 调用线程不能持有该环境的写事务。
+ */
+int lmjcore_env_shape(lmjcore_env *env, const lmjcore_shape_opts *opts,
+                      lmjcore_shape_report *report_out);
+
 // ==================== 工具 ====================
 
 /**
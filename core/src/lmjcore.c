@@ -1,22 +1,51 @@
 #include "lmjcore.h"
+#include <errno.h>
+#include <fcntl.h>
 #include <lmdb.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
+#include <unistd.h>
 
 #define MAIN_DB_NAME "main"
 #define SET_DB_NAME "set"
+#define JOURNAL_DB_NAME "journal"
+#define STATS_DB_NAME "stats"
+
+// 调整映射时等待本进程事务排空的最长时间（毫秒）
+#define MAP_DRAIN_TIMEOUT_MS 5000
 
 /*
  *==========================================
  * 内部结构
  *==========================================
  */
+// 在线压缩期间被写入的键所属的库
+enum {
+  COMPACT_DB_MAIN = 0,
+  COMPACT_DB_SET,
+  COMPACT_DB_JOURNAL,
+  COMPACT_DB_STATS,
+};
+
+// 在线压缩期间被写入的键
+typedef struct compact_key {
+  struct compact_key *next;
+  uint8_t db; // COMPACT_DB_*
+  size_t len;
+  uint8_t data[];
+} compact_key;
+
 // 环境结构
 struct lmjcore_env {
   MDB_env *mdb_env;
@@ -24,6 +53,82 @@ struct lmjcore_env {
   MDB_dbi set_dbi;
   lmjcore_ptr_generator_fn ptr_generator;
   void *ptr_gen_ctx;
+
+  // 脏对象日志（journal 库存在即启用）
+  MDB_dbi journal_dbi;
+  atomic_bool journal_enabled;
+
+  // 实体统计（stats 库存在即启用）
+  MDB_dbi stats_dbi;
+  atomic_bool stats_enabled;
+
+  // 映射扩容策略（map_grow_factor 为 0 表示未启用）
+  double map_grow_factor;
+  size_t map_max_size;
+  size_t map_size; // 当前映射大小（受 gate_lock 保护）
+
+  // 事务闸门：调整映射前必须等待本进程内所有顶级事务结束
+  pthread_mutex_t gate_lock;
+  pthread_cond_t gate_cond;
+  atomic_size_t active_txns;
+  atomic_bool gate_closed;
+
+  atomic_uint_fast64_t commit_seq;       // 本进程顶级写事务提交计数
+  lmjcore_snapshot_mgr *snapshot_mgrs; // 已注册的读快照管理器（受 gate_lock 保护）
+
+  // 读者表健康监控
+  struct {
+    pthread_mutex_t lock;
+    pthread_cond_t stop_cond;
+    pthread_t thread;
+    bool running;
+    bool stopping;
+    lmjcore_health_opts opts;
+    lmjcore_health_stats last; // 最近一次采样结果
+    size_t oldest_txnid;       // 正在跟踪的最老读者
+    uint64_t oldest_since_ms;  // 首次观察到该读者的时间
+  } health;
+
+  // 启动预热
+  struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond; // 工作线程退出时通知协调线程
+    pthread_t thread;    // 协调线程
+    bool running;        // 协调线程已启动且尚未回收
+    bool done;
+    int result;
+    atomic_bool cancel;
+    lmjcore_warmup_opts opts;
+    char *ranges_path; // opts.ranges_path 的副本
+    atomic_uint phase;
+    atomic_size_t bytes_total;
+    atomic_size_t bytes_done;
+    atomic_size_t keys_total;
+    atomic_size_t keys_done;
+    atomic_size_t slices_walked;
+  } warmup;
+
+  // 在线压缩：复制期间记录被写入的键，供追赶时同步到副本
+  struct {
+    pthread_mutex_t lock;
+    atomic_bool tracking; // 正在记录脏键（写入路径只读取这一个原子量）
+    bool running;
+    bool overflow; // 记录脏键时内存不足，副本无法保证完整
+    compact_key **buckets;
+    size_t bucket_count;
+    size_t count;
+  } compact;
+
+  // 垃圾回收：标记开始后记录写入的指针值，清除前据此重新标记
+  struct {
+    pthread_mutex_t lock;
+    atomic_bool tracking; // 正在记录（写入路径只读取这一个原子量）
+    bool running;
+    bool overflow; // 记录时内存不足，无法确认哪些实体被重新引用
+    uint8_t (*ptrs)[LMJCORE_PTR_LEN];
+    size_t count;
+    size_t cap;
+  } gc;
 };
 
 // 事务结构
@@ -31,6 +136,56 @@ struct lmjcore_txn {
   lmjcore_env *env;
   MDB_txn *mdb_txn;
   bool is_read_only;
+  lmjcore_txn *parent;
+  bool map_full;    // 事务内某次写入触发了 MDB_MAP_FULL
+  bool is_snapshot; // 由读快照管理器持有，不能直接提交或中止
+
+  // 缓存游标：首次使用时打开，事务结束前关闭
+  MDB_cursor *main_cursor;
+  MDB_cursor *set_cursor;
+
+  // 本事务最近记入脏对象日志的对象，连续修改同一对象时不再重复写入
+  uint8_t journal_last[LMJCORE_PTR_LEN];
+  bool journal_cached;
+};
+
+// 读快照槽状态
+enum {
+  SNAPSHOT_IDLE = 0,   // 空闲，读事务可能仍保持打开
+  SNAPSHOT_BUSY,       // 所属线程正在使用
+  SNAPSHOT_RECLAIMING, // 看门狗正在回收
+};
+
+// 每个线程的读快照槽
+typedef struct lmjcore_snapshot_slot {
+  lmjcore_snapshot_mgr *mgr;
+  struct lmjcore_snapshot_slot *next;
+  lmjcore_txn txn;     // 复用的只读事务句柄
+  atomic_int state;    // SNAPSHOT_* 状态
+  bool live;           // 读事务处于活动状态（未被 reset）
+  unsigned int depth;  // 本线程嵌套获取次数
+  uint64_t begin_ms;   // 快照建立（或确认仍为最新）的时间
+  uint64_t commit_seq; // 建立快照时的本进程提交计数
+} lmjcore_snapshot_slot;
+
+// 读快照管理器
+struct lmjcore_snapshot_mgr {
+  lmjcore_env *env;
+  lmjcore_snapshot_opts opts;
+  pthread_key_t key;
+  pthread_mutex_t lock; // 保护 slots 链表及槽的回收
+  lmjcore_snapshot_slot *slots;
+  lmjcore_snapshot_mgr *next;
+
+  // 看门狗线程
+  pthread_t watchdog;
+  pthread_cond_t stop_cond;
+  bool watchdog_running;
+  bool stopping;
+
+  atomic_uint_fast64_t acquires;
+  atomic_uint_fast64_t renewals;
+  atomic_uint_fast64_t reclaims;
 };
 
 typedef struct {
@@ -58,6 +213,8 @@ static const LmjCoreErrorEntry error_entries[] = {
     {LMJCORE_ERROR_READONLY_TXN, "Write operation in read-only transaction"},
     {LMJCORE_ERROR_READONLY_PARENT,
      "Parent transaction is read-only, cannot create sub-transaction"},
+    {LMJCORE_ERROR_NOTLS_REQUIRED,
+     "Environment must be opened with LMJCORE_ENV_NOTLS"},
 
     // Entity Errors
     {LMJCORE_ERROR_ENTITY_NOT_FOUND, "Entity not found"},
@@ -71,9 +228,14 @@ static const LmjCoreErrorEntry error_entries[] = {
 
     // Resource Errors
     {LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED, "Memory allocation failed"},
+    {LMJCORE_ERROR_PTR_EXHAUSTED, "Pointer generator exhausted"},
+    {LMJCORE_ERROR_POOL_FULL, "Environment pool is full"},
+    {LMJCORE_ERROR_CANCELLED, "Operation cancelled"},
+    {LMJCORE_ERROR_BUSY, "Online compaction in progress"},
 
     // Audit Errors
     {LMJCORE_ERROR_GHOST_MEMBER, "Ghost member exists"},
+    {LMJCORE_ERROR_JOURNAL_DISABLED, "Dirty-object journal is not enabled"},
 };
 
 #define ERROR_ENTRY_COUNT (sizeof(error_entries) / sizeof(error_entries[0]))
@@ -108,6 +270,321 @@ static inline bool OBJ_KEY_PREFIX(const lmjcore_ptr obj_ptr, MDB_val key) {
          (memcmp(key.mv_data, obj_ptr, LMJCORE_PTR_LEN) == 0);
 }
 
+static void compact_track(lmjcore_env *env, MDB_dbi dbi, const MDB_val *key);
+static void gc_track(lmjcore_env *env, const MDB_val *value);
+
+/**
+ * @brief 写入 LMDB 并记录映射空间耗尽
+ *
+ * LMDB 在 MDB_MAP_FULL 之后会将事务置为不可用，后续操作只会返回
+ * MDB_BAD_TXN，因此需要在第一次出现时记下，供 lmjcore_txn_exec 判断是否重放。
+ * 在线压缩期间同时记录被写入的键，垃圾回收期间记录写入的指针值。
+ */
+static int txn_put(lmjcore_txn *txn, MDB_dbi dbi, MDB_val *key, MDB_val *data,
+                   unsigned int flags) {
+  if (atomic_load(&txn->env->compact.tracking)) {
+    compact_track(txn->env, dbi, key);
+  }
+  if (atomic_load(&txn->env->gc.tracking)) {
+    gc_track(txn->env, data);
+  }
+  int rc = mdb_put(txn->mdb_txn, dbi, key, data, flags);
+  if (rc == MDB_MAP_FULL) {
+    txn->map_full = true;
+  }
+  return rc;
+}
+
+/**
+ * @brief 删除 LMDB 条目并记录映射空间耗尽（删除同样可能分配新页）
+ */
+static int txn_del(lmjcore_txn *txn, MDB_dbi dbi, MDB_val *key,
+                   MDB_val *data) {
+  if (atomic_load(&txn->env->compact.tracking)) {
+    compact_track(txn->env, dbi, key);
+  }
+  int rc = mdb_del(txn->mdb_txn, dbi, key, data);
+  if (rc == MDB_MAP_FULL) {
+    txn->map_full = true;
+  }
+  return rc;
+}
+
+/**
+ * @brief 获取事务缓存的游标
+ *
+ * 游标在事务内复用，连续访问相邻键时 LMDB 可以直接在当前页内定位。
+ * 调用方不得关闭返回的游标，且在遍历期间不能再调用使用同一游标的函数。
+ * 只缓存 main、set 库的游标，其他库返回 LMJCORE_ERROR_INVALID_PARAM。
+ */
+static int txn_cursor(lmjcore_txn *txn, MDB_dbi dbi, MDB_cursor **cursor) {
+  MDB_cursor **cached;
+  if (dbi == txn->env->main_dbi) {
+    cached = &txn->main_cursor;
+  } else if (dbi == txn->env->set_dbi) {
+    cached = &txn->set_cursor;
+  } else {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  if (!*cached) {
+    int rc = mdb_cursor_open(txn->mdb_txn, dbi, cached);
+    if (rc != MDB_SUCCESS) {
+      *cached = NULL;
+      return rc;
+    }
+  }
+  *cursor = *cached;
+  return MDB_SUCCESS;
+}
+
+// 关闭事务缓存的游标（事务提交或中止前调用）
+static void txn_cursors_close(lmjcore_txn *txn) {
+  if (txn->main_cursor) {
+    mdb_cursor_close(txn->main_cursor);
+    txn->main_cursor = NULL;
+  }
+  if (txn->set_cursor) {
+    mdb_cursor_close(txn->set_cursor);
+    txn->set_cursor = NULL;
+  }
+}
+
+// 只读事务续期后重新绑定缓存的游标
+static int txn_cursors_renew(lmjcore_txn *txn) {
+  int rc = MDB_SUCCESS;
+  if (txn->main_cursor) {
+    rc = mdb_cursor_renew(txn->mdb_txn, txn->main_cursor);
+  }
+  if (rc == MDB_SUCCESS && txn->set_cursor) {
+    rc = mdb_cursor_renew(txn->mdb_txn, txn->set_cursor);
+  }
+  if (rc != MDB_SUCCESS) {
+    txn_cursors_close(txn);
+  }
+  return rc;
+}
+
+/**
+ * @brief 通过缓存游标精确查找一个键（等价于 mdb_get）
+ */
+static int txn_get(lmjcore_txn *txn, MDB_dbi dbi, MDB_val *key,
+                   MDB_val *data) {
+  MDB_cursor *cursor;
+  int rc = txn_cursor(txn, dbi, &cursor);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  return mdb_cursor_get(cursor, key, data, MDB_SET);
+}
+
+/**
+ * @brief 把被修改的对象记入脏对象日志（未启用时直接返回）
+ *
+ * 值为写事务 ID，增量审计据此判断对象是否在检查点之后又被修改过。
+ */
+static int journal_mark(lmjcore_txn *txn, const lmjcore_ptr obj_ptr) {
+  lmjcore_env *env = txn->env;
+  if (!atomic_load(&env->journal_enabled)) {
+    return MDB_SUCCESS;
+  }
+  if (txn->journal_cached &&
+      memcmp(txn->journal_last, obj_ptr, LMJCORE_PTR_LEN) == 0) {
+    return MDB_SUCCESS;
+  }
+  uint64_t seq = mdb_txn_id(txn->mdb_txn);
+  MDB_val key = {.mv_size = LMJCORE_PTR_LEN, .mv_data = (void *)obj_ptr};
+  MDB_val data = {.mv_size = sizeof(seq), .mv_data = &seq};
+  int rc = txn_put(txn, env->journal_dbi, &key, &data, 0);
+  if (rc == MDB_SUCCESS) {
+    memcpy(txn->journal_last, obj_ptr, LMJCORE_PTR_LEN);
+    txn->journal_cached = true;
+  }
+  return rc;
+}
+
+// 实体统计记录（stats 库的值，本机字节序）
+typedef struct {
+  uint64_t members;      // set 库中的条目数（含登记占位）
+  uint64_t member_bytes; // set 库中条目的总字节数
+  uint64_t values;       // main 库中的成员值数（仅对象）
+  uint64_t value_bytes;  // main 库中成员值的总字节数
+} entity_stats;
+
+// 读取实体统计记录（不存在时返回 MDB_NOTFOUND）
+static int stats_get(lmjcore_txn *txn, const uint8_t *ptr, entity_stats *out) {
+  MDB_val key = {.mv_size = LMJCORE_PTR_LEN, .mv_data = (void *)ptr};
+  MDB_val data;
+  int rc = mdb_get(txn->mdb_txn, txn->env->stats_dbi, &key, &data);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  if (data.mv_size != sizeof(*out)) {
+    return MDB_CORRUPTED;
+  }
+  memcpy(out, data.mv_data, sizeof(*out));
+  return MDB_SUCCESS;
+}
+
+/**
+ * @brief 查询实体统计记录，结果写入 rc_out
+ *
+ * 未启用实体统计，或读事务开始于启用之前而看不到 stats 库（LMDB 返回
+ * EINVAL 或 MDB_BAD_DBI）时返回 false，由调用方退回遍历。
+ */
+static bool stats_lookup(lmjcore_txn *txn, const uint8_t *ptr,
+                         entity_stats *out, int *rc_out) {
+  if (!atomic_load(&txn->env->stats_enabled)) {
+    return false;
+  }
+  *rc_out = stats_get(txn, ptr, out);
+  return *rc_out != EINVAL && *rc_out != MDB_BAD_DBI;
+}
+
+// 写入实体统计记录
+static int stats_put(lmjcore_txn *txn, const uint8_t *ptr,
+                     const entity_stats *st) {
+  MDB_val key = {.mv_size = LMJCORE_PTR_LEN, .mv_data = (void *)ptr};
+  MDB_val data = {.mv_size = sizeof(*st), .mv_data = (void *)st};
+  return txn_put(txn, txn->env->stats_dbi, &key, &data, 0);
+}
+
+// 删除实体统计记录（实体整体删除时调用）
+static int stats_drop(lmjcore_txn *txn, const uint8_t *ptr) {
+  if (!atomic_load(&txn->env->stats_enabled)) {
+    return MDB_SUCCESS;
+  }
+  MDB_val key = {.mv_size = LMJCORE_PTR_LEN, .mv_data = (void *)ptr};
+  int rc = txn_del(txn, txn->env->stats_dbi, &key, NULL);
+  return rc == MDB_NOTFOUND ? MDB_SUCCESS : rc;
+}
+
+// 统计 main 库中实体指针下已有的成员值（与 stats_rebuild 计入的范围相同）
+static int stats_scan_values(lmjcore_txn *txn, const uint8_t *ptr,
+                             entity_stats *st) {
+  MDB_cursor *cursor = NULL;
+  int rc = mdb_cursor_open(txn->mdb_txn, txn->env->main_dbi, &cursor);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  MDB_val key = {.mv_size = LMJCORE_PTR_LEN, .mv_data = (void *)ptr};
+  MDB_val data;
+  rc = mdb_cursor_get(cursor, &key, &data, MDB_SET_RANGE);
+  while (rc == MDB_SUCCESS && OBJ_KEY_PREFIX(ptr, key)) {
+    st->values++;
+    st->value_bytes += data.mv_size;
+    rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT);
+  }
+  mdb_cursor_close(cursor);
+  return rc == MDB_NOTFOUND ? MDB_SUCCESS : rc;
+}
+
+/**
+ * @brief 按增量更新实体统计记录
+ *
+ * 记录与 set 库中的键同生同灭：只有新增 set 条目时才创建记录，set 条目
+ * 全部删除后删除记录。没有记录时写入的成员值（未登记实体下的幽灵成员）
+ * 不计入，但创建记录时会先计入 main 库中已有的成员值，使记录始终覆盖
+ * 实体下的全部成员值，之后删除这些值也不会使计数下溢。
+ */
+static int stats_add(lmjcore_txn *txn, const uint8_t *ptr, int64_t members,
+                     int64_t member_bytes, int64_t values,
+                     int64_t value_bytes) {
+  entity_stats st = {0};
+  int rc = stats_get(txn, ptr, &st);
+  if (rc == MDB_NOTFOUND && members <= 0) {
+    return MDB_SUCCESS;
+  }
+  if (rc == MDB_NOTFOUND) {
+    rc = stats_scan_values(txn, ptr, &st);
+  }
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  st.members += members;
+  st.member_bytes += member_bytes;
+  st.values += values;
+  st.value_bytes += value_bytes;
+  if (st.members == 0) {
+    return stats_drop(txn, ptr);
+  }
+  return stats_put(txn, ptr, &st);
+}
+
+/**
+ * @brief 写入 set 库条目，启用实体统计时同步更新记录
+ *
+ * 启用时总是带 MDB_NODUPDATA 写入以得知条目是否新增；条目已存在时按调用方
+ * 的 flags 返回，结果与未启用时一致。
+ */
+static int stats_set_put(lmjcore_txn *txn, MDB_val *key, MDB_val *data,
+                         unsigned int flags) {
+  lmjcore_env *env = txn->env;
+  if (!atomic_load(&env->stats_enabled)) {
+    return txn_put(txn, env->set_dbi, key, data, flags);
+  }
+  int64_t len = (int64_t)data->mv_size;
+  int rc = txn_put(txn, env->set_dbi, key, data, flags | MDB_NODUPDATA);
+  if (rc == MDB_KEYEXIST) {
+    return (flags & MDB_NODUPDATA) ? rc : MDB_SUCCESS;
+  }
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  return stats_add(txn, key->mv_data, 1, len, 0, 0);
+}
+
+// 删除 set 库中的一个条目，启用实体统计时同步更新记录
+static int stats_set_del(lmjcore_txn *txn, MDB_val *key, MDB_val *data) {
+  int64_t len = (int64_t)data->mv_size;
+  int rc = txn_del(txn, txn->env->set_dbi, key, data);
+  if (rc != MDB_SUCCESS || !atomic_load(&txn->env->stats_enabled)) {
+    return rc;
+  }
+  return stats_add(txn, key->mv_data, -1, -len, 0, 0);
+}
+
+// 写入 main 库中的成员值，启用实体统计时按新旧值大小更新记录
+static int stats_main_put(lmjcore_txn *txn, const uint8_t *obj_ptr,
+                          MDB_val *key, MDB_val *data) {
+  lmjcore_env *env = txn->env;
+  if (!atomic_load(&env->stats_enabled)) {
+    return txn_put(txn, env->main_dbi, key, data, 0);
+  }
+  MDB_val old;
+  int rc = mdb_get(txn->mdb_txn, env->main_dbi, key, &old);
+  if (rc != MDB_SUCCESS && rc != MDB_NOTFOUND) {
+    return rc;
+  }
+  int64_t values = rc == MDB_NOTFOUND ? 1 : 0;
+  int64_t delta = (int64_t)data->mv_size -
+                  (rc == MDB_SUCCESS ? (int64_t)old.mv_size : 0);
+  rc = txn_put(txn, env->main_dbi, key, data, 0);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  return stats_add(txn, obj_ptr, 0, 0, values, delta);
+}
+
+// 删除 main 库中的成员值，启用实体统计时同步更新记录
+static int stats_main_del(lmjcore_txn *txn, const uint8_t *obj_ptr,
+                          MDB_val *key) {
+  lmjcore_env *env = txn->env;
+  if (!atomic_load(&env->stats_enabled)) {
+    return txn_del(txn, env->main_dbi, key, NULL);
+  }
+  MDB_val old;
+  int rc = mdb_get(txn->mdb_txn, env->main_dbi, key, &old);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  int64_t len = (int64_t)old.mv_size;
+  rc = txn_del(txn, env->main_dbi, key, NULL);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  return stats_add(txn, obj_ptr, 0, 0, -1, -len);
+}
+
 /**
  * @brief 向对象结果中添加错误
  */
@@ -228,6 +705,7 @@ static int set_get_all_values(lmjcore_txn *txn, const lmjcore_ptr ptr,
   lmjcore_result_set *result = (lmjcore_result_set *)result_buf;
   result->element_count = 0;
   result->error_count = 0;
+  result->sorted = true; // 按 set 库的 dup 顺序遍历
   *result_head = result;
 
   // 计算内存分区边界
@@ -239,7 +717,7 @@ static int set_get_all_values(lmjcore_txn *txn, const lmjcore_ptr ptr,
   MDB_val key = {.mv_size = LMJCORE_PTR_LEN, .mv_data = (void *)ptr};
   MDB_val data;
   MDB_cursor *cursor;
-  int rc = mdb_cursor_open(txn->mdb_txn, txn->env->set_dbi, &cursor);
+  int rc = txn_cursor(txn, txn->env->set_dbi, &cursor);
   if (rc != MDB_SUCCESS) {
     return rc; // lmdb错误
   }
@@ -247,21 +725,18 @@ static int set_get_all_values(lmjcore_txn *txn, const lmjcore_ptr ptr,
   // 定位到集合的第一个元素
   rc = mdb_cursor_get(cursor, &key, &data, MDB_SET);
   if (rc == MDB_NOTFOUND) {
-    mdb_cursor_close(cursor);
     result->element_count = 0;
     result->error_count += 1;
     result_set_add_error(result, LMJCORE_ERROR_ENTITY_NOT_FOUND, 0, 0, ptr);
     return LMJCORE_SUCCESS; // 有意设计：空集合返回成功
   }
   if (rc != MDB_SUCCESS) {
-    mdb_cursor_close(cursor);
     return rc;
   }
 
   while (rc == MDB_SUCCESS) {
     // 检查是否有足够空间存放数据
     if (data.mv_size > data_offset) {
-      mdb_cursor_close(cursor);
       return LMJCORE_ERROR_BUFFER_TOO_SMALL;
     }
 
@@ -269,13 +744,11 @@ static int set_get_all_values(lmjcore_txn *txn, const lmjcore_ptr ptr,
     size_t needed_for_descriptor =
         next_descriptor_offset + sizeof(lmjcore_descriptor);
     if (needed_for_descriptor > data_offset) {
-      mdb_cursor_close(cursor);
       return LMJCORE_ERROR_BUFFER_TOO_SMALL;
     }
 
     // 检查是否有足够空间同时存放数据和描述符
     if (needed_for_descriptor > (data_offset - data.mv_size)) {
-      mdb_cursor_close(cursor);
       return LMJCORE_ERROR_BUFFER_TOO_SMALL;
     }
 
@@ -299,8 +772,6 @@ static int set_get_all_values(lmjcore_txn *txn, const lmjcore_ptr ptr,
     rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT_DUP);
   }
 
-  mdb_cursor_close(cursor);
-
   if (rc != MDB_NOTFOUND) {
     return rc;
   }
@@ -321,11 +792,21 @@ static int set_stat_values(lmjcore_txn *txn, const lmjcore_ptr ptr,
   *total_size_out = 0;
   *count_out = 0;
 
-  // 开启游标启用
+  // 启用实体统计时直接读取维护的记录
+  entity_stats st;
+  int rc;
+  if (stats_lookup(txn, ptr, &st, &rc)) {
+    if (rc != MDB_SUCCESS) {
+      return rc;
+    }
+    *total_size_out = st.member_bytes;
+    *count_out = st.members;
+    return LMJCORE_SUCCESS;
+  }
+
   MDB_cursor *cursor;
-  int rc = mdb_cursor_open(txn->mdb_txn, txn->env->set_dbi, &cursor);
+  rc = txn_cursor(txn, txn->env->set_dbi, &cursor);
   if (rc != MDB_SUCCESS) {
-    mdb_cursor_close(cursor);
     return rc;
   }
 
@@ -334,7 +815,6 @@ static int set_stat_values(lmjcore_txn *txn, const lmjcore_ptr ptr,
   MDB_val value;
   rc = mdb_cursor_get(cursor, &key, &value, MDB_SET);
   if (rc != MDB_SUCCESS) {
-    mdb_cursor_close(cursor);
     return rc;
   }
   while (rc != MDB_NOTFOUND) {
@@ -343,107 +823,388 @@ static int set_stat_values(lmjcore_txn *txn, const lmjcore_ptr ptr,
     rc = mdb_cursor_get(cursor, &key, &value, MDB_NEXT_DUP);
   }
 
-  mdb_cursor_close(cursor);
   return LMJCORE_SUCCESS;
 }
 
 /*
  *==========================================
- * 初始化环境与清理
+ * 事务闸门与映射扩容（内部）
  *==========================================
  */
-// 初始化lmjcore环境
-int lmjcore_init(const char *path, size_t map_size, unsigned int flags,
-                 lmjcore_ptr_generator_fn ptr_gen, void *ptr_gen_ctx,
-                 lmjcore_env **env) {
-  if (!path || !env || !ptr_gen) {
-    return LMJCORE_ERROR_NULL_POINTER;
+// 顶级事务结束后离开闸门
+static void txn_gate_leave(lmjcore_env *env) {
+  if (atomic_fetch_sub(&env->active_txns, 1) == 1 &&
+      atomic_load(&env->gate_closed)) {
+    // 最后一个事务结束，唤醒等待排空的线程
+    pthread_mutex_lock(&env->gate_lock);
+    pthread_cond_broadcast(&env->gate_cond);
+    pthread_mutex_unlock(&env->gate_lock);
   }
+}
 
-  lmjcore_env *new_env = calloc(1, sizeof(lmjcore_env));
-  if (!new_env) {
-    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+/**
+ * @brief 开启顶级事务前进入闸门
+ *
+ * 闸门打开时只有一次原子加和一次原子读；闸门关闭期间退回计数并阻塞等待。
+ */
+static void txn_gate_enter(lmjcore_env *env) {
+  for (;;) {
+    atomic_fetch_add(&env->active_txns, 1);
+    if (!atomic_load(&env->gate_closed)) {
+      return;
+    }
+
+    txn_gate_leave(env);
+    pthread_mutex_lock(&env->gate_lock);
+    while (atomic_load(&env->gate_closed)) {
+      pthread_cond_wait(&env->gate_cond, &env->gate_lock);
+    }
+    pthread_mutex_unlock(&env->gate_lock);
   }
+}
 
-  // 设置指针生成器
-  new_env->ptr_generator = ptr_gen;
-  new_env->ptr_gen_ctx = ptr_gen_ctx;
+// 计算 CLOCK_REALTIME 下的截止时间
+static struct timespec deadline_after_ms(unsigned int timeout_ms) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += timeout_ms / 1000;
+  deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+  if (deadline.tv_nsec >= 1000000000L) {
+    deadline.tv_sec += 1;
+    deadline.tv_nsec -= 1000000000L;
+  }
+  return deadline;
+}
 
-  // 初始化 LMDB 环境
-  int rc = mdb_env_create(&new_env->mdb_env);
-  if (rc != MDB_SUCCESS) {
-    free(new_env);
-    return rc;
-  }
+// 单调时钟毫秒数
+static uint64_t monotonic_ms(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+}
 
-  // 设置映射大小
-  rc = mdb_env_set_mapsize(new_env->mdb_env, map_size);
-  if (rc != MDB_SUCCESS) {
-    mdb_env_close(new_env->mdb_env);
-    free(new_env);
-    return rc;
-  }
+static void snapshots_reset_idle(lmjcore_env *env);
 
-  // 设置数据库数量(main,set)
-  rc = mdb_env_set_maxdbs(new_env->mdb_env, 2);
-  if (rc != MDB_SUCCESS) {
-    mdb_env_close(new_env->mdb_env);
-    free(new_env);
-    return rc;
+/**
+ * @brief 关闭闸门并等待本进程内事务排空
+ *
+ * 调用线程自身不能持有任何事务。超时未排空时重新打开闸门并返回 false，
+ * 避免与长读事务互相等待。排空后空闲的读快照也会被重置。
+ */
+static bool txn_gate_close(lmjcore_env *env, unsigned int timeout_ms) {
+  struct timespec deadline = deadline_after_ms(timeout_ms);
+
+  pthread_mutex_lock(&env->gate_lock);
+  // 其他线程正在调整映射，等待其完成
+  while (atomic_load(&env->gate_closed)) {
+    if (pthread_cond_timedwait(&env->gate_cond, &env->gate_lock, &deadline) ==
+        ETIMEDOUT) {
+      pthread_mutex_unlock(&env->gate_lock);
+      return false;
+    }
   }
-
-  // 打开mdb的环境
-  rc = mdb_env_open(new_env->mdb_env, path, flags, 0664);
-  if (rc != MDB_SUCCESS) {
-    mdb_env_close(new_env->mdb_env);
-    free(new_env);
-    return rc;
+  atomic_store(&env->gate_closed, true);
+  while (atomic_load(&env->active_txns) > 0) {
+    if (pthread_cond_timedwait(&env->gate_cond, &env->gate_lock, &deadline) ==
+            ETIMEDOUT &&
+        atomic_load(&env->active_txns) > 0) {
+      atomic_store(&env->gate_closed, false);
+      pthread_cond_broadcast(&env->gate_cond);
+      pthread_mutex_unlock(&env->gate_lock);
+      return false;
+    }
   }
+  pthread_mutex_unlock(&env->gate_lock);
 
-  // 打开数据库
-  MDB_txn *txn;
-  rc = mdb_txn_begin(new_env->mdb_env, NULL, 0, &txn);
-  if (rc != MDB_SUCCESS) {
-    mdb_env_close(new_env->mdb_env);
-    free(new_env);
-    return rc;
+  snapshots_reset_idle(env);
+  return true;
+}
+
+// 重新打开闸门
+static void txn_gate_open(lmjcore_env *env) {
+  pthread_mutex_lock(&env->gate_lock);
+  atomic_store(&env->gate_closed, false);
+  pthread_cond_broadcast(&env->gate_cond);
+  pthread_mutex_unlock(&env->gate_lock);
+}
+
+// 读取当前映射大小
+static size_t env_map_size(lmjcore_env *env) {
+  pthread_mutex_lock(&env->gate_lock);
+  size_t size = env->map_size;
+  pthread_mutex_unlock(&env->gate_lock);
+  return size;
+}
+
+// 计算下一次扩容后的映射大小（按系统页对齐，不超过上限）
+static size_t map_next_size(size_t map_size, double grow_factor,
+                            size_t max_size) {
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  double target = (double)map_size * grow_factor;
+  size_t next = target >= (double)SIZE_MAX ? SIZE_MAX : (size_t)target;
+  if (next < SIZE_MAX - page) {
+    next = (next + page - 1) / page * page;
   }
-  // 打开main数据库
-  rc = mdb_dbi_open(txn, MAIN_DB_NAME, MDB_CREATE, &new_env->main_dbi);
-  if (rc != MDB_SUCCESS) {
-    mdb_txn_abort(txn);
-    mdb_env_close(new_env->mdb_env);
-    free(new_env);
-    return rc;
+  if (max_size != 0 && next > max_size) {
+    next = max_size;
   }
+  return next;
+}
 
-  // 打开set数据库
-  rc = mdb_dbi_open(txn, SET_DB_NAME, MDB_CREATE | MDB_DUPSORT,
-                    &new_env->set_dbi);
-  if (rc != MDB_SUCCESS) {
-    mdb_txn_abort(txn);
-    mdb_env_close(new_env->mdb_env);
-    free(new_env);
-    return rc;
+/**
+ * @brief 按策略扩大映射
+ *
+ * 扩容策略由 lmjcore_env_set_map_grow 在 gate_lock 下写入，这里同样在锁内
+ * 读取一份快照。
+ *
+ * @param seen_size 调用方观察到空间耗尽时的映射大小；若在等待闸门期间
+ *                  已被其他线程扩容，则不再重复扩容
+ */
+static int map_grow(lmjcore_env *env, size_t seen_size) {
+  pthread_mutex_lock(&env->gate_lock);
+  double grow_factor = env->map_grow_factor;
+  size_t max_size = env->map_max_size;
+  pthread_mutex_unlock(&env->gate_lock);
+  if (grow_factor == 0) {
+    return MDB_MAP_FULL;
+  }
+  if (!txn_gate_close(env, MAP_DRAIN_TIMEOUT_MS)) {
+    return MDB_MAP_FULL;
+  }
+
+  int rc = LMJCORE_SUCCESS;
+  if (env->map_size == seen_size) {
+    size_t next = map_next_size(env->map_size, grow_factor, max_size);
+    if (next <= env->map_size) {
+      rc = MDB_MAP_FULL; // 已达上限
+    } else {
+      rc = mdb_env_set_mapsize(env->mdb_env, next);
+      if (rc == MDB_SUCCESS) {
+        pthread_mutex_lock(&env->gate_lock);
+        env->map_size = next;
+        pthread_mutex_unlock(&env->gate_lock);
+      }
+    }
   }
-  mdb_txn_commit(txn);
-  *env = new_env;
 
-  return LMJCORE_SUCCESS;
+  txn_gate_open(env);
+  return rc;
 }
 
-// 清理函数
-int lmjcore_cleanup(lmjcore_env *env) {
-  if (!env) {
-    return LMJCORE_ERROR_NULL_POINTER;
+/**
+ * @brief 采纳其他进程扩大后的映射（处理 MDB_MAP_RESIZED）
+ */
+static int map_adopt_resized(lmjcore_env *env) {
+  if (!txn_gate_close(env, MAP_DRAIN_TIMEOUT_MS)) {
+    return MDB_MAP_RESIZED;
   }
 
-  mdb_dbi_close(env->mdb_env, env->main_dbi);
-  mdb_dbi_close(env->mdb_env, env->set_dbi);
-  mdb_env_close(env->mdb_env);
-  free(env);
+  // 传入 0 表示沿用数据文件中记录的当前大小
+  int rc = mdb_env_set_mapsize(env->mdb_env, 0);
+  if (rc == MDB_SUCCESS) {
+    MDB_envinfo info;
+    mdb_env_info(env->mdb_env, &info);
+    pthread_mutex_lock(&env->gate_lock);
+    env->map_size = info.me_mapsize;
+    pthread_mutex_unlock(&env->gate_lock);
+  }
 
-  return LMJCORE_SUCCESS;
+  txn_gate_open(env);
+  return rc;
+}
+
+/*
+ *==========================================
+ * 初始化环境与清理
+ *==========================================
+ */
+// 创建并打开 LMDB 环境（设置映射大小与库数量 main、set、journal、stats）
+static int env_open_mdb(const char *path, size_t map_size, unsigned int flags,
+                        MDB_env **mdb_env_out) {
+  MDB_env *mdb_env;
+  int rc = mdb_env_create(&mdb_env);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+
+  rc = mdb_env_set_mapsize(mdb_env, map_size);
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_env_set_maxdbs(mdb_env, 4);
+  }
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_env_open(mdb_env, path, flags, 0664);
+  }
+  if (rc != MDB_SUCCESS) {
+    mdb_env_close(mdb_env);
+    return rc;
+  }
+
+  *mdb_env_out = mdb_env;
+  return MDB_SUCCESS;
+}
+
+// 打开 main 与 set 数据库（只读事务时不创建），journal、stats 库存在时一并
+// 打开
+static int env_open_dbis(lmjcore_env *env, unsigned int txn_flags) {
+  unsigned int create = (txn_flags & MDB_RDONLY) ? 0 : MDB_CREATE;
+  MDB_txn *txn;
+  int rc = mdb_txn_begin(env->mdb_env, NULL, txn_flags, &txn);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+
+  rc = mdb_dbi_open(txn, MAIN_DB_NAME, create, &env->main_dbi);
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_dbi_open(txn, SET_DB_NAME, create | MDB_DUPSORT, &env->set_dbi);
+  }
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_dbi_open(txn, JOURNAL_DB_NAME, 0, &env->journal_dbi);
+    atomic_store(&env->journal_enabled, rc == MDB_SUCCESS);
+    if (rc == MDB_NOTFOUND) {
+      rc = MDB_SUCCESS;
+    }
+  }
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_dbi_open(txn, STATS_DB_NAME, 0, &env->stats_dbi);
+    atomic_store(&env->stats_enabled, rc == MDB_SUCCESS);
+    if (rc == MDB_NOTFOUND) {
+      rc = MDB_SUCCESS;
+    }
+  }
+  if (rc != MDB_SUCCESS) {
+    mdb_txn_abort(txn);
+    return rc;
+  }
+  return mdb_txn_commit(txn);
+}
+
+// 销毁环境中的锁与条件变量（与 lmjcore_init 中的初始化对应）
+static void env_sync_destroy(lmjcore_env *env) {
+  pthread_cond_destroy(&env->health.stop_cond);
+  pthread_mutex_destroy(&env->health.lock);
+  pthread_cond_destroy(&env->warmup.cond);
+  pthread_mutex_destroy(&env->warmup.lock);
+  pthread_mutex_destroy(&env->compact.lock);
+  pthread_mutex_destroy(&env->gc.lock);
+  pthread_cond_destroy(&env->gate_cond);
+  pthread_mutex_destroy(&env->gate_lock);
+}
+
+// 初始化lmjcore环境
+int lmjcore_init(const char *path, size_t map_size, unsigned int flags,
+                 lmjcore_ptr_generator_fn ptr_gen, void *ptr_gen_ctx,
+                 lmjcore_env **env) {
+  if (!path || !env || !ptr_gen) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  lmjcore_env *new_env = calloc(1, sizeof(lmjcore_env));
+  if (!new_env) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+
+  // 设置指针生成器
+  new_env->ptr_generator = ptr_gen;
+  new_env->ptr_gen_ctx = ptr_gen_ctx;
+
+  // 初始化事务闸门与健康监控
+  pthread_mutex_init(&new_env->gate_lock, NULL);
+  pthread_cond_init(&new_env->gate_cond, NULL);
+  pthread_mutex_init(&new_env->health.lock, NULL);
+  pthread_cond_init(&new_env->health.stop_cond, NULL);
+  pthread_mutex_init(&new_env->warmup.lock, NULL);
+  pthread_cond_init(&new_env->warmup.cond, NULL);
+  pthread_mutex_init(&new_env->compact.lock, NULL);
+  pthread_mutex_init(&new_env->gc.lock, NULL);
+
+  // 初始化并打开 LMDB 环境
+  int rc = env_open_mdb(path, map_size, flags, &new_env->mdb_env);
+  if (rc != MDB_SUCCESS) {
+    env_sync_destroy(new_env);
+    free(new_env);
+    return rc;
+  }
+
+  // 打开数据库：先用只读事务打开已有的库（无需写锁和提交刷盘，重新打开
+  // 已存在的环境更廉价），库不存在时再用写事务创建
+  rc = env_open_dbis(new_env, MDB_RDONLY);
+  if (rc == MDB_NOTFOUND) {
+    rc = env_open_dbis(new_env, 0);
+  }
+  if (rc != MDB_SUCCESS) {
+    mdb_env_close(new_env->mdb_env);
+    env_sync_destroy(new_env);
+    free(new_env);
+    return rc;
+  }
+
+  // 记录实际映射大小（已存在的数据文件可能比 map_size 更大）
+  MDB_envinfo info;
+  mdb_env_info(new_env->mdb_env, &info);
+  new_env->map_size = info.me_mapsize;
+
+  *env = new_env;
+
+  return LMJCORE_SUCCESS;
+}
+
+// 清理函数
+int lmjcore_cleanup(lmjcore_env *env) {
+  if (!env) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  lmjcore_health_monitor_stop(env);
+  lmjcore_warmup_cancel(env);
+
+  mdb_dbi_close(env->mdb_env, env->main_dbi);
+  mdb_dbi_close(env->mdb_env, env->set_dbi);
+  if (atomic_load(&env->journal_enabled)) {
+    mdb_dbi_close(env->mdb_env, env->journal_dbi);
+  }
+  if (atomic_load(&env->stats_enabled)) {
+    mdb_dbi_close(env->mdb_env, env->stats_dbi);
+  }
+  mdb_env_close(env->mdb_env);
+  env_sync_destroy(env);
+  free(env);
+
+  return LMJCORE_SUCCESS;
+}
+
+// 设置映射自动扩容策略
+int lmjcore_env_set_map_grow(lmjcore_env *env, double growth_factor,
+                             size_t max_map_size) {
+  if (!env) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (growth_factor != 0 && growth_factor <= 1.0) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  pthread_mutex_lock(&env->gate_lock);
+  env->map_grow_factor = growth_factor;
+  env->map_max_size = max_map_size;
+  pthread_mutex_unlock(&env->gate_lock);
+
+  return LMJCORE_SUCCESS;
+}
+
+// 按策略扩容一次
+int lmjcore_env_map_grow(lmjcore_env *env) {
+  if (!env) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  return map_grow(env, env_map_size(env));
+}
+
+// 获取当前映射大小
+int lmjcore_env_get_map_size(lmjcore_env *env, size_t *map_size_out) {
+  if (!env || !map_size_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  *map_size_out = env_map_size(env);
+  return LMJCORE_SUCCESS;
 }
 
 /*
@@ -458,25 +1219,48 @@ int lmjcore_txn_begin(lmjcore_env *env, lmjcore_txn *parent, unsigned int flags,
     return LMJCORE_ERROR_NULL_POINTER;
   }
 
+  MDB_txn *t_parent = NULL;
+  if (parent) {
+    if (parent->is_read_only) {
+      return LMJCORE_ERROR_READONLY_PARENT;
+    }
+    t_parent = parent->mdb_txn;
+  }
+
   lmjcore_txn *new_txn = calloc(1, sizeof(lmjcore_txn));
   if (!new_txn) {
     return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
   }
 
   new_txn->env = env;
+  new_txn->parent = parent;
   new_txn->mdb_txn = NULL;
 
-  MDB_txn *t_parent = NULL;
-  if (parent) {
-    if (parent->is_read_only) {
-      return LMJCORE_ERROR_READONLY_PARENT;
-    } else {
-      t_parent = parent->mdb_txn;
-    }
+  // 子事务随父事务计入闸门
+  if (!parent) {
+    txn_gate_enter(env);
   }
 
   int rc = mdb_txn_begin(env->mdb_env, t_parent, flags, &new_txn->mdb_txn);
-  if (rc != MDB_SUCCESS) {
+  if (rc == MDB_MAP_RESIZED && !parent) {
+    // 其他进程扩大了映射，采纳新大小后重试
+    txn_gate_leave(env);
+    rc = map_adopt_resized(env);
+    if (rc == MDB_SUCCESS) {
+      txn_gate_enter(env);
+      rc = mdb_txn_begin(env->mdb_env, NULL, flags, &new_txn->mdb_txn);
+      if (rc != MDB_SUCCESS) {
+        txn_gate_leave(env);
+      }
+    }
+    if (rc != MDB_SUCCESS) {
+      free(new_txn);
+      return rc;
+    }
+  } else if (rc != MDB_SUCCESS) {
+    if (!parent) {
+      txn_gate_leave(env);
+    }
     free(new_txn);
     return rc;
   }
@@ -493,9 +1277,24 @@ int lmjcore_txn_commit(lmjcore_txn *txn) {
     return LMJCORE_ERROR_NULL_POINTER;
   }
 
+  if (txn->is_snapshot) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  lmjcore_env *env = txn->env;
+  bool is_top = txn->parent == NULL;
+  bool is_write = !txn->is_read_only;
+  txn_cursors_close(txn);
   int rc = mdb_txn_commit(txn->mdb_txn);
   free(txn);
 
+  if (is_top) {
+    if (rc == MDB_SUCCESS && is_write) {
+      atomic_fetch_add(&env->commit_seq, 1);
+    }
+    txn_gate_leave(env);
+  }
+
   if (rc != MDB_SUCCESS) {
     return rc;
   }
@@ -509,918 +1308,5620 @@ int lmjcore_txn_abort(lmjcore_txn *txn) {
     return LMJCORE_ERROR_NULL_POINTER;
   }
 
+  if (txn->is_snapshot) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  lmjcore_env *env = txn->env;
+  bool is_top = txn->parent == NULL;
+  txn_cursors_close(txn);
   mdb_txn_abort(txn->mdb_txn);
   free(txn);
 
+  if (is_top) {
+    txn_gate_leave(env);
+  }
+
   return LMJCORE_SUCCESS;
 }
 
+// 在事务中执行操作批次，映射空间不足时扩容并重放
+int lmjcore_txn_exec(lmjcore_env *env, unsigned int flags, lmjcore_txn_fn fn,
+                     void *ctx) {
+  if (!env || !fn) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  for (;;) {
+    size_t seen_size = env_map_size(env);
+
+    lmjcore_txn *txn = NULL;
+    int rc = lmjcore_txn_begin(env, NULL, flags, &txn);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+
+    rc = fn(txn, ctx);
+    bool map_full = txn->map_full || rc == MDB_MAP_FULL;
+    if (rc == LMJCORE_SUCCESS && !map_full) {
+      rc = lmjcore_txn_commit(txn);
+      map_full = rc == MDB_MAP_FULL;
+    } else {
+      lmjcore_txn_abort(txn);
+    }
+
+    if (!map_full) {
+      return rc;
+    }
+
+    // 此时本线程已不持有事务，可以安全调整映射
+    rc = map_grow(env, seen_size);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+  }
+}
+
 /*
  *==========================================
- * 对象相关
- ==========================================
+ * 读快照管理
+ *==========================================
  */
-// 创建对象
-int lmjcore_obj_create(lmjcore_txn *txn, lmjcore_ptr ptr_out) {
-  if (!txn || !ptr_out) {
-    return LMJCORE_ERROR_NULL_POINTER;
+// 闸门关闭并排空后调用：重置所有空闲快照，释放其占用的读槽
+static void snapshots_reset_idle(lmjcore_env *env) {
+  pthread_mutex_lock(&env->gate_lock);
+  for (lmjcore_snapshot_mgr *mgr = env->snapshot_mgrs; mgr; mgr = mgr->next) {
+    pthread_mutex_lock(&mgr->lock);
+    for (lmjcore_snapshot_slot *slot = mgr->slots; slot; slot = slot->next) {
+      if (slot->live) {
+        mdb_txn_reset(slot->txn.mdb_txn);
+        slot->live = false;
+      }
+    }
+    pthread_mutex_unlock(&mgr->lock);
   }
+  pthread_mutex_unlock(&env->gate_lock);
+}
 
-  if (txn->is_read_only) {
-    return LMJCORE_ERROR_READONLY_TXN;
-  }
+// 线程退出时释放其快照槽
+static void snapshot_slot_destroy(void *arg) {
+  lmjcore_snapshot_slot *slot = arg;
+  lmjcore_snapshot_mgr *mgr = slot->mgr;
 
-  // 生成指针
-  int rc = txn->env->ptr_generator(txn->env->ptr_gen_ctx, ptr_out);
-  if (rc != LMJCORE_SUCCESS) {
-    return rc;
+  pthread_mutex_lock(&mgr->lock);
+  for (lmjcore_snapshot_slot **pp = &mgr->slots; *pp; pp = &(*pp)->next) {
+    if (*pp == slot) {
+      *pp = slot->next;
+      break;
+    }
   }
+  pthread_mutex_unlock(&mgr->lock);
 
-  // 确保指针类型为对象
-  ptr_out[0] = LMJCORE_OBJ;
+  if (slot->txn.mdb_txn) {
+    txn_cursors_close(&slot->txn);
+    mdb_txn_abort(slot->txn.mdb_txn);
+  }
+  if (slot->depth > 0) {
+    txn_gate_leave(mgr->env); // 线程退出前未释放快照
+  }
+  free(slot);
+}
 
-  // 在 set 数据库中创建空成员列表（不存储任何值，仅表示对象存在）
-  MDB_val key, data;
-  key.mv_data = ptr_out;
-  key.mv_size = LMJCORE_PTR_LEN;
+// 当前最新已提交的事务 ID（含其他进程的提交）
+static size_t env_last_txnid(lmjcore_env *env) {
+  MDB_envinfo info;
+  mdb_env_info(env->mdb_env, &info);
+  return info.me_last_txnid;
+}
 
-  data.mv_data = NULL;
-  data.mv_size = 0;
+/**
+ * @brief 按过期策略决定复用还是续期快照（调用方已持有槽）
+ */
+static int snapshot_refresh(lmjcore_snapshot_slot *slot) {
+  lmjcore_snapshot_mgr *mgr = slot->mgr;
+  lmjcore_env *env = mgr->env;
+  uint64_t now = monotonic_ms();
+  uint64_t seq = atomic_load(&env->commit_seq);
+
+  if (!slot->txn.mdb_txn) {
+    int rc = mdb_txn_begin(env->mdb_env, NULL, MDB_RDONLY, &slot->txn.mdb_txn);
+    if (rc != MDB_SUCCESS) {
+      slot->txn.mdb_txn = NULL;
+      return rc;
+    }
+  } else {
+    bool renew = !slot->live;
+    if (!renew && mgr->opts.renew_on_commit && seq != slot->commit_seq) {
+      renew = true;
+    }
+    if (!renew && now - slot->begin_ms >= mgr->opts.max_staleness_ms) {
+      // 到期后确认是否确有新提交，没有则继续沿用当前快照
+      if (env_last_txnid(env) != mdb_txn_id(slot->txn.mdb_txn)) {
+        renew = true;
+      } else {
+        slot->begin_ms = now;
+      }
+    }
+    if (!renew) {
+      return LMJCORE_SUCCESS;
+    }
 
-  rc = mdb_put(txn->mdb_txn, txn->env->set_dbi, &key, &data, 0);
-  if (rc != MDB_SUCCESS) {
-    return rc;
+    if (slot->live) {
+      mdb_txn_reset(slot->txn.mdb_txn);
+      slot->live = false;
+    }
+    int rc = mdb_txn_renew(slot->txn.mdb_txn);
+    if (rc == MDB_SUCCESS) {
+      rc = txn_cursors_renew(&slot->txn);
+    }
+    if (rc != MDB_SUCCESS) {
+      return rc;
+    }
   }
+
+  slot->live = true;
+  slot->begin_ms = now;
+  slot->commit_seq = seq;
+  atomic_fetch_add(&mgr->renewals, 1);
   return LMJCORE_SUCCESS;
 }
 
-// 注册对象
-int lmjcore_obj_register(lmjcore_txn *txn, const lmjcore_ptr ptr) {
-  if (!txn || !ptr) {
+// 看门狗：回收长时间空闲且已落后的快照，避免旧页被持续钉住
+static void *snapshot_watchdog(void *arg) {
+  lmjcore_snapshot_mgr *mgr = arg;
+
+  pthread_mutex_lock(&mgr->lock);
+  while (!mgr->stopping) {
+    struct timespec deadline =
+        deadline_after_ms(mgr->opts.watchdog_interval_ms);
+    pthread_cond_timedwait(&mgr->stop_cond, &mgr->lock, &deadline);
+    if (mgr->stopping) {
+      break;
+    }
+
+    uint64_t now = monotonic_ms();
+    size_t last_txnid = env_last_txnid(mgr->env);
+    for (lmjcore_snapshot_slot *slot = mgr->slots; slot; slot = slot->next) {
+      int expected = SNAPSHOT_IDLE;
+      if (!atomic_compare_exchange_strong(&slot->state, &expected,
+                                          SNAPSHOT_RECLAIMING)) {
+        continue; // 正在使用，下一轮再检查
+      }
+      if (slot->live && now - slot->begin_ms >= mgr->opts.max_pin_ms &&
+          mdb_txn_id(slot->txn.mdb_txn) != last_txnid) {
+        mdb_txn_reset(slot->txn.mdb_txn);
+        slot->live = false;
+        atomic_fetch_add(&mgr->reclaims, 1);
+      }
+      atomic_store(&slot->state, SNAPSHOT_IDLE);
+    }
+  }
+  pthread_mutex_unlock(&mgr->lock);
+
+  return NULL;
+}
+
+// 创建读快照管理器
+int lmjcore_snapshot_mgr_create(lmjcore_env *env,
+                                const lmjcore_snapshot_opts *opts,
+                                lmjcore_snapshot_mgr **mgr_out) {
+  if (!env || !mgr_out) {
     return LMJCORE_ERROR_NULL_POINTER;
   }
-  if (txn->is_read_only) {
-    return LMJCORE_ERROR_READONLY_TXN;
+
+  unsigned int env_flags = 0;
+  mdb_env_get_flags(env->mdb_env, &env_flags);
+  if (!(env_flags & MDB_NOTLS)) {
+    return LMJCORE_ERROR_NOTLS_REQUIRED;
   }
-  if (ptr[0] != LMJCORE_OBJ) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+
+  lmjcore_snapshot_mgr *mgr = calloc(1, sizeof(lmjcore_snapshot_mgr));
+  if (!mgr) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
   }
-  if (lmjcore_entity_exist(txn, ptr) == 1) {
-    return LMJCORE_ERROR_ENTITY_EXISTS;
+
+  mgr->env = env;
+  if (opts) {
+    mgr->opts = *opts;
+  } else {
+    mgr->opts.max_staleness_ms = 5;
+    mgr->opts.max_pin_ms = 1000;
+  }
+  if (mgr->opts.max_pin_ms > 0 && mgr->opts.watchdog_interval_ms == 0) {
+    mgr->opts.watchdog_interval_ms = mgr->opts.max_pin_ms / 2 + 1;
   }
-  // 在 set 数据库中创建空成员列表（不存储任何值，仅表示对象存在）
-  MDB_val key, data;
-  key.mv_data = (void *)ptr;
-  key.mv_size = LMJCORE_PTR_LEN;
 
-  data.mv_data = NULL;
-  data.mv_size = 0;
+  if (pthread_key_create(&mgr->key, snapshot_slot_destroy) != 0) {
+    free(mgr);
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  pthread_mutex_init(&mgr->lock, NULL);
+  pthread_cond_init(&mgr->stop_cond, NULL);
 
-  int rc = mdb_put(txn->mdb_txn, txn->env->set_dbi, &key, &data, 0);
-  if (rc != MDB_SUCCESS) {
-    return rc;
+  if (mgr->opts.max_pin_ms > 0) {
+    if (pthread_create(&mgr->watchdog, NULL, snapshot_watchdog, mgr) != 0) {
+      pthread_cond_destroy(&mgr->stop_cond);
+      pthread_mutex_destroy(&mgr->lock);
+      pthread_key_delete(mgr->key);
+      free(mgr);
+      return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    mgr->watchdog_running = true;
   }
+
+  pthread_mutex_lock(&env->gate_lock);
+  mgr->next = env->snapshot_mgrs;
+  env->snapshot_mgrs = mgr;
+  pthread_mutex_unlock(&env->gate_lock);
+
+  *mgr_out = mgr;
   return LMJCORE_SUCCESS;
 }
 
-// 读取对象
-int lmjcore_obj_get(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
-                    uint8_t *result_buf, size_t result_buf_size,
-                    lmjcore_result_obj **result_head) {
-  if (!txn || !obj_ptr || !result_buf || !result_head) {
+// 销毁读快照管理器
+int lmjcore_snapshot_mgr_destroy(lmjcore_snapshot_mgr *mgr) {
+  if (!mgr) {
     return LMJCORE_ERROR_NULL_POINTER;
   }
-  if (obj_ptr[0] != LMJCORE_OBJ) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
-  }
-
-  // 初始化返回空间
-  memset(result_buf, 0, result_buf_size);
-
-  // 设置返回头在缓冲区起始位置
-  lmjcore_result_obj *result = (lmjcore_result_obj *)result_buf;
-  result->error_count = 0;
-  result->member_count = 0;
-
-  // 计算关键边界指针
-  uint8_t *descriptors_start = result_buf + sizeof(lmjcore_result_obj);
 
-  *result_head = result;
+  lmjcore_env *env = mgr->env;
 
-  // 最小缓冲区检查
-  if (result_buf_size <
-      sizeof(lmjcore_result_obj) + sizeof(lmjcore_member_descriptor)) {
-    return LMJCORE_ERROR_BUFFER_TOO_SMALL;
+  if (mgr->watchdog_running) {
+    pthread_mutex_lock(&mgr->lock);
+    mgr->stopping = true;
+    pthread_cond_signal(&mgr->stop_cond);
+    pthread_mutex_unlock(&mgr->lock);
+    pthread_join(mgr->watchdog, NULL);
   }
 
-  // 对象存在性检查
-  int rc = lmjcore_entity_exist(txn, obj_ptr);
-  if (rc < 0) {
-    return rc; // lmdb 错误
-  }
-  if (rc == 0) {
-    // 实体不存在
-    result_obj_add_error(result, LMJCORE_ERROR_ENTITY_NOT_FOUND, 0, 0, obj_ptr);
-    return LMJCORE_SUCCESS;
+  pthread_mutex_lock(&env->gate_lock);
+  for (lmjcore_snapshot_mgr **pp = &env->snapshot_mgrs; *pp;
+       pp = &(*pp)->next) {
+    if (*pp == mgr) {
+      *pp = mgr->next;
+      break;
+    }
   }
+  pthread_mutex_unlock(&env->gate_lock);
 
-  // 内存布局定义：
-  // +------------------------+ ← result_buf (result)
-  // | lmjcore_result_obj     | 固定头部
-  // +------------------------+
-  // | member_descriptors[]   | 描述符从前向后增长
-  // +------------------------+
-  // | ...                    |
-  // +------------------------+
-  // | name & value data      | 数据从后向前增长
-  // +------------------------+ ← result_buf + result_buf_size
+  // 删除键后线程退出时不再调用析构函数，由这里统一回收
+  pthread_key_delete(mgr->key);
+  lmjcore_snapshot_slot *slot = mgr->slots;
+  while (slot) {
+    lmjcore_snapshot_slot *next = slot->next;
+    if (slot->txn.mdb_txn) {
+      txn_cursors_close(&slot->txn);
+      mdb_txn_abort(slot->txn.mdb_txn);
+    }
+    if (slot->depth > 0) {
+      txn_gate_leave(env);
+    }
+    free(slot);
+    slot = next;
+  }
 
-  uint8_t *data_end = result_buf + result_buf_size;
+  pthread_cond_destroy(&mgr->stop_cond);
+  pthread_mutex_destroy(&mgr->lock);
+  free(mgr);
 
-  lmjcore_member_descriptor *current_descriptor =
-      (lmjcore_member_descriptor *)descriptors_start;
-  uint8_t *current_data = data_end; // 数据从末尾开始
+  return LMJCORE_SUCCESS;
+}
 
-  // 开启游标读取成员列表
-  MDB_cursor *cursor;
-  rc = mdb_cursor_open(txn->mdb_txn, txn->env->set_dbi, &cursor);
-  if (rc != MDB_SUCCESS) {
-    return rc; // lmdb错误直接返回
+// 获取当前线程的读快照
+int lmjcore_snapshot_acquire(lmjcore_snapshot_mgr *mgr, lmjcore_txn **txn) {
+  if (!mgr || !txn) {
+    return LMJCORE_ERROR_NULL_POINTER;
   }
 
-  MDB_val key = {.mv_data = (void *)obj_ptr, .mv_size = LMJCORE_PTR_LEN};
-  MDB_val member_name_val;
-
-  // 定位到该对象的成员列表开始位置
-  rc = mdb_cursor_get(cursor, &key, &member_name_val, MDB_SET);
-  if (rc == MDB_NOTFOUND) {
-    // 空对象 - 没有成员
-    mdb_cursor_close(cursor);
-    *result_head = result;
+  lmjcore_snapshot_slot *slot = pthread_getspecific(mgr->key);
+  if (!slot) {
+    slot = calloc(1, sizeof(lmjcore_snapshot_slot));
+    if (!slot) {
+      return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    slot->mgr = mgr;
+    slot->txn.env = mgr->env;
+    slot->txn.is_read_only = true;
+    slot->txn.is_snapshot = true;
+    atomic_init(&slot->state, SNAPSHOT_IDLE);
+
+    pthread_mutex_lock(&mgr->lock);
+    slot->next = mgr->slots;
+    mgr->slots = slot;
+    pthread_mutex_unlock(&mgr->lock);
+    pthread_setspecific(mgr->key, slot);
+  }
+
+  // 嵌套获取直接复用同一快照
+  if (slot->depth > 0) {
+    slot->depth++;
+    *txn = &slot->txn;
     return LMJCORE_SUCCESS;
   }
-  if (rc != MDB_SUCCESS) {
-    mdb_cursor_close(cursor);
-    return rc; // lmdb错误直接返回
-  }
 
-  // 单次遍历处理所有成员
-  while (rc == MDB_SUCCESS) {
-    size_t member_name_len = member_name_val.mv_size;
+  for (;;) {
+    txn_gate_enter(mgr->env);
 
-    // 检查描述符空间是否足够
-    uint8_t *next_descriptor = (uint8_t *)(current_descriptor + 1);
-    if (next_descriptor >= current_data) {
-      mdb_cursor_close(cursor);
-      return LMJCORE_ERROR_BUFFER_TOO_SMALL; // 缓存太小直接返回(致命错误)
+    // 与看门狗互斥，回收只需一次 reset，自旋等待即可
+    int expected = SNAPSHOT_IDLE;
+    while (!atomic_compare_exchange_weak(&slot->state, &expected,
+                                         SNAPSHOT_BUSY)) {
+      expected = SNAPSHOT_IDLE;
+      sched_yield();
     }
 
-    // 构建完整key查询成员值
-    uint8_t full_key[LMJCORE_MAX_KEY_LEN];
-    memcpy(full_key, obj_ptr, LMJCORE_PTR_LEN);
-    memcpy(full_key + LMJCORE_PTR_LEN, member_name_val.mv_data,
-           member_name_len);
-
-    MDB_val member_key = {.mv_data = full_key,
-                          .mv_size = LMJCORE_PTR_LEN + member_name_len};
-    MDB_val member_value;
-
-    // 查询成员值
-    rc = mdb_get(txn->mdb_txn, txn->env->main_dbi, &member_key, &member_value);
+    int rc = snapshot_refresh(slot);
+    if (rc == LMJCORE_SUCCESS) {
+      break;
+    }
 
+    atomic_store(&slot->state, SNAPSHOT_IDLE);
+    txn_gate_leave(mgr->env);
+    if (rc != MDB_MAP_RESIZED) {
+      return rc;
+    }
+    // 其他进程扩大了映射，采纳后重试
+    rc = map_adopt_resized(mgr->env);
     if (rc != MDB_SUCCESS) {
-      // 成员值缺失处理
-      current_descriptor->member_name.value_len = member_name_len;
-      current_descriptor->member_value.value_len = 0;
-      current_descriptor->member_value.value_offset = 0; // 表示null
-
-      // 尝试存储成员名称（如果空间足够）
-      if (current_data - member_name_len >= next_descriptor) {
-        current_data -= member_name_len;
-        memcpy(current_data, member_name_val.mv_data, member_name_len);
-        current_descriptor->member_name.value_offset =
-            current_data - result_buf;
-      } else {
-        // 名称空间不足
-        current_descriptor->member_name.value_offset = 0;
-        mdb_cursor_close(cursor);
-        return LMJCORE_ERROR_BUFFER_TOO_SMALL; // 致命错误缓存太小
-      }
-
-      result_obj_add_error(result, LMJCORE_ERROR_MEMBER_MISSING,
-                           current_descriptor->member_name.value_offset,
-                           current_descriptor->member_name.value_len, obj_ptr);
-    } else {
-      // 成功获取成员值
-      size_t total_needed = member_name_len + member_value.mv_size;
-
-      // 检查数据空间是否足够
-      if (current_data - total_needed < next_descriptor) {
-        mdb_cursor_close(cursor);
-        return LMJCORE_ERROR_BUFFER_TOO_SMALL; // 致命错误缓存空间不够
-      }
-
-      // 存储名称和值
-      current_data -= member_value.mv_size;
-      memcpy(current_data, member_value.mv_data, member_value.mv_size);
-      current_descriptor->member_value.value_offset = current_data - result_buf;
-      current_descriptor->member_value.value_len = member_value.mv_size;
-
-      current_data -= member_name_len;
-      memcpy(current_data, member_name_val.mv_data, member_name_len);
-      current_descriptor->member_name.value_offset = current_data - result_buf;
-      current_descriptor->member_name.value_len = member_name_len;
+      return rc;
     }
-
-    // 移动到下一个描述符位置
-    current_descriptor++;
-    result->member_count++;
-
-    // 获取下一个成员名称
-    rc = mdb_cursor_get(cursor, &key, &member_name_val, MDB_NEXT_DUP);
   }
 
-  mdb_cursor_close(cursor);
-
-  // 设置返回头
-  *result_head = result;
-
+  slot->depth = 1;
+  atomic_fetch_add(&mgr->acquires, 1);
+  *txn = &slot->txn;
   return LMJCORE_SUCCESS;
 }
 
-// 删除对象
-int lmjcore_obj_del(lmjcore_txn *txn, const lmjcore_ptr obj_ptr) {
-  if (!txn || !obj_ptr) {
-    return LMJCORE_ERROR_INVALID_PARAM;
-  }
-  if (txn->is_read_only) {
-    return LMJCORE_ERROR_READONLY_TXN;
-  }
-  if (obj_ptr[0] != LMJCORE_OBJ) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+// 释放当前线程的读快照
+int lmjcore_snapshot_release(lmjcore_snapshot_mgr *mgr, lmjcore_txn *txn) {
+  if (!mgr || !txn) {
+    return LMJCORE_ERROR_NULL_POINTER;
   }
 
-  MDB_cursor *cursor = NULL;
-  int rc = mdb_cursor_open(txn->mdb_txn, txn->env->set_dbi, &cursor);
-  if (rc != MDB_SUCCESS) {
-    return rc;
+  lmjcore_snapshot_slot *slot = pthread_getspecific(mgr->key);
+  if (!slot || txn != &slot->txn || slot->depth == 0) {
+    return LMJCORE_ERROR_INVALID_PARAM;
   }
 
-  // 构建对象key
-  MDB_val key = {.mv_data = (void *)obj_ptr, .mv_size = LMJCORE_PTR_LEN};
-  MDB_val value;
-
-  rc = mdb_cursor_get(cursor, &key, &value, MDB_NEXT_DUP);
-  if (rc == MDB_NOTFOUND) {
-    // 没有成员，直接删除 set 条目
-    rc = mdb_del(txn->mdb_txn, txn->env->set_dbi, &key, NULL);
-    mdb_cursor_close(cursor);
-    return (rc == MDB_SUCCESS) ? LMJCORE_SUCCESS : rc;
+  if (--slot->depth > 0) {
+    return LMJCORE_SUCCESS;
   }
 
-  if (rc == MDB_SUCCESS) {
-    // 遍历所有成员，删除值
-    while (rc == MDB_SUCCESS) {
-      rc = lmjcore_obj_member_value_del(txn, obj_ptr, value.mv_data,
-                                        value.mv_size);
-      if (rc != LMJCORE_SUCCESS) {
-        break;
-      }
-      rc = mdb_cursor_get(cursor, &key, &value, MDB_NEXT_DUP);
-    }
+  // 读事务保持打开，下次获取时按过期策略决定是否续期
+  atomic_store(&slot->state, SNAPSHOT_IDLE);
+  txn_gate_leave(mgr->env);
+  return LMJCORE_SUCCESS;
+}
+
+// 获取读快照统计
+int lmjcore_snapshot_mgr_stats(lmjcore_snapshot_mgr *mgr,
+                               lmjcore_snapshot_stats *stats_out) {
+  if (!mgr || !stats_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
   }
 
-  // 无论成功还是失败，都清理游标
-  mdb_cursor_close(cursor);
+  memset(stats_out, 0, sizeof(*stats_out));
+  stats_out->acquires = atomic_load(&mgr->acquires);
+  stats_out->renewals = atomic_load(&mgr->renewals);
+  stats_out->reclaims = atomic_load(&mgr->reclaims);
 
-  // 最后删除 set 条目
-  if (rc == MDB_NOTFOUND || rc == MDB_SUCCESS) {
-    MDB_val del_key = {.mv_data = (void *)obj_ptr, .mv_size = LMJCORE_PTR_LEN};
-    rc = mdb_del(txn->mdb_txn, txn->env->set_dbi, &del_key, NULL);
+  pthread_mutex_lock(&mgr->lock);
+  for (lmjcore_snapshot_slot *slot = mgr->slots; slot; slot = slot->next) {
+    stats_out->threads++;
   }
+  pthread_mutex_unlock(&mgr->lock);
 
-  return (rc == MDB_SUCCESS || rc == MDB_NOTFOUND) ? LMJCORE_SUCCESS : rc;
+  return LMJCORE_SUCCESS;
 }
+
 /*
  *==========================================
- * 对象成员相关
+ * 共享读快照
  *==========================================
  */
-// 对象成员写入
-int lmjcore_obj_member_put(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
-                           const uint8_t *member_name, size_t member_name_len,
-                           const uint8_t *value, size_t value_len) {
-  if (!txn || !obj_ptr || !member_name) {
-    return LMJCORE_ERROR_NULL_POINTER;
-  }
-  if (txn->is_read_only) {
-    return LMJCORE_ERROR_READONLY_TXN;
-  }
-  if (obj_ptr[0] != LMJCORE_OBJ) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
-  }
-  // 检查成员名长度
-  if (member_name_len > LMJCORE_MAX_MEMBER_NAME_LEN) {
-    return LMJCORE_ERROR_MEMBER_TOO_LONG;
-  }
+// 乐观开启同版本读事务的尝试次数，失败后改为暂停写入再开启
+#define SHARED_SNAPSHOT_OPTIMISTIC_TRIES 3
 
-  // 在 set 数据库中注册成员名（如果尚未注册）
-  MDB_val set_key = {.mv_size = LMJCORE_PTR_LEN, .mv_data = (void *)obj_ptr};
-  MDB_val set_val = {.mv_size = member_name_len,
-                     .mv_data = (void *)member_name};
+struct lmjcore_shared_snapshot {
+  lmjcore_env *env;
+  size_t worker_count;
+  size_t txn_id;
+  lmjcore_txn workers[]; // 每个工作线程一个只读事务
+};
 
-  // 使用lmdb数据库的原生检查插入
-  int rc = mdb_put(txn->mdb_txn, txn->env->set_dbi, &set_key, &set_val,
-                   MDB_NODUPDATA);
-  // 有重复的值
-  if (rc == MDB_KEYEXIST) {
-    rc = MDB_SUCCESS;
+// 关闭已开启的工作事务
+static void shared_snapshot_close_workers(lmjcore_shared_snapshot *snap,
+                                          size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    txn_cursors_close(&snap->workers[i]);
+    mdb_txn_abort(snap->workers[i].mdb_txn);
+    snap->workers[i].mdb_txn = NULL;
   }
-  if (rc == MDB_SUCCESS) {
-    // 构建主键：对象指针 + 成员名
-    size_t key_size = LMJCORE_PTR_LEN + member_name_len;
-    uint8_t key[key_size];
-
-    memcpy(key, obj_ptr, LMJCORE_PTR_LEN);
-    memcpy(key + LMJCORE_PTR_LEN, member_name, member_name_len);
-
-    // 写入 main 数据库
-    MDB_val mdb_key = {.mv_size = key_size, .mv_data = key};
-    MDB_val mdb_val = {.mv_size = value_len, .mv_data = (void *)value};
-
-    rc = mdb_put(txn->mdb_txn, txn->env->main_dbi, &mdb_key, &mdb_val, 0);
+}
 
+/**
+ * @brief 开启全部工作事务
+ *
+ * @return int 错误码；各事务版本不一致时返回 MDB_BAD_TXN 且不保留任何事务
+ */
+static int shared_snapshot_open_workers(lmjcore_shared_snapshot *snap) {
+  for (size_t i = 0; i < snap->worker_count; i++) {
+    int rc = mdb_txn_begin(snap->env->mdb_env, NULL, MDB_RDONLY,
+                           &snap->workers[i].mdb_txn);
     if (rc != MDB_SUCCESS) {
+      snap->workers[i].mdb_txn = NULL;
+      shared_snapshot_close_workers(snap, i);
       return rc;
     }
+    if (mdb_txn_id(snap->workers[i].mdb_txn) !=
+        mdb_txn_id(snap->workers[0].mdb_txn)) {
+      shared_snapshot_close_workers(snap, i + 1);
+      return MDB_BAD_TXN;
+    }
   }
-
-  return rc;
+  snap->txn_id = mdb_txn_id(snap->workers[0].mdb_txn);
+  return MDB_SUCCESS;
 }
 
-// 注册成员
-int lmjcore_obj_member_register(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
-                                const uint8_t *member_name,
-                                size_t member_name_len) {
-  if (!txn || !obj_ptr || !member_name) {
+// 创建共享读快照
+int lmjcore_shared_snapshot_create(lmjcore_env *env, size_t worker_count,
+                                   lmjcore_shared_snapshot **snap_out) {
+  if (!env || !snap_out) {
     return LMJCORE_ERROR_NULL_POINTER;
   }
-  if (obj_ptr[0] != LMJCORE_OBJ) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  if (worker_count == 0) {
+    return LMJCORE_ERROR_INVALID_PARAM;
   }
-  if (txn->is_read_only) {
-    return LMJCORE_ERROR_READONLY_TXN;
+
+  // 读事务需要跨线程使用，必须脱离线程局部读槽
+  unsigned int env_flags = 0;
+  mdb_env_get_flags(env->mdb_env, &env_flags);
+  if (!(env_flags & MDB_NOTLS)) {
+    return LMJCORE_ERROR_NOTLS_REQUIRED;
   }
-  // 检查成员名长度
-  if (member_name_len > LMJCORE_MAX_MEMBER_NAME_LEN) {
-    return LMJCORE_ERROR_MEMBER_TOO_LONG;
+
+  lmjcore_shared_snapshot *snap =
+      calloc(1, sizeof(lmjcore_shared_snapshot) +
+                    worker_count * sizeof(lmjcore_txn));
+  if (!snap) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  snap->env = env;
+  snap->worker_count = worker_count;
+  for (size_t i = 0; i < worker_count; i++) {
+    snap->workers[i].env = env;
+    snap->workers[i].is_read_only = true;
+    snap->workers[i].is_snapshot = true;
+  }
+
+  // 整个共享快照在闸门中计为一个事务
+  txn_gate_enter(env);
+
+  int rc = MDB_BAD_TXN;
+  for (int i = 0; i < SHARED_SNAPSHOT_OPTIMISTIC_TRIES && rc == MDB_BAD_TXN;
+       i++) {
+    rc = shared_snapshot_open_workers(snap);
+  }
+
+  if (rc == MDB_BAD_TXN && !(env_flags & MDB_RDONLY)) {
+    // 写入频繁时持有写锁阻止提交，保证所有读事务看到同一版本
+    MDB_txn *writer = NULL;
+    rc = mdb_txn_begin(env->mdb_env, NULL, 0, &writer);
+    if (rc == MDB_SUCCESS) {
+      rc = shared_snapshot_open_workers(snap);
+      mdb_txn_abort(writer);
+    }
   }
 
-  MDB_val key = {.mv_data = (void *)obj_ptr, .mv_size = LMJCORE_PTR_LEN};
-  MDB_val value = {.mv_data = (void *)member_name, .mv_size = member_name_len};
-  int rc =
-      mdb_put(txn->mdb_txn, txn->env->set_dbi, &key, &value, MDB_NODUPDATA);
   if (rc != MDB_SUCCESS) {
+    txn_gate_leave(env);
+    free(snap);
     return rc;
   }
+
+  *snap_out = snap;
   return LMJCORE_SUCCESS;
 }
 
-// 删除成员值
-int lmjcore_obj_member_value_del(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
-                                 const uint8_t *member_name,
-                                 size_t member_name_len) {
-  if (!txn || !obj_ptr || !member_name) {
+// 获取共享快照中的工作事务
+int lmjcore_shared_snapshot_txn(lmjcore_shared_snapshot *snap, size_t index,
+                                lmjcore_txn **txn_out) {
+  if (!snap || !txn_out) {
     return LMJCORE_ERROR_NULL_POINTER;
   }
-  if (txn->is_read_only) {
-    return LMJCORE_ERROR_READONLY_TXN;
-  }
-  if (obj_ptr[0] != LMJCORE_OBJ) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
-  }
-  if (member_name_len > LMJCORE_MAX_MEMBER_NAME_LEN) {
-    return LMJCORE_ERROR_MEMBER_TOO_LONG;
+  if (index >= snap->worker_count) {
+    return LMJCORE_ERROR_INVALID_PARAM;
   }
 
-  uint8_t member_key[LMJCORE_PTR_LEN + member_name_len];
-  memcpy(member_key, obj_ptr, LMJCORE_PTR_LEN);
-  memcpy(member_key + LMJCORE_PTR_LEN, member_name, member_name_len);
-  MDB_val key = {.mv_data = member_key,
-                 .mv_size = LMJCORE_PTR_LEN + member_name_len};
-  int rc = mdb_del(txn->mdb_txn, txn->env->main_dbi, &key, NULL);
-  if (rc != MDB_SUCCESS) {
-    return rc;
-  }
+  *txn_out = &snap->workers[index];
   return LMJCORE_SUCCESS;
 }
 
-int lmjcore_obj_member_get(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
-                           const uint8_t *member_name, size_t member_name_len,
-                           uint8_t *value_buf, size_t value_buf_size,
-                           size_t *value_size_out) {
-  if (!txn || !obj_ptr || !member_name || !value_size_out) {
+// 获取共享快照对应的数据版本
+int lmjcore_shared_snapshot_txn_id(lmjcore_shared_snapshot *snap,
+                                   size_t *txn_id_out) {
+  if (!snap || !txn_id_out) {
     return LMJCORE_ERROR_NULL_POINTER;
   }
-  if (obj_ptr[0] != LMJCORE_OBJ) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
-  }
 
-  // 确认对象存在
-  int rc = lmjcore_entity_exist(txn, obj_ptr);
-  if (rc <= 0) {
-    return rc == 0 ? LMJCORE_ERROR_ENTITY_NOT_FOUND : rc;
-  }
+  *txn_id_out = snap->txn_id;
+  return LMJCORE_SUCCESS;
+}
 
-  // 成员名长度检查
-  if (member_name_len > LMJCORE_MAX_MEMBER_NAME_LEN) {
-    return LMJCORE_ERROR_MEMBER_TOO_LONG;
+// 销毁共享读快照
+int lmjcore_shared_snapshot_destroy(lmjcore_shared_snapshot *snap) {
+  if (!snap) {
+    return LMJCORE_ERROR_NULL_POINTER;
   }
 
-  // 初始化
-  *value_size_out = 0;
-
-  // 拼接完整的key
-  uint8_t t_key[LMJCORE_PTR_LEN + member_name_len];
-  memcpy(t_key, obj_ptr, LMJCORE_PTR_LEN);
-  memcpy(t_key + LMJCORE_PTR_LEN, member_name, member_name_len);
+  lmjcore_env *env = snap->env;
+  shared_snapshot_close_workers(snap, snap->worker_count);
+  free(snap);
+  txn_gate_leave(env);
 
-  // 查询成员的值
-  MDB_val key = {.mv_data = t_key,
-                 .mv_size = LMJCORE_PTR_LEN + member_name_len};
-  MDB_val value;
-  rc = mdb_get(txn->mdb_txn, txn->env->main_dbi, &key, &value);
+  return LMJCORE_SUCCESS;
+}
 
-  // 转换 LMDB 错误码为 LMJCore 错误码
-  if (rc == MDB_NOTFOUND) {
-    return LMJCORE_ERROR_MEMBER_NOT_FOUND;
+/*
+ *==========================================
+ * 读者表健康监控
+ *==========================================
+ */
+// 遍历读者表时的统计上下文
+typedef struct {
+  size_t active;
+  size_t oldest_txnid;
+} reader_scan_ctx;
+
+// 解析 mdb_reader_list 的输出行："pid thread txnid"，空闲槽的 txnid 为 "-"
+static int reader_list_line(const char *msg, void *arg) {
+  reader_scan_ctx *ctx = arg;
+  int pid;
+  size_t thread, txnid;
+  if (sscanf(msg, "%d %zx %zu", &pid, &thread, &txnid) == 3) {
+    ctx->active++;
+    if (ctx->oldest_txnid == 0 || txnid < ctx->oldest_txnid) {
+      ctx->oldest_txnid = txnid;
+    }
   }
+  return 0;
+}
 
+// 统计空闲列表（FREE_DBI）中等待复用的页数（自行开启读事务，调用线程
+// 不能持有该环境的事务）
+static int count_free_pages(lmjcore_env *env, size_t *free_pages_out) {
+  *free_pages_out = 0;
+
+  txn_gate_enter(env);
+  MDB_txn *txn = NULL;
+  int rc = mdb_txn_begin(env->mdb_env, NULL, MDB_RDONLY, &txn);
   if (rc != MDB_SUCCESS) {
-    return rc; // 其他错误
+    txn_gate_leave(env);
+    return rc;
   }
 
-  // 检查缓冲区是否足够
-  if (value.mv_size > value_buf_size) {
-    return LMJCORE_ERROR_BUFFER_TOO_SMALL;
+  MDB_cursor *cursor = NULL;
+  rc = mdb_cursor_open(txn, 0, &cursor); // 0 号库为 LMDB 内部空闲列表
+  if (rc == MDB_SUCCESS) {
+    MDB_val key, data;
+    // 每条记录的值是页号数组，首个元素为页数
+    while ((rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT)) ==
+           MDB_SUCCESS) {
+      size_t count = 0;
+      if (data.mv_size >= sizeof(count)) {
+        memcpy(&count, data.mv_data, sizeof(count));
+      }
+      *free_pages_out += count;
+    }
+    if (rc == MDB_NOTFOUND) {
+      rc = MDB_SUCCESS;
+    }
+    mdb_cursor_close(cursor);
   }
 
-  // 将值复制到缓冲区
-  memcpy(value_buf, value.mv_data, value.mv_size);
-  *value_size_out = value.mv_size;
-
-  return LMJCORE_SUCCESS;
+  mdb_txn_abort(txn);
+  txn_gate_leave(env);
+  return rc;
 }
 
-/**
- * @brief 完全删除对象成员（包括注册信息和值）
- * @param txn 写事务句柄
- * @param obj_ptr 目标对象指针
- * @param member_name 成员名称
- * @param member_name_len 成员名称长度
- * @return
- *   - LMJCORE_SUCCESS: 成功
- *   - LMJCORE_ERROR_*: 参数错误
- *   - MDB_*: LMDB 错误
- */
-int lmjcore_obj_member_del(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
-                           const uint8_t *member_name, size_t member_name_len) {
-  // 1. 参数验证
-  if (!txn || !obj_ptr || !member_name) {
-    return LMJCORE_ERROR_NULL_POINTER;
+// 根据阈值计算告警位
+static unsigned int health_alerts(const lmjcore_health_opts *opts,
+                                  const lmjcore_health_stats *stats) {
+  unsigned int alerts = 0;
+  if (stats->stale_readers_cleared > 0) {
+    alerts |= LMJCORE_HEALTH_STALE_READERS;
   }
-  if (txn->is_read_only) {
-    return LMJCORE_ERROR_READONLY_TXN;
+  if (opts->max_reader_age_ms > 0 &&
+      stats->oldest_reader_age_ms >= opts->max_reader_age_ms) {
+    alerts |= LMJCORE_HEALTH_OLD_READER;
   }
-  if (obj_ptr[0] != LMJCORE_OBJ) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  if (opts->max_free_pages > 0 && stats->free_pages >= opts->max_free_pages) {
+    alerts |= LMJCORE_HEALTH_FREE_BACKLOG;
   }
-  if (member_name_len > LMJCORE_MAX_MEMBER_NAME_LEN) {
-    return LMJCORE_ERROR_MEMBER_TOO_LONG;
+  if (opts->max_map_use > 0 && stats->map_size > 0 &&
+      (double)stats->map_used / (double)stats->map_size >= opts->max_map_use) {
+    alerts |= LMJCORE_HEALTH_MAP_USAGE;
   }
+  return alerts;
+}
 
-  // 2. 构建完整的 main 库 key: [对象指针][成员名]
-  uint8_t main_key[LMJCORE_PTR_LEN + member_name_len];
-  memcpy(main_key, obj_ptr, LMJCORE_PTR_LEN);
-  memcpy(main_key + LMJCORE_PTR_LEN, member_name, member_name_len);
-
-  // 3. 在 main 库中删除成员值
-  MDB_val main_key_val = {.mv_data = main_key,
-                          .mv_size = LMJCORE_PTR_LEN + member_name_len};
+/**
+ * @brief 采样一次读者表与映射状态
+ *
+ * 先通过 mdb_reader_check 清理已退出进程遗留的读槽，再统计最老读者、
+ * 空闲页积压与映射使用量。
+ */
+static int health_sample(lmjcore_env *env, lmjcore_health_stats *stats) {
+  memset(stats, 0, sizeof(*stats));
 
-  int rc = mdb_del(txn->mdb_txn, txn->env->main_dbi, &main_key_val, NULL);
-  // 成员值不存在是允许的（缺失值状态），所以忽略 MDB_NOTFOUND
-  if (rc != MDB_SUCCESS && rc != MDB_NOTFOUND) {
-    return rc; // 其他错误才返回
+  int dead = 0;
+  int rc = mdb_reader_check(env->mdb_env, &dead);
+  if (rc != MDB_SUCCESS) {
+    return rc;
   }
+  stats->stale_readers_cleared = dead;
 
-  // 4. 在 set 库中删除成员注册信息
-  MDB_val set_key = {.mv_data = (void *)obj_ptr, .mv_size = LMJCORE_PTR_LEN};
-  MDB_val set_val = {.mv_data = (void *)member_name,
-                     .mv_size = member_name_len};
-
-  rc = mdb_del(txn->mdb_txn, txn->env->set_dbi, &set_key, &set_val);
-  if (rc != MDB_SUCCESS) {
-    return rc; // 注册信息必须存在，所以任何错误都返回
+  // 先遍历读者表，避免把统计空闲页用的读事务计入
+  reader_scan_ctx scan = {0};
+  rc = mdb_reader_list(env->mdb_env, reader_list_line, &scan);
+  if (rc < 0) {
+    return rc;
   }
 
-  return LMJCORE_SUCCESS;
-}
+  MDB_envinfo info;
+  MDB_stat env_stat;
+  mdb_env_info(env->mdb_env, &info);
+  mdb_env_stat(env->mdb_env, &env_stat);
 
-// 统计对象成员名长度
-int lmjcore_obj_stat_members(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
-                             size_t *total_member_len_out,
-                             size_t *member_count_out) {
-  if (obj_ptr[0] != LMJCORE_OBJ) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  stats->readers_used = info.me_numreaders;
+  stats->max_readers = info.me_maxreaders;
+  stats->active_readers = scan.active;
+  stats->last_txnid = info.me_last_txnid;
+  stats->oldest_reader_txnid = scan.oldest_txnid;
+  if (scan.oldest_txnid != 0 && info.me_last_txnid > scan.oldest_txnid) {
+    stats->oldest_reader_lag = info.me_last_txnid - scan.oldest_txnid;
   }
-  return set_stat_values(txn, obj_ptr, total_member_len_out, member_count_out);
-}
+  stats->map_size = info.me_mapsize;
+  stats->map_used = (info.me_last_pgno + 1) * (size_t)env_stat.ms_psize;
 
-// 获取对象成员列表
-int lmjcore_obj_member_list(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
-                            uint8_t *result_buf, size_t result_buf_size,
-                            lmjcore_result_set **result_head) {
-  if (obj_ptr[0] != LMJCORE_OBJ) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  rc = count_free_pages(env, &stats->free_pages);
+  if (rc != MDB_SUCCESS) {
+    return rc;
   }
-  return set_get_all_values(txn, obj_ptr, result_buf, result_buf_size,
-                            result_head);
-}
 
-/*
- *==========================================
- * 集合相关
- *==========================================
- */
-// 创建集合
-int lmjcore_set_create(lmjcore_txn *txn, lmjcore_ptr ptr_out) {
-  if (!txn || !ptr_out) {
-    return LMJCORE_ERROR_NULL_POINTER;
+  // 读者年龄按采样观测：同一最老读者持续存在的时间
+  uint64_t now = monotonic_ms();
+  pthread_mutex_lock(&env->health.lock);
+  if (scan.oldest_txnid != env->health.oldest_txnid) {
+    env->health.oldest_txnid = scan.oldest_txnid;
+    env->health.oldest_since_ms = now;
   }
-  if (txn->is_read_only) {
-    return LMJCORE_ERROR_READONLY_TXN;
+  if (scan.oldest_txnid != 0) {
+    stats->oldest_reader_age_ms = now - env->health.oldest_since_ms;
   }
+  stats->alerts = health_alerts(&env->health.opts, stats);
+  env->health.last = *stats;
+  pthread_mutex_unlock(&env->health.lock);
 
-  // 生成指针
-  int rc = txn->env->ptr_generator(txn->env->ptr_gen_ctx, ptr_out);
-  if (rc != LMJCORE_SUCCESS) {
-    return rc;
-  }
+  return LMJCORE_SUCCESS;
+}
 
-  // 确保指针类型为集合
-  ptr_out[0] = LMJCORE_SET;
+// 健康监控线程
+static void *health_monitor_main(void *arg) {
+  lmjcore_env *env = arg;
 
-  // 在 set 数据库中创建空列表（不存储任何值，仅表示集合存在）
-  MDB_val key, data;
-  key.mv_data = ptr_out;
-  key.mv_size = LMJCORE_PTR_LEN;
+  pthread_mutex_lock(&env->health.lock);
+  while (!env->health.stopping) {
+    lmjcore_health_opts opts = env->health.opts;
+    pthread_mutex_unlock(&env->health.lock);
 
-  data.mv_data = NULL;
-  data.mv_size = 0;
+    lmjcore_health_stats stats;
+    if (health_sample(env, &stats) == LMJCORE_SUCCESS && stats.alerts != 0 &&
+        opts.alert) {
+      opts.alert(env, stats.alerts, &stats, opts.alert_ctx);
+    }
 
-  rc = mdb_put(txn->mdb_txn, txn->env->set_dbi, &key, &data, 0);
-  if (rc != MDB_SUCCESS) {
-    return rc;
+    pthread_mutex_lock(&env->health.lock);
+    if (env->health.stopping) {
+      break;
+    }
+    struct timespec deadline = deadline_after_ms(opts.interval_ms);
+    pthread_cond_timedwait(&env->health.stop_cond, &env->health.lock,
+                           &deadline);
   }
+  pthread_mutex_unlock(&env->health.lock);
 
-  return LMJCORE_SUCCESS;
+  return NULL;
 }
 
-// 向集合添加元素
-int lmjcore_set_add(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
-                    const uint8_t *value, size_t value_len) {
-  if (!txn || !set_ptr || !value) {
+// 立即执行一次健康检查
+int lmjcore_env_health_check(lmjcore_env *env,
+                             lmjcore_health_stats *stats_out) {
+  if (!env || !stats_out) {
     return LMJCORE_ERROR_NULL_POINTER;
   }
-  if (txn->is_read_only) {
-    return LMJCORE_ERROR_READONLY_TXN;
+  return health_sample(env, stats_out);
+}
+
+// 启动健康监控线程
+int lmjcore_health_monitor_start(lmjcore_env *env,
+                                 const lmjcore_health_opts *opts) {
+  if (!env || !opts) {
+    return LMJCORE_ERROR_NULL_POINTER;
   }
-  if (set_ptr[0] != LMJCORE_SET) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  if (opts->interval_ms == 0 || opts->max_map_use < 0 ||
+      opts->max_map_use > 1.0) {
+    return LMJCORE_ERROR_INVALID_PARAM;
   }
 
-  MDB_val key = {.mv_size = LMJCORE_PTR_LEN, .mv_data = (void *)set_ptr};
-  MDB_val mdb_val = {.mv_size = value_len, .mv_data = (void *)value};
-
-  int rc = mdb_put(txn->mdb_txn, txn->env->set_dbi, &key, &mdb_val, 0);
-  if (rc == MDB_KEYEXIST) {
-    return LMJCORE_ERROR_MEMBER_EXISTS;
+  pthread_mutex_lock(&env->health.lock);
+  if (env->health.running) {
+    pthread_mutex_unlock(&env->health.lock);
+    return LMJCORE_ERROR_INVALID_PARAM;
   }
-  if (rc != MDB_SUCCESS) {
-    return rc;
+  env->health.opts = *opts;
+  env->health.stopping = false;
+  if (pthread_create(&env->health.thread, NULL, health_monitor_main, env) !=
+      0) {
+    pthread_mutex_unlock(&env->health.lock);
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
   }
+  env->health.running = true;
+  pthread_mutex_unlock(&env->health.lock);
 
   return LMJCORE_SUCCESS;
 }
 
-// 删除集合
-int lmjcore_set_del(lmjcore_txn *txn, const lmjcore_ptr set_ptr) {
-  if (!txn || !set_ptr) {
+// 停止健康监控线程
+int lmjcore_health_monitor_stop(lmjcore_env *env) {
+  if (!env) {
     return LMJCORE_ERROR_NULL_POINTER;
   }
-  if (txn->is_read_only) {
-    return LMJCORE_ERROR_READONLY_TXN;
-  }
-  if (set_ptr[0] != LMJCORE_SET) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
-  }
 
-  MDB_val key = {.mv_data = (void *)set_ptr, .mv_size = LMJCORE_PTR_LEN};
-  int rc = mdb_del(txn->mdb_txn, txn->env->set_dbi, &key, NULL);
-  if (rc != MDB_SUCCESS) {
-    return rc;
+  pthread_mutex_lock(&env->health.lock);
+  if (!env->health.running) {
+    pthread_mutex_unlock(&env->health.lock);
+    return LMJCORE_SUCCESS;
   }
-  return LMJCORE_SUCCESS;
-}
+  env->health.stopping = true;
+  pthread_cond_signal(&env->health.stop_cond);
+  pthread_mutex_unlock(&env->health.lock);
 
-// 从集合中删除元素
-int lmjcore_set_remove(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
-                       const uint8_t *element, size_t element_len) {
-  if (!txn || !set_ptr || !element) {
-    return LMJCORE_ERROR_NULL_POINTER;
-  }
-  if (txn->is_read_only) {
-    return LMJCORE_ERROR_READONLY_TXN;
-  }
-  if (set_ptr[0] != LMJCORE_SET) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
-  }
+  pthread_join(env->health.thread, NULL);
+
+  pthread_mutex_lock(&env->health.lock);
+  env->health.running = false;
+  pthread_mutex_unlock(&env->health.lock);
 
-  MDB_val key = {.mv_data = (void *)set_ptr, .mv_size = LMJCORE_PTR_LEN};
-  MDB_val value = {.mv_data = (void *)element, .mv_size = element_len};
-  int rc = mdb_del(txn->mdb_txn, txn->env->set_dbi, &key, &value);
-  if (rc != MDB_SUCCESS) {
-    return rc;
-  }
   return LMJCORE_SUCCESS;
 }
 
-// 检查集合中是否存在指定元素
-int lmjcore_set_contains(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
-                         const uint8_t *element, size_t element_len) {
-  if (!txn || !set_ptr || !element) {
+// 获取最近一次采样结果
+int lmjcore_health_monitor_last(lmjcore_env *env,
+                                lmjcore_health_stats *stats_out) {
+  if (!env || !stats_out) {
     return LMJCORE_ERROR_NULL_POINTER;
   }
-  if (set_ptr[0] != LMJCORE_SET) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
-  }
 
-  MDB_val key = {.mv_data = (void *)set_ptr, .mv_size = LMJCORE_PTR_LEN};
-  MDB_val value = {.mv_data = (void *)element, .mv_size = element_len};
+  pthread_mutex_lock(&env->health.lock);
+  *stats_out = env->health.last;
+  pthread_mutex_unlock(&env->health.lock);
 
-  int rc = mdb_get(txn->mdb_txn, txn->env->set_dbi, &key, &value);
-  if (rc == MDB_SUCCESS) {
-    return 1; // 存在
-  }
-  if (rc == MDB_NOTFOUND) {
-    return 0; // 不存在
-  }
-  return rc; // 错误
+  return LMJCORE_SUCCESS;
 }
 
-// 读取集合的所有元素
-int lmjcore_set_get(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
-                    uint8_t *result_buf, size_t result_buf_size,
-                    lmjcore_result_set **result_head) {
-  if (set_ptr[0] != LMJCORE_SET) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+/*
+ *==========================================
+ * 启动预热
+ *==========================================
+ */
+#define WARMUP_DEFAULT_CHUNK (1024 * 1024)
+#define WARMUP_DEFAULT_REPORT_MS 100
+// TREE 阶段每个库中每种实体类型按类型字节之后的 1 字节切成的片数
+// （每片一个短读事务）
+#define WARMUP_TREE_SLICES 64
+// 每个库的工作项上限：两种类型各 WARMUP_TREE_SLICES 片，加上其余前缀
+#define WARMUP_TREE_ITEMS (2 * WARMUP_TREE_SLICES + 2)
+// 工作线程每处理这么多条目检查一次取消并汇总进度
+#define WARMUP_KEY_BATCH 1024
+
+// 一个预热工作项：文件区间，或某个库中前缀落在 [start, end) 的条目
+typedef struct {
+  size_t offset;
+  size_t len;
+  MDB_dbi dbi;
+  uint32_t start;
+  uint32_t end;
+} warmup_item;
+
+// 一个阶段内所有工作线程共享的任务
+typedef struct {
+  lmjcore_env *env;
+  unsigned int phase;
+  int fd;
+  size_t chunk_size;
+  warmup_item *items;
+  size_t item_count;
+  atomic_size_t next; // 下一个待领取的工作项
+  size_t active;      // 仍在运行的工作线程数（受 warmup.lock 保护）
+  int error;          // 第一个错误（受 warmup.lock 保护）
+} warmup_job;
+
+static void warmup_job_fail(warmup_job *job, int rc) {
+  pthread_mutex_lock(&job->env->warmup.lock);
+  if (job->error == LMJCORE_SUCCESS) {
+    job->error = rc;
+  }
+  pthread_mutex_unlock(&job->env->warmup.lock);
+}
+
+// 顺序读取文件区间，数据进入页缓存后丢弃
+static int warmup_read_range(warmup_job *job, const warmup_item *item,
+                             uint8_t *buf) {
+  lmjcore_env *env = job->env;
+  size_t done = 0;
+  while (done < item->len) {
+    if (atomic_load(&env->warmup.cancel)) {
+      return LMJCORE_ERROR_CANCELLED;
+    }
+    size_t want = item->len - done;
+    if (want > job->chunk_size) {
+      want = job->chunk_size;
+    }
+    ssize_t n = pread(job->fd, buf, want, (off_t)(item->offset + done));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return errno;
+    }
+    if (n == 0) {
+      break; // 文件在记录之后变短
+    }
+    done += (size_t)n;
+    atomic_fetch_add(&env->warmup.bytes_done, (size_t)n);
   }
-  return set_get_all_values(txn, set_ptr, result_buf, result_buf_size,
-                            result_head);
+  return LMJCORE_SUCCESS;
 }
 
-// 统计集合元素
-int lmjcore_set_stat(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
-                     size_t *total_value_len_out, size_t *element_count_out) {
-  if (set_ptr[0] != LMJCORE_SET) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+// 在短读事务中遍历一片条目，LMDB 沿路径读取分支页与叶子页
+static int warmup_walk_slice(warmup_job *job, const warmup_item *item) {
+  lmjcore_env *env = job->env;
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
   }
-  return set_stat_values(txn, set_ptr, total_value_len_out, element_count_out);
+  MDB_cursor *cursor = NULL;
+  rc = mdb_cursor_open(txn->mdb_txn, item->dbi, &cursor);
+  if (rc != MDB_SUCCESS) {
+    lmjcore_txn_abort(txn);
+    return rc;
+  }
+
+  uint8_t prefix[2] = {(uint8_t)(item->start >> 8), (uint8_t)item->start};
+  MDB_val key = {.mv_size = sizeof(prefix), .mv_data = prefix};
+  MDB_val data;
+  size_t pending = 0;
+  bool walked = false;
+  rc = mdb_cursor_get(cursor, &key, &data, MDB_SET_RANGE);
+  while (rc == MDB_SUCCESS) {
+    const uint8_t *k = key.mv_data;
+    uint32_t p = (uint32_t)k[0] << 8 | (key.mv_size > 1 ? k[1] : 0);
+    if (p >= item->end) {
+      break;
+    }
+    walked = true;
+    if (++pending == WARMUP_KEY_BATCH) {
+      atomic_fetch_add(&env->warmup.keys_done, pending);
+      pending = 0;
+      if (atomic_load(&env->warmup.cancel)) {
+        rc = LMJCORE_ERROR_CANCELLED;
+        break;
+      }
+    }
+    rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT);
+  }
+  atomic_fetch_add(&env->warmup.keys_done, pending);
+  if (walked) {
+    atomic_fetch_add(&env->warmup.slices_walked, 1);
+  }
+  mdb_cursor_close(cursor);
+  lmjcore_txn_abort(txn);
+  return rc == MDB_NOTFOUND ? LMJCORE_SUCCESS : rc;
+}
+
+// 预热工作线程：领取工作项直到取完、出错或被取消
+static void *warmup_worker(void *arg) {
+  warmup_job *job = arg;
+  lmjcore_env *env = job->env;
+  uint8_t *buf = NULL;
+  int rc = LMJCORE_SUCCESS;
+
+  if (job->phase != LMJCORE_WARMUP_TREE) {
+    buf = malloc(job->chunk_size);
+    if (!buf) {
+      rc = LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+  }
+  while (rc == LMJCORE_SUCCESS) {
+    size_t i = atomic_fetch_add(&job->next, 1);
+    if (i >= job->item_count) {
+      break;
+    }
+    if (atomic_load(&env->warmup.cancel)) {
+      rc = LMJCORE_ERROR_CANCELLED;
+      break;
+    }
+    rc = job->phase == LMJCORE_WARMUP_TREE
+             ? warmup_walk_slice(job, &job->items[i])
+             : warmup_read_range(job, &job->items[i], buf);
+  }
+  free(buf);
+  if (rc != LMJCORE_SUCCESS) {
+    warmup_job_fail(job, rc);
+  }
+
+  pthread_mutex_lock(&env->warmup.lock);
+  job->active--;
+  pthread_cond_broadcast(&env->warmup.cond);
+  pthread_mutex_unlock(&env->warmup.lock);
+  return NULL;
+}
+
+static void warmup_snapshot(lmjcore_env *env, lmjcore_warmup_progress *p) {
+  p->phase = atomic_load(&env->warmup.phase);
+  p->bytes_total = atomic_load(&env->warmup.bytes_total);
+  p->bytes_done = atomic_load(&env->warmup.bytes_done);
+  p->keys_total = atomic_load(&env->warmup.keys_total);
+  p->keys_done = atomic_load(&env->warmup.keys_done);
+  p->slices_walked = atomic_load(&env->warmup.slices_walked);
+  pthread_mutex_lock(&env->warmup.lock);
+  p->done = env->warmup.done;
+  p->result = env->warmup.result;
+  pthread_mutex_unlock(&env->warmup.lock);
+}
+
+static void warmup_report(lmjcore_env *env) {
+  if (env->warmup.opts.progress) {
+    lmjcore_warmup_progress p;
+    warmup_snapshot(env, &p);
+    env->warmup.opts.progress(env, &p, env->warmup.opts.progress_ctx);
+  }
+}
+
+// 追加文件区间，按块大小切分成工作项
+static int warmup_add_range(warmup_item **items, size_t *count, size_t *cap,
+                            size_t offset, size_t len, size_t chunk) {
+  while (len > 0) {
+    if (*count == *cap) {
+      size_t new_cap = *cap ? *cap * 2 : 64;
+      warmup_item *grown = realloc(*items, new_cap * sizeof(warmup_item));
+      if (!grown) {
+        return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+      }
+      *items = grown;
+      *cap = new_cap;
+    }
+    size_t n = len < chunk ? len : chunk;
+    (*items)[(*count)++] = (warmup_item){.offset = offset, .len = n};
+    offset += n;
+    len -= n;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 解析热点区间文件（每行 "偏移 长度"，以 # 开头的行为注释），截断到文件大小
+static int warmup_load_ranges(const char *path, size_t file_size, size_t chunk,
+                              warmup_item **items, size_t *count,
+                              size_t *total) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    // 首次启动尚未记录过区间：视为空区间，继续后续阶段
+    return errno == ENOENT ? LMJCORE_SUCCESS : errno;
+  }
+  size_t cap = 0;
+  char line[128];
+  int rc = LMJCORE_SUCCESS;
+  while (rc == LMJCORE_SUCCESS && fgets(line, sizeof(line), f)) {
+    unsigned long long offset, len;
+    if (line[0] == '#' || sscanf(line, "%llu %llu", &offset, &len) != 2 ||
+        offset >= file_size) {
+      continue;
+    }
+    if (len > file_size - offset) {
+      len = file_size - offset;
+    }
+    rc = warmup_add_range(items, count, &cap, (size_t)offset, (size_t)len,
+                          chunk);
+    *total += (size_t)len;
+  }
+  fclose(f);
+  return rc;
 }
 
 /**
- * @brief 统计对象成员的数据大小
- * @param txn 事务句柄
- * @param obj_ptr 对象指针
- * @param total_value_len_out 返回所有成员值的总字节数
- * @param total_value_count_out 返回所有成员值的数量
- * @return 错误码
+ * @brief 生成一个库的 TREE 工作项
+ *
+ * 键的首字节总是类型字节，按前 2 字节均分会让全部条目落进同一片；
+ * 因此每种实体类型单独按类型字节之后的 1 字节切片，其余前缀（无效的
+ * 类型字节）各合为一片，保证覆盖整个键空间。
  */
-int lmjcore_obj_stat_values(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
-                            size_t *total_value_len_out,
-                            size_t *total_value_count_out) {
-  if (!txn || !obj_ptr || !total_value_len_out || !total_value_count_out)
+static void warmup_tree_items(warmup_job *job, MDB_dbi dbi) {
+  static const uint8_t types[] = {LMJCORE_OBJ, LMJCORE_SET};
+  uint32_t pos = 0;
+  for (size_t t = 0; t < sizeof(types); t++) {
+    uint32_t base = (uint32_t)types[t] << 8;
+    if (pos < base) {
+      job->items[job->item_count++] =
+          (warmup_item){.dbi = dbi, .start = pos, .end = base};
+    }
+    for (uint32_t slice = 0; slice < WARMUP_TREE_SLICES; slice++) {
+      job->items[job->item_count++] = (warmup_item){
+          .dbi = dbi,
+          .start = base + slice * 256 / WARMUP_TREE_SLICES,
+          .end = base + (slice + 1) * 256 / WARMUP_TREE_SLICES};
+    }
+    pos = base + 256;
+  }
+  if (pos < 65536) {
+    job->items[job->item_count++] =
+        (warmup_item){.dbi = dbi, .start = pos, .end = 65536};
+  }
+}
+
+// 执行一个预热阶段：生成工作项，启动工作线程并按间隔汇报进度
+static int warmup_run_phase(lmjcore_env *env, unsigned int phase) {
+  const lmjcore_warmup_opts *opts = &env->warmup.opts;
+  warmup_job job = {
+      .env = env, .phase = phase, .fd = -1, .chunk_size = opts->chunk_size};
+  atomic_init(&job.next, 0);
+  size_t total = 0;
+  int rc = LMJCORE_SUCCESS;
+
+  if (phase == LMJCORE_WARMUP_TREE) {
+    lmjcore_txn *txn = NULL;
+    rc = lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+    MDB_stat main_stat, set_stat;
+    rc = mdb_stat(txn->mdb_txn, env->main_dbi, &main_stat);
+    if (rc == MDB_SUCCESS) {
+      rc = mdb_stat(txn->mdb_txn, env->set_dbi, &set_stat);
+    }
+    lmjcore_txn_abort(txn);
+    if (rc != MDB_SUCCESS) {
+      return rc;
+    }
+    total = main_stat.ms_entries + set_stat.ms_entries;
+
+    job.items = calloc(2 * WARMUP_TREE_ITEMS, sizeof(warmup_item));
+    if (!job.items) {
+      return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    warmup_tree_items(&job, env->main_dbi);
+    warmup_tree_items(&job, env->set_dbi);
+  } else {
+    rc = mdb_env_get_fd(env->mdb_env, &job.fd);
+    if (rc != MDB_SUCCESS) {
+      return rc;
+    }
+    struct stat st;
+    if (fstat(job.fd, &st) != 0) {
+      return errno;
+    }
+    size_t file_size = (size_t)st.st_size;
+    if (phase == LMJCORE_WARMUP_RANGES) {
+      rc = warmup_load_ranges(env->warmup.ranges_path, file_size,
+                              job.chunk_size, &job.items, &job.item_count,
+                              &total);
+    } else {
+      size_t cap = 0;
+      rc = warmup_add_range(&job.items, &job.item_count, &cap, 0, file_size,
+                            job.chunk_size);
+      total = file_size;
+    }
+    if (rc != LMJCORE_SUCCESS) {
+      free(job.items);
+      return rc;
+    }
+  }
+
+  atomic_store(&env->warmup.phase, phase);
+  bool tree = phase == LMJCORE_WARMUP_TREE;
+  atomic_store(&env->warmup.bytes_total, tree ? 0 : total);
+  atomic_store(&env->warmup.bytes_done, 0);
+  atomic_store(&env->warmup.keys_total, tree ? total : 0);
+  atomic_store(&env->warmup.keys_done, 0);
+  atomic_store(&env->warmup.slices_walked, 0);
+
+  unsigned int threads = opts->threads ? opts->threads : 1;
+  pthread_t *tids = calloc(threads, sizeof(pthread_t));
+  if (!tids) {
+    free(job.items);
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  unsigned int started = 0;
+  pthread_mutex_lock(&env->warmup.lock);
+  for (; started < threads; started++) {
+    job.active++;
+    if (pthread_create(&tids[started], NULL, warmup_worker, &job) != 0) {
+      job.active--;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&env->warmup.lock);
+  if (started == 0) {
+    // 无法创建线程时由协调线程自己完成
+    job.active = 1;
+    warmup_worker(&job);
+  }
+
+  pthread_mutex_lock(&env->warmup.lock);
+  while (job.active > 0) {
+    struct timespec deadline = deadline_after_ms(opts->report_ms);
+    pthread_cond_timedwait(&env->warmup.cond, &env->warmup.lock, &deadline);
+    if (job.active > 0) {
+      pthread_mutex_unlock(&env->warmup.lock);
+      warmup_report(env);
+      pthread_mutex_lock(&env->warmup.lock);
+    }
+  }
+  rc = job.error;
+  pthread_mutex_unlock(&env->warmup.lock);
+
+  for (unsigned int i = 0; i < started; i++) {
+    pthread_join(tids[i], NULL);
+  }
+  free(tids);
+  free(job.items);
+  warmup_report(env);
+  return rc;
+}
+
+// 预热协调线程：按 RANGES、TREE、FILE 的顺序执行选中的阶段
+static void *warmup_main(void *arg) {
+  lmjcore_env *env = arg;
+  static const unsigned int phases[] = {
+      LMJCORE_WARMUP_RANGES, LMJCORE_WARMUP_TREE, LMJCORE_WARMUP_FILE};
+
+  int rc = LMJCORE_SUCCESS;
+  for (size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); i++) {
+    if (rc != LMJCORE_SUCCESS) {
+      break;
+    }
+    if (env->warmup.opts.modes & phases[i]) {
+      rc = warmup_run_phase(env, phases[i]);
+    }
+  }
+  if (rc == LMJCORE_SUCCESS && atomic_load(&env->warmup.cancel)) {
+    rc = LMJCORE_ERROR_CANCELLED;
+  }
+
+  atomic_store(&env->warmup.phase, 0);
+  pthread_mutex_lock(&env->warmup.lock);
+  env->warmup.result = rc;
+  env->warmup.done = true;
+  pthread_mutex_unlock(&env->warmup.lock);
+  warmup_report(env);
+  return NULL;
+}
+
+// 回收已结束的协调线程（需持有 warmup.lock，期间会临时释放）
+static void warmup_join_locked(lmjcore_env *env) {
+  pthread_t thread = env->warmup.thread;
+  env->warmup.running = false;
+  pthread_mutex_unlock(&env->warmup.lock);
+  pthread_join(thread, NULL);
+  pthread_mutex_lock(&env->warmup.lock);
+  free(env->warmup.ranges_path);
+  env->warmup.ranges_path = NULL;
+}
+
+// 开始预热
+int lmjcore_warmup_start(lmjcore_env *env, const lmjcore_warmup_opts *opts) {
+  if (!env || !opts) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (opts->modes == 0 ||
+      (opts->modes & ~(unsigned int)(LMJCORE_WARMUP_RANGES |
+                                     LMJCORE_WARMUP_TREE |
+                                     LMJCORE_WARMUP_FILE)) != 0) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  if ((opts->modes & LMJCORE_WARMUP_RANGES) && !opts->ranges_path) {
     return LMJCORE_ERROR_NULL_POINTER;
+  }
 
-  *total_value_len_out = 0;
-  *total_value_count_out = 0;
+  pthread_mutex_lock(&env->warmup.lock);
+  if (env->warmup.running && !env->warmup.done) {
+    pthread_mutex_unlock(&env->warmup.lock);
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  if (env->warmup.running) {
+    warmup_join_locked(env);
+  }
 
-  MDB_cursor *cursor = NULL;
-  int rc = mdb_cursor_open(txn->mdb_txn, txn->env->main_dbi, &cursor);
+  env->warmup.opts = *opts;
+  if (env->warmup.opts.chunk_size == 0) {
+    env->warmup.opts.chunk_size = WARMUP_DEFAULT_CHUNK;
+  }
+  if (env->warmup.opts.report_ms == 0) {
+    env->warmup.opts.report_ms = WARMUP_DEFAULT_REPORT_MS;
+  }
+  if (opts->ranges_path) {
+    env->warmup.ranges_path = strdup(opts->ranges_path);
+    if (!env->warmup.ranges_path) {
+      pthread_mutex_unlock(&env->warmup.lock);
+      return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+  }
+  env->warmup.opts.ranges_path = env->warmup.ranges_path;
+  env->warmup.done = false;
+  env->warmup.result = LMJCORE_SUCCESS;
+  atomic_store(&env->warmup.cancel, false);
+  atomic_store(&env->warmup.phase, 0);
+  atomic_store(&env->warmup.bytes_total, 0);
+  atomic_store(&env->warmup.bytes_done, 0);
+  atomic_store(&env->warmup.keys_total, 0);
+  atomic_store(&env->warmup.keys_done, 0);
+  atomic_store(&env->warmup.slices_walked, 0);
+
+  if (pthread_create(&env->warmup.thread, NULL, warmup_main, env) != 0) {
+    free(env->warmup.ranges_path);
+    env->warmup.ranges_path = NULL;
+    pthread_mutex_unlock(&env->warmup.lock);
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  env->warmup.running = true;
+  pthread_mutex_unlock(&env->warmup.lock);
+
+  return LMJCORE_SUCCESS;
+}
+
+// 读取预热进度
+int lmjcore_warmup_status(lmjcore_env *env,
+                          lmjcore_warmup_progress *progress_out) {
+  if (!env || !progress_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  warmup_snapshot(env, progress_out);
+  return LMJCORE_SUCCESS;
+}
+
+// 等待预热结束
+int lmjcore_warmup_wait(lmjcore_env *env,
+                        lmjcore_warmup_progress *progress_out) {
+  if (!env) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  pthread_mutex_lock(&env->warmup.lock);
+  if (env->warmup.running) {
+    warmup_join_locked(env);
+  }
+  int rc = env->warmup.result;
+  pthread_mutex_unlock(&env->warmup.lock);
+
+  if (progress_out) {
+    warmup_snapshot(env, progress_out);
+  }
+  return rc;
+}
+
+// 取消预热
+int lmjcore_warmup_cancel(lmjcore_env *env) {
+  if (!env) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  atomic_store(&env->warmup.cancel, true);
+  lmjcore_warmup_wait(env, NULL);
+  return LMJCORE_SUCCESS;
+}
+
+/**
+ * @brief 检查数据文件每一页是否驻留在页缓存中
+ *
+ * 独立的只读映射与 LMDB 的映射共享页缓存，mincore 反映同一份驻留状态。
+ *
+ * @param vec_out 输出每个系统页的 mincore 结果（调用方释放，空文件时为 NULL）
+ * @param pages_out 输出系统页数
+ * @param file_size_out 输出数据文件大小
+ */
+static int file_residency(lmjcore_env *env, unsigned char **vec_out,
+                          size_t *pages_out, size_t *file_size_out) {
+  int fd = -1;
+  int rc = mdb_env_get_fd(env->mdb_env, &fd);
   if (rc != MDB_SUCCESS) {
     return rc;
   }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    return errno;
+  }
+  size_t file_size = (size_t)st.st_size;
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  size_t pages = (file_size + page - 1) / page;
 
-  // 构建搜索key - 对象指针
-  MDB_val key = {.mv_data = (void *)obj_ptr, .mv_size = LMJCORE_PTR_LEN};
-  MDB_val value;
+  unsigned char *vec = NULL;
+  if (pages > 0) {
+    void *map = mmap(NULL, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+      return errno;
+    }
+    vec = malloc(pages);
+    if (!vec) {
+      munmap(map, file_size);
+      return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    if (mincore(map, file_size, vec) != 0) {
+      rc = errno;
+      free(vec);
+      munmap(map, file_size);
+      return rc;
+    }
+    munmap(map, file_size);
+  }
 
-  // 使用MDB_SET_RANGE定位到该对象的第一个成员
-  rc = mdb_cursor_get(cursor, &key, &value, MDB_SET_RANGE);
-  if (rc == MDB_NOTFOUND) {
-    // 对象没有成员，这是正常情况
-    rc = LMJCORE_SUCCESS;
-    goto cleanup;
+  *vec_out = vec;
+  *pages_out = pages;
+  *file_size_out = file_size;
+  return LMJCORE_SUCCESS;
+}
+
+// 记录数据文件驻留在页缓存中的区间
+int lmjcore_warmup_record(lmjcore_env *env, const char *ranges_path,
+                          size_t *bytes_out) {
+  if (!env || !ranges_path) {
+    return LMJCORE_ERROR_NULL_POINTER;
   }
-  if (rc != MDB_SUCCESS) {
-    goto cleanup;
+
+  unsigned char *vec = NULL;
+  size_t pages = 0, file_size = 0;
+  int rc = file_residency(env, &vec, &pages, &file_size);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
   }
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
 
-  // 遍历所有属于该对象的成员
-  do {
-    // 检查当前key是否还属于同一个对象
-    if (key.mv_size < LMJCORE_PTR_LEN ||
-        memcmp(key.mv_data, obj_ptr, LMJCORE_PTR_LEN) != 0) {
-      // 已经移动到下一个对象，结束遍历
-      break;
+  char tmp_path[4096];
+  if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", ranges_path) >=
+      (int)sizeof(tmp_path)) {
+    free(vec);
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  FILE *f = fopen(tmp_path, "w");
+  if (!f) {
+    rc = errno;
+    free(vec);
+    return rc;
+  }
+
+  // 连续驻留的页合并为一个区间
+  size_t resident = 0;
+  fprintf(f, "# lmjcore warmup ranges v1: offset length\n");
+  for (size_t i = 0; i < pages;) {
+    if (!(vec[i] & 1)) {
+      i++;
+      continue;
     }
+    size_t j = i;
+    while (j < pages && (vec[j] & 1)) {
+      j++;
+    }
+    size_t offset = i * page;
+    size_t len = (j * page < file_size ? j * page : file_size) - offset;
+    fprintf(f, "%zu %zu\n", offset, len);
+    resident += len;
+    i = j;
+  }
+  free(vec);
 
-    *total_value_count_out += 1;
-    *total_value_len_out += value.mv_size;
+  rc = LMJCORE_SUCCESS;
+  if (fflush(f) != 0 || ferror(f)) {
+    rc = errno ? errno : EIO;
+  }
+  if (fclose(f) != 0 && rc == LMJCORE_SUCCESS) {
+    rc = errno;
+  }
+  if (rc == LMJCORE_SUCCESS && rename(tmp_path, ranges_path) != 0) {
+    rc = errno;
+  }
+  if (rc != LMJCORE_SUCCESS) {
+    remove(tmp_path);
+    return rc;
+  }
 
-    // 移动到下一个key
-    rc = mdb_cursor_get(cursor, &key, &value, MDB_NEXT);
-  } while (rc == MDB_SUCCESS);
+  if (bytes_out) {
+    *bytes_out = resident;
+  }
+  return LMJCORE_SUCCESS;
+}
 
-  // MDB_NOTFOUND表示遍历结束，这是正常情况
-  if (rc == MDB_NOTFOUND) {
-    rc = LMJCORE_SUCCESS;
+/*
+ *==========================================
+ * 在线压缩
+ *==========================================
+ */
+#define COMPACT_DEFAULT_ROUNDS 8
+#define COMPACT_DEFAULT_THRESHOLD 1024
+#define COMPACT_INITIAL_BUCKETS 1024
+#define COMPACT_PATH_MAX 4096
+
+// 压缩副本（独占打开，不使用锁文件）
+typedef struct {
+  MDB_env *mdb_env;
+  MDB_dbi main_dbi;
+  MDB_dbi set_dbi;
+  MDB_dbi journal_dbi;
+  MDB_dbi stats_dbi;
+} compact_copy;
+
+// FNV-1a 哈希（库标记参与计算）
+static size_t compact_hash(uint8_t db, const void *data, size_t len) {
+  const uint8_t *p = data;
+  uint64_t h = 1469598103934665603ULL ^ db;
+  for (size_t i = 0; i < len; i++) {
+    h = (h ^ p[i]) * 1099511628211ULL;
+  }
+  return (size_t)h;
+}
+
+// 脏键数量超过桶数两倍时扩容（失败时沿用原桶，只是链更长）
+static void compact_rehash(lmjcore_env *env) {
+  size_t count = env->compact.bucket_count * 2;
+  compact_key **buckets = calloc(count, sizeof(compact_key *));
+  if (!buckets) {
+    return;
+  }
+  for (size_t i = 0; i < env->compact.bucket_count; i++) {
+    compact_key *e = env->compact.buckets[i];
+    while (e) {
+      compact_key *next = e->next;
+      size_t b = compact_hash(e->db, e->data, e->len) & (count - 1);
+      e->next = buckets[b];
+      buckets[b] = e;
+      e = next;
+    }
   }
+  free(env->compact.buckets);
+  env->compact.buckets = buckets;
+  env->compact.bucket_count = count;
+}
 
-cleanup:
-  if (cursor) {
-    mdb_cursor_close(cursor);
+/**
+ * @brief 记录一个被写入的键（由 txn_put / txn_del 调用）
+ *
+ * 只记录键，不区分写入是否最终提交；追赶时总是从数据文件读取最新值，
+ * 多同步一个未变化的键没有副作用。
+ */
+static void compact_track(lmjcore_env *env, MDB_dbi dbi, const MDB_val *key) {
+  // 关闭后的库句柄可能被重新分配，只与已启用的 stats 库比较
+  bool stats = atomic_load(&env->stats_enabled) && dbi == env->stats_dbi;
+  uint8_t db = dbi == env->set_dbi    ? COMPACT_DB_SET
+               : dbi == env->main_dbi ? COMPACT_DB_MAIN
+               : stats                ? COMPACT_DB_STATS
+                                      : COMPACT_DB_JOURNAL;
+  size_t h = compact_hash(db, key->mv_data, key->mv_size);
+
+  pthread_mutex_lock(&env->compact.lock);
+  if (!atomic_load(&env->compact.tracking)) {
+    pthread_mutex_unlock(&env->compact.lock);
+    return;
+  }
+  compact_key **slot =
+      &env->compact.buckets[h & (env->compact.bucket_count - 1)];
+  for (compact_key *e = *slot; e; e = e->next) {
+    if (e->db == db && e->len == key->mv_size &&
+        memcmp(e->data, key->mv_data, e->len) == 0) {
+      pthread_mutex_unlock(&env->compact.lock);
+      return;
+    }
+  }
+
+  compact_key *e = malloc(sizeof(compact_key) + key->mv_size);
+  if (!e) {
+    env->compact.overflow = true;
+    pthread_mutex_unlock(&env->compact.lock);
+    return;
+  }
+  e->db = db;
+  e->len = key->mv_size;
+  memcpy(e->data, key->mv_data, key->mv_size);
+  e->next = *slot;
+  *slot = e;
+  if (++env->compact.count > env->compact.bucket_count * 2) {
+    compact_rehash(env);
+  }
+  pthread_mutex_unlock(&env->compact.lock);
+}
+
+// 取走当前记录的全部脏键，串成一条链表
+static compact_key *compact_take(lmjcore_env *env) {
+  compact_key *list = NULL;
+  pthread_mutex_lock(&env->compact.lock);
+  for (size_t i = 0; i < env->compact.bucket_count; i++) {
+    compact_key *e = env->compact.buckets[i];
+    while (e) {
+      compact_key *next = e->next;
+      e->next = list;
+      list = e;
+      e = next;
+    }
+    env->compact.buckets[i] = NULL;
+  }
+  env->compact.count = 0;
+  pthread_mutex_unlock(&env->compact.lock);
+  return list;
+}
+
+static void compact_keys_free(compact_key *list) {
+  while (list) {
+    compact_key *next = list->next;
+    free(list);
+    list = next;
+  }
+}
+
+// 当前记录的脏键数量
+static size_t compact_pending(lmjcore_env *env) {
+  pthread_mutex_lock(&env->compact.lock);
+  size_t count = env->compact.count;
+  pthread_mutex_unlock(&env->compact.lock);
+  return count;
+}
+
+/**
+ * @brief 停止记录并释放剩余的脏键
+ *
+ * @return bool 记录期间是否发生过内存不足
+ */
+static bool compact_stop_tracking(lmjcore_env *env) {
+  pthread_mutex_lock(&env->compact.lock);
+  atomic_store(&env->compact.tracking, false);
+  pthread_mutex_unlock(&env->compact.lock);
+
+  compact_keys_free(compact_take(env));
+
+  pthread_mutex_lock(&env->compact.lock);
+  bool overflow = env->compact.overflow;
+  free(env->compact.buckets);
+  env->compact.buckets = NULL;
+  env->compact.bucket_count = 0;
+  pthread_mutex_unlock(&env->compact.lock);
+  return overflow;
+}
+
+/**
+ * @brief 等待当前写事务结束后取走脏键
+ *
+ * 脏键只在写事务内记录，拿到写锁时记录过这些键的事务都已提交或中止；
+ * 之后开启的读事务一定能看到它们的最终结果。写事务同样经过闸门，映射
+ * 扩容不会在它打开期间调整映射。
+ */
+static int compact_take_settled(lmjcore_env *env, compact_key **list_out) {
+  txn_gate_enter(env);
+  MDB_txn *writer = NULL;
+  int rc = mdb_txn_begin(env->mdb_env, NULL, 0, &writer);
+  if (rc != MDB_SUCCESS) {
+    txn_gate_leave(env);
+    return rc;
+  }
+  *list_out = compact_take(env);
+  mdb_txn_abort(writer);
+  txn_gate_leave(env);
+  return MDB_SUCCESS;
+}
+
+// 把一个键在数据文件中的最新状态同步到副本
+static int compact_sync_key(lmjcore_env *env, MDB_txn *live, compact_copy *copy,
+                            MDB_txn *dst, const compact_key *e) {
+  MDB_val key = {.mv_size = e->len, .mv_data = (void *)e->data};
+  MDB_val data;
+
+  if (e->db != COMPACT_DB_SET) {
+    MDB_dbi src_dbi = e->db == COMPACT_DB_JOURNAL ? env->journal_dbi
+                      : e->db == COMPACT_DB_STATS ? env->stats_dbi
+                                                  : env->main_dbi;
+    MDB_dbi dst_dbi = e->db == COMPACT_DB_JOURNAL ? copy->journal_dbi
+                      : e->db == COMPACT_DB_STATS ? copy->stats_dbi
+                                                  : copy->main_dbi;
+    int rc = mdb_get(live, src_dbi, &key, &data);
+    if (rc == MDB_SUCCESS) {
+      return mdb_put(dst, dst_dbi, &key, &data, 0);
+    }
+    if (rc != MDB_NOTFOUND) {
+      return rc;
+    }
+    rc = mdb_del(dst, dst_dbi, &key, NULL);
+    return rc == MDB_NOTFOUND ? MDB_SUCCESS : rc;
+  }
+
+  // set 库的键对应一组重复值：整体删除后按当前值重建
+  int rc = mdb_del(dst, copy->set_dbi, &key, NULL);
+  if (rc != MDB_SUCCESS && rc != MDB_NOTFOUND) {
+    return rc;
+  }
+  MDB_cursor *cursor;
+  rc = mdb_cursor_open(live, env->set_dbi, &cursor);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  rc = mdb_cursor_get(cursor, &key, &data, MDB_SET);
+  while (rc == MDB_SUCCESS) {
+    rc = mdb_put(dst, copy->set_dbi, &key, &data, 0);
+    if (rc == MDB_SUCCESS) {
+      rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT_DUP);
+    }
+  }
+  mdb_cursor_close(cursor);
+  return rc == MDB_NOTFOUND ? MDB_SUCCESS : rc;
+}
+
+/**
+ * @brief 执行一轮追赶：把一批脏键同步到副本（链表总是被释放）
+ *
+ * 会在数据文件上开启读事务，调用方需已进入闸门，或已关闭并排空闸门。
+ */
+static int compact_sync(lmjcore_env *env, compact_copy *copy,
+                        compact_key *list, size_t *synced) {
+  MDB_txn *live = NULL, *dst = NULL;
+  int rc = mdb_txn_begin(env->mdb_env, NULL, MDB_RDONLY, &live);
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_txn_begin(copy->mdb_env, NULL, 0, &dst);
+  }
+
+  for (compact_key *e = list; e && rc == MDB_SUCCESS; e = e->next) {
+    rc = compact_sync_key(env, live, copy, dst, e);
+    (*synced)++;
+  }
+
+  if (dst) {
+    if (rc == MDB_SUCCESS) {
+      rc = mdb_txn_commit(dst);
+    } else {
+      mdb_txn_abort(dst);
+    }
+  }
+  if (live) {
+    mdb_txn_abort(live);
+  }
+  compact_keys_free(list);
+  return rc;
+}
+
+/**
+ * @brief 把副本中脏对象日志的事务 ID 全部改为 0
+ *
+ * 日志的值是写入时的事务 ID，检查点按它判断记录是否早于审计快照。压缩
+ * 得到的副本事务 ID 从头计数，沿用旧值会让这些记录永远大于之后的快照
+ * 而无法清除；交换前的记录都早于交换后的任何事务，统一记为 0。
+ */
+static int compact_journal_rebase(compact_copy *copy) {
+  MDB_txn *txn = NULL;
+  int rc = mdb_txn_begin(copy->mdb_env, NULL, 0, &txn);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  MDB_cursor *cursor = NULL;
+  rc = mdb_cursor_open(txn, copy->journal_dbi, &cursor);
+  MDB_val key, data;
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_cursor_get(cursor, &key, &data, MDB_FIRST);
+  }
+  while (rc == MDB_SUCCESS) {
+    uint64_t seq = 0;
+    data = (MDB_val){.mv_size = sizeof(seq), .mv_data = &seq};
+    rc = mdb_cursor_put(cursor, &key, &data, MDB_CURRENT);
+    if (rc == MDB_SUCCESS) {
+      rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT);
+    }
+  }
+  if (cursor) {
+    mdb_cursor_close(cursor);
+  }
+  if (rc != MDB_NOTFOUND) {
+    mdb_txn_abort(txn);
+    return rc;
+  }
+  return mdb_txn_commit(txn);
+}
+
+// 打开压缩副本及其中的 main、set 库（启用脏对象日志、实体统计时还有
+// journal、stats 库）
+static int compact_copy_open(compact_copy *copy, const char *path,
+                             size_t map_size, unsigned int flags,
+                             bool journal, bool stats) {
+  int rc = env_open_mdb(path, map_size,
+                        (flags & MDB_NOSUBDIR) | MDB_NOLOCK | MDB_NOSYNC,
+                        &copy->mdb_env);
+  if (rc != MDB_SUCCESS) {
+    copy->mdb_env = NULL;
+    return rc;
+  }
+
+  MDB_txn *txn;
+  rc = mdb_txn_begin(copy->mdb_env, NULL, 0, &txn);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  rc = mdb_dbi_open(txn, MAIN_DB_NAME, MDB_CREATE, &copy->main_dbi);
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_dbi_open(txn, SET_DB_NAME, MDB_CREATE | MDB_DUPSORT,
+                      &copy->set_dbi);
+  }
+  if (rc == MDB_SUCCESS && journal) {
+    rc = mdb_dbi_open(txn, JOURNAL_DB_NAME, MDB_CREATE, &copy->journal_dbi);
+  }
+  if (rc == MDB_SUCCESS && stats) {
+    rc = mdb_dbi_open(txn, STATS_DB_NAME, MDB_CREATE, &copy->stats_dbi);
+  }
+  if (rc != MDB_SUCCESS) {
+    mdb_txn_abort(txn);
+    return rc;
+  }
+  return mdb_txn_commit(txn);
+}
+
+static void compact_copy_close(compact_copy *copy) {
+  if (copy->mdb_env) {
+    mdb_env_close(copy->mdb_env);
+    copy->mdb_env = NULL;
+  }
+}
+
+// 文件大小（不存在时为 0）
+static size_t compact_file_size(const char *path) {
+  struct stat st;
+  return stat(path, &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+/**
+ * @brief 用副本替换数据文件并重新打开环境（闸门已关闭且已排空）
+ *
+ * 读快照管理器的锁在交换期间一直持有，看门狗不会访问正在关闭的环境；
+ * 空闲快照的读事务属于旧环境，中止后由下次获取时重新开启。
+ */
+static int compact_swap(lmjcore_env *env, const char *copy_data,
+                        const char *data_path, const char *path,
+                        unsigned int flags) {
+  pthread_mutex_lock(&env->gate_lock);
+  for (lmjcore_snapshot_mgr *mgr = env->snapshot_mgrs; mgr; mgr = mgr->next) {
+    pthread_mutex_lock(&mgr->lock);
+    for (lmjcore_snapshot_slot *slot = mgr->slots; slot; slot = slot->next) {
+      if (slot->txn.mdb_txn) {
+        txn_cursors_close(&slot->txn);
+        mdb_txn_abort(slot->txn.mdb_txn);
+        slot->txn.mdb_txn = NULL;
+        slot->live = false;
+      }
+    }
+  }
+
+  mdb_dbi_close(env->mdb_env, env->main_dbi);
+  mdb_dbi_close(env->mdb_env, env->set_dbi);
+  if (atomic_load(&env->journal_enabled)) {
+    mdb_dbi_close(env->mdb_env, env->journal_dbi);
+  }
+  if (atomic_load(&env->stats_enabled)) {
+    mdb_dbi_close(env->mdb_env, env->stats_dbi);
+  }
+  mdb_env_close(env->mdb_env);
+  env->mdb_env = NULL;
+
+  // 替换失败时重新打开原数据文件
+  int rc = rename(copy_data, data_path) == 0 ? MDB_SUCCESS : errno;
+  int open_rc = env_open_mdb(path, env->map_size, flags, &env->mdb_env);
+  if (open_rc == MDB_SUCCESS) {
+    open_rc = env_open_dbis(env, MDB_RDONLY);
+  }
+  if (open_rc == MDB_SUCCESS) {
+    MDB_envinfo info;
+    mdb_env_info(env->mdb_env, &info);
+    env->map_size = info.me_mapsize;
+  }
+
+  for (lmjcore_snapshot_mgr *mgr = env->snapshot_mgrs; mgr; mgr = mgr->next) {
+    pthread_mutex_unlock(&mgr->lock);
+  }
+  pthread_mutex_unlock(&env->gate_lock);
+  return rc != MDB_SUCCESS ? rc : open_rc;
+}
+
+/**
+ * @brief 确认没有在线压缩在运行并持有 compact.lock
+ *
+ * 供切换可选库（journal、stats）使用：压缩只复制开始时已启用的库，中途
+ * 切换会使副本与数据文件不一致。返回 true 时调用方持有锁，切换完成后
+ * 释放，期间开始的压缩会等待。
+ */
+static bool compact_lock_idle(lmjcore_env *env) {
+  pthread_mutex_lock(&env->compact.lock);
+  if (env->compact.running) {
+    pthread_mutex_unlock(&env->compact.lock);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief 删除一个可选库并清除其启用标志
+ *
+ * mdb_drop 会关闭库句柄，其他线程的事务可能仍在使用。先关闭闸门排空
+ * 本进程内的事务，再用不经过闸门的写事务删除，并在重新打开闸门前清除
+ * 标志，之后开始的事务都不会再访问该库。
+ */
+static int optional_db_drop(lmjcore_env *env, MDB_dbi dbi,
+                            atomic_bool *enabled) {
+  if (!txn_gate_close(env, MAP_DRAIN_TIMEOUT_MS)) {
+    return ETIMEDOUT;
+  }
+  MDB_txn *txn = NULL;
+  int rc = mdb_txn_begin(env->mdb_env, NULL, 0, &txn);
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_drop(txn, dbi, 1);
+    if (rc == MDB_SUCCESS) {
+      rc = mdb_txn_commit(txn);
+    } else {
+      mdb_txn_abort(txn);
+    }
+  }
+  if (rc == MDB_SUCCESS) {
+    atomic_store(enabled, false);
+  }
+  txn_gate_open(env);
+  return rc;
+}
+
+// 在线压缩并原子替换数据文件
+int lmjcore_env_compact(lmjcore_env *env, const lmjcore_compact_opts *opts,
+                        lmjcore_compact_stats *stats_out) {
+  if (!env) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  lmjcore_compact_opts o = opts ? *opts : (lmjcore_compact_opts){0};
+  if (o.max_rounds == 0) {
+    o.max_rounds = COMPACT_DEFAULT_ROUNDS;
+  }
+  if (o.swap_threshold == 0) {
+    o.swap_threshold = COMPACT_DEFAULT_THRESHOLD;
+  }
+  if (o.drain_timeout_ms == 0) {
+    o.drain_timeout_ms = MAP_DRAIN_TIMEOUT_MS;
+  }
+
+  unsigned int flags = 0;
+  const char *env_path = NULL;
+  mdb_env_get_flags(env->mdb_env, &flags);
+  mdb_env_get_path(env->mdb_env, &env_path);
+  if (flags & MDB_RDONLY) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+
+  // 数据文件与副本路径：NOSUBDIR 时副本与数据文件同目录，否则放在子目录中
+  char path[COMPACT_PATH_MAX];
+  char data_path[COMPACT_PATH_MAX + 32], copy_path[COMPACT_PATH_MAX + 32];
+  char copy_data[COMPACT_PATH_MAX + 32];
+  if (strlen(env_path) >= sizeof(path)) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  strcpy(path, env_path);
+  if (flags & MDB_NOSUBDIR) {
+    snprintf(data_path, sizeof(data_path), "%s", path);
+    snprintf(copy_path, sizeof(copy_path), "%s.compact", path);
+    snprintf(copy_data, sizeof(copy_data), "%s.compact", path);
+  } else {
+    snprintf(data_path, sizeof(data_path), "%s/data.mdb", path);
+    snprintf(copy_path, sizeof(copy_path), "%s/compact.tmp", path);
+    snprintf(copy_data, sizeof(copy_data), "%s/compact.tmp/data.mdb", path);
+  }
+
+  pthread_mutex_lock(&env->compact.lock);
+  if (env->compact.running) {
+    pthread_mutex_unlock(&env->compact.lock);
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  env->compact.buckets = calloc(COMPACT_INITIAL_BUCKETS, sizeof(compact_key *));
+  if (!env->compact.buckets) {
+    pthread_mutex_unlock(&env->compact.lock);
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  env->compact.bucket_count = COMPACT_INITIAL_BUCKETS;
+  env->compact.count = 0;
+  env->compact.overflow = false;
+  env->compact.running = true;
+  atomic_store(&env->compact.tracking, true);
+  pthread_mutex_unlock(&env->compact.lock);
+
+  lmjcore_compact_stats stats = {.size_before = compact_file_size(data_path)};
+  compact_copy copy = {0};
+  bool gate_closed = false;
+  bool restart_health = false;
+  lmjcore_health_opts health_opts;
+
+  // 开始记录之前已经写入的键属于当时的写事务，等它结束后再复制
+  compact_key *list = NULL;
+  remove(copy_data);
+  if (!(flags & MDB_NOSUBDIR)) {
+    mkdir(copy_path, 0775);
+  }
+  int rc = compact_take_settled(env, &list);
+  compact_keys_free(list);
+  if (rc == MDB_SUCCESS) {
+    // 复制期间持有读事务，经过闸门避免映射扩容与之并发
+    txn_gate_enter(env);
+    rc = mdb_env_copy2(env->mdb_env, copy_path, MDB_CP_COMPACT);
+    txn_gate_leave(env);
+  }
+  if (rc == MDB_SUCCESS) {
+    rc = compact_copy_open(&copy, copy_path, env_map_size(env), flags,
+                           atomic_load(&env->journal_enabled),
+                           atomic_load(&env->stats_enabled));
+  }
+
+  // 追赶：复制期间的写入在副本中重放，直到剩余脏键足够少
+  while (rc == MDB_SUCCESS && stats.rounds < o.max_rounds &&
+         compact_pending(env) > o.swap_threshold) {
+    rc = compact_take_settled(env, &list);
+    if (rc == MDB_SUCCESS) {
+      txn_gate_enter(env);
+      rc = compact_sync(env, &copy, list, &stats.keys_synced);
+      txn_gate_leave(env);
+      stats.rounds++;
+    }
+  }
+
+  if (rc == MDB_SUCCESS) {
+    // 后台线程会直接访问 LMDB 环境，交换前停止
+    lmjcore_warmup_cancel(env);
+    pthread_mutex_lock(&env->health.lock);
+    restart_health = env->health.running;
+    health_opts = env->health.opts;
+    pthread_mutex_unlock(&env->health.lock);
+    if (restart_health) {
+      lmjcore_health_monitor_stop(env);
+    }
+
+    gate_closed = txn_gate_close(env, o.drain_timeout_ms);
+    if (!gate_closed) {
+      rc = ETIMEDOUT;
+    }
+  }
+  if (rc == MDB_SUCCESS) {
+    // 事务已排空，最后一批脏键不会再变化
+    rc = compact_sync(env, &copy, compact_take(env), &stats.keys_synced);
+    stats.rounds++;
+  }
+  if (compact_stop_tracking(env) && rc == MDB_SUCCESS) {
+    rc = LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  // 压缩期间不能切换日志，这里的状态与副本打开时一致
+  if (rc == MDB_SUCCESS && atomic_load(&env->journal_enabled)) {
+    rc = compact_journal_rebase(&copy);
+  }
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_env_sync(copy.mdb_env, 1);
+  }
+  compact_copy_close(&copy);
+
+  if (rc == MDB_SUCCESS) {
+    rc = compact_swap(env, copy_data, data_path, path, flags);
+  }
+  if (rc != MDB_SUCCESS) {
+    remove(copy_data);
+  }
+  if (!(flags & MDB_NOSUBDIR)) {
+    rmdir(copy_path);
+  }
+  if (gate_closed) {
+    txn_gate_open(env);
+  }
+  if (restart_health) {
+    lmjcore_health_monitor_start(env, &health_opts);
+  }
+
+  pthread_mutex_lock(&env->compact.lock);
+  env->compact.running = false;
+  pthread_mutex_unlock(&env->compact.lock);
+
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  stats.size_after = compact_file_size(data_path);
+  if (stats_out) {
+    *stats_out = stats;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+/*
+ *==========================================
+ * 存储统计
+ *==========================================
+ */
+#define SAMPLE_DEFAULT_MAX 1000
+
+// LMDB 页布局常量（与 mdb.c 中的 PAGEHDRSZ、NODESIZE、MDB_MINKEYS 一致）
+#define LMDB_PAGE_HEADER 16
+#define LMDB_NODE_HEADER 8
+#define LMDB_NODE_INDEX 2 // 页头后的节点偏移表项
+#define LMDB_MIN_KEYS 2
+
+// 叶子节点的最大大小，超过时值放入溢出页（mdb.c 中的 me_nodemax）
+static size_t lmdb_node_max(unsigned int psize) {
+  return (((psize - LMDB_PAGE_HEADER) / LMDB_MIN_KEYS) & ~(size_t)1) -
+         sizeof(uint16_t);
+}
+
+// 复制 mdb_stat 的结果
+static void dbi_stats_from(lmjcore_dbi_stats *out, const MDB_stat *st) {
+  out->depth = st->ms_depth;
+  out->branch_pages = st->ms_branch_pages;
+  out->leaf_pages = st->ms_leaf_pages;
+  out->overflow_pages = st->ms_overflow_pages;
+  out->entries = st->ms_entries;
+}
+
+// 读取环境存储统计
+int lmjcore_env_stats(lmjcore_env *env, lmjcore_storage_stats *stats_out) {
+  if (!env || !stats_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  memset(stats_out, 0, sizeof(*stats_out));
+
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(env, NULL, MDB_RDONLY, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  MDB_stat main_stat, set_stat;
+  rc = mdb_stat(txn->mdb_txn, env->main_dbi, &main_stat);
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_stat(txn->mdb_txn, env->set_dbi, &set_stat);
+  }
+  if (rc == MDB_SUCCESS) {
+    MDB_envinfo info;
+    mdb_env_info(env->mdb_env, &info);
+    dbi_stats_from(&stats_out->main, &main_stat);
+    dbi_stats_from(&stats_out->set, &set_stat);
+    stats_out->page_size = main_stat.ms_psize;
+    stats_out->map_size = info.me_mapsize;
+    stats_out->map_used = (info.me_last_pgno + 1) * (size_t)main_stat.ms_psize;
+    stats_out->last_txnid = info.me_last_txnid;
+  }
+  lmjcore_txn_abort(txn);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+
+  return count_free_pages(env, &stats_out->free_pages);
+}
+
+// 单类实体的采样累计
+typedef struct {
+  size_t sampled;
+  size_t members;
+  size_t keys;
+  size_t key_bytes;
+  size_t values;
+  size_t value_bytes;
+  size_t overflow_values;
+  size_t overflow_bytes; // 溢出页总字节
+  size_t overflow_waste; // 溢出页中未使用的字节
+  size_t main_bytes;     // 在 main 库叶子页中占用的字节
+  size_t set_bytes;      // 在 set 库叶子页中占用的字节
+} sample_acc;
+
+// 叶子页中一个节点占用的字节（含偏移表项，按 2 字节对齐）
+static size_t sample_node_size(size_t key_len, size_t data_len) {
+  size_t size = LMDB_NODE_INDEX + LMDB_NODE_HEADER + key_len + data_len;
+  return (size + 1) & ~(size_t)1;
+}
+
+/**
+ * @brief 采样一个实体（游标位于该实体的键上，返回时位于其最后一个重复值）
+ */
+static int sample_entity(lmjcore_txn *txn, MDB_cursor *cursor, MDB_val *key,
+                         unsigned int psize, size_t node_max,
+                         sample_acc *acc) {
+  bool is_obj = ((const uint8_t *)key->mv_data)[0] == LMJCORE_OBJ;
+  uint8_t main_key[LMJCORE_MAX_KEY_LEN];
+  memcpy(main_key, key->mv_data, LMJCORE_PTR_LEN);
+
+  acc->sampled++;
+  acc->set_bytes += sample_node_size(LMJCORE_PTR_LEN, 0);
+
+  MDB_val data;
+  int rc = mdb_cursor_get(cursor, key, &data, MDB_FIRST_DUP);
+  while (rc == MDB_SUCCESS) {
+    acc->set_bytes += sample_node_size(0, data.mv_size);
+    if (data.mv_size == 0) {
+      // 实体登记用的空占位
+      rc = mdb_cursor_get(cursor, key, &data, MDB_NEXT_DUP);
+      continue;
+    }
+
+    acc->members++;
+    if (!is_obj) {
+      acc->keys++;
+      acc->key_bytes += LMJCORE_PTR_LEN;
+      acc->values++;
+      acc->value_bytes += data.mv_size;
+    } else if (LMJCORE_PTR_LEN + data.mv_size <= sizeof(main_key)) {
+      memcpy(main_key + LMJCORE_PTR_LEN, data.mv_data, data.mv_size);
+      MDB_val mkey = {.mv_size = LMJCORE_PTR_LEN + data.mv_size,
+                      .mv_data = main_key};
+      MDB_val value;
+      acc->keys++;
+      acc->key_bytes += mkey.mv_size;
+
+      int get_rc = mdb_get(txn->mdb_txn, txn->env->main_dbi, &mkey, &value);
+      if (get_rc == MDB_SUCCESS) {
+        acc->values++;
+        acc->value_bytes += value.mv_size;
+        if (LMDB_NODE_HEADER + mkey.mv_size + value.mv_size > node_max) {
+          // 叶子节点只保存溢出页号，值占用连续的溢出页
+          size_t pages =
+              (LMDB_PAGE_HEADER - 1 + value.mv_size) / psize + 1;
+          acc->overflow_values++;
+          acc->overflow_bytes += pages * psize;
+          acc->overflow_waste +=
+              pages * psize - LMDB_PAGE_HEADER - value.mv_size;
+          acc->main_bytes += sample_node_size(mkey.mv_size, sizeof(size_t));
+        } else {
+          acc->main_bytes += sample_node_size(mkey.mv_size, value.mv_size);
+        }
+      } else if (get_rc != MDB_NOTFOUND) {
+        return get_rc;
+      }
+    }
+    rc = mdb_cursor_get(cursor, key, &data, MDB_NEXT_DUP);
+  }
+  return rc == MDB_NOTFOUND ? MDB_SUCCESS : rc;
+}
+
+// 由累计值计算单类实体的采样结果
+static void sample_finish(lmjcore_type_sample *out, const sample_acc *acc) {
+  out->sampled = acc->sampled;
+  if (acc->sampled > 0) {
+    out->avg_members = (double)acc->members / (double)acc->sampled;
+  }
+  if (acc->keys > 0) {
+    out->avg_key_size = (double)acc->key_bytes / (double)acc->keys;
+  }
+  if (acc->values > 0) {
+    out->avg_value_size = (double)acc->value_bytes / (double)acc->values;
+  }
+  out->overflow_values = acc->overflow_values;
+  if (acc->overflow_bytes > 0) {
+    out->overflow_waste =
+        (double)acc->overflow_waste / (double)acc->overflow_bytes;
+  }
+}
+
+// 按采样得到的平均占用估算整库的叶子页填充率
+static double sample_fill(double bytes_per_entity, size_t entities,
+                          size_t leaf_pages, unsigned int psize) {
+  if (leaf_pages == 0) {
+    return 0;
+  }
+  double fill = bytes_per_entity * (double)entities /
+                ((double)leaf_pages * (double)(psize - LMDB_PAGE_HEADER));
+  return fill > 1.0 ? 1.0 : fill;
+}
+
+// 采样分析键值大小、页填充率与溢出页浪费
+int lmjcore_env_sample(lmjcore_env *env, size_t max_samples,
+                       lmjcore_storage_sample *sample_out) {
+  if (!env || !sample_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (max_samples == 0) {
+    max_samples = SAMPLE_DEFAULT_MAX;
+  }
+  memset(sample_out, 0, sizeof(*sample_out));
+
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(env, NULL, MDB_RDONLY, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  MDB_stat main_stat, set_stat;
+  MDB_cursor *cursor = NULL;
+  rc = mdb_stat(txn->mdb_txn, env->main_dbi, &main_stat);
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_stat(txn->mdb_txn, env->set_dbi, &set_stat);
+  }
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_cursor_open(txn->mdb_txn, env->set_dbi, &cursor);
+  }
+  if (rc != MDB_SUCCESS) {
+    lmjcore_txn_abort(txn);
+    return rc;
+  }
+
+  // 叶子节点超过该大小时值放入溢出页
+  unsigned int psize = main_stat.ms_psize;
+  size_t node_max = lmdb_node_max(psize);
+  sample_out->inline_limit = node_max - LMDB_NODE_HEADER;
+
+  // 蓄水池抽样：一次遍历得到均匀样本，只保存样本的指针
+  lmjcore_ptr *picked = malloc(max_samples * sizeof(lmjcore_ptr));
+  if (!picked) {
+    mdb_cursor_close(cursor);
+    lmjcore_txn_abort(txn);
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  uint64_t rng = 0x9E3779B97F4A7C15ULL; // 固定种子，结果可复现
+  size_t entities = 0, candidates = 0, count = 0;
+  MDB_val key, data;
+  rc = mdb_cursor_get(cursor, &key, &data, MDB_FIRST);
+  while (rc == MDB_SUCCESS) {
+    if (key.mv_size == LMJCORE_PTR_LEN) {
+      uint8_t type = ((const uint8_t *)key.mv_data)[0];
+      entities++;
+      if (type == LMJCORE_OBJ) {
+        sample_out->obj.entities++;
+      } else if (type == LMJCORE_SET) {
+        sample_out->set.entities++;
+      }
+      if (type == LMJCORE_OBJ || type == LMJCORE_SET) {
+        size_t slot = candidates++;
+        if (slot >= max_samples) {
+          rng ^= rng << 13;
+          rng ^= rng >> 7;
+          rng ^= rng << 17;
+          slot = (size_t)(rng % candidates);
+        }
+        if (slot < max_samples) {
+          memcpy(picked[slot], key.mv_data, LMJCORE_PTR_LEN);
+          count = count < max_samples ? count + 1 : count;
+        }
+      }
+    }
+    rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT_NODUP);
+  }
+
+  sample_acc obj = {0}, set = {0};
+  if (rc == MDB_NOTFOUND) {
+    rc = MDB_SUCCESS;
+  }
+  for (size_t i = 0; i < count && rc == MDB_SUCCESS; i++) {
+    key.mv_size = LMJCORE_PTR_LEN;
+    key.mv_data = picked[i];
+    rc = mdb_cursor_get(cursor, &key, &data, MDB_SET);
+    if (rc == MDB_SUCCESS) {
+      rc = sample_entity(txn, cursor, &key, psize, node_max,
+                         picked[i][0] == LMJCORE_OBJ ? &obj : &set);
+    }
+  }
+  free(picked);
+  mdb_cursor_close(cursor);
+  lmjcore_txn_abort(txn);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+
+  sample_finish(&sample_out->obj, &obj);
+  sample_finish(&sample_out->set, &set);
+  if (obj.sampled > 0) {
+    sample_out->main_fill =
+        sample_fill((double)obj.main_bytes / (double)obj.sampled,
+                    sample_out->obj.entities, main_stat.ms_leaf_pages, psize);
+  }
+  if (obj.sampled + set.sampled > 0) {
+    sample_out->set_fill = sample_fill(
+        (double)(obj.set_bytes + set.set_bytes) /
+            (double)(obj.sampled + set.sampled),
+        entities, set_stat.ms_leaf_pages, psize);
+  }
+  return LMJCORE_SUCCESS;
+}
+
+#define RESIDENCY_DEFAULT_SAMPLES 4096
+
+static int audit_segments(MDB_txn *txn, MDB_dbi dbi,
+                          uint8_t (*firsts)[LMJCORE_PTR_LEN],
+                          uint8_t (*lasts)[LMJCORE_PTR_LEN], size_t *segments);
+static void audit_interpolate(const uint8_t *first, const uint8_t *last,
+                              size_t n, uint8_t (*bounds)[LMJCORE_PTR_LEN],
+                              size_t *count);
+
+// 记录一个采样条目：值指向映射内的叶子页或溢出页，由地址换算出所在文件页
+static void residency_record(const MDB_val *key, const MDB_val *data,
+                             size_t per_range, const uint8_t *map_base,
+                             const unsigned char *vec, size_t pages,
+                             size_t page, lmjcore_dbi_residency *out) {
+  size_t r = out->sampled / per_range;
+  lmjcore_residency_range *range = &out->ranges[r];
+  if (range->sampled == 0) {
+    out->range_count = r + 1;
+    memset(range->start, 0, LMJCORE_PTR_LEN);
+    memcpy(range->start, key->mv_data,
+           key->mv_size < LMJCORE_PTR_LEN ? key->mv_size : LMJCORE_PTR_LEN);
+  }
+  out->sampled++;
+  range->sampled++;
+
+  const uint8_t *addr = data->mv_data;
+  if (map_base && addr >= map_base && addr < map_base + pages * page) {
+    out->mapped++;
+    if (vec[(size_t)(addr - map_base) / page] & 1) {
+      out->resident++;
+      range->resident++;
+    }
+  }
+}
+
+/**
+ * @brief 采样一个库的条目并按其所在页统计驻留情况
+ *
+ * 条目数不超过 max_samples 时逐条遍历；否则按类型字节分段，在段内首尾
+ * 实体之间插值出 max_samples 个指针前缀，逐个 MDB_SET_RANGE 定位，
+ * 只读取采样点路径上的页，不会为统计而把整个库读进页缓存。
+ *
+ * @param map_base LMDB 映射的起始地址（为 NULL 时无法定位条目所在页）
+ */
+static int residency_scan(lmjcore_txn *txn, MDB_dbi dbi, size_t max_samples,
+                          const uint8_t *map_base, const unsigned char *vec,
+                          size_t pages, size_t page,
+                          lmjcore_dbi_residency *out) {
+  MDB_stat st;
+  int rc = mdb_stat(txn->mdb_txn, dbi, &st);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+
+  MDB_cursor *cursor;
+  MDB_val key, data;
+  if (st.ms_entries <= max_samples) {
+    // 每段区间包含的采样条目数，保证不超过 LMJCORE_RESIDENCY_RANGES 段
+    size_t per_range = (st.ms_entries + LMJCORE_RESIDENCY_RANGES - 1) /
+                       LMJCORE_RESIDENCY_RANGES;
+    rc = mdb_cursor_open(txn->mdb_txn, dbi, &cursor);
+    if (rc != MDB_SUCCESS) {
+      return rc;
+    }
+    rc = mdb_cursor_get(cursor, &key, &data, MDB_FIRST);
+    while (rc == MDB_SUCCESS) {
+      residency_record(&key, &data, per_range, map_base, vec, pages, page,
+                       out);
+      rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT);
+    }
+    mdb_cursor_close(cursor);
+    return rc == MDB_NOTFOUND ? MDB_SUCCESS : rc;
+  }
+
+  // 各类型字节下的首尾实体，段内插值出采样点
+  uint8_t firsts[256][LMJCORE_PTR_LEN], lasts[256][LMJCORE_PTR_LEN];
+  size_t segments = 0;
+  rc = audit_segments(txn->mdb_txn, dbi, firsts, lasts, &segments);
+  if (rc != MDB_SUCCESS || segments == 0) {
+    return rc;
+  }
+  size_t per_segment = max_samples / segments ? max_samples / segments : 1;
+  uint8_t(*points)[LMJCORE_PTR_LEN] =
+      calloc(segments * per_segment, LMJCORE_PTR_LEN);
+  if (!points) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  size_t count = 0;
+  for (size_t i = 0; i < segments; i++) {
+    memcpy(points[count++], firsts[i], LMJCORE_PTR_LEN);
+    audit_interpolate(firsts[i], lasts[i], per_segment, points, &count);
+  }
+  if (count > max_samples) {
+    count = max_samples;
+  }
+  size_t per_range =
+      (count + LMJCORE_RESIDENCY_RANGES - 1) / LMJCORE_RESIDENCY_RANGES;
+
+  rc = mdb_cursor_open(txn->mdb_txn, dbi, &cursor);
+  if (rc != MDB_SUCCESS) {
+    free(points);
+    return rc;
+  }
+  MDB_val prev = {0};
+  for (size_t i = 0; i < count; i++) {
+    key.mv_size = LMJCORE_PTR_LEN;
+    key.mv_data = points[i];
+    rc = mdb_cursor_get(cursor, &key, &data, MDB_SET_RANGE);
+    if (rc != MDB_SUCCESS) {
+      break; // MDB_NOTFOUND：之后的采样点都已越过最后一个条目
+    }
+    // 相邻采样点落在同一条目上时只记一次
+    if (prev.mv_data && prev.mv_size == key.mv_size &&
+        memcmp(prev.mv_data, key.mv_data, key.mv_size) == 0) {
+      continue;
+    }
+    prev = key;
+    residency_record(&key, &data, per_range, map_base, vec, pages, page, out);
+  }
+  mdb_cursor_close(cursor);
+  free(points);
+  return rc == MDB_NOTFOUND ? MDB_SUCCESS : rc;
+}
+
+// 报告数据文件在页缓存中的驻留情况
+int lmjcore_env_residency(lmjcore_env *env, size_t max_samples,
+                          lmjcore_residency_report *report_out) {
+  if (!env || !report_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (max_samples == 0) {
+    max_samples = RESIDENCY_DEFAULT_SAMPLES;
+  }
+  memset(report_out, 0, sizeof(*report_out));
+
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(env, NULL, MDB_RDONLY, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  unsigned char *vec = NULL;
+  size_t pages = 0, file_size = 0;
+  rc = file_residency(env, &vec, &pages, &file_size);
+  if (rc != LMJCORE_SUCCESS) {
+    lmjcore_txn_abort(txn);
+    return rc;
+  }
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  report_out->file_size = file_size;
+  report_out->page_size = page;
+  report_out->file_pages = pages;
+  for (size_t i = 0; i < pages; i++) {
+    report_out->resident_pages += vec[i] & 1;
+  }
+  if (pages > 0) {
+    report_out->resident_ratio =
+        (double)report_out->resident_pages / (double)pages;
+  }
+
+  MDB_envinfo info;
+  mdb_env_info(env->mdb_env, &info);
+  const uint8_t *map_base = info.me_mapaddr;
+  rc = residency_scan(txn, env->main_dbi, max_samples, map_base, vec, pages,
+                      page, &report_out->main);
+  if (rc == MDB_SUCCESS) {
+    rc = residency_scan(txn, env->set_dbi, max_samples, map_base, vec, pages,
+                        page, &report_out->set);
+  }
+  free(vec);
+  lmjcore_txn_abort(txn);
+  return rc;
+}
+
+/*
+ *==========================================
+ * 对象相关
+ ==========================================
+ */
+// 创建对象
+int lmjcore_obj_create(lmjcore_txn *txn, lmjcore_ptr ptr_out) {
+  if (!txn || !ptr_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  if (txn->is_read_only) {
+    return LMJCORE_ERROR_READONLY_TXN;
+  }
+
+  // 生成指针
+  int rc = txn->env->ptr_generator(txn->env->ptr_gen_ctx, ptr_out);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  // 确保指针类型为对象
+  ptr_out[0] = LMJCORE_OBJ;
+
+  // 在 set 数据库中创建空成员列表（不存储任何值，仅表示对象存在）
+  MDB_val key, data;
+  key.mv_data = ptr_out;
+  key.mv_size = LMJCORE_PTR_LEN;
+
+  data.mv_data = NULL;
+  data.mv_size = 0;
+
+  rc = stats_set_put(txn, &key, &data, 0);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 注册对象
+int lmjcore_obj_register(lmjcore_txn *txn, const lmjcore_ptr ptr) {
+  if (!txn || !ptr) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (txn->is_read_only) {
+    return LMJCORE_ERROR_READONLY_TXN;
+  }
+  if (ptr[0] != LMJCORE_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+  if (lmjcore_entity_exist(txn, ptr) == 1) {
+    return LMJCORE_ERROR_ENTITY_EXISTS;
+  }
+  // 在 set 数据库中创建空成员列表（不存储任何值，仅表示对象存在）
+  MDB_val key, data;
+  key.mv_data = (void *)ptr;
+  key.mv_size = LMJCORE_PTR_LEN;
+
+  data.mv_data = NULL;
+  data.mv_size = 0;
+
+  int rc = stats_set_put(txn, &key, &data, 0);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 读取对象
+int lmjcore_obj_get(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
+                    uint8_t *result_buf, size_t result_buf_size,
+                    lmjcore_result_obj **result_head) {
+  if (!txn || !obj_ptr || !result_buf || !result_head) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (obj_ptr[0] != LMJCORE_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+
+  // 初始化返回空间
+  memset(result_buf, 0, result_buf_size);
+
+  // 设置返回头在缓冲区起始位置
+  lmjcore_result_obj *result = (lmjcore_result_obj *)result_buf;
+  result->error_count = 0;
+  result->member_count = 0;
+  result->sorted = true; // 按 set 库的 dup 顺序遍历
+
+  // 计算关键边界指针
+  uint8_t *descriptors_start = result_buf + sizeof(lmjcore_result_obj);
+
+  *result_head = result;
+
+  // 最小缓冲区检查
+  if (result_buf_size <
+      sizeof(lmjcore_result_obj) + sizeof(lmjcore_member_descriptor)) {
+    return LMJCORE_ERROR_BUFFER_TOO_SMALL;
+  }
+
+  // 对象存在性检查
+  int rc = lmjcore_entity_exist(txn, obj_ptr);
+  if (rc < 0) {
+    return rc; // lmdb 错误
+  }
+  if (rc == 0) {
+    // 实体不存在
+    result_obj_add_error(result, LMJCORE_ERROR_ENTITY_NOT_FOUND, 0, 0, obj_ptr);
+    return LMJCORE_SUCCESS;
+  }
+
+  // 内存布局定义：
+  // +------------------------+ ← result_buf (result)
+  // | lmjcore_result_obj     | 固定头部
+  // +------------------------+
+  // | member_descriptors[]   | 描述符从前向后增长
+  // +------------------------+
+  // | ...                    |
+  // +------------------------+
+  // | name & value data      | 数据从后向前增长
+  // +------------------------+ ← result_buf + result_buf_size
+
+  uint8_t *data_end = result_buf + result_buf_size;
+
+  lmjcore_member_descriptor *current_descriptor =
+      (lmjcore_member_descriptor *)descriptors_start;
+  uint8_t *current_data = data_end; // 数据从末尾开始
+
+  // 使用缓存游标读取成员列表
+  MDB_cursor *cursor;
+  rc = txn_cursor(txn, txn->env->set_dbi, &cursor);
+  if (rc != MDB_SUCCESS) {
+    return rc; // lmdb错误直接返回
+  }
+
+  MDB_val key = {.mv_data = (void *)obj_ptr, .mv_size = LMJCORE_PTR_LEN};
+  MDB_val member_name_val;
+
+  // 定位到该对象的成员列表开始位置
+  rc = mdb_cursor_get(cursor, &key, &member_name_val, MDB_SET);
+  if (rc == MDB_NOTFOUND) {
+    // 空对象 - 没有成员
+    *result_head = result;
+    return LMJCORE_SUCCESS;
+  }
+  if (rc != MDB_SUCCESS) {
+    return rc; // lmdb错误直接返回
+  }
+
+  // 单次遍历处理所有成员
+  while (rc == MDB_SUCCESS) {
+    size_t member_name_len = member_name_val.mv_size;
+
+    // 检查描述符空间是否足够
+    uint8_t *next_descriptor = (uint8_t *)(current_descriptor + 1);
+    if (next_descriptor >= current_data) {
+      return LMJCORE_ERROR_BUFFER_TOO_SMALL; // 缓存太小直接返回(致命错误)
+    }
+
+    // 构建完整key查询成员值
+    uint8_t full_key[LMJCORE_MAX_KEY_LEN];
+    memcpy(full_key, obj_ptr, LMJCORE_PTR_LEN);
+    memcpy(full_key + LMJCORE_PTR_LEN, member_name_val.mv_data,
+           member_name_len);
+
+    MDB_val member_key = {.mv_data = full_key,
+                          .mv_size = LMJCORE_PTR_LEN + member_name_len};
+    MDB_val member_value;
+
+    // 查询成员值
+    rc = txn_get(txn, txn->env->main_dbi, &member_key, &member_value);
+
+    if (rc != MDB_SUCCESS) {
+      // 成员值缺失处理
+      current_descriptor->member_name.value_len = member_name_len;
+      current_descriptor->member_value.value_len = 0;
+      current_descriptor->member_value.value_offset = 0; // 表示null
+
+      // 尝试存储成员名称（如果空间足够）
+      if (current_data - member_name_len >= next_descriptor) {
+        current_data -= member_name_len;
+        memcpy(current_data, member_name_val.mv_data, member_name_len);
+        current_descriptor->member_name.value_offset =
+            current_data - result_buf;
+      } else {
+        // 名称空间不足
+        current_descriptor->member_name.value_offset = 0;
+        return LMJCORE_ERROR_BUFFER_TOO_SMALL; // 致命错误缓存太小
+      }
+
+      result_obj_add_error(result, LMJCORE_ERROR_MEMBER_MISSING,
+                           current_descriptor->member_name.value_offset,
+                           current_descriptor->member_name.value_len, obj_ptr);
+    } else {
+      // 成功获取成员值
+      size_t total_needed = member_name_len + member_value.mv_size;
+
+      // 检查数据空间是否足够
+      if (current_data - total_needed < next_descriptor) {
+        return LMJCORE_ERROR_BUFFER_TOO_SMALL; // 致命错误缓存空间不够
+      }
+
+      // 存储名称和值
+      current_data -= member_value.mv_size;
+      memcpy(current_data, member_value.mv_data, member_value.mv_size);
+      current_descriptor->member_value.value_offset = current_data - result_buf;
+      current_descriptor->member_value.value_len = member_value.mv_size;
+
+      current_data -= member_name_len;
+      memcpy(current_data, member_name_val.mv_data, member_name_len);
+      current_descriptor->member_name.value_offset = current_data - result_buf;
+      current_descriptor->member_name.value_len = member_name_len;
+    }
+
+    // 移动到下一个描述符位置
+    current_descriptor++;
+    result->member_count++;
+
+    // 获取下一个成员名称
+    rc = mdb_cursor_get(cursor, &key, &member_name_val, MDB_NEXT_DUP);
+  }
+
+
+  // 设置返回头
+  *result_head = result;
+
+  return LMJCORE_SUCCESS;
+}
+
+// 删除对象
+int lmjcore_obj_del(lmjcore_txn *txn, const lmjcore_ptr obj_ptr) {
+  if (!txn || !obj_ptr) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  if (txn->is_read_only) {
+    return LMJCORE_ERROR_READONLY_TXN;
+  }
+  if (obj_ptr[0] != LMJCORE_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+
+  MDB_cursor *cursor = NULL;
+  int rc = txn_cursor(txn, txn->env->set_dbi, &cursor);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+
+  // 构建对象key
+  MDB_val key = {.mv_data = (void *)obj_ptr, .mv_size = LMJCORE_PTR_LEN};
+  MDB_val value;
+
+  // 定位到对象成员列表的第一项（缓存游标可能停留在其他位置）
+  rc = mdb_cursor_get(cursor, &key, &value, MDB_SET);
+  if (rc == MDB_NOTFOUND) {
+    return LMJCORE_SUCCESS; // 对象不存在，视为已删除
+  }
+
+  // 遍历所有成员，删除值（缺失值的成员直接跳过）
+  while (rc == MDB_SUCCESS) {
+    rc = lmjcore_obj_member_value_del(txn, obj_ptr, value.mv_data,
+                                      value.mv_size);
+    if (rc != LMJCORE_SUCCESS && rc != MDB_NOTFOUND) {
+      break;
+    }
+    rc = mdb_cursor_get(cursor, &key, &value, MDB_NEXT_DUP);
+  }
+
+  // 最后删除 set 条目
+  if (rc == MDB_NOTFOUND || rc == MDB_SUCCESS) {
+    MDB_val del_key = {.mv_data = (void *)obj_ptr, .mv_size = LMJCORE_PTR_LEN};
+    rc = txn_del(txn, txn->env->set_dbi, &del_key, NULL);
+    if (rc == MDB_SUCCESS) {
+      rc = stats_drop(txn, obj_ptr);
+    }
+  }
+
+  return (rc == MDB_SUCCESS || rc == MDB_NOTFOUND) ? LMJCORE_SUCCESS : rc;
+}
+/*
+ *==========================================
+ * 对象成员相关
+ *==========================================
+ */
+// 对象成员写入
+int lmjcore_obj_member_put(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
+                           const uint8_t *member_name, size_t member_name_len,
+                           const uint8_t *value, size_t value_len) {
+  if (!txn || !obj_ptr || !member_name) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (txn->is_read_only) {
+    return LMJCORE_ERROR_READONLY_TXN;
+  }
+  if (obj_ptr[0] != LMJCORE_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+  // 检查成员名长度
+  if (member_name_len > LMJCORE_MAX_MEMBER_NAME_LEN) {
+    return LMJCORE_ERROR_MEMBER_TOO_LONG;
+  }
+
+  // 在 set 数据库中注册成员名（如果尚未注册）
+  MDB_val set_key = {.mv_size = LMJCORE_PTR_LEN, .mv_data = (void *)obj_ptr};
+  MDB_val set_val = {.mv_size = member_name_len,
+                     .mv_data = (void *)member_name};
+
+  // 使用lmdb数据库的原生检查插入
+  int rc = stats_set_put(txn, &set_key, &set_val, MDB_NODUPDATA);
+  // 有重复的值
+  if (rc == MDB_KEYEXIST) {
+    rc = MDB_SUCCESS;
+  }
+  if (rc == MDB_SUCCESS) {
+    // 构建主键：对象指针 + 成员名
+    size_t key_size = LMJCORE_PTR_LEN + member_name_len;
+    uint8_t key[key_size];
+
+    memcpy(key, obj_ptr, LMJCORE_PTR_LEN);
+    memcpy(key + LMJCORE_PTR_LEN, member_name, member_name_len);
+
+    // 写入 main 数据库
+    MDB_val mdb_key = {.mv_size = key_size, .mv_data = key};
+    MDB_val mdb_val = {.mv_size = value_len, .mv_data = (void *)value};
+
+    rc = stats_main_put(txn, obj_ptr, &mdb_key, &mdb_val);
+
+    if (rc != MDB_SUCCESS) {
+      return rc;
+    }
+    rc = journal_mark(txn, obj_ptr);
+  }
+
+  return rc;
+}
+
+// 注册成员
+int lmjcore_obj_member_register(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
+                                const uint8_t *member_name,
+                                size_t member_name_len) {
+  if (!txn || !obj_ptr || !member_name) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (obj_ptr[0] != LMJCORE_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+  if (txn->is_read_only) {
+    return LMJCORE_ERROR_READONLY_TXN;
+  }
+  // 检查成员名长度
+  if (member_name_len > LMJCORE_MAX_MEMBER_NAME_LEN) {
+    return LMJCORE_ERROR_MEMBER_TOO_LONG;
+  }
+
+  MDB_val key = {.mv_data = (void *)obj_ptr, .mv_size = LMJCORE_PTR_LEN};
+  MDB_val value = {.mv_data = (void *)member_name, .mv_size = member_name_len};
+  int rc = stats_set_put(txn, &key, &value, MDB_NODUPDATA);
+  if (rc == MDB_SUCCESS) {
+    rc = journal_mark(txn, obj_ptr);
+  }
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 删除成员值
+int lmjcore_obj_member_value_del(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
+                                 const uint8_t *member_name,
+                                 size_t member_name_len) {
+  if (!txn || !obj_ptr || !member_name) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (txn->is_read_only) {
+    return LMJCORE_ERROR_READONLY_TXN;
+  }
+  if (obj_ptr[0] != LMJCORE_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+  if (member_name_len > LMJCORE_MAX_MEMBER_NAME_LEN) {
+    return LMJCORE_ERROR_MEMBER_TOO_LONG;
+  }
+
+  uint8_t member_key[LMJCORE_PTR_LEN + member_name_len];
+  memcpy(member_key, obj_ptr, LMJCORE_PTR_LEN);
+  memcpy(member_key + LMJCORE_PTR_LEN, member_name, member_name_len);
+  MDB_val key = {.mv_data = member_key,
+                 .mv_size = LMJCORE_PTR_LEN + member_name_len};
+  int rc = stats_main_del(txn, obj_ptr, &key);
+  if (rc == MDB_SUCCESS) {
+    rc = journal_mark(txn, obj_ptr);
+  }
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_obj_member_get(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
+                           const uint8_t *member_name, size_t member_name_len,
+                           uint8_t *value_buf, size_t value_buf_size,
+                           size_t *value_size_out) {
+  if (!txn || !obj_ptr || !member_name || !value_size_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (obj_ptr[0] != LMJCORE_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+
+  // 确认对象存在
+  int rc = lmjcore_entity_exist(txn, obj_ptr);
+  if (rc <= 0) {
+    return rc == 0 ? LMJCORE_ERROR_ENTITY_NOT_FOUND : rc;
+  }
+
+  // 成员名长度检查
+  if (member_name_len > LMJCORE_MAX_MEMBER_NAME_LEN) {
+    return LMJCORE_ERROR_MEMBER_TOO_LONG;
+  }
+
+  // 初始化
+  *value_size_out = 0;
+
+  // 拼接完整的key
+  uint8_t t_key[LMJCORE_PTR_LEN + member_name_len];
+  memcpy(t_key, obj_ptr, LMJCORE_PTR_LEN);
+  memcpy(t_key + LMJCORE_PTR_LEN, member_name, member_name_len);
+
+  // 查询成员的值
+  MDB_val key = {.mv_data = t_key,
+                 .mv_size = LMJCORE_PTR_LEN + member_name_len};
+  MDB_val value;
+  rc = txn_get(txn, txn->env->main_dbi, &key, &value);
+
+  // 转换 LMDB 错误码为 LMJCore 错误码
+  if (rc == MDB_NOTFOUND) {
+    return LMJCORE_ERROR_MEMBER_NOT_FOUND;
+  }
+
+  if (rc != MDB_SUCCESS) {
+    return rc; // 其他错误
+  }
+
+  // 检查缓冲区是否足够
+  if (value.mv_size > value_buf_size) {
+    return LMJCORE_ERROR_BUFFER_TOO_SMALL;
+  }
+
+  // 将值复制到缓冲区
+  memcpy(value_buf, value.mv_data, value.mv_size);
+  *value_size_out = value.mv_size;
+
+  return LMJCORE_SUCCESS;
+}
+
+/**
+ * @brief 完全删除对象成员（包括注册信息和值）
+ * @param txn 写事务句柄
+ * @param obj_ptr 目标对象指针
+ * @param member_name 成员名称
+ * @param member_name_len 成员名称长度
+ * @return
+ *   - LMJCORE_SUCCESS: 成功
+ *   - LMJCORE_ERROR_*: 参数错误
+ *   - MDB_*: LMDB 错误
+ */
+int lmjcore_obj_member_del(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
+                           const uint8_t *member_name, size_t member_name_len) {
+  // 1. 参数验证
+  if (!txn || !obj_ptr || !member_name) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (txn->is_read_only) {
+    return LMJCORE_ERROR_READONLY_TXN;
+  }
+  if (obj_ptr[0] != LMJCORE_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+  if (member_name_len > LMJCORE_MAX_MEMBER_NAME_LEN) {
+    return LMJCORE_ERROR_MEMBER_TOO_LONG;
+  }
+
+  // 2. 构建完整的 main 库 key: [对象指针][成员名]
+  uint8_t main_key[LMJCORE_PTR_LEN + member_name_len];
+  memcpy(main_key, obj_ptr, LMJCORE_PTR_LEN);
+  memcpy(main_key + LMJCORE_PTR_LEN, member_name, member_name_len);
+
+  // 3. 在 main 库中删除成员值
+  MDB_val main_key_val = {.mv_data = main_key,
+                          .mv_size = LMJCORE_PTR_LEN + member_name_len};
+
+  int rc = stats_main_del(txn, obj_ptr, &main_key_val);
+  // 成员值不存在是允许的（缺失值状态），所以忽略 MDB_NOTFOUND
+  if (rc != MDB_SUCCESS && rc != MDB_NOTFOUND) {
+    return rc; // 其他错误才返回
+  }
+
+  // 4. 在 set 库中删除成员注册信息
+  MDB_val set_key = {.mv_data = (void *)obj_ptr, .mv_size = LMJCORE_PTR_LEN};
+  MDB_val set_val = {.mv_data = (void *)member_name,
+                     .mv_size = member_name_len};
+
+  rc = stats_set_del(txn, &set_key, &set_val);
+  if (rc != MDB_SUCCESS) {
+    return rc; // 注册信息必须存在，所以任何错误都返回
+  }
+
+  // 5. 记入脏对象日志
+  rc = journal_mark(txn, obj_ptr);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+
+  return LMJCORE_SUCCESS;
+}
+
+// 统计对象成员名长度
+int lmjcore_obj_stat_members(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
+                             size_t *total_member_len_out,
+                             size_t *member_count_out) {
+  if (obj_ptr[0] != LMJCORE_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+  return set_stat_values(txn, obj_ptr, total_member_len_out, member_count_out);
+}
+
+// 获取对象成员列表
+int lmjcore_obj_member_list(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
+                            uint8_t *result_buf, size_t result_buf_size,
+                            lmjcore_result_set **result_head) {
+  if (obj_ptr[0] != LMJCORE_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+  return set_get_all_values(txn, obj_ptr, result_buf, result_buf_size,
+                            result_head);
+}
+
+/*
+ *==========================================
+ * 集合相关
+ *==========================================
+ */
+// 创建集合
+int lmjcore_set_create(lmjcore_txn *txn, lmjcore_ptr ptr_out) {
+  if (!txn || !ptr_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (txn->is_read_only) {
+    return LMJCORE_ERROR_READONLY_TXN;
+  }
+
+  // 生成指针
+  int rc = txn->env->ptr_generator(txn->env->ptr_gen_ctx, ptr_out);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  // 确保指针类型为集合
+  ptr_out[0] = LMJCORE_SET;
+
+  // 在 set 数据库中创建空列表（不存储任何值，仅表示集合存在）
+  MDB_val key, data;
+  key.mv_data = ptr_out;
+  key.mv_size = LMJCORE_PTR_LEN;
+
+  data.mv_data = NULL;
+  data.mv_size = 0;
+
+  rc = stats_set_put(txn, &key, &data, 0);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+
+  return LMJCORE_SUCCESS;
+}
+
+// 向集合添加元素
+int lmjcore_set_add(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
+                    const uint8_t *value, size_t value_len) {
+  if (!txn || !set_ptr || !value) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (txn->is_read_only) {
+    return LMJCORE_ERROR_READONLY_TXN;
+  }
+  if (set_ptr[0] != LMJCORE_SET) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+
+  MDB_val key = {.mv_size = LMJCORE_PTR_LEN, .mv_data = (void *)set_ptr};
+  MDB_val mdb_val = {.mv_size = value_len, .mv_data = (void *)value};
+
+  int rc = stats_set_put(txn, &key, &mdb_val, 0);
+  if (rc == MDB_KEYEXIST) {
+    return LMJCORE_ERROR_MEMBER_EXISTS;
+  }
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+
+  return LMJCORE_SUCCESS;
+}
+
+// 删除集合
+int lmjcore_set_del(lmjcore_txn *txn, const lmjcore_ptr set_ptr) {
+  if (!txn || !set_ptr) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (txn->is_read_only) {
+    return LMJCORE_ERROR_READONLY_TXN;
+  }
+  if (set_ptr[0] != LMJCORE_SET) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+
+  MDB_val key = {.mv_data = (void *)set_ptr, .mv_size = LMJCORE_PTR_LEN};
+  int rc = txn_del(txn, txn->env->set_dbi, &key, NULL);
+  if (rc == MDB_SUCCESS) {
+    rc = stats_drop(txn, set_ptr);
+  }
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 从集合中删除元素
+int lmjcore_set_remove(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
+                       const uint8_t *element, size_t element_len) {
+  if (!txn || !set_ptr || !element) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (txn->is_read_only) {
+    return LMJCORE_ERROR_READONLY_TXN;
+  }
+  if (set_ptr[0] != LMJCORE_SET) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+
+  MDB_val key = {.mv_data = (void *)set_ptr, .mv_size = LMJCORE_PTR_LEN};
+  MDB_val value = {.mv_data = (void *)element, .mv_size = element_len};
+  int rc = stats_set_del(txn, &key, &value);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 检查集合中是否存在指定元素
+int lmjcore_set_contains(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
+                         const uint8_t *element, size_t element_len) {
+  if (!txn || !set_ptr || !element) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (set_ptr[0] != LMJCORE_SET) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+
+  MDB_val key = {.mv_data = (void *)set_ptr, .mv_size = LMJCORE_PTR_LEN};
+  MDB_val value = {.mv_data = (void *)element, .mv_size = element_len};
+
+  // 按键和值精确匹配集合元素
+  MDB_cursor *cursor;
+  int rc = txn_cursor(txn, txn->env->set_dbi, &cursor);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  rc = mdb_cursor_get(cursor, &key, &value, MDB_GET_BOTH);
+  if (rc == MDB_SUCCESS) {
+    return 1; // 存在
+  }
+  if (rc == MDB_NOTFOUND) {
+    return 0; // 不存在
+  }
+  return rc; // 错误
+}
+
+// 读取集合的所有元素
+int lmjcore_set_get(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
+                    uint8_t *result_buf, size_t result_buf_size,
+                    lmjcore_result_set **result_head) {
+  if (set_ptr[0] != LMJCORE_SET) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+  return set_get_all_values(txn, set_ptr, result_buf, result_buf_size,
+                            result_head);
+}
+
+// 统计集合元素
+int lmjcore_set_stat(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
+                     size_t *total_value_len_out, size_t *element_count_out) {
+  if (set_ptr[0] != LMJCORE_SET) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+  return set_stat_values(txn, set_ptr, total_value_len_out, element_count_out);
+}
+
+// 统计集合元素数量
+int lmjcore_set_count(lmjcore_txn *txn, const lmjcore_ptr set_ptr,
+                      size_t *element_count_out) {
+  if (!txn || !set_ptr || !element_count_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (set_ptr[0] != LMJCORE_SET) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+  *element_count_out = 0;
+
+  entity_stats st;
+  int rc;
+  if (stats_lookup(txn, set_ptr, &st, &rc)) {
+    if (rc == MDB_SUCCESS) {
+      *element_count_out = st.members;
+    }
+    return rc;
+  }
+
+  // 未启用实体统计时由 LMDB 给出重复值个数，不必逐个遍历
+  MDB_cursor *cursor;
+  rc = txn_cursor(txn, txn->env->set_dbi, &cursor);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  MDB_val key = {.mv_data = (void *)set_ptr, .mv_size = LMJCORE_PTR_LEN};
+  MDB_val value;
+  rc = mdb_cursor_get(cursor, &key, &value, MDB_SET);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  return mdb_cursor_count(cursor, element_count_out);
+}
+
+/**
+ * @brief 统计对象成员的数据大小
+ * @param txn 事务句柄
+ * @param obj_ptr 对象指针
+ * @param total_value_len_out 返回所有成员值的总字节数
+ * @param total_value_count_out 返回所有成员值的数量
+ * @return 错误码
+ */
+int lmjcore_obj_stat_values(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
+                            size_t *total_value_len_out,
+                            size_t *total_value_count_out) {
+  if (!txn || !obj_ptr || !total_value_len_out || !total_value_count_out)
+    return LMJCORE_ERROR_NULL_POINTER;
+
+  *total_value_len_out = 0;
+  *total_value_count_out = 0;
+
+  // 启用实体统计时直接读取维护的记录（没有记录即没有成员值）
+  entity_stats st;
+  int rc;
+  if (stats_lookup(txn, obj_ptr, &st, &rc)) {
+    if (rc == MDB_SUCCESS) {
+      *total_value_len_out = st.value_bytes;
+      *total_value_count_out = st.values;
+    }
+    return rc == MDB_NOTFOUND ? LMJCORE_SUCCESS : rc;
+  }
+
+  MDB_cursor *cursor = NULL;
+  rc = txn_cursor(txn, txn->env->main_dbi, &cursor);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+
+  // 构建搜索key - 对象指针
+  MDB_val key = {.mv_data = (void *)obj_ptr, .mv_size = LMJCORE_PTR_LEN};
+  MDB_val value;
+
+  // 使用MDB_SET_RANGE定位到该对象的第一个成员
+  rc = mdb_cursor_get(cursor, &key, &value, MDB_SET_RANGE);
+  if (rc == MDB_NOTFOUND) {
+    // 对象没有成员，这是正常情况
+    rc = LMJCORE_SUCCESS;
+    goto cleanup;
+  }
+  if (rc != MDB_SUCCESS) {
+    goto cleanup;
+  }
+
+  // 遍历所有属于该对象的成员
+  do {
+    // 检查当前key是否还属于同一个对象
+    if (key.mv_size < LMJCORE_PTR_LEN ||
+        memcmp(key.mv_data, obj_ptr, LMJCORE_PTR_LEN) != 0) {
+      // 已经移动到下一个对象，结束遍历
+      break;
+    }
+
+    *total_value_count_out += 1;
+    *total_value_len_out += value.mv_size;
+
+    // 移动到下一个key
+    rc = mdb_cursor_get(cursor, &key, &value, MDB_NEXT);
+  } while (rc == MDB_SUCCESS);
+
+  // MDB_NOTFOUND表示遍历结束，这是正常情况
+  if (rc == MDB_NOTFOUND) {
+    rc = LMJCORE_SUCCESS;
+  }
+
+cleanup:
+  // 如果出现错误，重置统计结果
+  if (rc != LMJCORE_SUCCESS) {
+    *total_value_count_out = 0;
+    *total_value_len_out = 0;
+  }
+
+  return rc;
+}
+
+/*
+ *==========================================
+ * 审计与修复
+ *==========================================
+ */
+/*
+  report_buf内存结构
+  ---------------------  <-- report_buf(report_head)
+  |report_head         |
+  ---------------------
+  |report_descriptor   | <-- 前往后
+  ----------------------
+  |....                |
+  ----------------------
+  | member_name        | <-- 由后往前
+  ---------------------- <-- data_offset(report_buf_size)
+  */
+int lmjcore_audit_object(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
+                         uint8_t *report_buf, size_t report_buf_size,
+                         lmjcore_audit_report **report_head) {
+  if (!txn || !obj_ptr || !report_buf || !report_head) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (obj_ptr[0] != LMJCORE_OBJ) {
+    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
+  }
+
+  if (report_buf_size < sizeof(lmjcore_audit_report)) {
+    return LMJCORE_ERROR_BUFFER_TOO_SMALL;
+  }
+
+  // 初始化报告头
+  lmjcore_audit_report *report = (lmjcore_audit_report *)report_buf;
+  report->audit_count = 0;
+  *report_head = report;
+
+  size_t report_desc_offset = sizeof(lmjcore_audit_report); // 描述符数组偏移量
+  size_t data_offset = report_buf_size;                     // 数据偏移量
+
+  MDB_cursor *cursor_main, *cursor_set;
+  int rc = txn_cursor(txn, txn->env->main_dbi, &cursor_main); // main库游标
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  rc = txn_cursor(txn, txn->env->set_dbi, &cursor_set); // set库游标
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+
+  MDB_val obj = {.mv_data = (void *)obj_ptr, .mv_size = LMJCORE_PTR_LEN};
+  MDB_val key = obj; // 第一个成员使用前缀匹配
+  MDB_val value;
+  rc = mdb_cursor_get(cursor_main, &key, &value, MDB_SET_RANGE);
+  while (rc == MDB_SUCCESS) {
+    // 判断是否处于目标对象中
+    if (memcmp(obj_ptr, key.mv_data, LMJCORE_PTR_LEN) != 0) {
+      rc = LMJCORE_SUCCESS;
+      break;
+    }
+    // 判断成员名是否在set库中注册
+    MDB_val member_name = {.mv_data = key.mv_data + LMJCORE_PTR_LEN,
+                           .mv_size = key.mv_size - LMJCORE_PTR_LEN};
+    int exist = mdb_cursor_get(cursor_set, &obj, &member_name, MDB_GET_BOTH);
+    // 查询set库如果找到会返回MDB_SUCCESS未找到会返回MDB_NOTFOUND(幽灵成员)
+    if (exist == MDB_NOTFOUND) {
+      int error = add_audit(report_buf, &member_name, &value, obj_ptr,
+                            &data_offset, &report_desc_offset);
+      if (error != LMJCORE_SUCCESS) {
+        rc = error;
+        goto cleanup;
+      }
+      // 记录审计数量
+      report->audit_count++;
+    } else if (exist != MDB_SUCCESS) {
+      rc = exist;
+      goto cleanup;
+    }
+    rc = mdb_cursor_get(cursor_main, &key, &value, MDB_NEXT);
+  }
+  if (rc == MDB_NOTFOUND) {
+    rc = LMJCORE_SUCCESS;
+  }
+cleanup:
+  return rc;
+}
+
+int lmjcore_repair_object(lmjcore_txn *txn, uint8_t *report_buf,
+                          size_t report_buf_size,
+                          lmjcore_audit_report *report) {
+  if (!txn || !report || !report_buf) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  // 没有错误
+  if (report->audit_count == 0) {
+    return LMJCORE_SUCCESS;
+  }
+
+  int final_result = LMJCORE_SUCCESS;
+
+  // 遍历整个错误列表
+  for (size_t i = 0; i < report->audit_count; i++) {
+    lmjcore_audit_descriptor *desc = &report->audit_descriptor[i];
+
+    // 验证成员名偏移和长度
+    if (desc->member.member_name.value_offset +
+            desc->member.member_name.value_len >
+        report_buf_size) {
+      final_result = LMJCORE_ERROR_INVALID_PARAM;
+      break;
+    }
+
+    // 成员值的验证
+    if (desc->member.member_value.value_offset +
+            desc->member.member_value.value_len >
+        report_buf_size) {
+      final_result = LMJCORE_ERROR_INVALID_PARAM;
+      break;
+    }
+
+    // 构建幽灵成员的完整key: <LMJCORE_PTR_LEN字节指针> + <成员名>
+    size_t key_len = LMJCORE_PTR_LEN + desc->member.member_name.value_len;
+    uint8_t ghost_key[key_len];
+
+    memcpy(ghost_key, desc->ptr, LMJCORE_PTR_LEN);
+    memcpy(ghost_key + LMJCORE_PTR_LEN,
+           report_buf + desc->member.member_name.value_offset,
+           desc->member.member_name.value_len);
+
+    MDB_val key = {.mv_data = ghost_key, .mv_size = key_len};
+
+    int error = stats_main_del(txn, desc->ptr, &key);
+
+    if (error != MDB_SUCCESS) {
+      final_result = error;
+      break; // 遇到第一个错误就停止，保持事务一致性
+    }
+  }
+
+  return final_result;
+}
+
+// ==================== 全库审计 ====================
+
+#define AUDIT_DEFAULT_THREADS 4
+#define AUDIT_RANGES_PER_THREAD 8
+// 每扫描这么多实体检查一次停止标志
+#define AUDIT_STOP_BATCH 1024
+
+// 所有工作线程共享的审计任务
+typedef struct {
+  lmjcore_shared_snapshot *snap;
+  const lmjcore_audit_scan_opts *opts;
+  MDB_dbi main_dbi;
+  MDB_dbi set_dbi;
+  uint8_t (*bounds)[LMJCORE_PTR_LEN]; // 区间 i 为 [bounds[i-1], bounds[i])
+  size_t bound_count;                 // 区间数为 bound_count + 1
+  atomic_size_t next;                 // 下一个待领取的区间
+  atomic_bool stop;
+  pthread_mutex_t lock;           // 串行化回调，保护以下字段
+  int error;                      // 第一个错误或回调的中止值
+  lmjcore_audit_scan_stats total; // 各线程汇总的计数
+} audit_job;
+
+typedef struct {
+  audit_job *job;
+  size_t index; // 使用的共享快照工作事务
+} audit_worker;
+
+// 键与区间边界比较：按前 LMJCORE_PTR_LEN 字节，较短的键在前
+static int audit_ptr_cmp(const MDB_val *key, const uint8_t *ptr) {
+  size_t n = key->mv_size < LMJCORE_PTR_LEN ? key->mv_size : LMJCORE_PTR_LEN;
+  int diff = memcmp(key->mv_data, ptr, n);
+  if (diff != 0) {
+    return diff;
+  }
+  return n < LMJCORE_PTR_LEN ? -1 : 0;
+}
+
+static bool audit_in_range(const MDB_val *key, const uint8_t *end) {
+  return !end || audit_ptr_cmp(key, end) < 0;
+}
+
+// 把 first 与 last 之间（同一类型字节下）按键值插值出 n - 1 个内部边界
+static void audit_interpolate(const uint8_t *first, const uint8_t *last,
+                              size_t n, uint8_t (*bounds)[LMJCORE_PTR_LEN],
+                              size_t *count) {
+  size_t common = 0;
+  while (common < LMJCORE_PTR_LEN && first[common] == last[common]) {
+    common++;
+  }
+  if (common == LMJCORE_PTR_LEN) {
+    return;
+  }
+  // 取公共前缀之后最多 8 个字节作为大端整数
+  size_t width = LMJCORE_PTR_LEN - common < 8 ? LMJCORE_PTR_LEN - common : 8;
+  uint64_t a = 0, b = 0;
+  for (size_t i = 0; i < width; i++) {
+    a = a << 8 | first[common + i];
+    b = b << 8 | last[common + i];
+  }
+  uint64_t span = b - a;
+  for (size_t j = 1; j < n; j++) {
+    uint64_t v = a + span / n * j + span % n * j / n;
+    uint8_t bound[LMJCORE_PTR_LEN] = {0};
+    memcpy(bound, first, common);
+    for (size_t i = 0; i < width; i++) {
+      bound[common + i] = (uint8_t)(v >> (8 * (width - 1 - i)));
+    }
+    if (*count > 0 && memcmp(bounds[*count - 1], bound, LMJCORE_PTR_LEN) >= 0) {
+      continue; // 跳过重复边界，保持严格递增
+    }
+    memcpy(bounds[(*count)++], bound, LMJCORE_PTR_LEN);
+  }
+}
+
+// 收集库中各类型字节下的首尾实体（只定位段首段尾，不遍历条目）
+static int audit_segments(MDB_txn *txn, MDB_dbi dbi,
+                          uint8_t (*firsts)[LMJCORE_PTR_LEN],
+                          uint8_t (*lasts)[LMJCORE_PTR_LEN], size_t *segments) {
+  MDB_cursor *cursor = NULL;
+  int rc = mdb_cursor_open(txn, dbi, &cursor);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+
+  MDB_val key = {0}, data;
+  rc = mdb_cursor_get(cursor, &key, &data, MDB_FIRST);
+  while (rc == MDB_SUCCESS) {
+    uint8_t type = ((const uint8_t *)key.mv_data)[0];
+    memset(firsts[*segments], 0, LMJCORE_PTR_LEN);
+    memcpy(firsts[*segments], key.mv_data,
+           key.mv_size < LMJCORE_PTR_LEN ? key.mv_size : LMJCORE_PTR_LEN);
+
+    uint8_t next_type = (uint8_t)(type + 1);
+    key.mv_size = 1;
+    key.mv_data = &next_type;
+    rc = type == UINT8_MAX ? MDB_NOTFOUND
+                           : mdb_cursor_get(cursor, &key, &data, MDB_SET_RANGE);
+    int last_rc = rc == MDB_SUCCESS
+                      ? mdb_cursor_get(cursor, &key, &data, MDB_PREV_NODUP)
+                      : mdb_cursor_get(cursor, &key, &data, MDB_LAST);
+    if (last_rc != MDB_SUCCESS || (rc != MDB_SUCCESS && rc != MDB_NOTFOUND)) {
+      mdb_cursor_close(cursor);
+      return last_rc != MDB_SUCCESS ? last_rc : rc;
+    }
+    memset(lasts[*segments], 0, LMJCORE_PTR_LEN);
+    memcpy(lasts[*segments], key.mv_data,
+           key.mv_size < LMJCORE_PTR_LEN ? key.mv_size : LMJCORE_PTR_LEN);
+    (*segments)++;
+    if (rc == MDB_SUCCESS) {
+      rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT_NODUP);
+    }
+  }
+  mdb_cursor_close(cursor);
+  return rc == MDB_NOTFOUND ? MDB_SUCCESS : rc;
+}
+
+// 将实体键空间切成约 want 个区间：每种类型字节一段，段内按首尾实体插值
+static int audit_split(audit_job *job, MDB_txn *txn, size_t want) {
+  uint8_t firsts[256][LMJCORE_PTR_LEN], lasts[256][LMJCORE_PTR_LEN];
+  size_t segments = 0;
+  int rc = audit_segments(txn, job->set_dbi, firsts, lasts, &segments);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  if (segments == 0) {
+    return LMJCORE_SUCCESS; // 空库只有一个区间
+  }
+
+  size_t per_segment = want / segments ? want / segments : 1;
+  job->bounds = calloc(segments * per_segment, LMJCORE_PTR_LEN);
+  if (!job->bounds) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  for (size_t i = 0; i < segments; i++) {
+    if (i > 0) {
+      memcpy(job->bounds[job->bound_count++], firsts[i], LMJCORE_PTR_LEN);
+    }
+    audit_interpolate(firsts[i], lasts[i], per_segment, job->bounds,
+                      &job->bound_count);
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 记录一条发现：计数总是累加，命中 report_mask 时串行调用回调
+static int audit_report(audit_job *job, lmjcore_audit_scan_stats *stats,
+                        const lmjcore_audit_finding *finding) {
+  switch (finding->kind) {
+  case LMJCORE_AUDIT_GHOST_MEMBER:
+    stats->ghost_members++;
+    break;
+  case LMJCORE_AUDIT_MISSING_VALUE:
+    stats->missing_values++;
+    break;
+  case LMJCORE_AUDIT_EMPTY_OBJECT:
+    stats->empty_objects++;
+    break;
+  default:
+    stats->type_mismatches++;
+    break;
+  }
+
+  const lmjcore_audit_scan_opts *opts = job->opts;
+  unsigned int mask = opts->report_mask ? opts->report_mask : LMJCORE_AUDIT_ALL;
+  if (!opts->on_finding || !(mask & finding->kind)) {
+    return LMJCORE_SUCCESS;
+  }
+  pthread_mutex_lock(&job->lock);
+  int rc = atomic_load(&job->stop) ? LMJCORE_ERROR_CANCELLED
+                                   : opts->on_finding(opts->ctx, finding);
+  pthread_mutex_unlock(&job->lock);
+  return rc;
+}
+
+// 未登记实体的 main 条目：对象指针下为幽灵成员，其余为类型异常
+static int audit_report_orphan(audit_job *job, lmjcore_audit_scan_stats *stats,
+                               const MDB_val *key, const MDB_val *value) {
+  const uint8_t *k = key->mv_data;
+  bool obj = key->mv_size >= LMJCORE_PTR_LEN && k[0] == LMJCORE_OBJ;
+  bool named = key->mv_size >= LMJCORE_PTR_LEN;
+  lmjcore_audit_finding finding = {
+      .kind = obj ? LMJCORE_AUDIT_GHOST_MEMBER : LMJCORE_AUDIT_TYPE_MISMATCH,
+      .ptr = k,
+      .ptr_len = named ? LMJCORE_PTR_LEN : key->mv_size,
+      .member_name = named ? k + LMJCORE_PTR_LEN : NULL,
+      .member_name_len = named ? key->mv_size - LMJCORE_PTR_LEN : 0,
+      .value = value->mv_data,
+      .value_len = value->mv_size};
+  return audit_report(job, stats, &finding);
+}
+
+// 以归并方式扫描一个区间：set 中每个实体的成员名与 main 中同一指针下的键
+// 都按相同的字节序排列，两个游标各前进一遍即可完成比对
+static int audit_range(audit_job *job, MDB_cursor *set_cursor,
+                       MDB_cursor *main_cursor, const uint8_t *start,
+                       const uint8_t *end, lmjcore_audit_scan_stats *stats) {
+  MDB_val sk = {0}, sv, mk = {0}, mv;
+  MDB_cursor_op first = MDB_FIRST;
+  if (start) {
+    sk = (MDB_val){.mv_size = LMJCORE_PTR_LEN, .mv_data = (void *)start};
+    mk = sk;
+    first = MDB_SET_RANGE;
+  }
+  int rc = mdb_cursor_get(set_cursor, &sk, &sv, first);
+  int mrc = mdb_cursor_get(main_cursor, &mk, &mv, first);
+  if (mrc != MDB_SUCCESS && mrc != MDB_NOTFOUND) {
+    return mrc;
+  }
+#define MAIN_VALID (mrc == MDB_SUCCESS && audit_in_range(&mk, end))
+#define MAIN_NEXT()                                                            \
+  do {                                                                         \
+    stats->main_entries++;                                                     \
+    mrc = mdb_cursor_get(main_cursor, &mk, &mv, MDB_NEXT);                     \
+  } while (0)
+
+  int err = LMJCORE_SUCCESS;
+  size_t batch = 0;
+  while (err == LMJCORE_SUCCESS && rc == MDB_SUCCESS &&
+         audit_in_range(&sk, end)) {
+    if (++batch == AUDIT_STOP_BATCH) {
+      batch = 0;
+      if (atomic_load(&job->stop)) {
+        err = LMJCORE_ERROR_CANCELLED;
+        break;
+      }
+    }
+    const uint8_t *ptr = sk.mv_data;
+    bool valid_key = sk.mv_size == LMJCORE_PTR_LEN;
+    bool obj = valid_key && ptr[0] == LMJCORE_OBJ;
+    stats->entities++;
+
+    // main 中排在当前实体之前的条目都没有对应实体（键长异常的实体不参与
+    // 比对，之前的条目留给下一个实体处理）
+    while (err == LMJCORE_SUCCESS && valid_key && MAIN_VALID &&
+           audit_ptr_cmp(&mk, ptr) < 0) {
+      err = audit_report_orphan(job, stats, &mk, &mv);
+      MAIN_NEXT();
+    }
+    if (err != LMJCORE_SUCCESS) {
+      break;
+    }
+
+    if (!valid_key || (!obj && ptr[0] != LMJCORE_SET)) {
+      lmjcore_audit_finding finding = {.kind = LMJCORE_AUDIT_TYPE_MISMATCH,
+                                       .ptr = ptr,
+                                       .ptr_len = sk.mv_size};
+      err = audit_report(job, stats, &finding);
+    }
+
+    // 逐个成员名与 main 中同一指针下的键比对
+    size_t members = 0;
+    while (err == LMJCORE_SUCCESS && rc == MDB_SUCCESS) {
+      stats->set_entries++;
+      if (sv.mv_size > 0) { // 跳过登记占位
+        members++;
+      }
+      if (sv.mv_size > 0 && obj) {
+        int cmp = 1;
+        while (err == LMJCORE_SUCCESS && MAIN_VALID &&
+               mk.mv_size >= LMJCORE_PTR_LEN &&
+               memcmp(mk.mv_data, ptr, LMJCORE_PTR_LEN) == 0) {
+          MDB_val name = {.mv_size = mk.mv_size - LMJCORE_PTR_LEN,
+                          .mv_data = (uint8_t *)mk.mv_data + LMJCORE_PTR_LEN};
+          cmp = mdb_dcmp(mdb_cursor_txn(set_cursor), job->set_dbi, &name, &sv);
+          if (cmp >= 0) {
+            break;
+          }
+          err = audit_report_orphan(job, stats, &mk, &mv);
+          MAIN_NEXT();
+          cmp = 1;
+        }
+        if (err != LMJCORE_SUCCESS) {
+          break;
+        }
+        if (cmp == 0) {
+          MAIN_NEXT(); // 成员名与值一一对应
+        } else {
+          lmjcore_audit_finding finding = {
+              .kind = LMJCORE_AUDIT_MISSING_VALUE,
+              .ptr = ptr,
+              .ptr_len = LMJCORE_PTR_LEN,
+              .member_name = sv.mv_data,
+              .member_name_len = sv.mv_size};
+          err = audit_report(job, stats, &finding);
+        }
+      }
+      rc = mdb_cursor_get(set_cursor, &sk, &sv, MDB_NEXT_DUP);
+    }
+    if (rc == MDB_NOTFOUND) {
+      rc = MDB_SUCCESS;
+    }
+    if (err != LMJCORE_SUCCESS || rc != MDB_SUCCESS) {
+      break;
+    }
+
+    // 剩余同一指针下的 main 条目：对象为幽灵成员，集合不应有成员值
+    while (err == LMJCORE_SUCCESS && MAIN_VALID && valid_key &&
+           mk.mv_size >= LMJCORE_PTR_LEN &&
+           memcmp(mk.mv_data, ptr, LMJCORE_PTR_LEN) == 0) {
+      lmjcore_audit_finding finding = {
+          .kind = obj ? LMJCORE_AUDIT_GHOST_MEMBER : LMJCORE_AUDIT_TYPE_MISMATCH,
+          .ptr = ptr,
+          .ptr_len = LMJCORE_PTR_LEN,
+          .member_name = (uint8_t *)mk.mv_data + LMJCORE_PTR_LEN,
+          .member_name_len = mk.mv_size - LMJCORE_PTR_LEN,
+          .value = mv.mv_data,
+          .value_len = mv.mv_size};
+      err = audit_report(job, stats, &finding);
+      MAIN_NEXT();
+    }
+    if (err == LMJCORE_SUCCESS && obj && members == 0) {
+      lmjcore_audit_finding finding = {.kind = LMJCORE_AUDIT_EMPTY_OBJECT,
+                                       .ptr = ptr,
+                                       .ptr_len = LMJCORE_PTR_LEN};
+      err = audit_report(job, stats, &finding);
+    }
+    if (err == LMJCORE_SUCCESS) {
+      rc = mdb_cursor_get(set_cursor, &sk, &sv, MDB_NEXT_NODUP);
+    }
+  }
+
+  // 区间内最后一个实体之后的 main 条目
+  while (err == LMJCORE_SUCCESS && (rc == MDB_SUCCESS || rc == MDB_NOTFOUND) &&
+         MAIN_VALID) {
+    err = audit_report_orphan(job, stats, &mk, &mv);
+    MAIN_NEXT();
+  }
+#undef MAIN_VALID
+#undef MAIN_NEXT
+
+  if (err != LMJCORE_SUCCESS) {
+    return err;
+  }
+  if (rc != MDB_SUCCESS && rc != MDB_NOTFOUND) {
+    return rc;
+  }
+  return mrc == MDB_SUCCESS || mrc == MDB_NOTFOUND ? LMJCORE_SUCCESS : mrc;
+}
+
+// 填写耗时与吞吐量
+static void audit_finish_stats(lmjcore_audit_scan_stats *stats,
+                               uint64_t started_ms) {
+  stats->elapsed_ms = monotonic_ms() - started_ms;
+  double seconds =
+      (stats->elapsed_ms ? (double)stats->elapsed_ms : 1.0) / 1000.0;
+  stats->entries_per_sec =
+      (double)(stats->set_entries + stats->main_entries) / seconds;
+}
+
+static void audit_fail(audit_job *job, int rc) {
+  pthread_mutex_lock(&job->lock);
+  if (job->error == LMJCORE_SUCCESS) {
+    job->error = rc;
+  }
+  pthread_mutex_unlock(&job->lock);
+  atomic_store(&job->stop, true);
+}
+
+// 审计工作线程：领取区间直到取完、出错或被中止
+static void *audit_worker_main(void *arg) {
+  audit_worker *worker = arg;
+  audit_job *job = worker->job;
+  lmjcore_audit_scan_stats stats = {0};
+  MDB_cursor *set_cursor = NULL, *main_cursor = NULL;
+
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_shared_snapshot_txn(job->snap, worker->index, &txn);
+  if (rc == LMJCORE_SUCCESS) {
+    rc = mdb_cursor_open(txn->mdb_txn, job->set_dbi, &set_cursor);
+  }
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_cursor_open(txn->mdb_txn, job->main_dbi, &main_cursor);
+  }
+  while (rc == LMJCORE_SUCCESS && !atomic_load(&job->stop)) {
+    size_t i = atomic_fetch_add(&job->next, 1);
+    if (i > job->bound_count) {
+      break;
+    }
+    const uint8_t *start = i > 0 ? job->bounds[i - 1] : NULL;
+    const uint8_t *end = i < job->bound_count ? job->bounds[i] : NULL;
+    rc = audit_range(job, set_cursor, main_cursor, start, end, &stats);
+  }
+  if (main_cursor) {
+    mdb_cursor_close(main_cursor);
+  }
+  if (set_cursor) {
+    mdb_cursor_close(set_cursor);
+  }
+  if (rc != LMJCORE_SUCCESS && rc != LMJCORE_ERROR_CANCELLED) {
+    audit_fail(job, rc);
+  }
+
+  pthread_mutex_lock(&job->lock);
+  job->total.entities += stats.entities;
+  job->total.set_entries += stats.set_entries;
+  job->total.main_entries += stats.main_entries;
+  job->total.ghost_members += stats.ghost_members;
+  job->total.missing_values += stats.missing_values;
+  job->total.empty_objects += stats.empty_objects;
+  job->total.type_mismatches += stats.type_mismatches;
+  pthread_mutex_unlock(&job->lock);
+  return NULL;
+}
+
+int lmjcore_audit_scan(lmjcore_env *env, const lmjcore_audit_scan_opts *opts,
+                       lmjcore_audit_scan_stats *stats_out) {
+  if (!env) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  lmjcore_audit_scan_opts defaults = {0};
+  if (!opts) {
+    opts = &defaults;
+  }
+  size_t threads = opts->threads ? opts->threads : AUDIT_DEFAULT_THREADS;
+  size_t ranges = opts->ranges ? opts->ranges
+                               : threads * AUDIT_RANGES_PER_THREAD;
+
+  audit_job job = {.opts = opts,
+                   .main_dbi = env->main_dbi,
+                   .set_dbi = env->set_dbi};
+  atomic_init(&job.next, 0);
+  atomic_init(&job.stop, false);
+  int rc = lmjcore_shared_snapshot_create(env, threads, &job.snap);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  uint64_t started_ms = monotonic_ms();
+  lmjcore_shared_snapshot_txn_id(job.snap, &job.total.txn_id);
+
+  lmjcore_txn *txn = NULL;
+  rc = lmjcore_shared_snapshot_txn(job.snap, 0, &txn);
+  if (rc == LMJCORE_SUCCESS) {
+    rc = audit_split(&job, txn->mdb_txn, ranges);
+  }
+  audit_worker *workers = NULL;
+  pthread_t *tids = NULL;
+  if (rc == LMJCORE_SUCCESS) {
+    workers = calloc(threads, sizeof(audit_worker));
+    tids = calloc(threads, sizeof(pthread_t));
+    if (!workers || !tids) {
+      rc = LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+  }
+  if (rc != LMJCORE_SUCCESS) {
+    free(workers);
+    free(tids);
+    free(job.bounds);
+    lmjcore_shared_snapshot_destroy(job.snap);
+    return rc;
+  }
+
+  pthread_mutex_init(&job.lock, NULL);
+  size_t running = 0;
+  for (; running < threads; running++) {
+    workers[running] = (audit_worker){.job = &job, .index = running};
+    if (pthread_create(&tids[running], NULL, audit_worker_main,
+                       &workers[running]) != 0) {
+      break;
+    }
+  }
+  if (running == 0) {
+    // 无法创建线程时由调用线程自己完成
+    workers[0] = (audit_worker){.job = &job, .index = 0};
+    audit_worker_main(&workers[0]);
+  }
+  for (size_t i = 0; i < running; i++) {
+    pthread_join(tids[i], NULL);
+  }
+  pthread_mutex_destroy(&job.lock);
+
+  rc = job.error;
+  audit_finish_stats(&job.total, started_ms);
+  if (stats_out) {
+    *stats_out = job.total;
+  }
+
+  free(workers);
+  free(tids);
+  free(job.bounds);
+  lmjcore_shared_snapshot_destroy(job.snap);
+  return rc;
+}
+
+// ==================== 增量审计 ====================
+
+// 启用或关闭脏对象日志
+int lmjcore_journal_set(lmjcore_env *env, bool enabled) {
+  if (!env) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (!compact_lock_idle(env)) {
+    return LMJCORE_ERROR_BUSY;
+  }
+  if (atomic_load(&env->journal_enabled) == enabled) {
+    pthread_mutex_unlock(&env->compact.lock);
+    return LMJCORE_SUCCESS;
+  }
+  if (!enabled) {
+    int rc = optional_db_drop(env, env->journal_dbi, &env->journal_enabled);
+    pthread_mutex_unlock(&env->compact.lock);
+    return rc;
+  }
+
+  // 持有写锁期间没有其他写事务，在提交前切换标志，之后开始的写事务
+  // 一定能看到新的状态
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(env, NULL, 0, &txn);
+  if (rc == LMJCORE_SUCCESS) {
+    rc = mdb_dbi_open(txn->mdb_txn, JOURNAL_DB_NAME, MDB_CREATE,
+                      &env->journal_dbi);
+    if (rc != MDB_SUCCESS) {
+      lmjcore_txn_abort(txn);
+    }
+  }
+  if (rc == MDB_SUCCESS) {
+    atomic_store(&env->journal_enabled, true);
+    rc = lmjcore_txn_commit(txn);
+    if (rc != LMJCORE_SUCCESS) {
+      atomic_store(&env->journal_enabled, false);
+    }
+  }
+  pthread_mutex_unlock(&env->compact.lock);
+  return rc;
+}
+
+// 查询尚未检查的脏对象数
+int lmjcore_journal_pending(lmjcore_env *env, size_t *count_out) {
+  if (!env || !count_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (!atomic_load(&env->journal_enabled)) {
+    return LMJCORE_ERROR_JOURNAL_DISABLED;
+  }
+
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  MDB_stat st;
+  rc = mdb_stat(txn->mdb_txn, env->journal_dbi, &st);
+  lmjcore_txn_abort(txn);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  *count_out = st.ms_entries;
+  return LMJCORE_SUCCESS;
+}
+
+// 指针按大端整数加一，溢出时返回 false
+static bool audit_ptr_next(const uint8_t *ptr, uint8_t *next) {
+  memcpy(next, ptr, LMJCORE_PTR_LEN);
+  for (size_t i = LMJCORE_PTR_LEN; i-- > 0;) {
+    if (++next[i] != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief 删除快照 txn_id 及之前记录的脏对象
+ *
+ * 审计期间再次被修改的对象记录的是更新的事务 ID，会保留到下次检查。
+ */
+static int journal_checkpoint(lmjcore_env *env, size_t txn_id) {
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(env, NULL, 0, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  MDB_cursor *cursor = NULL;
+  rc = mdb_cursor_open(txn->mdb_txn, env->journal_dbi, &cursor);
+
+  MDB_val key, data;
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_cursor_get(cursor, &key, &data, MDB_FIRST);
+  }
+  while (rc == MDB_SUCCESS) {
+    uint64_t seq = 0;
+    if (data.mv_size == sizeof(seq)) {
+      memcpy(&seq, data.mv_data, sizeof(seq));
+    }
+    if (seq > txn_id) {
+      rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT);
+      continue;
+    }
+    // 删除后从被删键的位置重新定位到下一项
+    uint8_t pos[LMJCORE_PTR_LEN];
+    size_t pos_len = key.mv_size < LMJCORE_PTR_LEN ? key.mv_size
+                                                   : LMJCORE_PTR_LEN;
+    memcpy(pos, key.mv_data, pos_len);
+    rc = txn_del(txn, env->journal_dbi, &key, NULL);
+    if (rc == MDB_SUCCESS) {
+      key = (MDB_val){.mv_size = pos_len, .mv_data = pos};
+      rc = mdb_cursor_get(cursor, &key, &data, MDB_SET_RANGE);
+    }
+  }
+  if (cursor) {
+    mdb_cursor_close(cursor);
+  }
+  if (rc != MDB_NOTFOUND) {
+    lmjcore_txn_abort(txn);
+    return rc;
+  }
+  return lmjcore_txn_commit(txn);
+}
+
+int lmjcore_audit_incremental(lmjcore_env *env,
+                              const lmjcore_audit_scan_opts *opts,
+                              bool checkpoint,
+                              lmjcore_audit_scan_stats *stats_out) {
+  if (!env) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (!atomic_load(&env->journal_enabled)) {
+    return LMJCORE_ERROR_JOURNAL_DISABLED;
+  }
+  lmjcore_audit_scan_opts defaults = {0};
+  audit_job job = {.opts = opts ? opts : &defaults,
+                   .main_dbi = env->main_dbi,
+                   .set_dbi = env->set_dbi};
+  atomic_init(&job.next, 0);
+  atomic_init(&job.stop, false);
+  lmjcore_audit_scan_stats stats = {0};
+  uint64_t started_ms = monotonic_ms();
+
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  stats.txn_id = mdb_txn_id(txn->mdb_txn);
+
+  MDB_cursor *journal = NULL, *set_cursor = NULL, *main_cursor = NULL;
+  rc = mdb_cursor_open(txn->mdb_txn, env->journal_dbi, &journal);
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_cursor_open(txn->mdb_txn, env->set_dbi, &set_cursor);
+  }
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_cursor_open(txn->mdb_txn, env->main_dbi, &main_cursor);
+  }
+
+  // 每个脏对象是一个只含该指针的区间，复用全库审计的归并比对
+  pthread_mutex_init(&job.lock, NULL);
+  MDB_val key, data;
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_cursor_get(journal, &key, &data, MDB_FIRST);
+  }
+  while (rc == MDB_SUCCESS) {
+    if (key.mv_size == LMJCORE_PTR_LEN) {
+      uint8_t end[LMJCORE_PTR_LEN];
+      bool bounded = audit_ptr_next(key.mv_data, end);
+      stats.dirty_objects++;
+      rc = audit_range(&job, set_cursor, main_cursor, key.mv_data,
+                       bounded ? end : NULL, &stats);
+      if (rc != LMJCORE_SUCCESS) {
+        break;
+      }
+    }
+    rc = mdb_cursor_get(journal, &key, &data, MDB_NEXT);
+  }
+  if (rc == MDB_NOTFOUND) {
+    rc = LMJCORE_SUCCESS;
+  }
+  pthread_mutex_destroy(&job.lock);
+
+  if (main_cursor) {
+    mdb_cursor_close(main_cursor);
+  }
+  if (set_cursor) {
+    mdb_cursor_close(set_cursor);
+  }
+  if (journal) {
+    mdb_cursor_close(journal);
+  }
+  lmjcore_txn_abort(txn);
+
+  if (rc == LMJCORE_SUCCESS && checkpoint) {
+    rc = journal_checkpoint(env, stats.txn_id);
+  }
+  audit_finish_stats(&stats, started_ms);
+  if (stats_out) {
+    *stats_out = stats;
+  }
+  return rc;
+}
+
+// ==================== 批量修复 ====================
+
+#define REPAIR_DEFAULT_CHUNK_KEYS 1000
+#define REPAIR_DEFAULT_CHUNK_MS 50
+#define REPAIR_DEFAULT_DUTY 25
+// 扫描时切分的区间数，每轮扫描在区间边界检查时间上限
+#define REPAIR_RANGES 256
+
+// 一批待删除的幽灵成员键
+typedef struct {
+  uint8_t *keys; // 依次存放 [uint16_t 键长][键]
+  size_t len;
+  size_t cap;
+  size_t count;
+  size_t limit;
+  uint8_t last_ptr[LMJCORE_PTR_LEN]; // 最近一个幽灵成员所属的对象
+  bool full;
+} repair_chunk;
+
+// 审计回调：收集幽灵成员键，攒满一批后中止本轮扫描
+static int repair_collect(void *ctx, const lmjcore_audit_finding *finding) {
+  repair_chunk *chunk = ctx;
+  uint16_t key_len = (uint16_t)(finding->ptr_len + finding->member_name_len);
+  size_t need = chunk->len + sizeof(key_len) + key_len;
+  if (need > chunk->cap) {
+    size_t cap = chunk->cap ? chunk->cap * 2 : 4096;
+    while (cap < need) {
+      cap *= 2;
+    }
+    uint8_t *keys = realloc(chunk->keys, cap);
+    if (!keys) {
+      return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    chunk->keys = keys;
+    chunk->cap = cap;
+  }
+  uint8_t *p = chunk->keys + chunk->len;
+  memcpy(p, &key_len, sizeof(key_len));
+  memcpy(p + sizeof(key_len), finding->ptr, finding->ptr_len);
+  memcpy(p + sizeof(key_len) + finding->ptr_len, finding->member_name,
+         finding->member_name_len);
+  chunk->len = need;
+  memcpy(chunk->last_ptr, finding->ptr, LMJCORE_PTR_LEN);
+  if (++chunk->count >= chunk->limit) {
+    chunk->full = true;
+    return LMJCORE_ERROR_CANCELLED;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+/**
+ * @brief 从 pos 开始扫描一轮，直到攒满一批或超过时间上限
+ *
+ * 攒满时下一轮从最后一个幽灵成员所属的对象重新开始（已删除的不会
+ * 再被发现）；超时时从下一个区间边界开始。扫描到末尾时 has_next 为 false。
+ */
+static int repair_scan(lmjcore_env *env, audit_job *job, repair_chunk *chunk,
+                       const uint8_t *pos, unsigned int chunk_ms,
+                       uint8_t *next, bool *has_next,
+                       lmjcore_repair_stats *stats) {
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  MDB_cursor *set_cursor = NULL, *main_cursor = NULL;
+  rc = mdb_cursor_open(txn->mdb_txn, env->set_dbi, &set_cursor);
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_cursor_open(txn->mdb_txn, env->main_dbi, &main_cursor);
+  }
+
+  // 第一个大于 pos 的区间边界
+  size_t i = 0;
+  while (pos && i < job->bound_count &&
+         memcmp(job->bounds[i], pos, LMJCORE_PTR_LEN) <= 0) {
+    i++;
+  }
+  uint64_t started_ms = monotonic_ms();
+  const uint8_t *start = pos;
+  *has_next = false;
+  while (rc == MDB_SUCCESS) {
+    const uint8_t *end = i < job->bound_count ? job->bounds[i++] : NULL;
+    lmjcore_audit_scan_stats scanned = {0};
+    rc = audit_range(job, set_cursor, main_cursor, start, end, &scanned);
+    stats->entities += scanned.entities;
+    stats->ghosts_found += scanned.ghost_members;
+    if (chunk->full) {
+      memcpy(next, chunk->last_ptr, LMJCORE_PTR_LEN);
+      *has_next = true;
+      rc = LMJCORE_SUCCESS;
+      break;
+    }
+    if (rc != LMJCORE_SUCCESS || !end) {
+      break;
+    }
+    start = end;
+    if (monotonic_ms() - started_ms >= chunk_ms) {
+      memcpy(next, end, LMJCORE_PTR_LEN);
+      *has_next = true;
+      break;
+    }
+  }
+
+  if (main_cursor) {
+    mdb_cursor_close(main_cursor);
+  }
+  if (set_cursor) {
+    mdb_cursor_close(set_cursor);
+  }
+  lmjcore_txn_abort(txn);
+  return rc;
+}
+
+/**
+ * @brief 分若干写事务删除一批幽灵成员
+ *
+ * 每个写事务最多持有 chunk_ms 毫秒。删除前在写事务内重新确认：扫描之后
+ * 被登记为成员或已被删除的键跳过。
+ */
+static int repair_apply(lmjcore_env *env, const repair_chunk *chunk,
+                        unsigned int chunk_ms, uint64_t *held_ms,
+                        lmjcore_repair_stats *stats) {
+  size_t off = 0;
+  while (off < chunk->len) {
+    lmjcore_txn *txn = NULL;
+    int rc = lmjcore_txn_begin(env, NULL, 0, &txn);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+    uint64_t began_ms = monotonic_ms();
+    MDB_cursor *set_cursor = NULL;
+    rc = txn_cursor(txn, env->set_dbi, &set_cursor);
+    size_t deleted = 0, skipped = 0;
+    while (rc == MDB_SUCCESS && off < chunk->len) {
+      uint16_t key_len;
+      memcpy(&key_len, chunk->keys + off, sizeof(key_len));
+      uint8_t *key = chunk->keys + off + sizeof(key_len);
+      off += sizeof(key_len) + key_len;
+
+      MDB_val sk = {.mv_size = LMJCORE_PTR_LEN, .mv_data = key};
+      MDB_val sv = {.mv_size = key_len - LMJCORE_PTR_LEN,
+                    .mv_data = key + LMJCORE_PTR_LEN};
+      rc = mdb_cursor_get(set_cursor, &sk, &sv, MDB_GET_BOTH);
+      if (rc == MDB_SUCCESS) {
+        skipped++; // 扫描之后已被登记为成员
+      } else if (rc == MDB_NOTFOUND) {
+        MDB_val mk = {.mv_size = key_len, .mv_data = key};
+        rc = stats_main_del(txn, key, &mk);
+        if (rc == MDB_SUCCESS) {
+          deleted++;
+        } else if (rc == MDB_NOTFOUND) {
+          skipped++; // 扫描之后已被删除
+          rc = MDB_SUCCESS;
+        }
+      }
+      if (monotonic_ms() - began_ms >= chunk_ms) {
+        break;
+      }
+    }
+    if (rc != MDB_SUCCESS) {
+      lmjcore_txn_abort(txn);
+      return rc;
+    }
+    rc = lmjcore_txn_commit(txn);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+    *held_ms += monotonic_ms() - began_ms;
+    stats->chunks++;
+    stats->ghosts_deleted += deleted;
+    stats->skipped += skipped;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 读取进度文件（不存在时从头开始）
+static int repair_load_checkpoint(const char *path, uint8_t *pos,
+                                  bool *found) {
+  *found = false;
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    return errno == ENOENT ? LMJCORE_SUCCESS : errno;
+  }
+  char line[LMJCORE_PTR_STRING_BUF_SIZE + 1] = {0};
+  bool ok = fgets(line, sizeof(line), f) != NULL;
+  fclose(f);
+  line[strcspn(line, "\n")] = '\0';
+  if (!ok || lmjcore_ptr_from_string(line, pos) != LMJCORE_SUCCESS) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  *found = true;
+  return LMJCORE_SUCCESS;
+}
+
+// 写入进度文件：先写临时文件再重命名，崩溃时保留上一次的进度
+static int repair_save_checkpoint(const char *path, const uint8_t *pos) {
+  char tmp_path[4096];
+  if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >=
+      (int)sizeof(tmp_path)) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  char str[LMJCORE_PTR_STRING_BUF_SIZE];
+  lmjcore_ptr_to_string(pos, str, sizeof(str));
+  FILE *f = fopen(tmp_path, "w");
+  if (!f) {
+    return errno;
+  }
+  int rc = LMJCORE_SUCCESS;
+  if (fprintf(f, "%s\n", str) < 0 || fflush(f) != 0 ||
+      fsync(fileno(f)) != 0) {
+    rc = errno ? errno : EIO;
+  }
+  if (fclose(f) != 0 && rc == LMJCORE_SUCCESS) {
+    rc = errno;
+  }
+  if (rc == LMJCORE_SUCCESS && rename(tmp_path, path) != 0) {
+    rc = errno;
+  }
+  if (rc != LMJCORE_SUCCESS) {
+    remove(tmp_path);
+  }
+  return rc;
+}
+
+// 休眠指定毫秒数
+static void repair_sleep_ms(uint64_t ms) {
+  struct timespec ts = {.tv_sec = (time_t)(ms / 1000),
+                        .tv_nsec = (long)(ms % 1000) * 1000000L};
+  while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+  }
+}
+
+int lmjcore_repair_ghosts(lmjcore_env *env, const lmjcore_repair_opts *opts,
+                          lmjcore_repair_stats *stats_out) {
+  if (!env) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  lmjcore_repair_opts o = opts ? *opts : (lmjcore_repair_opts){0};
+  if (o.max_duty > 100) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  if (o.chunk_keys == 0) {
+    o.chunk_keys = REPAIR_DEFAULT_CHUNK_KEYS;
+  }
+  if (o.chunk_ms == 0) {
+    o.chunk_ms = REPAIR_DEFAULT_CHUNK_MS;
+  }
+  if (o.max_duty == 0) {
+    o.max_duty = REPAIR_DEFAULT_DUTY;
+  }
+
+  lmjcore_repair_stats stats = {0};
+  uint64_t started_ms = monotonic_ms();
+  uint8_t pos[LMJCORE_PTR_LEN], next[LMJCORE_PTR_LEN];
+  int rc = LMJCORE_SUCCESS;
+  if (o.checkpoint_path) {
+    rc = repair_load_checkpoint(o.checkpoint_path, pos, &stats.resumed);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+  }
+
+  repair_chunk chunk = {.limit = o.chunk_keys};
+  lmjcore_audit_scan_opts audit_opts = {
+      .report_mask = LMJCORE_AUDIT_GHOST_MEMBER,
+      .on_finding = repair_collect,
+      .ctx = &chunk};
+  audit_job job = {.opts = &audit_opts,
+                   .main_dbi = env->main_dbi,
+                   .set_dbi = env->set_dbi};
+  atomic_init(&job.next, 0);
+  atomic_init(&job.stop, false);
+
+  // 区间边界只需估计一次，之后的写入不影响正确性
+  lmjcore_txn *txn = NULL;
+  rc = lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  rc = audit_split(&job, txn->mdb_txn, REPAIR_RANGES);
+  lmjcore_txn_abort(txn);
+  if (rc != LMJCORE_SUCCESS) {
+    free(job.bounds);
+    return rc;
+  }
+
+  pthread_mutex_init(&job.lock, NULL);
+  bool from_start = !stats.resumed;
+  while (rc == LMJCORE_SUCCESS) {
+    chunk.len = 0;
+    chunk.count = 0;
+    chunk.full = false;
+    bool has_next = false;
+    rc = repair_scan(env, &job, &chunk, from_start ? NULL : pos, o.chunk_ms,
+                     next, &has_next, &stats);
+    uint64_t held_ms = 0;
+    if (rc == LMJCORE_SUCCESS && chunk.count > 0) {
+      rc = repair_apply(env, &chunk, o.chunk_ms, &held_ms, &stats);
+    }
+    if (rc != LMJCORE_SUCCESS) {
+      break;
+    }
+
+    // 删除提交之后才推进进度：崩溃时最多重新扫描一轮
+    if (o.checkpoint_path) {
+      if (has_next) {
+        rc = repair_save_checkpoint(o.checkpoint_path, next);
+      } else if (remove(o.checkpoint_path) != 0 && errno != ENOENT) {
+        rc = errno;
+      }
+    }
+    stats.done = !has_next;
+    stats.elapsed_ms = monotonic_ms() - started_ms;
+    if (rc == LMJCORE_SUCCESS && o.on_chunk) {
+      rc = o.on_chunk(o.ctx, &stats);
+    }
+    if (rc != LMJCORE_SUCCESS || !has_next) {
+      break;
+    }
+
+    // 按占空比限速：持有写锁 h 毫秒后让出 h * (100 - duty) / duty 毫秒
+    if (held_ms > 0 && o.max_duty < 100) {
+      uint64_t pause = held_ms * (100 - o.max_duty) / o.max_duty;
+      repair_sleep_ms(pause);
+      stats.throttle_ms += pause;
+    }
+    memcpy(pos, next, LMJCORE_PTR_LEN);
+    from_start = false;
+  }
+  pthread_mutex_destroy(&job.lock);
+  free(chunk.keys);
+  free(job.bounds);
+
+  stats.elapsed_ms = monotonic_ms() - started_ms;
+  if (stats_out) {
+    *stats_out = stats;
+  }
+  return rc;
+}
+
+// ==================== 垃圾回收 ====================
+
+#define GC_DEFAULT_CHUNK_KEYS 256
+
+// 快照中全部实体的有序指针表及其标记位，放在内存映射中
+typedef struct {
+  uint8_t (*ptrs)[LMJCORE_PTR_LEN]; // 按键序排列的实体指针
+  uint8_t *marks;                   // 每个实体一位，1 表示可达
+  size_t count;
+  size_t filled;
+  void *map;
+  size_t map_size;
+  const char *path; // 溢出文件（NULL 表示匿名映射）
+} gc_index;
+
+// 建立可容纳 count 个实体的映射：有路径时映射到文件，由内核按需换出
+static int gc_index_open(gc_index *idx, const char *path, size_t count) {
+  idx->count = count;
+  idx->path = path;
+  idx->map_size = count * LMJCORE_PTR_LEN + (count + 7) / 8;
+  if (idx->map_size == 0) {
+    idx->map_size = 1;
+  }
+  if (path) {
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+      return errno;
+    }
+    if (ftruncate(fd, (off_t)idx->map_size) != 0) {
+      int rc = errno;
+      close(fd);
+      remove(path);
+      return rc;
+    }
+    idx->map = mmap(NULL, idx->map_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    fd, 0);
+    close(fd);
+  } else {
+    idx->map = mmap(NULL, idx->map_size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  }
+  if (idx->map == MAP_FAILED) {
+    int rc = errno;
+    idx->map = NULL;
+    if (path) {
+      remove(path);
+    }
+    return rc;
+  }
+  idx->ptrs = idx->map;
+  idx->marks = (uint8_t *)idx->map + count * LMJCORE_PTR_LEN;
+  return LMJCORE_SUCCESS;
+}
+
+static void gc_index_close(gc_index *idx) {
+  if (idx->map) {
+    munmap(idx->map, idx->map_size);
+    idx->map = NULL;
+  }
+  if (idx->path) {
+    remove(idx->path);
+  }
+}
+
+static int gc_count_entity(void *ctx, const lmjcore_ptr ptr) {
+  (void)ptr;
+  (*(size_t *)ctx)++;
+  return 0;
+}
+
+static int gc_fill_entity(void *ctx, const lmjcore_ptr ptr) {
+  gc_index *idx = ctx;
+  memcpy(idx->ptrs[idx->filled++], ptr, LMJCORE_PTR_LEN);
+  return 0;
+}
+
+// 有序指针表中第一个不小于 ptr 的下标
+static size_t gc_index_lower(const gc_index *idx, const uint8_t *ptr) {
+  size_t lo = 0, hi = idx->count;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (memcmp(idx->ptrs[mid], ptr, LMJCORE_PTR_LEN) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// 在有序指针表中二分查找，返回下标或 SIZE_MAX
+static size_t gc_index_find(const gc_index *idx, const uint8_t *ptr) {
+  size_t i = gc_index_lower(idx, ptr);
+  if (i < idx->count && memcmp(idx->ptrs[i], ptr, LMJCORE_PTR_LEN) == 0) {
+    return i;
+  }
+  return SIZE_MAX;
+}
+
+// 第 1~8 字节全为 0 的指针（配置对象等保留实体）
+static bool gc_reserved_ptr(const uint8_t *ptr) {
+  static const uint8_t zeros[8] = {0};
+  return memcmp(ptr + 1, zeros, sizeof(zeros)) == 0;
+}
+
+// 待扫描的可达实体
+typedef struct {
+  size_t *items;
+  size_t count;
+  size_t cap;
+} gc_stack;
+
+/**
+ * @brief 若值形如实体指针且指向快照中的实体，标记并压栈
+ */
+static int gc_mark_value(gc_index *idx, gc_stack *stack, const MDB_val *value,
+                         size_t *reachable) {
+  const uint8_t *v = value->mv_data;
+  if (value->mv_size != LMJCORE_PTR_LEN ||
+      (v[0] != LMJCORE_OBJ && v[0] != LMJCORE_SET)) {
+    return LMJCORE_SUCCESS;
+  }
+  size_t i = gc_index_find(idx, v);
+  if (i == SIZE_MAX || (idx->marks[i / 8] & (1u << (i % 8)))) {
+    return LMJCORE_SUCCESS;
+  }
+  idx->marks[i / 8] |= (uint8_t)(1u << (i % 8));
+  (*reachable)++;
+  if (stack->count == stack->cap) {
+    size_t cap = stack->cap ? stack->cap * 2 : 1024;
+    size_t *items = realloc(stack->items, cap * sizeof(size_t));
+    if (!items) {
+      return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    stack->items = items;
+    stack->cap = cap;
+  }
+  stack->items[stack->count++] = i;
+  return LMJCORE_SUCCESS;
+}
+
+/**
+ * @brief 逐个弹出栈中的实体，扫描其成员值或元素中的指针并继续标记
+ */
+static int gc_mark_scan(MDB_txn *mdb_txn, lmjcore_env *env, gc_index *idx,
+                        gc_stack *stack, size_t *marked) {
+  MDB_cursor *set_cursor = NULL, *main_cursor = NULL;
+  int rc = mdb_cursor_open(mdb_txn, env->set_dbi, &set_cursor);
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_cursor_open(mdb_txn, env->main_dbi, &main_cursor);
+  }
+
+  while (rc == MDB_SUCCESS && stack->count > 0) {
+    const uint8_t *ptr = idx->ptrs[stack->items[--stack->count]];
+    MDB_val key = {.mv_size = LMJCORE_PTR_LEN, .mv_data = (void *)ptr};
+    MDB_val data;
+    if (ptr[0] == LMJCORE_SET) {
+      rc = mdb_cursor_get(set_cursor, &key, &data, MDB_SET);
+      while (rc == MDB_SUCCESS) {
+        rc = gc_mark_value(idx, stack, &data, marked);
+        if (rc == MDB_SUCCESS) {
+          rc = mdb_cursor_get(set_cursor, &key, &data, MDB_NEXT_DUP);
+        }
+      }
+    } else {
+      rc = mdb_cursor_get(main_cursor, &key, &data, MDB_SET_RANGE);
+      while (rc == MDB_SUCCESS && OBJ_KEY_PREFIX(ptr, key)) {
+        rc = gc_mark_value(idx, stack, &data, marked);
+        if (rc == MDB_SUCCESS) {
+          rc = mdb_cursor_get(main_cursor, &key, &data, MDB_NEXT);
+        }
+      }
+    }
+    if (rc == MDB_NOTFOUND) {
+      rc = MDB_SUCCESS;
+    }
+  }
+
+  if (main_cursor) {
+    mdb_cursor_close(main_cursor);
+  }
+  if (set_cursor) {
+    mdb_cursor_close(set_cursor);
+  }
+  return rc;
+}
+
+/**
+ * @brief 标记阶段：从根出发，扫描对象成员值与集合元素中的指针
+ */
+static int gc_mark(lmjcore_txn *txn, gc_index *idx, const lmjcore_gc_opts *o,
+                   lmjcore_gc_stats *stats) {
+  int rc = LMJCORE_SUCCESS;
+  gc_stack stack = {0};
+  for (size_t r = 0; rc == MDB_SUCCESS && r < o->root_count; r++) {
+    size_t before = stats->reachable;
+    MDB_val root = {.mv_size = LMJCORE_PTR_LEN, .mv_data = (void *)o->roots[r]};
+    rc = gc_mark_value(idx, &stack, &root, &stats->reachable);
+    stats->roots += stats->reachable - before;
+  }
+  // 保留指针空间中的实体总是根：配置对象（LMJCORE_OBJ 后全 0）保存着
+  // 顺序指针生成器的计数器等状态，删除后会重复分配已使用的指针。
+  // 它们按键序排在各类型的最前面
+  const uint8_t types[] = {LMJCORE_OBJ, LMJCORE_SET};
+  for (size_t t = 0; rc == MDB_SUCCESS && t < sizeof(types); t++) {
+    uint8_t first[LMJCORE_PTR_LEN] = {types[t]};
+    for (size_t i = gc_index_lower(idx, first);
+         rc == MDB_SUCCESS && i < idx->count && idx->ptrs[i][0] == types[t] &&
+         gc_reserved_ptr(idx->ptrs[i]);
+         i++) {
+      size_t before = stats->reachable;
+      MDB_val root = {.mv_size = LMJCORE_PTR_LEN, .mv_data = idx->ptrs[i]};
+      rc = gc_mark_value(idx, &stack, &root, &stats->reachable);
+      stats->roots += stats->reachable - before;
+    }
+  }
+
+  if (rc == MDB_SUCCESS) {
+    rc = gc_mark_scan(txn->mdb_txn, txn->env, idx, &stack, &stats->reachable);
+  }
+  free(stack.items);
+  return rc;
+}
+
+// ==================== 回收期间的写入记录 ====================
+
+static void gc_track_stop(lmjcore_env *env) {
+  pthread_mutex_lock(&env->gc.lock);
+  atomic_store(&env->gc.tracking, false);
+  env->gc.running = false;
+  free(env->gc.ptrs);
+  env->gc.ptrs = NULL;
+  env->gc.count = 0;
+  env->gc.cap = 0;
+  pthread_mutex_unlock(&env->gc.lock);
+}
+
+/**
+ * @brief 开始记录写入的指针值（同一环境同时只能有一个回收）
+ *
+ * 开始记录之前已经开始的写事务写入的引用不会被记录，等它结束后再开启
+ * 标记快照，这些引用就都在快照中可见。
+ */
+static int gc_track_start(lmjcore_env *env) {
+  pthread_mutex_lock(&env->gc.lock);
+  if (env->gc.running) {
+    pthread_mutex_unlock(&env->gc.lock);
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  env->gc.running = true;
+  env->gc.overflow = false;
+  env->gc.count = 0;
+  atomic_store(&env->gc.tracking, true);
+  pthread_mutex_unlock(&env->gc.lock);
+
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(env, NULL, 0, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    gc_track_stop(env);
+    return rc;
+  }
+  lmjcore_txn_abort(txn);
+  return LMJCORE_SUCCESS;
+}
+
+/**
+ * @brief 记录一个写入的值（由 txn_put 调用，只保留形如实体指针的值）
+ *
+ * 不区分写入是否最终提交：多保留一个实体只是推迟到下次回收。
+ */
+static void gc_track(lmjcore_env *env, const MDB_val *value) {
+  const uint8_t *v = value->mv_data;
+  if (value->mv_size != LMJCORE_PTR_LEN ||
+      (v[0] != LMJCORE_OBJ && v[0] != LMJCORE_SET)) {
+    return;
+  }
+  pthread_mutex_lock(&env->gc.lock);
+  if (!atomic_load(&env->gc.tracking)) {
+    pthread_mutex_unlock(&env->gc.lock);
+    return;
+  }
+  if (env->gc.count == env->gc.cap) {
+    size_t cap = env->gc.cap ? env->gc.cap * 2 : 256;
+    uint8_t(*ptrs)[LMJCORE_PTR_LEN] =
+        realloc(env->gc.ptrs, cap * LMJCORE_PTR_LEN);
+    if (!ptrs) {
+      env->gc.overflow = true;
+      pthread_mutex_unlock(&env->gc.lock);
+      return;
+    }
+    env->gc.ptrs = ptrs;
+    env->gc.cap = cap;
+  }
+  memcpy(env->gc.ptrs[env->gc.count++], v, LMJCORE_PTR_LEN);
+  pthread_mutex_unlock(&env->gc.lock);
+}
+
+/**
+ * @brief 重新标记：从标记开始后写入的指针值出发（需在写事务内调用）
+ *
+ * 快照中不可达的实体仍可能被持有其指针的写入者重新引用，例如从另一个
+ * 待回收的实体中读出指针后写入可达对象。持有写锁时没有新的写入，把记录
+ * 中指向的未标记实体连同它们当前引用的实体一并标记，这一批就不会删除。
+ */
+static int gc_remark(lmjcore_txn *txn, gc_index *idx,
+                     lmjcore_gc_stats *stats) {
+  lmjcore_env *env = txn->env;
+  pthread_mutex_lock(&env->gc.lock);
+  uint8_t(*ptrs)[LMJCORE_PTR_LEN] = env->gc.ptrs;
+  size_t count = env->gc.count;
+  bool overflow = env->gc.overflow;
+  env->gc.ptrs = NULL;
+  env->gc.count = 0;
+  env->gc.cap = 0;
+  pthread_mutex_unlock(&env->gc.lock);
+
+  int rc = overflow ? LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED : LMJCORE_SUCCESS;
+  gc_stack stack = {0};
+  for (size_t k = 0; rc == LMJCORE_SUCCESS && k < count; k++) {
+    MDB_val value = {.mv_size = LMJCORE_PTR_LEN, .mv_data = ptrs[k]};
+    rc = gc_mark_value(idx, &stack, &value, &stats->relinked);
+  }
+  if (rc == LMJCORE_SUCCESS && stack.count > 0) {
+    rc = gc_mark_scan(txn->mdb_txn, env, idx, &stack, &stats->relinked);
+  }
+  free(stack.items);
+  free(ptrs);
+  return rc;
+}
+
+/**
+ * @brief 清除阶段：分批删除未标记的实体
+ *
+ * 每批先在写事务内重新标记，再删除仍未标记的实体。
+ */
+static int gc_sweep(lmjcore_env *env, gc_index *idx, const lmjcore_gc_opts *o,
+                    lmjcore_gc_stats *stats) {
+  size_t i = 0;
+  while (i < idx->count) {
+    lmjcore_txn *txn = NULL;
+    int rc = lmjcore_txn_begin(env, NULL, 0, &txn);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+    uint64_t began_ms = monotonic_ms();
+    size_t deleted = 0;
+    rc = gc_remark(txn, idx, stats);
+    for (; rc == LMJCORE_SUCCESS && i < idx->count; i++) {
+      if (idx->marks[i / 8] & (1u << (i % 8))) {
+        continue;
+      }
+      const uint8_t *ptr = idx->ptrs[i];
+      if (ptr[0] == LMJCORE_OBJ) {
+        rc = lmjcore_obj_del(txn, ptr);
+      } else if (ptr[0] == LMJCORE_SET) {
+        rc = lmjcore_set_del(txn, ptr);
+      } else {
+        continue; // 类型字节无效的实体交给审计处理
+      }
+      if (rc == MDB_NOTFOUND) {
+        rc = LMJCORE_SUCCESS; // 已被其他写事务删除
+        continue;
+      }
+      if (rc != LMJCORE_SUCCESS) {
+        break;
+      }
+      deleted++;
+      if (deleted >= o->chunk_keys ||
+          monotonic_ms() - began_ms >= o->chunk_ms) {
+        i++;
+        break;
+      }
+    }
+    if (rc != LMJCORE_SUCCESS) {
+      lmjcore_txn_abort(txn);
+      return rc;
+    }
+    if (deleted == 0) {
+      lmjcore_txn_abort(txn);
+      break;
+    }
+    rc = lmjcore_txn_commit(txn);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+    stats->deleted += deleted;
+    stats->chunks++;
+
+    uint64_t held_ms = monotonic_ms() - began_ms;
+    if (held_ms > 0 && o->max_duty < 100 && i < idx->count) {
+      uint64_t pause = held_ms * (100 - o->max_duty) / o->max_duty;
+      repair_sleep_ms(pause);
+      stats->throttle_ms += pause;
+    }
+  }
+  return LMJCORE_SUCCESS;
+}
+
+int lmjcore_gc(lmjcore_env *env, const lmjcore_gc_opts *opts,
+               lmjcore_gc_stats *stats_out) {
+  if (!env) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (!opts || !opts->roots) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  lmjcore_gc_opts o = *opts;
+  // 没有根时所有实体都不可达，视为误用
+  if (o.root_count == 0 || o.max_duty > 100) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  if (o.chunk_keys == 0) {
+    o.chunk_keys = GC_DEFAULT_CHUNK_KEYS;
+  }
+  if (o.chunk_ms == 0) {
+    o.chunk_ms = REPAIR_DEFAULT_CHUNK_MS;
+  }
+  if (o.max_duty == 0) {
+    o.max_duty = REPAIR_DEFAULT_DUTY;
+  }
+
+  lmjcore_gc_stats stats = {0};
+  uint64_t started_ms = monotonic_ms();
+
+  // 标记开始前开始记录写入，清除时据此找回被重新引用的实体
+  int rc = LMJCORE_SUCCESS;
+  if (!o.dry_run) {
+    rc = gc_track_start(env);
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+  }
+
+  // 标记在同一快照中完成：先数出实体，再建立有序指针表
+  lmjcore_txn *txn = NULL;
+  rc = lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    if (!o.dry_run) {
+      gc_track_stop(env);
+    }
+    return rc;
+  }
+  stats.txn_id = mdb_txn_id(txn->mdb_txn);
+  size_t count = 0;
+  rc = lmjcore_entity_scan(txn, NULL, gc_count_entity, &count);
+  gc_index idx = {0};
+  if (rc == LMJCORE_SUCCESS) {
+    rc = gc_index_open(&idx, o.spill_path, count);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    rc = lmjcore_entity_scan(txn, NULL, gc_fill_entity, &idx);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    stats.entities = idx.count;
+    stats.spill_bytes = idx.map_size;
+    rc = gc_mark(txn, &idx, &o, &stats);
+  }
+  lmjcore_txn_abort(txn);
+
+  if (rc == LMJCORE_SUCCESS) {
+    stats.unreachable = stats.entities - stats.reachable;
+    if (!o.dry_run) {
+      rc = gc_sweep(env, &idx, &o, &stats);
+    }
+  }
+  if (!o.dry_run) {
+    gc_track_stop(env);
+  }
+  gc_index_close(&idx);
+
+  stats.elapsed_ms = monotonic_ms() - started_ms;
+  if (stats_out) {
+    *stats_out = stats;
+  }
+  return rc;
+}
+
+/*
+ *==========================================
+ * 实体统计
+ *==========================================
+ */
+/**
+ * @brief 按现有数据为每个实体生成统计记录
+ *
+ * 先逐个实体汇总 set 库中的条目生成记录，再按前缀汇总 main 库中的成员值
+ * 补到已有记录上；未登记实体下的成员值不计入。
+ */
+static int stats_rebuild(lmjcore_txn *txn) {
+  lmjcore_env *env = txn->env;
+  MDB_cursor *cursor = NULL;
+  int rc = mdb_cursor_open(txn->mdb_txn, env->set_dbi, &cursor);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  MDB_val key, data;
+  uint8_t ptr[LMJCORE_PTR_LEN];
+  rc = mdb_cursor_get(cursor, &key, &data, MDB_FIRST);
+  while (rc == MDB_SUCCESS) {
+    bool valid = key.mv_size == LMJCORE_PTR_LEN;
+    if (valid) {
+      memcpy(ptr, key.mv_data, LMJCORE_PTR_LEN);
+    }
+    entity_stats st = {0};
+    do {
+      st.members++;
+      st.member_bytes += data.mv_size;
+      rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT_DUP);
+    } while (rc == MDB_SUCCESS);
+    if (rc == MDB_NOTFOUND && valid) {
+      rc = stats_put(txn, ptr, &st);
+    }
+    if (rc == MDB_SUCCESS || rc == MDB_NOTFOUND) {
+      rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT_NODUP);
+    }
+  }
+  mdb_cursor_close(cursor);
+  if (rc != MDB_NOTFOUND) {
+    return rc;
+  }
+
+  rc = mdb_cursor_open(txn->mdb_txn, env->main_dbi, &cursor);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  rc = mdb_cursor_get(cursor, &key, &data, MDB_FIRST);
+  while (rc == MDB_SUCCESS) {
+    if (key.mv_size < LMJCORE_PTR_LEN) {
+      rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT);
+      continue;
+    }
+    memcpy(ptr, key.mv_data, LMJCORE_PTR_LEN);
+    uint64_t values = 0, value_bytes = 0;
+    while (rc == MDB_SUCCESS && OBJ_KEY_PREFIX(ptr, key)) {
+      values++;
+      value_bytes += data.mv_size;
+      rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT);
+    }
+    if (rc != MDB_SUCCESS && rc != MDB_NOTFOUND) {
+      break;
+    }
+    int walk_rc = rc;
+    entity_stats st;
+    rc = stats_get(txn, ptr, &st);
+    if (rc == MDB_SUCCESS) {
+      st.values = values;
+      st.value_bytes = value_bytes;
+      rc = stats_put(txn, ptr, &st);
+    } else if (rc == MDB_NOTFOUND) {
+      rc = MDB_SUCCESS; // 未登记实体
+    }
+    if (rc == MDB_SUCCESS) {
+      rc = walk_rc;
+    }
   }
+  mdb_cursor_close(cursor);
+  return rc == MDB_NOTFOUND ? MDB_SUCCESS : rc;
+}
 
-  // 如果出现错误，重置统计结果
-  if (rc != LMJCORE_SUCCESS) {
-    *total_value_count_out = 0;
-    *total_value_len_out = 0;
+// 启用或关闭实体统计
+int lmjcore_entity_stats_set(lmjcore_env *env, bool enabled) {
+  if (!env) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (!compact_lock_idle(env)) {
+    return LMJCORE_ERROR_BUSY;
+  }
+  if (atomic_load(&env->stats_enabled) == enabled) {
+    pthread_mutex_unlock(&env->compact.lock);
+    return LMJCORE_SUCCESS;
+  }
+  if (!enabled) {
+    int rc = optional_db_drop(env, env->stats_dbi, &env->stats_enabled);
+    pthread_mutex_unlock(&env->compact.lock);
+    return rc;
   }
 
+  // 与脏对象日志相同：持有写锁期间生成记录，之后开始的写事务一定能看到
+  // 新的状态
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(env, NULL, 0, &txn);
+  if (rc == LMJCORE_SUCCESS) {
+    rc = mdb_dbi_open(txn->mdb_txn, STATS_DB_NAME, MDB_CREATE,
+                      &env->stats_dbi);
+    if (rc == MDB_SUCCESS) {
+      // 此时开始的读事务看不到 stats 库，会退回遍历
+      atomic_store(&env->stats_enabled, true);
+      rc = stats_rebuild(txn);
+    }
+    if (rc != MDB_SUCCESS) {
+      atomic_store(&env->stats_enabled, false);
+      lmjcore_txn_abort(txn);
+    }
+  }
+  if (rc == MDB_SUCCESS) {
+    rc = lmjcore_txn_commit(txn);
+    if (rc != LMJCORE_SUCCESS) {
+      atomic_store(&env->stats_enabled, false);
+    }
+  }
+  pthread_mutex_unlock(&env->compact.lock);
   return rc;
 }
 
 /*
  *==========================================
- * 审计与修复
+ * 形态分析
  *==========================================
  */
-/*
-  report_buf内存结构
-  ---------------------  <-- report_buf(report_head)
-  |report_head         |
-  ---------------------
-  |report_descriptor   | <-- 前往后
-  ----------------------
-  |....                |
-  ----------------------
-  | member_name        | <-- 由后往前
-  ---------------------- <-- data_offset(report_buf_size)
-  */
-int lmjcore_audit_object(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
-                         uint8_t *report_buf, size_t report_buf_size,
-                         lmjcore_audit_report **report_head) {
-  if (!txn || !obj_ptr || !report_buf || !report_head) {
-    return LMJCORE_ERROR_NULL_POINTER;
-  }
-  if (obj_ptr[0] != LMJCORE_OBJ) {
-    return LMJCORE_ERROR_ENTITY_TYPE_MISMATCH;
-  }
+#define SHAPE_DEFAULT_SKETCH 1024
 
-  if (report_buf_size < sizeof(lmjcore_audit_report)) {
-    return LMJCORE_ERROR_BUFFER_TOO_SMALL;
+// Space-Saving 草图中的一个计数器
+typedef struct {
+  uint8_t *name; // 指向 names 中该计数器的槽位
+  size_t name_len;
+  size_t count;    // 估计次数（上界）
+  size_t error;    // 接管槽位时继承的次数
+  size_t hash;     // 名字的哈希
+  size_t heap_pos; // 在最小堆中的位置
+} shape_counter;
+
+/**
+ * @brief 跟踪固定个数高频名字的 Space-Saving 草图
+ *
+ * 计数器按 count 组成最小堆，另用线性探测散列表按名字查找计数器；
+ * 计数器满后新名字接管 count 最小的计数器，并以其 count 作为误差。
+ */
+typedef struct {
+  shape_counter *counters;
+  uint8_t *names; // cap 个槽位，每个 LMJCORE_MAX_MEMBER_NAME_LEN 字节
+  size_t *heap;   // 计数器下标
+  size_t *table;  // 计数器下标 + 1（0 表示空位），容量为 2 的幂
+  size_t mask;
+  size_t used;
+  size_t cap;
+} shape_sketch;
+
+static int shape_sketch_init(shape_sketch *sk, size_t cap) {
+  size_t slots = 1;
+  while (slots < cap * 2) {
+    slots <<= 1;
+  }
+  *sk = (shape_sketch){.mask = slots - 1, .cap = cap};
+  sk->counters = calloc(cap, sizeof(shape_counter));
+  sk->names = malloc(cap * LMJCORE_MAX_MEMBER_NAME_LEN);
+  sk->heap = calloc(cap, sizeof(size_t));
+  sk->table = calloc(slots, sizeof(size_t));
+  if (!sk->counters || !sk->names || !sk->heap || !sk->table) {
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
   }
+  return LMJCORE_SUCCESS;
+}
 
-  // 初始化报告头
-  lmjcore_audit_report *report = (lmjcore_audit_report *)report_buf;
-  report->audit_count = 0;
-  *report_head = report;
+static void shape_sketch_free(shape_sketch *sk) {
+  free(sk->counters);
+  free(sk->names);
+  free(sk->heap);
+  free(sk->table);
+}
 
-  size_t report_desc_offset = sizeof(lmjcore_audit_report); // 描述符数组偏移量
-  size_t data_offset = report_buf_size;                     // 数据偏移量
+static void shape_heap_swap(shape_sketch *sk, size_t i, size_t j) {
+  size_t a = sk->heap[i], b = sk->heap[j];
+  sk->heap[i] = b;
+  sk->heap[j] = a;
+  sk->counters[b].heap_pos = i;
+  sk->counters[a].heap_pos = j;
+}
 
-  MDB_cursor *cursor_main, *cursor_set;
-  int rc = mdb_cursor_open(txn->mdb_txn, txn->env->main_dbi,
-                           &cursor_main); // 开启main库游标
-  if (rc != MDB_SUCCESS) {
-    return rc;
-  }
-  rc = mdb_cursor_open(txn->mdb_txn, txn->env->set_dbi,
-                       &cursor_set); // 开启set库游标
-  if (rc != MDB_SUCCESS) {
-    return rc;
+static void shape_heap_up(shape_sketch *sk, size_t i) {
+  while (i > 0) {
+    size_t parent = (i - 1) / 2;
+    if (sk->counters[sk->heap[parent]].count <=
+        sk->counters[sk->heap[i]].count) {
+      break;
+    }
+    shape_heap_swap(sk, i, parent);
+    i = parent;
   }
+}
 
-  MDB_val obj = {.mv_data = (void *)obj_ptr, .mv_size = LMJCORE_PTR_LEN};
-  MDB_val key = obj; // 第一个成员使用前缀匹配
-  MDB_val value;
-  rc = mdb_cursor_get(cursor_main, &key, &value, MDB_SET_RANGE);
-  while (rc == MDB_SUCCESS) {
-    // 判断是否处于目标对象中
-    if (memcmp(obj_ptr, key.mv_data, LMJCORE_PTR_LEN) != 0) {
-      rc = LMJCORE_SUCCESS;
+static void shape_heap_down(shape_sketch *sk, size_t i) {
+  for (;;) {
+    size_t least = i, l = 2 * i + 1, r = l + 1;
+    if (l < sk->used && sk->counters[sk->heap[l]].count <
+                            sk->counters[sk->heap[least]].count) {
+      least = l;
+    }
+    if (r < sk->used && sk->counters[sk->heap[r]].count <
+                            sk->counters[sk->heap[least]].count) {
+      least = r;
+    }
+    if (least == i) {
       break;
     }
-    // 判断成员名是否在set库中注册
-    MDB_val member_name = {.mv_data = key.mv_data + LMJCORE_PTR_LEN,
-                           .mv_size = key.mv_size - LMJCORE_PTR_LEN};
-    int exist = mdb_cursor_get(cursor_set, &obj, &member_name, MDB_GET_BOTH);
-    // 查询set库如果找到会返回MDB_SUCCESS未找到会返回MDB_NOTFOUND(幽灵成员)
-    if (exist == MDB_NOTFOUND) {
-      int error = add_audit(report_buf, &member_name, &value, obj_ptr,
-                            &data_offset, &report_desc_offset);
-      if (error != LMJCORE_SUCCESS) {
-        rc = error;
-        goto cleanup;
+    shape_heap_swap(sk, i, least);
+    i = least;
+  }
+}
+
+// 从散列表删除计数器 idx，把后续探测链上的项前移填补空位
+static void shape_table_remove(shape_sketch *sk, size_t idx) {
+  size_t i = sk->counters[idx].hash & sk->mask;
+  while (sk->table[i] != idx + 1) {
+    i = (i + 1) & sk->mask;
+  }
+  for (;;) {
+    sk->table[i] = 0;
+    size_t j = i;
+    for (;;) {
+      j = (j + 1) & sk->mask;
+      if (!sk->table[j]) {
+        return;
+      }
+      size_t home = sk->counters[sk->table[j] - 1].hash & sk->mask;
+      // home 在 (i, j] 之间（环形）时该项留在原处
+      bool stays = i < j ? home > i && home <= j : home > i || home <= j;
+      if (!stays) {
+        break;
       }
-      // 记录审计数量
-      report->audit_count++;
-    } else if (exist != MDB_SUCCESS) {
-      rc = exist;
-      goto cleanup;
     }
-    rc = mdb_cursor_get(cursor_main, &key, &value, MDB_NEXT);
+    sk->table[i] = sk->table[j];
+    i = j;
   }
-  if (rc == MDB_NOTFOUND) {
-    rc = LMJCORE_SUCCESS;
+}
+
+// 记录名字出现一次
+static void shape_sketch_add(shape_sketch *sk, const uint8_t *name,
+                             size_t name_len) {
+  size_t hash = compact_hash(0, name, name_len);
+  size_t slot = hash & sk->mask;
+  while (sk->table[slot]) {
+    shape_counter *c = &sk->counters[sk->table[slot] - 1];
+    if (c->hash == hash && c->name_len == name_len &&
+        memcmp(c->name, name, name_len) == 0) {
+      c->count++;
+      shape_heap_down(sk, c->heap_pos);
+      return;
+    }
+    slot = (slot + 1) & sk->mask;
+  }
+
+  size_t idx, error = 0;
+  if (sk->used < sk->cap) {
+    idx = sk->used++;
+    sk->counters[idx].name = sk->names + idx * LMJCORE_MAX_MEMBER_NAME_LEN;
+    sk->counters[idx].heap_pos = idx;
+    sk->heap[idx] = idx;
+  } else {
+    // 接管次数最少的计数器；删除旧名字后空位可能移动，重新探测
+    idx = sk->heap[0];
+    error = sk->counters[idx].count;
+    shape_table_remove(sk, idx);
+    slot = hash & sk->mask;
+    while (sk->table[slot]) {
+      slot = (slot + 1) & sk->mask;
+    }
   }
-cleanup:
-  if (cursor_set) {
-    mdb_cursor_close(cursor_set);
+  shape_counter *c = &sk->counters[idx];
+  memcpy(c->name, name, name_len);
+  c->name_len = name_len;
+  c->hash = hash;
+  c->count = error + 1;
+  c->error = error;
+  sk->table[slot] = idx + 1;
+  if (error == 0) {
+    shape_heap_up(sk, c->heap_pos);
+  } else {
+    shape_heap_down(sk, c->heap_pos);
+  }
+}
+
+// 草图已满时未被跟踪的名字次数不超过最小计数，否则为 0
+static size_t shape_sketch_floor(const shape_sketch *sk) {
+  return sk->used == sk->cap ? sk->counters[sk->heap[0]].count : 0;
+}
+
+static void shape_hist_add(lmjcore_shape_hist *h, uint64_t v) {
+  size_t b = 0;
+  while (b < LMJCORE_SHAPE_BUCKETS - 1 && v >> b) {
+    b++;
   }
-  if (cursor_main) {
-    mdb_cursor_close(cursor_main);
+  if (h->count == 0 || v < h->min) {
+    h->min = v;
   }
-  return rc;
+  if (v > h->max) {
+    h->max = v;
+  }
+  h->count++;
+  h->sum += v;
+  h->buckets[b]++;
 }
 
-int lmjcore_repair_object(lmjcore_txn *txn, uint8_t *report_buf,
-                          size_t report_buf_size,
-                          lmjcore_audit_report *report) {
-  if (!txn || !report || !report_buf) {
-    return LMJCORE_ERROR_NULL_POINTER;
+static void shape_hist_merge(lmjcore_shape_hist *h,
+                             const lmjcore_shape_hist *part) {
+  if (part->count == 0) {
+    return;
+  }
+  if (h->count == 0 || part->min < h->min) {
+    h->min = part->min;
   }
+  if (part->max > h->max) {
+    h->max = part->max;
+  }
+  h->count += part->count;
+  h->sum += part->sum;
+  for (size_t i = 0; i < LMJCORE_SHAPE_BUCKETS; i++) {
+    h->buckets[i] += part->buckets[i];
+  }
+}
 
-  // 没有错误
-  if (report->audit_count == 0) {
-    return LMJCORE_SUCCESS;
+// 所有工作线程共享的分析任务
+typedef struct {
+  lmjcore_shared_snapshot *snap;
+  MDB_dbi main_dbi;
+  MDB_dbi set_dbi;
+  uint8_t (*bounds)[LMJCORE_PTR_LEN]; // 与 audit_job 相同的区间划分
+  size_t bound_count;
+  atomic_size_t next;
+  atomic_bool stop;
+  pthread_mutex_t lock; // 保护 error
+  int error;
+  size_t inline_limit;
+} shape_job;
+
+// 每个线程独立统计，结束后由调用线程合并
+typedef struct {
+  shape_job *job;
+  size_t index;
+  lmjcore_shape_report part;
+  shape_sketch sketch;
+} shape_worker;
+
+// 分析区间 [start, end) 内的实体与成员值
+static int shape_range(shape_worker *worker, MDB_cursor *set_cursor,
+                       MDB_cursor *main_cursor, const uint8_t *start,
+                       const uint8_t *end) {
+  shape_job *job = worker->job;
+  lmjcore_shape_report *part = &worker->part;
+  MDB_val key = {0}, data;
+  MDB_cursor_op first = MDB_FIRST;
+  if (start) {
+    key = (MDB_val){.mv_size = LMJCORE_PTR_LEN, .mv_data = (void *)start};
+    first = MDB_SET_RANGE;
+  }
+  MDB_val main_start = key;
+
+  size_t batch = 0;
+  int rc = mdb_cursor_get(set_cursor, &key, &data, first);
+  while (rc == MDB_SUCCESS && audit_in_range(&key, end)) {
+    if (++batch == AUDIT_STOP_BATCH) {
+      batch = 0;
+      if (atomic_load(&job->stop)) {
+        return LMJCORE_ERROR_CANCELLED;
+      }
+    }
+    bool valid_key = key.mv_size == LMJCORE_PTR_LEN;
+    uint8_t type = ((const uint8_t *)key.mv_data)[0];
+    bool obj = valid_key && type == LMJCORE_OBJ;
+    bool set = valid_key && type == LMJCORE_SET;
+    size_t members = 0;
+    do {
+      if (data.mv_size > 0) { // 跳过登记占位
+        members++;
+        if (obj) {
+          shape_hist_add(&part->member_name_len, data.mv_size);
+          if (data.mv_size <= LMJCORE_MAX_MEMBER_NAME_LEN) {
+            shape_sketch_add(&worker->sketch, data.mv_data, data.mv_size);
+          }
+        } else if (set) {
+          shape_hist_add(&part->element_size, data.mv_size);
+        }
+      }
+      rc = mdb_cursor_get(set_cursor, &key, &data, MDB_NEXT_DUP);
+    } while (rc == MDB_SUCCESS);
+    if (rc != MDB_NOTFOUND) {
+      return rc;
+    }
+    if (obj) {
+      part->objects++;
+      shape_hist_add(&part->obj_members, members);
+    } else if (set) {
+      part->sets++;
+      shape_hist_add(&part->set_cardinality, members);
+    }
+    rc = mdb_cursor_get(set_cursor, &key, &data, MDB_NEXT_NODUP);
+  }
+  if (rc != MDB_SUCCESS && rc != MDB_NOTFOUND) {
+    return rc;
   }
 
-  int final_result = LMJCORE_SUCCESS;
+  // main 库中区间内的全部成员值
+  key = main_start;
+  rc = mdb_cursor_get(main_cursor, &key, &data, first);
+  while (rc == MDB_SUCCESS && audit_in_range(&key, end)) {
+    if (++batch == AUDIT_STOP_BATCH) {
+      batch = 0;
+      if (atomic_load(&job->stop)) {
+        return LMJCORE_ERROR_CANCELLED;
+      }
+    }
+    shape_hist_add(&part->value_size, data.mv_size);
+    if (key.mv_size + data.mv_size > job->inline_limit) {
+      part->overflow_values++;
+    }
+    rc = mdb_cursor_get(main_cursor, &key, &data, MDB_NEXT);
+  }
+  return rc == MDB_NOTFOUND ? LMJCORE_SUCCESS : rc;
+}
 
-  // 遍历整个错误列表
-  for (size_t i = 0; i < report->audit_count; i++) {
-    lmjcore_audit_descriptor *desc = &report->audit_descriptor[i];
+static void shape_fail(shape_job *job, int rc) {
+  pthread_mutex_lock(&job->lock);
+  if (job->error == LMJCORE_SUCCESS) {
+    job->error = rc;
+  }
+  pthread_mutex_unlock(&job->lock);
+  atomic_store(&job->stop, true);
+}
 
-    // 验证成员名偏移和长度
-    if (desc->member.member_name.value_offset +
-            desc->member.member_name.value_len >
-        report_buf_size) {
-      final_result = LMJCORE_ERROR_INVALID_PARAM;
-      break;
-    }
+// 分析工作线程：领取区间直到取完或出错
+static void *shape_worker_main(void *arg) {
+  shape_worker *worker = arg;
+  shape_job *job = worker->job;
+  MDB_cursor *set_cursor = NULL, *main_cursor = NULL;
 
-    // 成员值的验证
-    if (desc->member.member_value.value_offset +
-            desc->member.member_value.value_len >
-        report_buf_size) {
-      final_result = LMJCORE_ERROR_INVALID_PARAM;
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_shared_snapshot_txn(job->snap, worker->index, &txn);
+  if (rc == LMJCORE_SUCCESS) {
+    rc = mdb_cursor_open(txn->mdb_txn, job->set_dbi, &set_cursor);
+  }
+  if (rc == MDB_SUCCESS) {
+    rc = mdb_cursor_open(txn->mdb_txn, job->main_dbi, &main_cursor);
+  }
+  while (rc == LMJCORE_SUCCESS && !atomic_load(&job->stop)) {
+    size_t i = atomic_fetch_add(&job->next, 1);
+    if (i > job->bound_count) {
       break;
     }
+    const uint8_t *start = i > 0 ? job->bounds[i - 1] : NULL;
+    const uint8_t *end = i < job->bound_count ? job->bounds[i] : NULL;
+    rc = shape_range(worker, set_cursor, main_cursor, start, end);
+  }
+  if (main_cursor) {
+    mdb_cursor_close(main_cursor);
+  }
+  if (set_cursor) {
+    mdb_cursor_close(set_cursor);
+  }
+  if (rc != LMJCORE_SUCCESS && rc != LMJCORE_ERROR_CANCELLED) {
+    shape_fail(job, rc);
+  }
+  return NULL;
+}
 
-    // 构建幽灵成员的完整key: <LMJCORE_PTR_LEN字节指针> + <成员名>
-    size_t key_len = LMJCORE_PTR_LEN + desc->member.member_name.value_len;
-    uint8_t ghost_key[key_len];
+// 合并时的一个候选名字
+typedef struct {
+  const shape_counter *counter;
+  size_t worker;
+} shape_candidate;
+
+static int shape_candidate_cmp_name(const void *a, const void *b) {
+  const shape_counter *x = ((const shape_candidate *)a)->counter;
+  const shape_counter *y = ((const shape_candidate *)b)->counter;
+  size_t n = x->name_len < y->name_len ? x->name_len : y->name_len;
+  int diff = memcmp(x->name, y->name, n);
+  if (diff != 0) {
+    return diff;
+  }
+  return (x->name_len > y->name_len) - (x->name_len < y->name_len);
+}
 
-    memcpy(ghost_key, desc->ptr, LMJCORE_PTR_LEN);
-    memcpy(ghost_key + LMJCORE_PTR_LEN,
-           report_buf + desc->member.member_name.value_offset,
-           desc->member.member_name.value_len);
+static int shape_name_cmp_count(const void *a, const void *b) {
+  const lmjcore_shape_name *x = a, *y = b;
+  if (x->count != y->count) {
+    return x->count < y->count ? 1 : -1;
+  }
+  size_t n = x->name_len < y->name_len ? x->name_len : y->name_len;
+  int diff = memcmp(x->name, y->name, n);
+  if (diff != 0) {
+    return diff;
+  }
+  return (x->name_len > y->name_len) - (x->name_len < y->name_len);
+}
 
-    MDB_val key = {.mv_data = ghost_key, .mv_size = key_len};
-    MDB_val value;
+/**
+ * @brief 合并各线程的草图，取次数最多的名字写入报告
+ *
+ * 某线程没有跟踪的名字，在该线程中的次数不超过其草图的最小计数，
+ * 把这部分同时计入 count 与 error，合并结果仍是上界且误差可控。
+ */
+static int shape_merge_names(shape_worker *workers, size_t count,
+                             lmjcore_shape_report *report) {
+  size_t total = 0, floor_sum = 0;
+  for (size_t w = 0; w < count; w++) {
+    total += workers[w].sketch.used;
+    floor_sum += shape_sketch_floor(&workers[w].sketch);
+  }
+  if (total == 0) {
+    return LMJCORE_SUCCESS;
+  }
+  shape_candidate *cands = malloc(total * sizeof(shape_candidate));
+  lmjcore_shape_name *names = malloc(total * sizeof(lmjcore_shape_name));
+  if (!cands || !names) {
+    free(cands);
+    free(names);
+    return LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+  }
+  size_t n = 0;
+  for (size_t w = 0; w < count; w++) {
+    for (size_t i = 0; i < workers[w].sketch.used; i++) {
+      cands[n++] = (shape_candidate){.counter = &workers[w].sketch.counters[i],
+                                     .worker = w};
+    }
+  }
+  qsort(cands, n, sizeof(shape_candidate), shape_candidate_cmp_name);
+
+  size_t unique = 0;
+  for (size_t i = 0; i < n;) {
+    const shape_counter *c = cands[i].counter;
+    lmjcore_shape_name *out = &names[unique++];
+    memcpy(out->name, c->name, c->name_len);
+    out->name_len = c->name_len;
+    out->count = floor_sum;
+    out->error = floor_sum;
+    size_t j = i;
+    for (; j < n && shape_candidate_cmp_name(&cands[i], &cands[j]) == 0; j++) {
+      const shape_counter *own = cands[j].counter;
+      size_t floor = shape_sketch_floor(&workers[cands[j].worker].sketch);
+      out->count = out->count - floor + own->count;
+      out->error = out->error - floor + own->error;
+    }
+    i = j;
+  }
+  qsort(names, unique, sizeof(lmjcore_shape_name), shape_name_cmp_count);
+  report->top_count =
+      unique < LMJCORE_SHAPE_TOP_NAMES ? unique : LMJCORE_SHAPE_TOP_NAMES;
+  memcpy(report->top, names, report->top_count * sizeof(lmjcore_shape_name));
+  free(cands);
+  free(names);
+  return LMJCORE_SUCCESS;
+}
 
-    int error = mdb_del(txn->mdb_txn, txn->env->main_dbi, &key, &value);
+// 并行分析整个数据库的数据形态
+int lmjcore_env_shape(lmjcore_env *env, const lmjcore_shape_opts *opts,
+                      lmjcore_shape_report *report_out) {
+  if (!env || !report_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  lmjcore_shape_opts defaults = {0};
+  if (!opts) {
+    opts = &defaults;
+  }
+  size_t threads = opts->threads ? opts->threads : AUDIT_DEFAULT_THREADS;
+  size_t ranges = opts->ranges ? opts->ranges
+                               : threads * AUDIT_RANGES_PER_THREAD;
+  size_t sketch_size =
+      opts->sketch_size ? opts->sketch_size : SHAPE_DEFAULT_SKETCH;
 
-    if (error != MDB_SUCCESS) {
-      final_result = error;
-      break; // 遇到第一个错误就停止，保持事务一致性
+  shape_job job = {.main_dbi = env->main_dbi, .set_dbi = env->set_dbi};
+  atomic_init(&job.next, 0);
+  atomic_init(&job.stop, false);
+  int rc = lmjcore_shared_snapshot_create(env, threads, &job.snap);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  uint64_t started_ms = monotonic_ms();
+  lmjcore_shape_report report = {0};
+  lmjcore_shared_snapshot_txn_id(job.snap, &report.txn_id);
+
+  // 区间划分与全库审计相同
+  lmjcore_txn *txn = NULL;
+  rc = lmjcore_shared_snapshot_txn(job.snap, 0, &txn);
+  if (rc == LMJCORE_SUCCESS) {
+    audit_job split = {.set_dbi = env->set_dbi};
+    rc = audit_split(&split, txn->mdb_txn, ranges);
+    job.bounds = split.bounds;
+    job.bound_count = split.bound_count;
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    MDB_stat st;
+    rc = mdb_stat(txn->mdb_txn, env->main_dbi, &st);
+    if (rc == MDB_SUCCESS) {
+      job.inline_limit = lmdb_node_max(st.ms_psize) - LMDB_NODE_HEADER;
+      report.inline_limit = job.inline_limit;
     }
   }
+  shape_worker *workers = NULL;
+  pthread_t *tids = NULL;
+  if (rc == LMJCORE_SUCCESS) {
+    workers = calloc(threads, sizeof(shape_worker));
+    tids = calloc(threads, sizeof(pthread_t));
+    if (!workers || !tids) {
+      rc = LMJCORE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+  }
+  for (size_t i = 0; rc == LMJCORE_SUCCESS && i < threads; i++) {
+    workers[i].job = &job;
+    workers[i].index = i;
+    rc = shape_sketch_init(&workers[i].sketch, sketch_size);
+  }
 
-  return final_result;
+  if (rc == LMJCORE_SUCCESS) {
+    pthread_mutex_init(&job.lock, NULL);
+    size_t running = 0;
+    for (; running < threads; running++) {
+      if (pthread_create(&tids[running], NULL, shape_worker_main,
+                         &workers[running]) != 0) {
+        break;
+      }
+    }
+    if (running == 0) {
+      // 无法创建线程时由调用线程自己完成
+      shape_worker_main(&workers[0]);
+    }
+    for (size_t i = 0; i < running; i++) {
+      pthread_join(tids[i], NULL);
+    }
+    pthread_mutex_destroy(&job.lock);
+    rc = job.error;
+  }
+
+  if (rc == LMJCORE_SUCCESS) {
+    for (size_t i = 0; i < threads; i++) {
+      const lmjcore_shape_report *part = &workers[i].part;
+      report.objects += part->objects;
+      report.sets += part->sets;
+      report.overflow_values += part->overflow_values;
+      shape_hist_merge(&report.obj_members, &part->obj_members);
+      shape_hist_merge(&report.member_name_len, &part->member_name_len);
+      shape_hist_merge(&report.value_size, &part->value_size);
+      shape_hist_merge(&report.set_cardinality, &part->set_cardinality);
+      shape_hist_merge(&report.element_size, &part->element_size);
+    }
+    rc = shape_merge_names(workers, threads, &report);
+  }
+  if (rc == LMJCORE_SUCCESS) {
+    report.elapsed_ms = monotonic_ms() - started_ms;
+    *report_out = report;
+  }
+
+  for (size_t i = 0; workers && i < threads; i++) {
+    shape_sketch_free(&workers[i].sketch);
+  }
+  free(workers);
+  free(tids);
+  free(job.bounds);
+  lmjcore_shared_snapshot_destroy(job.snap);
+  return rc;
 }
 
 /*
@@ -1438,7 +6939,7 @@ int lmjcore_entity_exist(lmjcore_txn *txn, const lmjcore_ptr ptr) {
   MDB_val data;
 
   // 在 set 数据库中查找
-  int rc = mdb_get(txn->mdb_txn, txn->env->set_dbi, &key, &data);
+  int rc = txn_get(txn, txn->env->set_dbi, &key, &data);
   if (rc == MDB_NOTFOUND) {
     return 0; // 不存在
   }
@@ -1447,10 +6948,49 @@ int lmjcore_entity_exist(lmjcore_txn *txn, const lmjcore_ptr ptr) {
     return 1; // 存在
   }
 
-  // 其他返回mdb_get
+  // 其他返回LMDB错误
   return rc;
 }
 
+// 遍历实体（独立游标，回调内的读取不会移动遍历位置）
+int lmjcore_entity_scan(lmjcore_txn *txn, const lmjcore_ptr start,
+                        lmjcore_entity_scan_fn fn, void *ctx) {
+  if (!txn || !fn) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  MDB_cursor *cursor = NULL;
+  int rc = mdb_cursor_open(txn->mdb_txn, txn->env->set_dbi, &cursor);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+
+  MDB_val key = {.mv_size = 0, .mv_data = NULL};
+  MDB_val data;
+  if (start) {
+    key.mv_size = LMJCORE_PTR_LEN;
+    key.mv_data = (void *)start;
+    rc = mdb_cursor_get(cursor, &key, &data, MDB_SET_RANGE);
+  } else {
+    rc = mdb_cursor_get(cursor, &key, &data, MDB_FIRST);
+  }
+
+  while (rc == MDB_SUCCESS) {
+    if (key.mv_size == LMJCORE_PTR_LEN) {
+      lmjcore_ptr ptr;
+      memcpy(ptr, key.mv_data, LMJCORE_PTR_LEN);
+      int stop = fn(ctx, ptr);
+      if (stop != 0) {
+        mdb_cursor_close(cursor);
+        return stop;
+      }
+    }
+    rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT_NODUP);
+  }
+  mdb_cursor_close(cursor);
+  return rc == MDB_NOTFOUND ? LMJCORE_SUCCESS : rc;
+}
+
 // 成员值存在性检查
 int lmjcore_obj_member_value_exist(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
                                    const uint8_t *member_name,
@@ -1473,7 +7013,7 @@ int lmjcore_obj_member_value_exist(lmjcore_txn *txn, const lmjcore_ptr obj_ptr,
                  .mv_size = LMJCORE_PTR_LEN + member_name_len};
   MDB_val value;
 
-  int rc = mdb_get(txn->mdb_txn, txn->env->main_dbi, &key, &value);
+  int rc = txn_get(txn, txn->env->main_dbi, &key, &value);
   if (rc == MDB_SUCCESS) {
     return 1;
   }
@@ -1509,6 +7049,31 @@ int lmjcore_ptr_to_string(const lmjcore_ptr ptr, char *str_buf,
   return LMJCORE_SUCCESS;
 }
 
+// 读取分片编号
+int lmjcore_ptr_shard_get(const lmjcore_ptr ptr, uint16_t *shard_out) {
+  if (!ptr || !shard_out) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+  if (ptr[0] != LMJCORE_OBJ && ptr[0] != LMJCORE_SET) {
+    return LMJCORE_ERROR_INVALID_POINTER;
+  }
+
+  *shard_out = (uint16_t)((ptr[LMJCORE_PTR_SHARD_OFFSET] << 8) |
+                          ptr[LMJCORE_PTR_SHARD_OFFSET + 1]);
+  return LMJCORE_SUCCESS;
+}
+
+// 写入分片编号
+int lmjcore_ptr_shard_set(lmjcore_ptr ptr, uint16_t shard) {
+  if (!ptr) {
+    return LMJCORE_ERROR_NULL_POINTER;
+  }
+
+  ptr[LMJCORE_PTR_SHARD_OFFSET] = (uint8_t)(shard >> 8);
+  ptr[LMJCORE_PTR_SHARD_OFFSET + 1] = (uint8_t)shard;
+  return LMJCORE_SUCCESS;
+}
+
 // 字符串转指针
 int lmjcore_ptr_from_string(const char *str, lmjcore_ptr ptr_out) {
   if (!str || !ptr_out) {
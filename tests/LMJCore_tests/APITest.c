@@ -422,6 +422,61 @@ static void test_audit_repair(lmjcore_env *env) {
   lmjcore_txn_commit(txn);
 }
 
+// 测试事务内游标复用（交替访问多个实体）
+static void test_cursor_reuse(lmjcore_env *env) {
+  printf("\n=== 测试游标复用 ===\n");
+
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(env, NULL, LMJCORE_TXN_DEFAULT, &txn);
+  assert(rc == LMJCORE_SUCCESS);
+
+  lmjcore_ptr obj_a, obj_b, set_ptr;
+  lmjcore_obj_create(txn, obj_a);
+  lmjcore_obj_create(txn, obj_b);
+  lmjcore_set_create(txn, set_ptr);
+
+  const char *names[] = {"alpha", "beta", "gamma"};
+  for (int i = 0; i < 3; i++) {
+    lmjcore_obj_member_put(txn, obj_a, (const uint8_t *)names[i],
+                           strlen(names[i]), (const uint8_t *)"a", 1);
+    lmjcore_obj_member_put(txn, obj_b, (const uint8_t *)names[i],
+                           strlen(names[i]), (const uint8_t *)"b", 1);
+  }
+  lmjcore_set_add(txn, set_ptr, (const uint8_t *)"x", 1);
+  lmjcore_set_add(txn, set_ptr, (const uint8_t *)"y", 1);
+
+  // 交替读取不同实体，游标位置不应影响结果
+  uint8_t buf[TEST_BUF_SIZE];
+  lmjcore_result_obj *obj_result = NULL;
+  rc = lmjcore_obj_get(txn, obj_a, buf, sizeof(buf), &obj_result);
+  print_test_result("游标复用: obj_get(a)", rc, LMJCORE_SUCCESS);
+  rc = lmjcore_set_contains(txn, set_ptr, (const uint8_t *)"y", 1);
+  print_test_result("游标复用: set_contains(存在)", rc, 1);
+  rc = lmjcore_set_contains(txn, set_ptr, (const uint8_t *)"z", 1);
+  print_test_result("游标复用: set_contains(不存在)", rc, 0);
+  rc = lmjcore_obj_get(txn, obj_b, buf, sizeof(buf), &obj_result);
+  print_test_result("游标复用: obj_get(b)", rc, LMJCORE_SUCCESS);
+
+  // 删除对象后其全部成员值都应被清除
+  rc = lmjcore_obj_del(txn, obj_a);
+  print_test_result("游标复用: obj_del(a)", rc, LMJCORE_SUCCESS);
+  int remaining = 0;
+  for (int i = 0; i < 3; i++) {
+    remaining += lmjcore_obj_member_value_exist(txn, obj_a,
+                                                (const uint8_t *)names[i],
+                                                strlen(names[i]));
+  }
+  print_test_result("游标复用: 成员值已清除", remaining, 0);
+  print_test_result("游标复用: 对象已删除", lmjcore_entity_exist(txn, obj_a),
+                    0);
+  rc = lmjcore_obj_get(txn, obj_b, buf, sizeof(buf), &obj_result);
+  print_test_result("游标复用: 其他对象不受影响",
+                    rc == LMJCORE_SUCCESS && obj_result->member_count >= 3, 1);
+
+  rc = lmjcore_txn_commit(txn);
+  print_test_result("游标复用: 提交", rc, LMJCORE_SUCCESS);
+}
+
 // 测试指针工具函数
 static void test_ptr_utils(void) {
   printf("\n=== 测试指针工具函数 ===\n");
@@ -505,6 +560,7 @@ int main(void) {
   test_object_register(env);
   test_array_operations(env);
   test_audit_repair(env);
+  test_cursor_reuse(env);
   test_error_handling(env);
 
   // 清理环境
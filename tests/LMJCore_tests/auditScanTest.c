@@ -0,0 +1,224 @@
+#include "lmjcore.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+// 测试配置
+#define TEST_DB_PATH "./lmjcore_db/audit_scan_test.mdb"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_OBJECTS 3000
+#define TEST_SETS 200
+#define TEST_EMPTY_OBJECTS 5
+
+// 简单的递增指针生成器
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static uint64_t counter = 0;
+  (void)ctx;
+
+  memset(out, 0, LMJCORE_PTR_LEN);
+  counter++;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (counter >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+// 访问内部结构（仅供测试使用，用于绕过 API 制造不一致数据）
+struct lmjcore_env_internal {
+  MDB_env *mdb_env;
+  MDB_dbi main_dbi;
+  MDB_dbi set_dbi;
+};
+
+// 直接写入一个键值对
+static int put_raw(lmjcore_env *env, bool to_set, const lmjcore_ptr ptr,
+                   const char *name, const char *value) {
+  struct lmjcore_env_internal *internal = (struct lmjcore_env_internal *)env;
+  MDB_txn *txn = NULL;
+  int rc = mdb_txn_begin(internal->mdb_env, NULL, 0, &txn);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  size_t name_len = strlen(name);
+  uint8_t key[LMJCORE_PTR_LEN + 64];
+  memcpy(key, ptr, LMJCORE_PTR_LEN);
+  memcpy(key + LMJCORE_PTR_LEN, name, name_len);
+  MDB_val k = {.mv_size = LMJCORE_PTR_LEN + (to_set ? 0 : name_len),
+               .mv_data = key};
+  MDB_val v = {.mv_size = strlen(value), .mv_data = (void *)value};
+  rc = mdb_put(txn, to_set ? internal->set_dbi : internal->main_dbi, &k, &v,
+               0);
+  if (rc != MDB_SUCCESS) {
+    mdb_txn_abort(txn);
+    return rc;
+  }
+  return mdb_txn_commit(txn);
+}
+
+// 按类型统计回调收到的发现，并检查回调不会并发执行
+typedef struct {
+  int counts[LMJCORE_AUDIT_ALL + 1];
+  atomic_int inside;
+  int overlapped;
+  int stop_after; // 大于 0 时收到这么多条后中止
+  int seen;
+} finding_ctx;
+
+static int on_finding(void *ctx, const lmjcore_audit_finding *finding) {
+  finding_ctx *fc = ctx;
+  if (atomic_fetch_add(&fc->inside, 1) != 0) {
+    fc->overlapped = 1;
+  }
+  fc->counts[finding->kind]++;
+  fc->seen++;
+  atomic_fetch_sub(&fc->inside, 1);
+  return fc->stop_after > 0 && fc->seen >= fc->stop_after ? 12345 : 0;
+}
+
+int main() {
+  printf("=== LMJCore 全库并行审计测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE,
+                        LMJCORE_ENV_NOSUBDIR | LMJCORE_ENV_NOTLS,
+                        test_ptr_generator, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+
+  // 空库
+  lmjcore_audit_scan_stats stats;
+  rc = lmjcore_audit_scan(env, NULL, &stats);
+  print_test_result("空库审计", rc, LMJCORE_SUCCESS);
+  print_test_result("空库无实体", (int)stats.entities, 0);
+
+  // 正常数据：对象两个成员，集合两个元素，另有若干空对象
+  static lmjcore_ptr objs[TEST_OBJECTS];
+  static lmjcore_ptr sets[TEST_SETS];
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    lmjcore_obj_create(txn, objs[i]);
+    lmjcore_obj_member_put(txn, objs[i], (const uint8_t *)"a", 1,
+                           (const uint8_t *)"1", 1);
+    lmjcore_obj_member_put(txn, objs[i], (const uint8_t *)"b", 1,
+                           (const uint8_t *)"2", 1);
+  }
+  for (int i = 0; i < TEST_SETS; i++) {
+    lmjcore_set_create(txn, sets[i]);
+    lmjcore_set_add(txn, sets[i], (const uint8_t *)"x", 1);
+    lmjcore_set_add(txn, sets[i], (const uint8_t *)"y", 1);
+  }
+  for (int i = 0; i < TEST_EMPTY_OBJECTS; i++) {
+    lmjcore_ptr obj;
+    lmjcore_obj_create(txn, obj);
+  }
+  // 缺失值：只登记成员名，或删除成员值
+  lmjcore_obj_member_register(txn, objs[10], (const uint8_t *)"c", 1);
+  lmjcore_obj_member_value_del(txn, objs[20], (const uint8_t *)"a", 1);
+  lmjcore_txn_commit(txn);
+
+  // 幽灵成员：已登记对象下的未登记成员（排在已登记成员前后各一个），
+  // 以及未登记对象的成员
+  put_raw(env, false, objs[30], "zz", "ghost");
+  put_raw(env, false, objs[31], "0", "ghost");
+  lmjcore_ptr orphan;
+  memset(orphan, 0xee, sizeof(orphan));
+  orphan[0] = LMJCORE_OBJ;
+  put_raw(env, false, orphan, "a", "orphan");
+  // 类型异常：集合下有成员值，以及类型字节无效的实体
+  put_raw(env, false, sets[0], "m", "bad");
+  lmjcore_ptr bad_type;
+  memset(bad_type, 0x01, sizeof(bad_type));
+  bad_type[0] = 0x07;
+  put_raw(env, true, bad_type, "", "");
+
+  lmjcore_storage_stats storage;
+  lmjcore_env_stats(env, &storage);
+
+  finding_ctx fc = {0};
+  lmjcore_audit_scan_opts opts = {
+      .threads = 4, .on_finding = on_finding, .ctx = &fc};
+  rc = lmjcore_audit_scan(env, &opts, &stats);
+  print_test_result("audit_scan", rc, LMJCORE_SUCCESS);
+  print_test_result("实体数", (int)stats.entities,
+                    TEST_OBJECTS + TEST_SETS + TEST_EMPTY_OBJECTS + 1);
+  print_test_result("main 条目全部扫描", (int)stats.main_entries,
+                    (int)storage.main.entries);
+  print_test_result("set 条目全部扫描", (int)stats.set_entries,
+                    (int)storage.set.entries);
+  print_test_result("幽灵成员", (int)stats.ghost_members, 3);
+  print_test_result("缺失值", (int)stats.missing_values, 2);
+  print_test_result("空对象", (int)stats.empty_objects, TEST_EMPTY_OBJECTS);
+  print_test_result("类型异常", (int)stats.type_mismatches, 2);
+  print_test_result("回调计数一致",
+                    fc.counts[LMJCORE_AUDIT_GHOST_MEMBER] == 3 &&
+                        fc.counts[LMJCORE_AUDIT_MISSING_VALUE] == 2 &&
+                        fc.counts[LMJCORE_AUDIT_EMPTY_OBJECT] ==
+                            TEST_EMPTY_OBJECTS &&
+                        fc.counts[LMJCORE_AUDIT_TYPE_MISMATCH] == 2,
+                    1);
+  print_test_result("回调串行执行", fc.overlapped, 0);
+  print_test_result("吞吐量", stats.entries_per_sec > 0, 1);
+  print_test_result("数据版本", stats.txn_id > 0, 1);
+  printf("entities=%zu main=%zu set=%zu elapsed=%llums rate=%.0f/s\n",
+         stats.entities, stats.main_entries, stats.set_entries,
+         (unsigned long long)stats.elapsed_ms, stats.entries_per_sec);
+
+  // 单线程、大量区间与默认区间的结果一致
+  lmjcore_audit_scan_stats single;
+  opts = (lmjcore_audit_scan_opts){.threads = 1};
+  rc = lmjcore_audit_scan(env, &opts, &single);
+  print_test_result("单线程审计", rc, LMJCORE_SUCCESS);
+  lmjcore_audit_scan_stats many;
+  opts = (lmjcore_audit_scan_opts){.threads = 3, .ranges = 1000};
+  lmjcore_audit_scan(env, &opts, &many);
+  int same = 1;
+  lmjcore_audit_scan_stats *runs[] = {&single, &many};
+  for (int i = 0; i < 2; i++) {
+    if (runs[i]->entities != stats.entities ||
+        runs[i]->main_entries != stats.main_entries ||
+        runs[i]->set_entries != stats.set_entries ||
+        runs[i]->ghost_members != stats.ghost_members ||
+        runs[i]->missing_values != stats.missing_values ||
+        runs[i]->empty_objects != stats.empty_objects ||
+        runs[i]->type_mismatches != stats.type_mismatches) {
+      same = 0;
+    }
+  }
+  print_test_result("切分方式不影响结果", same, 1);
+
+  // 只回调指定类型
+  memset(&fc, 0, sizeof(fc));
+  opts = (lmjcore_audit_scan_opts){.report_mask = LMJCORE_AUDIT_GHOST_MEMBER,
+                                   .on_finding = on_finding,
+                                   .ctx = &fc};
+  lmjcore_audit_scan(env, &opts, NULL);
+  print_test_result("按类型过滤回调", fc.seen, 3);
+
+  // 回调中止扫描
+  memset(&fc, 0, sizeof(fc));
+  fc.stop_after = 1;
+  opts = (lmjcore_audit_scan_opts){.on_finding = on_finding, .ctx = &fc};
+  rc = lmjcore_audit_scan(env, &opts, NULL);
+  print_test_result("回调中止", rc, 12345);
+  print_test_result("中止后不再回调", fc.seen, 1);
+
+  print_test_result("空参数", lmjcore_audit_scan(NULL, NULL, NULL),
+                    LMJCORE_ERROR_NULL_POINTER);
+
+  lmjcore_cleanup(env);
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
@@ -0,0 +1,285 @@
+#include "lmjcore.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// 测试配置
+#define TEST_DB_PATH "./lmjcore_db/compact_test.mdb"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_OBJECTS 2000
+#define TEST_WRITES 4000
+
+// 简单的递增指针生成器（写线程与主线程共用，原子计数）
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static atomic_uint_fast64_t counter = 0;
+  (void)ctx;
+
+  uint64_t value = atomic_fetch_add(&counter, 1) + 1;
+  memset(out, 0, LMJCORE_PTR_LEN);
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (value >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+// 读取成员 v，返回值；不存在时返回 -1
+static int read_value(lmjcore_env *env, const lmjcore_ptr obj) {
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  int value = -1;
+  size_t size = 0;
+  int rc = lmjcore_obj_member_get(txn, obj, (const uint8_t *)"v", 1,
+                                  (uint8_t *)&value, sizeof(value), &size);
+  lmjcore_txn_abort(txn);
+  return rc == LMJCORE_SUCCESS && size == sizeof(value) ? value : -1;
+}
+
+// 压缩期间持续写入：每次创建一个对象，每三次删除上一个
+typedef struct {
+  lmjcore_env *env;
+  atomic_bool stop;
+  lmjcore_ptr objs[TEST_WRITES];
+  int alive[TEST_WRITES];
+  int count;
+  int failures;
+} writer_ctx;
+
+static void *writer_main(void *arg) {
+  writer_ctx *ctx = arg;
+  while (!atomic_load(&ctx->stop) && ctx->count < TEST_WRITES) {
+    int i = ctx->count;
+    lmjcore_txn *txn = NULL;
+    if (lmjcore_txn_begin(ctx->env, NULL, 0, &txn) != LMJCORE_SUCCESS) {
+      ctx->failures++;
+      continue;
+    }
+    int rc = lmjcore_obj_create(txn, ctx->objs[i]);
+    if (rc == LMJCORE_SUCCESS) {
+      rc = lmjcore_obj_member_put(txn, ctx->objs[i], (const uint8_t *)"v", 1,
+                                  (const uint8_t *)&i, sizeof(i));
+    }
+    bool del = i > 0 && i % 3 == 0 && ctx->alive[i - 1];
+    if (rc == LMJCORE_SUCCESS && del) {
+      rc = lmjcore_obj_del(txn, ctx->objs[i - 1]);
+    }
+    if (rc == LMJCORE_SUCCESS) {
+      rc = lmjcore_txn_commit(txn);
+    } else {
+      lmjcore_txn_abort(txn);
+    }
+    if (rc != LMJCORE_SUCCESS) {
+      ctx->failures++;
+      continue;
+    }
+    ctx->alive[i] = 1;
+    if (del) {
+      ctx->alive[i - 1] = 0;
+    }
+    ctx->count++;
+  }
+  return NULL;
+}
+
+// 在后台线程中压缩，用于检查压缩期间的其他操作
+typedef struct {
+  lmjcore_env *env;
+  lmjcore_compact_opts opts;
+  int rc;
+} compact_ctx;
+
+static void *compact_main(void *arg) {
+  compact_ctx *ctx = arg;
+  ctx->rc = lmjcore_env_compact(ctx->env, &ctx->opts, NULL);
+  return NULL;
+}
+
+// 压缩期间反复扩大映射
+typedef struct {
+  lmjcore_env *env;
+  atomic_bool stop;
+  int grown;
+} grow_ctx;
+
+static void *grow_main(void *arg) {
+  grow_ctx *ctx = arg;
+  while (!atomic_load(&ctx->stop)) {
+    if (lmjcore_env_map_grow(ctx->env) == LMJCORE_SUCCESS) {
+      ctx->grown++;
+    }
+    usleep(1000);
+  }
+  return NULL;
+}
+
+int main() {
+  printf("=== LMJCore 在线压缩测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+  remove(TEST_DB_PATH ".compact");
+
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE,
+                        LMJCORE_ENV_NOSUBDIR | LMJCORE_ENV_NOTLS,
+                        test_ptr_generator, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+
+  // 准备数据后删除大部分对象，留下大量空闲页
+  static lmjcore_ptr objs[TEST_OBJECTS];
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    lmjcore_obj_create(txn, objs[i]);
+    lmjcore_obj_member_put(txn, objs[i], (const uint8_t *)"v", 1,
+                           (const uint8_t *)&i, sizeof(i));
+  }
+  lmjcore_txn_commit(txn);
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    if (i % 4 != 0) {
+      lmjcore_obj_del(txn, objs[i]);
+    }
+  }
+  lmjcore_txn_commit(txn);
+
+  print_test_result("空环境参数", lmjcore_env_compact(NULL, NULL, NULL),
+                    LMJCORE_ERROR_NULL_POINTER);
+
+  // 无并发写入时压缩
+  lmjcore_compact_stats stats;
+  rc = lmjcore_env_compact(env, NULL, &stats);
+  print_test_result("env_compact", rc, LMJCORE_SUCCESS);
+  print_test_result("文件未变大", stats.size_after <= stats.size_before, 1);
+  print_test_result("交换前执行最后一轮", stats.rounds >= 1, 1);
+  print_test_result("副本已替换", access(TEST_DB_PATH ".compact", F_OK), -1);
+  printf("size_before=%zu size_after=%zu\n", stats.size_before,
+         stats.size_after);
+
+  int intact = 1;
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    int expect = i % 4 == 0 ? i : -1;
+    if (read_value(env, objs[i]) != expect) {
+      intact = 0;
+    }
+  }
+  print_test_result("压缩后数据完整", intact, 1);
+
+  // 压缩后可以继续写入
+  lmjcore_ptr obj;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  rc = lmjcore_obj_create(txn, obj);
+  lmjcore_txn_commit(txn);
+  print_test_result("压缩后写入", rc, LMJCORE_SUCCESS);
+
+  // 压缩期间持续写入，追赶后不丢失
+  static writer_ctx wctx;
+  wctx.env = env;
+  pthread_t writer;
+  pthread_create(&writer, NULL, writer_main, &wctx);
+  usleep(20 * 1000);
+  lmjcore_compact_opts opts = {.max_rounds = 4, .swap_threshold = 1};
+  rc = lmjcore_env_compact(env, &opts, &stats);
+  atomic_store(&wctx.stop, true);
+  pthread_join(writer, NULL);
+  print_test_result("写入期间压缩", rc, LMJCORE_SUCCESS);
+  print_test_result("写线程无失败", wctx.failures, 0);
+  printf("writes=%d rounds=%u keys_synced=%zu\n", wctx.count, stats.rounds,
+         stats.keys_synced);
+
+  intact = 1;
+  for (int i = 0; i < wctx.count; i++) {
+    int expect = wctx.alive[i] ? i : -1;
+    if (read_value(env, wctx.objs[i]) != expect) {
+      intact = 0;
+    }
+  }
+  print_test_result("并发写入全部保留", intact, 1);
+
+  // 压缩期间扩容映射：复制与追赶的事务经过闸门，扩容在它们之间进行
+  size_t map_before = 0, map_after = 0;
+  lmjcore_env_get_map_size(env, &map_before);
+  lmjcore_env_set_map_grow(env, 1.05, (size_t)TEST_MAP_SIZE * 4);
+  static writer_ctx wctx2;
+  wctx2.env = env;
+  static grow_ctx gctx;
+  gctx.env = env;
+  pthread_t grower;
+  pthread_create(&writer, NULL, writer_main, &wctx2);
+  pthread_create(&grower, NULL, grow_main, &gctx);
+  usleep(20 * 1000);
+  opts = (lmjcore_compact_opts){.max_rounds = 4, .swap_threshold = 1};
+  rc = lmjcore_env_compact(env, &opts, NULL);
+  atomic_store(&wctx2.stop, true);
+  atomic_store(&gctx.stop, true);
+  pthread_join(writer, NULL);
+  pthread_join(grower, NULL);
+  lmjcore_env_get_map_size(env, &map_after);
+  print_test_result("扩容期间压缩", rc, LMJCORE_SUCCESS);
+  print_test_result("压缩期间发生扩容", gctx.grown > 0, 1);
+  print_test_result("映射已扩大", map_after > map_before, 1);
+  intact = wctx2.failures == 0;
+  for (int i = 0; i < wctx2.count; i++) {
+    int expect = wctx2.alive[i] ? i : -1;
+    if (read_value(env, wctx2.objs[i]) != expect) {
+      intact = 0;
+    }
+  }
+  print_test_result("扩容与压缩后写入全部保留", intact, 1);
+  lmjcore_env_set_map_grow(env, 0, 0);
+
+  // 共享读快照阻止排空，超时后原文件不变
+  lmjcore_shared_snapshot *snap = NULL;
+  lmjcore_shared_snapshot_create(env, 1, &snap);
+  opts = (lmjcore_compact_opts){.drain_timeout_ms = 50};
+  rc = lmjcore_env_compact(env, &opts, NULL);
+  print_test_result("排空超时", rc, ETIMEDOUT);
+  lmjcore_shared_snapshot_destroy(snap);
+  print_test_result("超时后数据仍在", read_value(env, objs[0]), 0);
+
+  // 压缩进行中不能切换脏对象日志与实体统计（快照阻止排空，压缩停在交换之前）
+  lmjcore_shared_snapshot_create(env, 1, &snap);
+  compact_ctx cctx = {.env = env, .opts = {.drain_timeout_ms = 500}};
+  pthread_t compactor;
+  pthread_create(&compactor, NULL, compact_main, &cctx);
+  usleep(100 * 1000);
+  print_test_result("压缩期间启用脏对象日志", lmjcore_journal_set(env, true),
+                    LMJCORE_ERROR_BUSY);
+  print_test_result("压缩期间启用实体统计",
+                    lmjcore_entity_stats_set(env, true), LMJCORE_ERROR_BUSY);
+  pthread_join(compactor, NULL);
+  lmjcore_shared_snapshot_destroy(snap);
+  print_test_result("等待快照的压缩超时", cctx.rc, ETIMEDOUT);
+  print_test_result("压缩结束后启用脏对象日志",
+                    lmjcore_journal_set(env, true), LMJCORE_SUCCESS);
+  print_test_result("关闭脏对象日志", lmjcore_journal_set(env, false),
+                    LMJCORE_SUCCESS);
+  print_test_result("压缩结束后启用实体统计",
+                    lmjcore_entity_stats_set(env, true), LMJCORE_SUCCESS);
+  print_test_result("关闭实体统计", lmjcore_entity_stats_set(env, false),
+                    LMJCORE_SUCCESS);
+
+  // 重新打开后数据持久
+  lmjcore_cleanup(env);
+  rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE, LMJCORE_ENV_NOSUBDIR,
+                    test_ptr_generator, NULL, &env);
+  print_test_result("重新打开", rc, LMJCORE_SUCCESS);
+  print_test_result("重新打开后数据仍在", read_value(env, objs[4]), 4);
+  print_test_result("删除的对象不存在", read_value(env, objs[5]), -1);
+  lmjcore_cleanup(env);
+
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
@@ -0,0 +1,291 @@
+#include "lmjcore.h"
+#include <stdio.h>
+#include <string.h>
+
+// 测试配置
+#define TEST_DB_PATH "./lmjcore_db/entity_stats_test.mdb"
+#define TEST_MAP_SIZE (1024 * 1024 * 20) // 20MB
+#define TEST_OBJECTS 200
+#define TEST_SETS 50
+#define TEST_OPS 5000
+
+// 简单的递增指针生成器
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static uint64_t counter = 0;
+  (void)ctx;
+
+  memset(out, 0, LMJCORE_PTR_LEN);
+  counter++;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (counter >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+// 访问内部结构（仅供测试使用，用于绕过 API 制造幽灵成员）
+struct lmjcore_env_internal {
+  MDB_env *mdb_env;
+  MDB_dbi main_dbi;
+  MDB_dbi set_dbi;
+};
+
+static int put_ghost(lmjcore_env *env, const lmjcore_ptr ptr,
+                     const char *name) {
+  struct lmjcore_env_internal *internal = (struct lmjcore_env_internal *)env;
+  MDB_txn *txn = NULL;
+  int rc = mdb_txn_begin(internal->mdb_env, NULL, 0, &txn);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  size_t name_len = strlen(name);
+  uint8_t key[LMJCORE_PTR_LEN + 64];
+  memcpy(key, ptr, LMJCORE_PTR_LEN);
+  memcpy(key + LMJCORE_PTR_LEN, name, name_len);
+  MDB_val k = {.mv_size = LMJCORE_PTR_LEN + name_len, .mv_data = key};
+  MDB_val v = {.mv_size = 5, .mv_data = "ghost"};
+  rc = mdb_put(txn, internal->main_dbi, &k, &v, 0);
+  if (rc != MDB_SUCCESS) {
+    mdb_txn_abort(txn);
+    return rc;
+  }
+  return mdb_txn_commit(txn);
+}
+
+// 一个实体的全部统计结果
+typedef struct {
+  int rc;
+  size_t member_len, members;
+  size_t value_len, values;
+  size_t count;
+} entity_stat;
+
+static lmjcore_ptr objs[TEST_OBJECTS];
+static lmjcore_ptr sets[TEST_SETS];
+
+// 读取全部实体的统计结果
+static void collect(lmjcore_env *env, entity_stat *obj_out,
+                    entity_stat *set_out) {
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    entity_stat *st = &obj_out[i];
+    memset(st, 0, sizeof(*st));
+    st->rc = lmjcore_obj_stat_members(txn, objs[i], &st->member_len,
+                                      &st->members);
+    lmjcore_obj_stat_values(txn, objs[i], &st->value_len, &st->values);
+  }
+  for (int i = 0; i < TEST_SETS; i++) {
+    entity_stat *st = &set_out[i];
+    memset(st, 0, sizeof(*st));
+    st->rc = lmjcore_set_stat(txn, sets[i], &st->member_len, &st->members);
+    lmjcore_set_count(txn, sets[i], &st->count);
+  }
+  lmjcore_txn_abort(txn);
+}
+
+// 比较两次统计结果，返回不一致的实体数
+static int diff(const entity_stat *a, const entity_stat *b, int n) {
+  int bad = 0;
+  for (int i = 0; i < n; i++) {
+    if (memcmp(&a[i], &b[i], sizeof(entity_stat)) != 0) {
+      bad++;
+    }
+  }
+  return bad;
+}
+
+// 简单的线性同余随机数
+static unsigned int next_rand(unsigned int *state) {
+  *state = *state * 1103515245u + 12345u;
+  return (*state >> 16) & 0x7fff;
+}
+
+// 对对象和集合随机执行各种写操作
+static void mutate(lmjcore_env *env, unsigned int seed) {
+  unsigned int state = seed;
+  char name[16], value[64];
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  for (int i = 0; i < TEST_OPS; i++) {
+    unsigned int op = next_rand(&state) % 8;
+    lmjcore_ptr *obj = &objs[next_rand(&state) % TEST_OBJECTS];
+    lmjcore_ptr *set = &sets[next_rand(&state) % TEST_SETS];
+    snprintf(name, sizeof(name), "m%u", next_rand(&state) % 6);
+    size_t name_len = strlen(name);
+    size_t value_len = next_rand(&state) % sizeof(value);
+    memset(value, 'v', value_len);
+    switch (op) {
+    case 0:
+    case 1:
+      lmjcore_obj_member_put(txn, *obj, (const uint8_t *)name, name_len,
+                             (const uint8_t *)value, value_len);
+      break;
+    case 2:
+      lmjcore_obj_member_register(txn, *obj, (const uint8_t *)name, name_len);
+      break;
+    case 3:
+      lmjcore_obj_member_value_del(txn, *obj, (const uint8_t *)name,
+                                   name_len);
+      break;
+    case 4:
+      lmjcore_obj_member_del(txn, *obj, (const uint8_t *)name, name_len);
+      break;
+    case 5:
+    case 6:
+      lmjcore_set_add(txn, *set, (const uint8_t *)name, name_len);
+      break;
+    default:
+      lmjcore_set_remove(txn, *set, (const uint8_t *)name, name_len);
+      break;
+    }
+  }
+  lmjcore_txn_commit(txn);
+}
+
+int main() {
+  printf("=== LMJCore 实体统计测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE, LMJCORE_ENV_NOSUBDIR,
+                        test_ptr_generator, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    lmjcore_obj_create(txn, objs[i]);
+  }
+  for (int i = 0; i < TEST_SETS; i++) {
+    lmjcore_set_create(txn, sets[i]);
+  }
+  lmjcore_txn_commit(txn);
+  mutate(env, 1);
+  put_ghost(env, objs[0], "zz");
+
+  // 启用时按现有数据生成的记录与遍历结果一致
+  static entity_stat walk_obj[TEST_OBJECTS], walk_set[TEST_SETS];
+  static entity_stat kept_obj[TEST_OBJECTS], kept_set[TEST_SETS];
+  collect(env, walk_obj, walk_set);
+  print_test_result("未启用时数量与 set_stat 一致",
+                    walk_set[0].count == walk_set[0].members, 1);
+
+  rc = lmjcore_entity_stats_set(env, true);
+  print_test_result("启用实体统计", rc, LMJCORE_SUCCESS);
+  collect(env, kept_obj, kept_set);
+  print_test_result("生成的对象记录", diff(walk_obj, kept_obj, TEST_OBJECTS),
+                    0);
+  print_test_result("生成的集合记录", diff(walk_set, kept_set, TEST_SETS), 0);
+
+  // 启用后的写入同步更新记录，结果与关闭后遍历一致
+  mutate(env, 2);
+  collect(env, kept_obj, kept_set);
+  rc = lmjcore_entity_stats_set(env, false);
+  print_test_result("关闭实体统计", rc, LMJCORE_SUCCESS);
+  collect(env, walk_obj, walk_set);
+  print_test_result("维护的对象记录", diff(walk_obj, kept_obj, TEST_OBJECTS),
+                    0);
+  print_test_result("维护的集合记录", diff(walk_set, kept_set, TEST_SETS), 0);
+
+  // 中止的事务不改变记录
+  lmjcore_entity_stats_set(env, true);
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  lmjcore_obj_member_put(txn, objs[1], (const uint8_t *)"new", 3,
+                         (const uint8_t *)"12345", 5);
+  lmjcore_set_add(txn, sets[1], (const uint8_t *)"new", 3);
+  lmjcore_txn_abort(txn);
+  collect(env, kept_obj, kept_set);
+  print_test_result("中止事务不改变对象记录",
+                    diff(walk_obj, kept_obj, TEST_OBJECTS), 0);
+  print_test_result("中止事务不改变集合记录",
+                    diff(walk_set, kept_set, TEST_SETS), 0);
+
+  // 覆盖写入按新旧值大小调整字节数
+  size_t len = 0, count = 0, len2 = 0, count2 = 0;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  lmjcore_obj_member_put(txn, objs[2], (const uint8_t *)"w", 1,
+                         (const uint8_t *)"abc", 3);
+  lmjcore_obj_stat_values(txn, objs[2], &len, &count);
+  lmjcore_obj_member_put(txn, objs[2], (const uint8_t *)"w", 1,
+                         (const uint8_t *)"abcdefg", 7);
+  lmjcore_obj_stat_values(txn, objs[2], &len2, &count2);
+  lmjcore_txn_commit(txn);
+  print_test_result("覆盖写入数量不变", (int)(count2 - count), 0);
+  print_test_result("覆盖写入字节数", (int)(len2 - len), 4);
+
+  // 删除实体后记录一并删除
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  lmjcore_obj_del(txn, objs[3]);
+  lmjcore_set_del(txn, sets[3]);
+  print_test_result("删除对象后无记录",
+                    lmjcore_obj_stat_members(txn, objs[3], &len, &count),
+                    MDB_NOTFOUND);
+  print_test_result("删除集合后无记录",
+                    lmjcore_set_count(txn, sets[3], &count), MDB_NOTFOUND);
+  lmjcore_obj_stat_values(txn, objs[3], &len, &count);
+  print_test_result("删除对象后无成员值", (int)count, 0);
+  lmjcore_txn_commit(txn);
+
+  // 重新打开环境后继续维护
+  lmjcore_cleanup(env);
+  rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE, LMJCORE_ENV_NOSUBDIR,
+                    test_ptr_generator, NULL, &env);
+  print_test_result("重新打开", rc, LMJCORE_SUCCESS);
+  mutate(env, 3);
+  collect(env, kept_obj, kept_set);
+  lmjcore_entity_stats_set(env, false);
+  collect(env, walk_obj, walk_set);
+  print_test_result("重新打开后对象记录",
+                    diff(walk_obj, kept_obj, TEST_OBJECTS), 0);
+  print_test_result("重新打开后集合记录", diff(walk_set, kept_set, TEST_SETS),
+                    0);
+
+  // 修复幽灵成员时同步扣除
+  lmjcore_entity_stats_set(env, true);
+  put_ghost(env, objs[4], "zz");
+  lmjcore_entity_stats_set(env, false);
+  lmjcore_entity_stats_set(env, true);
+  lmjcore_repair_ghosts(env, NULL, NULL);
+  collect(env, kept_obj, kept_set);
+  lmjcore_entity_stats_set(env, false);
+  collect(env, walk_obj, walk_set);
+  print_test_result("修复后对象记录", diff(walk_obj, kept_obj, TEST_OBJECTS),
+                    0);
+
+  // 未登记实体下的幽灵成员在登记第一个成员时计入，之后删除不会下溢
+  lmjcore_entity_stats_set(env, true);
+  lmjcore_ptr late = {LMJCORE_OBJ, 0xee};
+  put_ghost(env, late, "zz");
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  lmjcore_obj_member_register(txn, late, (const uint8_t *)"aa", 2);
+  lmjcore_obj_stat_values(txn, late, &len, &count);
+  print_test_result("登记时计入已有成员值", count == 1 && len == 5, 1);
+  lmjcore_obj_member_value_del(txn, late, (const uint8_t *)"zz", 2);
+  lmjcore_obj_stat_values(txn, late, &len, &count);
+  print_test_result("删除幽灵成员值后不下溢", count == 0 && len == 0, 1);
+  lmjcore_txn_commit(txn);
+  lmjcore_entity_stats_set(env, false);
+
+  print_test_result("空参数", lmjcore_entity_stats_set(NULL, true),
+                    LMJCORE_ERROR_NULL_POINTER);
+  lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  print_test_result("类型不匹配", lmjcore_set_count(txn, objs[0], &count),
+                    LMJCORE_ERROR_ENTITY_TYPE_MISMATCH);
+  lmjcore_txn_abort(txn);
+
+  lmjcore_cleanup(env);
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
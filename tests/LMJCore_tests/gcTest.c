@@ -0,0 +1,243 @@
+#include "lmjcore.h"
+#include "lmjcore_config.h"
+#include "lmjcore_seq_gen.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// 测试配置
+#define TEST_DB_PATH "./lmjcore_db/gc_test.mdb"
+#define TEST_SPILL_PATH "./lmjcore_db/gc_test.marks"
+#define TEST_MAP_SIZE (1024 * 1024 * 20) // 20MB
+#define TEST_ORPHANS 1000
+
+// 简单的递增指针生成器
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static uint64_t counter = 0;
+  (void)ctx;
+
+  memset(out, 0, LMJCORE_PTR_LEN);
+  counter++;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (counter >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+// 把指针写为对象成员值
+static int put_ref(lmjcore_txn *txn, const lmjcore_ptr obj, const char *name,
+                   const lmjcore_ptr target) {
+  return lmjcore_obj_member_put(txn, obj, (const uint8_t *)name, strlen(name),
+                                target, LMJCORE_PTR_LEN);
+}
+
+static int exists(lmjcore_env *env, const lmjcore_ptr ptr) {
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  int rc = lmjcore_entity_exist(txn, ptr);
+  lmjcore_txn_abort(txn);
+  return rc;
+}
+
+// 回收期间把不可达的实体重新挂到根上
+typedef struct {
+  lmjcore_env *env;
+  const uint8_t *root;
+  const uint8_t *target;
+  int existed; // 写入时目标是否还在
+} relink_ctx;
+
+static void *relink_main(void *arg) {
+  relink_ctx *ctx = arg;
+  // 溢出文件在标记快照开启后创建
+  while (access(TEST_SPILL_PATH, F_OK) != 0) {
+    usleep(100);
+  }
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(ctx->env, NULL, 0, &txn);
+  ctx->existed = lmjcore_entity_exist(txn, ctx->target);
+  put_ref(txn, ctx->root, "relinked", ctx->target);
+  lmjcore_txn_commit(txn);
+  return NULL;
+}
+
+int main() {
+  printf("=== LMJCore 垃圾回收测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE,
+                        LMJCORE_ENV_NOSUBDIR | LMJCORE_ENV_NOTLS,
+                        test_ptr_generator, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+
+  // 可达部分：root -> a -> s -> {b, "x"}，b 指向自身和 root 形成环
+  lmjcore_ptr root, a, b, s, c, o1, o2, s2;
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  lmjcore_obj_create(txn, root);
+  lmjcore_obj_create(txn, a);
+  lmjcore_obj_create(txn, b);
+  lmjcore_set_create(txn, s);
+  put_ref(txn, root, "child", a);
+  put_ref(txn, a, "list", s);
+  lmjcore_set_add(txn, s, b, LMJCORE_PTR_LEN);
+  lmjcore_set_add(txn, s, (const uint8_t *)"x", 1);
+  put_ref(txn, b, "self", b);
+  put_ref(txn, b, "back", root);
+
+  // 悬空引用被忽略
+  lmjcore_ptr dangling;
+  memset(dangling, 0x77, sizeof(dangling));
+  dangling[0] = LMJCORE_OBJ;
+  put_ref(txn, root, "dangling", dangling);
+
+  // 被覆盖的引用：c 不再可达
+  lmjcore_obj_create(txn, c);
+  put_ref(txn, root, "old", c);
+  lmjcore_obj_member_put(txn, root, (const uint8_t *)"old", 3,
+                         (const uint8_t *)"none", 4);
+
+  // 不可达的子图：s2 -> o1 -> o2
+  lmjcore_obj_create(txn, o1);
+  lmjcore_obj_create(txn, o2);
+  lmjcore_set_create(txn, s2);
+  put_ref(txn, o1, "next", o2);
+  lmjcore_set_add(txn, s2, o1, LMJCORE_PTR_LEN);
+
+  // 大量孤立对象
+  for (int i = 0; i < TEST_ORPHANS; i++) {
+    lmjcore_ptr orphan;
+    lmjcore_obj_create(txn, orphan);
+    lmjcore_obj_member_put(txn, orphan, (const uint8_t *)"v", 1,
+                           (const uint8_t *)"1", 1);
+  }
+  lmjcore_txn_commit(txn);
+  int reachable = 4;
+  int unreachable = 4 + TEST_ORPHANS;
+
+  // 参数检查
+  print_test_result("空选项", lmjcore_gc(env, NULL, NULL),
+                    LMJCORE_ERROR_NULL_POINTER);
+  lmjcore_gc_opts opts = {.roots = &root, .root_count = 0};
+  print_test_result("没有根", lmjcore_gc(env, &opts, NULL),
+                    LMJCORE_ERROR_INVALID_PARAM);
+
+  // 只统计
+  lmjcore_ptr roots[2];
+  memcpy(roots[0], root, LMJCORE_PTR_LEN);
+  memcpy(roots[1], dangling, LMJCORE_PTR_LEN); // 不存在的根被忽略
+  opts = (lmjcore_gc_opts){.roots = roots, .root_count = 2, .dry_run = true};
+  lmjcore_gc_stats stats;
+  rc = lmjcore_gc(env, &opts, &stats);
+  print_test_result("试运行", rc, LMJCORE_SUCCESS);
+  print_test_result("实体数", (int)stats.entities, reachable + unreachable);
+  print_test_result("存在的根", (int)stats.roots, 1);
+  print_test_result("可达实体", (int)stats.reachable, reachable);
+  print_test_result("不可达实体", (int)stats.unreachable, unreachable);
+  print_test_result("试运行不删除", (int)stats.deleted, 0);
+  print_test_result("试运行后 c 仍存在", exists(env, c), 1);
+
+  // 使用溢出文件分批回收
+  opts = (lmjcore_gc_opts){.roots = roots,
+                           .root_count = 2,
+                           .spill_path = TEST_SPILL_PATH,
+                           .chunk_keys = 100,
+                           .max_duty = 50};
+  rc = lmjcore_gc(env, &opts, &stats);
+  print_test_result("回收", rc, LMJCORE_SUCCESS);
+  print_test_result("删除全部不可达实体", (int)stats.deleted, unreachable);
+  print_test_result("分批提交", (int)stats.chunks >= unreachable / 100, 1);
+  print_test_result("溢出文件已删除", access(TEST_SPILL_PATH, F_OK), -1);
+  printf("entities=%zu spill=%zuB chunks=%zu elapsed=%llums throttle=%llums\n",
+         stats.entities, stats.spill_bytes, stats.chunks,
+         (unsigned long long)stats.elapsed_ms,
+         (unsigned long long)stats.throttle_ms);
+
+  int kept = exists(env, root) + exists(env, a) + exists(env, b) +
+             exists(env, s);
+  print_test_result("可达实体保留", kept, reachable);
+  int gone = exists(env, c) + exists(env, o1) + exists(env, o2) +
+             exists(env, s2);
+  print_test_result("不可达实体删除", gone, 0);
+
+  // 删除对象时一并删除成员值，不留下幽灵成员
+  lmjcore_audit_scan_stats audit;
+  lmjcore_audit_scan(env, NULL, &audit);
+  print_test_result("回收后没有幽灵成员", (int)audit.ghost_members, 0);
+  print_test_result("回收后 main 只剩可达成员", (int)audit.main_entries, 6);
+
+  // 再次回收没有可删除的实体
+  rc = lmjcore_gc(env, &opts, &stats);
+  print_test_result("再次回收", rc, LMJCORE_SUCCESS);
+  print_test_result("再次回收无删除", (int)stats.deleted, 0);
+
+  // 配置对象及其中的顺序指针计数器不在 roots 中也不会被回收
+  const uint8_t *seq_name = (const uint8_t *)LMJCORE_SEQ_GEN_DEFAULT_NAME;
+  size_t seq_name_len = strlen(LMJCORE_SEQ_GEN_DEFAULT_NAME);
+  uint8_t counter[8] = {0, 0, 0, 0, 0, 0, 0x10, 0x01};
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  lmjcore_config_object_ensure(txn);
+  lmjcore_config_set(txn, seq_name, seq_name_len, counter, sizeof(counter));
+  lmjcore_txn_commit(txn);
+  rc = lmjcore_gc(env, &opts, &stats);
+  print_test_result("保留配置对象的回收", rc, LMJCORE_SUCCESS);
+  print_test_result("配置对象为隐含根", (int)stats.roots, 2);
+  print_test_result("配置对象未删除", (int)stats.deleted, 0);
+  print_test_result("配置对象仍存在",
+                    exists(env, *lmjcore_config_object_ptr()), 1);
+  uint8_t kept_counter[8] = {0};
+  size_t counter_len = 0;
+  lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  rc = lmjcore_config_get(txn, seq_name, seq_name_len, kept_counter,
+                          sizeof(kept_counter), &counter_len);
+  lmjcore_txn_abort(txn);
+  print_test_result("顺序指针计数器仍存在", rc, LMJCORE_SUCCESS);
+  print_test_result("计数器未变",
+                    counter_len == sizeof(counter) &&
+                        memcmp(kept_counter, counter, sizeof(counter)) == 0,
+                    1);
+
+  // 标记后被重新引用的实体不会删除：x -> y 在快照中不可达，清除期间 x
+  // 被挂到根上。x、y 最后创建，位于最后一批
+  lmjcore_ptr x, y;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  for (int i = 0; i < TEST_ORPHANS; i++) {
+    lmjcore_ptr orphan;
+    lmjcore_obj_create(txn, orphan);
+  }
+  lmjcore_obj_create(txn, x);
+  lmjcore_obj_create(txn, y);
+  put_ref(txn, x, "next", y);
+  lmjcore_txn_commit(txn);
+  relink_ctx rctx = {.env = env, .root = root, .target = x};
+  pthread_t relinker;
+  pthread_create(&relinker, NULL, relink_main, &rctx);
+  opts.chunk_keys = 10;
+  opts.chunk_ms = 1;
+  opts.max_duty = 10;
+  rc = lmjcore_gc(env, &opts, &stats);
+  pthread_join(relinker, NULL);
+  print_test_result("清除期间重新引用", rc, LMJCORE_SUCCESS);
+  print_test_result("写入时 x 尚未删除", rctx.existed, 1);
+  print_test_result("重新引用的实体保留", exists(env, x) + exists(env, y), 2);
+  print_test_result("计入重新引用", (int)stats.relinked, 2);
+  print_test_result("其余孤立对象删除", (int)stats.deleted, TEST_ORPHANS);
+
+  lmjcore_cleanup(env);
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
@@ -0,0 +1,141 @@
+#include "lmjcore.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// 测试配置
+#define TEST_DB_PATH "./lmjcore_db/health_test.mdb"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_COMMITS 5
+
+// 简单的递增指针生成器
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static uint64_t counter = 0;
+  (void)ctx;
+
+  memset(out, 0, LMJCORE_PTR_LEN);
+  counter++;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (counter >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+// 告警统计
+typedef struct {
+  atomic_uint seen;  // 收到过的告警位
+  atomic_int calls;  // 回调次数
+} alert_ctx;
+
+static void on_alert(lmjcore_env *env, unsigned int alerts,
+                     const lmjcore_health_stats *stats, void *ctx) {
+  alert_ctx *ac = ctx;
+  (void)env;
+  (void)stats;
+  atomic_fetch_or(&ac->seen, alerts);
+  atomic_fetch_add(&ac->calls, 1);
+}
+
+int main() {
+  printf("=== LMJCore 健康监控测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE,
+                        LMJCORE_ENV_NOSUBDIR | LMJCORE_ENV_NOTLS,
+                        test_ptr_generator, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+  if (rc != LMJCORE_SUCCESS) {
+    return 1;
+  }
+
+  // 没有读者时
+  lmjcore_health_stats stats;
+  rc = lmjcore_env_health_check(env, &stats);
+  print_test_result("env_health_check", rc, LMJCORE_SUCCESS);
+  print_test_result("无活动读者", (int)stats.active_readers, 0);
+  print_test_result("映射使用量", stats.map_used > 0 &&
+                                      stats.map_size == TEST_MAP_SIZE,
+                    1);
+
+  // 打开一个长读事务，随后连续提交写事务
+  lmjcore_txn *reader = NULL;
+  lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &reader);
+  for (int i = 0; i < TEST_COMMITS; i++) {
+    lmjcore_txn *txn = NULL;
+    lmjcore_ptr obj;
+    lmjcore_txn_begin(env, NULL, 0, &txn);
+    lmjcore_obj_create(txn, obj);
+    lmjcore_txn_commit(txn);
+  }
+
+  rc = lmjcore_env_health_check(env, &stats);
+  print_test_result("env_health_check(长读事务)", rc, LMJCORE_SUCCESS);
+  print_test_result("检测到活动读者", (int)stats.active_readers, 1);
+  print_test_result("最老读者落后事务数", (int)stats.oldest_reader_lag,
+                    TEST_COMMITS);
+
+  // 参数校验
+  lmjcore_health_opts bad = {.interval_ms = 0};
+  rc = lmjcore_health_monitor_start(env, &bad);
+  print_test_result("health_monitor_start(间隔为0)", rc,
+                    LMJCORE_ERROR_INVALID_PARAM);
+
+  // 后台监控：长读者与映射使用率告警
+  alert_ctx ac;
+  atomic_init(&ac.seen, 0);
+  atomic_init(&ac.calls, 0);
+  lmjcore_health_opts opts = {
+      .interval_ms = 20,
+      .max_reader_age_ms = 50,
+      .max_map_use = 0.0001,
+      .alert = on_alert,
+      .alert_ctx = &ac,
+  };
+  rc = lmjcore_health_monitor_start(env, &opts);
+  print_test_result("health_monitor_start", rc, LMJCORE_SUCCESS);
+  rc = lmjcore_health_monitor_start(env, &opts);
+  print_test_result("重复启动", rc, LMJCORE_ERROR_INVALID_PARAM);
+
+  usleep(200 * 1000);
+  unsigned int seen = atomic_load(&ac.seen);
+  print_test_result("长读者告警", (seen & LMJCORE_HEALTH_OLD_READER) != 0, 1);
+  print_test_result("映射使用率告警", (seen & LMJCORE_HEALTH_MAP_USAGE) != 0,
+                    1);
+
+  lmjcore_health_monitor_last(env, &stats);
+  print_test_result("最老读者年龄",
+                    stats.oldest_reader_age_ms >= opts.max_reader_age_ms, 1);
+
+  // 结束读事务后读者消失
+  lmjcore_txn_abort(reader);
+  usleep(100 * 1000);
+  lmjcore_health_monitor_last(env, &stats);
+  print_test_result("读者结束后", (int)stats.active_readers, 0);
+  print_test_result("长读者告警解除",
+                    (stats.alerts & LMJCORE_HEALTH_OLD_READER) != 0, 0);
+
+  rc = lmjcore_health_monitor_stop(env);
+  print_test_result("health_monitor_stop", rc, LMJCORE_SUCCESS);
+
+  // cleanup 会自动停止仍在运行的监控线程
+  lmjcore_health_monitor_start(env, &opts);
+  rc = lmjcore_cleanup(env);
+  print_test_result("cleanup(监控运行中)", rc, LMJCORE_SUCCESS);
+
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
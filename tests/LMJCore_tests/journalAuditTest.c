@@ -0,0 +1,226 @@
+#include "lmjcore.h"
+#include <stdio.h>
+#include <string.h>
+
+// 测试配置
+#define TEST_DB_PATH "./lmjcore_db/journal_audit_test.mdb"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_OBJECTS 1000
+
+// 简单的递增指针生成器
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static uint64_t counter = 0;
+  (void)ctx;
+
+  memset(out, 0, LMJCORE_PTR_LEN);
+  counter++;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (counter >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+// 访问内部结构（仅供测试使用，用于绕过 API 制造幽灵成员）
+struct lmjcore_env_internal {
+  MDB_env *mdb_env;
+  MDB_dbi main_dbi;
+  MDB_dbi set_dbi;
+};
+
+static int put_ghost(lmjcore_env *env, const lmjcore_ptr ptr,
+                     const char *name) {
+  struct lmjcore_env_internal *internal = (struct lmjcore_env_internal *)env;
+  MDB_txn *txn = NULL;
+  int rc = mdb_txn_begin(internal->mdb_env, NULL, 0, &txn);
+  if (rc != MDB_SUCCESS) {
+    return rc;
+  }
+  size_t name_len = strlen(name);
+  uint8_t key[LMJCORE_PTR_LEN + 64];
+  memcpy(key, ptr, LMJCORE_PTR_LEN);
+  memcpy(key + LMJCORE_PTR_LEN, name, name_len);
+  MDB_val k = {.mv_size = LMJCORE_PTR_LEN + name_len, .mv_data = key};
+  MDB_val v = {.mv_size = 5, .mv_data = "ghost"};
+  rc = mdb_put(txn, internal->main_dbi, &k, &v, 0);
+  if (rc != MDB_SUCCESS) {
+    mdb_txn_abort(txn);
+    return rc;
+  }
+  return mdb_txn_commit(txn);
+}
+
+static size_t pending(lmjcore_env *env) {
+  size_t count = 0;
+  lmjcore_journal_pending(env, &count);
+  return count;
+}
+
+// 第一次收到发现时修改另一个对象，模拟审计期间的并发写入
+typedef struct {
+  lmjcore_env *env;
+  const uint8_t *touch;
+  int findings;
+} touch_ctx;
+
+static int on_finding(void *ctx, const lmjcore_audit_finding *finding) {
+  touch_ctx *tc = ctx;
+  (void)finding;
+  if (tc->findings++ == 0 && tc->touch) {
+    lmjcore_txn *txn = NULL;
+    lmjcore_txn_begin(tc->env, NULL, 0, &txn);
+    lmjcore_obj_member_put(txn, tc->touch, (const uint8_t *)"a", 1,
+                           (const uint8_t *)"9", 1);
+    lmjcore_txn_commit(txn);
+  }
+  return 0;
+}
+
+int main() {
+  printf("=== LMJCore 脏对象日志与增量审计测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE, LMJCORE_ENV_NOSUBDIR,
+                        test_ptr_generator, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+
+  size_t count = 0;
+  print_test_result("未启用时查询", lmjcore_journal_pending(env, &count),
+                    LMJCORE_ERROR_JOURNAL_DISABLED);
+  print_test_result("未启用时增量审计",
+                    lmjcore_audit_incremental(env, NULL, true, NULL),
+                    LMJCORE_ERROR_JOURNAL_DISABLED);
+
+  // 启用前写入的对象不进入日志
+  static lmjcore_ptr objs[TEST_OBJECTS];
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    lmjcore_obj_create(txn, objs[i]);
+    lmjcore_obj_member_put(txn, objs[i], (const uint8_t *)"a", 1,
+                           (const uint8_t *)"1", 1);
+    lmjcore_obj_member_put(txn, objs[i], (const uint8_t *)"b", 1,
+                           (const uint8_t *)"2", 1);
+  }
+  lmjcore_txn_commit(txn);
+
+  rc = lmjcore_journal_set(env, true);
+  print_test_result("启用脏对象日志", rc, LMJCORE_SUCCESS);
+  print_test_result("启用时日志为空", (int)pending(env), 0);
+
+  // 修改 4 个对象：重复写入、只登记、删除值、删除成员
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  for (int i = 0; i < 10; i++) {
+    lmjcore_obj_member_put(txn, objs[1], (const uint8_t *)"a", 1,
+                           (const uint8_t *)"x", 1);
+  }
+  lmjcore_obj_member_register(txn, objs[2], (const uint8_t *)"c", 1);
+  lmjcore_obj_member_value_del(txn, objs[3], (const uint8_t *)"a", 1);
+  lmjcore_obj_member_del(txn, objs[4], (const uint8_t *)"b", 1);
+  lmjcore_txn_commit(txn);
+  print_test_result("记录脏对象", (int)pending(env), 4);
+
+  // 中止的事务不留下记录
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  lmjcore_obj_member_put(txn, objs[6], (const uint8_t *)"a", 1,
+                         (const uint8_t *)"x", 1);
+  lmjcore_txn_abort(txn);
+  print_test_result("中止事务不记录", (int)pending(env), 4);
+
+  // 绕过 API 的写入：脏对象上的能被发现，未修改对象上的不会被复查
+  put_ghost(env, objs[2], "zz");
+  put_ghost(env, objs[5], "zz");
+
+  lmjcore_audit_scan_stats stats;
+  rc = lmjcore_audit_incremental(env, NULL, false, &stats);
+  print_test_result("增量审计", rc, LMJCORE_SUCCESS);
+  print_test_result("复查脏对象数", (int)stats.dirty_objects, 4);
+  print_test_result("扫描实体数", (int)stats.entities, 4);
+  print_test_result("缺失值", (int)stats.missing_values, 2);
+  print_test_result("幽灵成员", (int)stats.ghost_members, 1);
+  print_test_result("不设检查点时保留日志", (int)pending(env), 4);
+
+  // 检查点只清除快照之前的记录，审计期间修改的对象留到下次
+  touch_ctx tc = {.env = env, .touch = objs[7]};
+  lmjcore_audit_scan_opts opts = {.on_finding = on_finding, .ctx = &tc};
+  rc = lmjcore_audit_incremental(env, &opts, true, &stats);
+  print_test_result("增量审计并设检查点", rc, LMJCORE_SUCCESS);
+  print_test_result("回调收到全部发现", tc.findings, 3);
+  print_test_result("审计期间的修改保留", (int)pending(env), 1);
+
+  rc = lmjcore_audit_incremental(env, NULL, true, &stats);
+  print_test_result("复查审计期间的修改", (int)stats.dirty_objects, 1);
+  print_test_result("没有新问题",
+                    (int)(stats.missing_values + stats.ghost_members), 0);
+  print_test_result("日志清空", (int)pending(env), 0);
+
+  // 删除的对象也会被复查，残留的值作为幽灵成员报告
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  lmjcore_obj_del(txn, objs[8]);
+  lmjcore_txn_commit(txn);
+  put_ghost(env, objs[8], "left");
+  rc = lmjcore_audit_incremental(env, NULL, true, &stats);
+  print_test_result("删除对象后审计", rc, LMJCORE_SUCCESS);
+  print_test_result("删除的对象不计入实体", (int)stats.entities, 0);
+  print_test_result("残留值为幽灵成员", (int)stats.ghost_members, 1);
+
+  // 重新打开环境后继续记录
+  lmjcore_cleanup(env);
+  rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE, LMJCORE_ENV_NOSUBDIR,
+                    test_ptr_generator, NULL, &env);
+  print_test_result("重新打开", rc, LMJCORE_SUCCESS);
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  lmjcore_obj_member_put(txn, objs[9], (const uint8_t *)"a", 1,
+                         (const uint8_t *)"x", 1);
+  lmjcore_txn_commit(txn);
+  print_test_result("重新打开后仍在记录", (int)pending(env), 1);
+
+  // 压缩后事务 ID 从头计数，压缩前的记录仍能被检查点清除
+  for (int i = 0; i < 100; i++) {
+    lmjcore_txn_begin(env, NULL, 0, &txn);
+    lmjcore_obj_member_put(txn, objs[10], (const uint8_t *)"a", 1,
+                           (const uint8_t *)&i, sizeof(i));
+    lmjcore_txn_commit(txn);
+  }
+  rc = lmjcore_env_compact(env, NULL, NULL);
+  print_test_result("压缩", rc, LMJCORE_SUCCESS);
+  print_test_result("压缩后日志保留", (int)pending(env), 2);
+  rc = lmjcore_audit_incremental(env, NULL, true, &stats);
+  print_test_result("压缩后复查脏对象", (int)stats.dirty_objects, 2);
+  print_test_result("压缩后检查点清空日志", (int)pending(env), 0);
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  lmjcore_obj_member_put(txn, objs[9], (const uint8_t *)"a", 1,
+                         (const uint8_t *)"x", 1);
+  lmjcore_txn_commit(txn);
+  print_test_result("压缩后继续记录", (int)pending(env), 1);
+
+  // 关闭后删除日志且不再记录
+  rc = lmjcore_journal_set(env, false);
+  print_test_result("关闭脏对象日志", rc, LMJCORE_SUCCESS);
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  rc = lmjcore_obj_member_put(txn, objs[9], (const uint8_t *)"a", 1,
+                              (const uint8_t *)"y", 1);
+  lmjcore_txn_commit(txn);
+  print_test_result("关闭后写入正常", rc, LMJCORE_SUCCESS);
+  print_test_result("关闭后不可查询", lmjcore_journal_pending(env, &count),
+                    LMJCORE_ERROR_JOURNAL_DISABLED);
+  rc = lmjcore_journal_set(env, true);
+  print_test_result("重新启用", rc, LMJCORE_SUCCESS);
+  print_test_result("重新启用时日志为空", (int)pending(env), 0);
+
+  lmjcore_cleanup(env);
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
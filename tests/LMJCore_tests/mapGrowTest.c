@@ -0,0 +1,141 @@
+#include "lmjcore.h"
+#include <stdio.h>
+#include <string.h>
+
+// 测试配置
+#define TEST_DB_PATH "./lmjcore_db/map_grow_test.mdb"
+#define TEST_MAP_SIZE (256 * 1024)       // 256KB，很快就会写满
+#define TEST_MAX_MAP_SIZE (4096 * 1024)  // 扩容上限 4MB
+#define TEST_MEMBER_COUNT 400
+#define TEST_VALUE_SIZE 1024
+
+// 简单的递增指针生成器
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static uint64_t counter = 0;
+  (void)ctx;
+
+  memset(out, 0, LMJCORE_PTR_LEN);
+  counter++;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (counter >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+// 批次上下文
+typedef struct {
+  lmjcore_ptr obj;
+  int member_count;
+  int calls; // 回调被执行的次数（含重放）
+} fill_ctx;
+
+// 写入批次：创建对象并写入大量成员（可重放）
+static int fill_batch(lmjcore_txn *txn, void *ctx) {
+  fill_ctx *fc = ctx;
+  fc->calls++;
+
+  int rc = lmjcore_obj_create(txn, fc->obj);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+
+  uint8_t value[TEST_VALUE_SIZE];
+  memset(value, 'v', sizeof(value));
+  for (int i = 0; i < fc->member_count; i++) {
+    char name[32];
+    int name_len = snprintf(name, sizeof(name), "member_%04d", i);
+    rc = lmjcore_obj_member_put(txn, fc->obj, (const uint8_t *)name, name_len,
+                                value, sizeof(value));
+    if (rc != LMJCORE_SUCCESS) {
+      return rc;
+    }
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 读取批次：确认最后一个成员存在
+static int check_batch(lmjcore_txn *txn, void *ctx) {
+  fill_ctx *fc = ctx;
+  char name[32];
+  int name_len =
+      snprintf(name, sizeof(name), "member_%04d", fc->member_count - 1);
+  uint8_t value[TEST_VALUE_SIZE];
+  size_t value_len = 0;
+  int rc = lmjcore_obj_member_get(txn, fc->obj, (const uint8_t *)name,
+                                  name_len, value, sizeof(value), &value_len);
+  if (rc == LMJCORE_SUCCESS && value_len != TEST_VALUE_SIZE) {
+    return LMJCORE_ERROR_INVALID_PARAM;
+  }
+  return rc;
+}
+
+int main() {
+  printf("=== LMJCore 映射自动扩容测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE, LMJCORE_ENV_NOSUBDIR,
+                        test_ptr_generator, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+  if (rc != LMJCORE_SUCCESS) {
+    return 1;
+  }
+
+  // 参数校验
+  rc = lmjcore_env_set_map_grow(env, 0.5, 0);
+  print_test_result("set_map_grow(因子<=1)", rc, LMJCORE_ERROR_INVALID_PARAM);
+
+  // 未启用扩容时，超出映射的批次应返回 MDB_MAP_FULL
+  fill_ctx fc = {.member_count = TEST_MEMBER_COUNT};
+  rc = lmjcore_txn_exec(env, 0, fill_batch, &fc);
+  print_test_result("txn_exec(未启用扩容)", rc, MDB_MAP_FULL);
+
+  size_t initial_size = 0;
+  lmjcore_env_get_map_size(env, &initial_size);
+
+  // 启用扩容后同一批次应透明重放并成功
+  rc = lmjcore_env_set_map_grow(env, 2.0, TEST_MAX_MAP_SIZE);
+  print_test_result("set_map_grow", rc, LMJCORE_SUCCESS);
+
+  fc.calls = 0;
+  rc = lmjcore_txn_exec(env, 0, fill_batch, &fc);
+  print_test_result("txn_exec(自动扩容)", rc, LMJCORE_SUCCESS);
+
+  size_t grown_size = 0;
+  lmjcore_env_get_map_size(env, &grown_size);
+  print_test_result("映射已扩大", grown_size > initial_size, 1);
+  print_test_result("批次已重放", fc.calls > 1, 1);
+  printf("映射大小: %zu -> %zu，批次执行 %d 次\n", initial_size, grown_size,
+         fc.calls);
+
+  rc = lmjcore_txn_exec(env, LMJCORE_TXN_READONLY, check_batch, &fc);
+  print_test_result("读取扩容后写入的数据", rc, LMJCORE_SUCCESS);
+
+  // 超过上限的批次最终返回 MDB_MAP_FULL
+  fill_ctx big = {.member_count = TEST_MEMBER_COUNT * 20};
+  rc = lmjcore_txn_exec(env, 0, fill_batch, &big);
+  print_test_result("txn_exec(超过上限)", rc, MDB_MAP_FULL);
+
+  size_t final_size = 0;
+  lmjcore_env_get_map_size(env, &final_size);
+  print_test_result("映射不超过上限", final_size <= TEST_MAX_MAP_SIZE, 1);
+
+  rc = lmjcore_env_map_grow(env);
+  print_test_result("env_map_grow(已达上限)", rc, MDB_MAP_FULL);
+
+  lmjcore_cleanup(env);
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
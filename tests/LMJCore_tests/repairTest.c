@@ -0,0 +1,206 @@
+#include "lmjcore.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// 测试配置
+#define TEST_DB_PATH "./lmjcore_db/repair_test.mdb"
+#define TEST_CHECKPOINT_PATH "./lmjcore_db/repair_test.progress"
+#define TEST_MAP_SIZE (1024 * 1024 * 20) // 20MB
+#define TEST_OBJECTS 500
+#define TEST_GHOSTS_PER_OBJECT 5
+#define TEST_ORPHANS 10
+
+// 简单的递增指针生成器
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static uint64_t counter = 0;
+  (void)ctx;
+
+  memset(out, 0, LMJCORE_PTR_LEN);
+  counter++;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (counter >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+// 访问内部结构（仅供测试使用，用于绕过 API 制造幽灵成员）
+struct lmjcore_env_internal {
+  MDB_env *mdb_env;
+  MDB_dbi main_dbi;
+  MDB_dbi set_dbi;
+};
+
+static int put_ghost(MDB_txn *txn, MDB_dbi dbi, const lmjcore_ptr ptr,
+                     const char *name) {
+  size_t name_len = strlen(name);
+  uint8_t key[LMJCORE_PTR_LEN + 64];
+  memcpy(key, ptr, LMJCORE_PTR_LEN);
+  memcpy(key + LMJCORE_PTR_LEN, name, name_len);
+  MDB_val k = {.mv_size = LMJCORE_PTR_LEN + name_len, .mv_data = key};
+  MDB_val v = {.mv_size = 5, .mv_data = "ghost"};
+  return mdb_put(txn, dbi, &k, &v, 0);
+}
+
+// 统计当前的幽灵成员数
+static int count_ghosts(lmjcore_env *env) {
+  lmjcore_audit_scan_stats stats = {0};
+  int rc = lmjcore_audit_scan(env, NULL, &stats);
+  return rc == LMJCORE_SUCCESS ? (int)stats.ghost_members : rc;
+}
+
+// 提交若干批后中止，模拟进程中途退出
+typedef struct {
+  size_t stop_after;
+  size_t calls;
+} chunk_ctx;
+
+static int on_chunk(void *ctx, const lmjcore_repair_stats *stats) {
+  chunk_ctx *cc = ctx;
+  (void)stats;
+  return ++cc->calls == cc->stop_after ? 777 : 0;
+}
+
+int main() {
+  printf("=== LMJCore 批量修复测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+  remove(TEST_CHECKPOINT_PATH);
+
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE,
+                        LMJCORE_ENV_NOSUBDIR | LMJCORE_ENV_NOTLS,
+                        test_ptr_generator, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+  if (rc != LMJCORE_SUCCESS) {
+    return 1;
+  }
+
+  // 没有需要修复的数据
+  lmjcore_repair_stats stats;
+  rc = lmjcore_repair_ghosts(env, NULL, &stats);
+  print_test_result("空库修复", rc, LMJCORE_SUCCESS);
+  print_test_result("空库修复完成", stats.done, 1);
+  print_test_result("空库无写事务", (int)stats.chunks, 0);
+
+  static lmjcore_ptr objs[TEST_OBJECTS];
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    lmjcore_obj_create(txn, objs[i]);
+    lmjcore_obj_member_put(txn, objs[i], (const uint8_t *)"a", 1,
+                           (const uint8_t *)"1", 1);
+  }
+  lmjcore_txn_commit(txn);
+
+  // 每个对象若干幽灵成员，另有未登记对象下的成员
+  struct lmjcore_env_internal *internal = (struct lmjcore_env_internal *)env;
+  MDB_txn *raw = NULL;
+  mdb_txn_begin(internal->mdb_env, NULL, 0, &raw);
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    for (int g = 0; g < TEST_GHOSTS_PER_OBJECT; g++) {
+      char name[8];
+      snprintf(name, sizeof(name), "g%d", g);
+      put_ghost(raw, internal->main_dbi, objs[i], name);
+    }
+  }
+  for (int i = 0; i < TEST_ORPHANS; i++) {
+    lmjcore_ptr orphan;
+    memset(orphan, 0xe0 + i, sizeof(orphan));
+    orphan[0] = LMJCORE_OBJ;
+    put_ghost(raw, internal->main_dbi, orphan, "o");
+  }
+  mdb_txn_commit(raw);
+  int total = TEST_OBJECTS * TEST_GHOSTS_PER_OBJECT + TEST_ORPHANS;
+  print_test_result("注入幽灵成员", count_ghosts(env), total);
+
+  print_test_result(
+      "max_duty 超限",
+      lmjcore_repair_ghosts(env, &(lmjcore_repair_opts){.max_duty = 101},
+                            NULL),
+      LMJCORE_ERROR_INVALID_PARAM);
+
+  // 第一次：每批 300 个，提交 3 批后中止
+  chunk_ctx cc = {.stop_after = 3};
+  lmjcore_repair_opts opts = {.chunk_keys = 300,
+                              .chunk_ms = 1000,
+                              .max_duty = 100,
+                              .checkpoint_path = TEST_CHECKPOINT_PATH,
+                              .on_chunk = on_chunk,
+                              .ctx = &cc};
+  rc = lmjcore_repair_ghosts(env, &opts, &stats);
+  print_test_result("回调中止修复", rc, 777);
+  print_test_result("中止前删除 3 批", (int)stats.ghosts_deleted, 900);
+  print_test_result("尚未完成", stats.done, 0);
+  print_test_result("保存进度", access(TEST_CHECKPOINT_PATH, F_OK), 0);
+  print_test_result("剩余幽灵成员", count_ghosts(env), total - 900);
+
+  // 第二次：从进度文件继续，限速运行到结束
+  cc = (chunk_ctx){0};
+  opts.max_duty = 50;
+  rc = lmjcore_repair_ghosts(env, &opts, &stats);
+  print_test_result("恢复修复", rc, LMJCORE_SUCCESS);
+  print_test_result("从进度继续", stats.resumed, 1);
+  print_test_result("修复完成", stats.done, 1);
+  print_test_result("删除剩余幽灵成员", (int)stats.ghosts_deleted,
+                    total - 900);
+  print_test_result("完成后删除进度文件", access(TEST_CHECKPOINT_PATH, F_OK),
+                    -1);
+  print_test_result("没有幽灵成员", count_ghosts(env), 0);
+  printf("chunks=%zu entities=%zu elapsed=%llums throttle=%llums\n",
+         stats.chunks, stats.entities, (unsigned long long)stats.elapsed_ms,
+         (unsigned long long)stats.throttle_ms);
+
+  // 合法成员不受影响
+  lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  int intact = 0;
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    uint8_t value[8];
+    size_t value_len = 0;
+    if (lmjcore_obj_member_get(txn, objs[i], (const uint8_t *)"a", 1, value,
+                               sizeof(value), &value_len) == LMJCORE_SUCCESS &&
+        value_len == 1 && value[0] == '1') {
+      intact++;
+    }
+  }
+  lmjcore_txn_abort(txn);
+  print_test_result("合法成员保留", intact, TEST_OBJECTS);
+
+  // 再次运行不再有任何删除
+  rc = lmjcore_repair_ghosts(env, &(lmjcore_repair_opts){.chunk_keys = 10},
+                             &stats);
+  print_test_result("重复修复", rc, LMJCORE_SUCCESS);
+  print_test_result("重复修复无删除", (int)stats.ghosts_deleted, 0);
+
+  // 进度文件损坏
+  FILE *f = fopen(TEST_CHECKPOINT_PATH, "w");
+  if (!f) {
+    printf("[FAIL] 写入进度文件: %s\n", TEST_CHECKPOINT_PATH);
+    lmjcore_cleanup(env);
+    return 1;
+  }
+  fputs("not-a-pointer\n", f);
+  fclose(f);
+  opts = (lmjcore_repair_opts){.checkpoint_path = TEST_CHECKPOINT_PATH};
+  print_test_result("进度文件损坏", lmjcore_repair_ghosts(env, &opts, NULL),
+                    LMJCORE_ERROR_INVALID_PARAM);
+  remove(TEST_CHECKPOINT_PATH);
+
+  print_test_result("空参数", lmjcore_repair_ghosts(NULL, NULL, NULL),
+                    LMJCORE_ERROR_NULL_POINTER);
+
+  lmjcore_cleanup(env);
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
@@ -0,0 +1,123 @@
+#include "lmjcore.h"
+#include <stdio.h>
+#include <string.h>
+
+// 测试配置
+#define TEST_DB_PATH "./lmjcore_db/residency_test.mdb"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_OBJECTS 1000
+
+// 简单的递增指针生成器
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static uint64_t counter = 0;
+  (void)ctx;
+
+  memset(out, 0, LMJCORE_PTR_LEN);
+  counter++;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (counter >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 取出指针中的计数器
+static uint64_t ptr_counter(const lmjcore_ptr ptr) {
+  uint64_t counter = 0;
+  for (int i = 0; i < 8; i++) {
+    counter = counter << 8 | ptr[1 + i];
+  }
+  return counter;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+// 检查单个库的采样与区间计数是否一致
+static int residency_consistent(const lmjcore_dbi_residency *dbi) {
+  size_t sampled = 0, resident = 0;
+  for (size_t i = 0; i < dbi->range_count; i++) {
+    sampled += dbi->ranges[i].sampled;
+    resident += dbi->ranges[i].resident;
+    if (i > 0 && memcmp(dbi->ranges[i - 1].start, dbi->ranges[i].start,
+                        LMJCORE_PTR_LEN) > 0) {
+      return 0; // 区间应按键递增
+    }
+  }
+  return dbi->range_count <= LMJCORE_RESIDENCY_RANGES &&
+         sampled == dbi->sampled && resident == dbi->resident &&
+         dbi->resident <= dbi->mapped && dbi->mapped <= dbi->sampled;
+}
+
+int main() {
+  printf("=== LMJCore 页缓存驻留报告测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE, LMJCORE_ENV_NOSUBDIR,
+                        test_ptr_generator, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    lmjcore_ptr obj;
+    lmjcore_obj_create(txn, obj);
+    lmjcore_obj_member_put(txn, obj, (const uint8_t *)"v", 1,
+                           (const uint8_t *)&i, sizeof(i));
+  }
+  lmjcore_txn_commit(txn);
+
+  // 全量采样
+  lmjcore_residency_report report;
+  rc = lmjcore_env_residency(env, 0, &report);
+  print_test_result("env_residency", rc, LMJCORE_SUCCESS);
+  print_test_result("文件页数", report.file_pages > 0, 1);
+  print_test_result("驻留页不超过总页数",
+                    report.resident_pages <= report.file_pages, 1);
+  // 刚写入的数据仍在页缓存中
+  print_test_result("刚写入的页驻留", report.resident_pages > 0, 1);
+  print_test_result("驻留比例",
+                    report.resident_ratio > 0 && report.resident_ratio <= 1,
+                    1);
+  print_test_result("main 全部采样", (int)report.main.sampled, TEST_OBJECTS);
+  print_test_result("set 全部采样", (int)report.set.sampled,
+                    TEST_OBJECTS * 2);
+  print_test_result("main 区间一致", residency_consistent(&report.main), 1);
+  print_test_result("set 区间一致", residency_consistent(&report.set), 1);
+  print_test_result("区间数",
+                    (int)report.main.range_count, LMJCORE_RESIDENCY_RANGES);
+  printf("file_pages=%zu resident=%zu main: mapped=%zu resident=%zu\n",
+         report.file_pages, report.resident_pages, report.main.mapped,
+         report.main.resident);
+
+  // 限制采样数
+  rc = lmjcore_env_residency(env, 100, &report);
+  print_test_result("限制采样", rc, LMJCORE_SUCCESS);
+  print_test_result("采样不超过上限", report.main.sampled <= 100, 1);
+  // 定位采样的点覆盖整个键空间，而不是集中在库的开头
+  print_test_result("定位采样数",
+                    report.main.sampled > 50 && report.set.sampled > 50 &&
+                        report.set.sampled <= 100,
+                    1);
+  const lmjcore_residency_range *last =
+      &report.main.ranges[report.main.range_count - 1];
+  print_test_result("定位采样区间数", report.main.range_count > 1, 1);
+  print_test_result("定位采样到达库尾",
+                    ptr_counter(last->start) >= TEST_OBJECTS * 3 / 4, 1);
+
+  print_test_result("空参数", lmjcore_env_residency(env, 0, NULL),
+                    LMJCORE_ERROR_NULL_POINTER);
+
+  lmjcore_cleanup(env);
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
@@ -0,0 +1,222 @@
+#include "lmjcore.h"
+#include "result_serializer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 测试配置
+#define TEST_DB_PATH "./lmjcore_db/shape_test.mdb"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_OBJECTS 300
+#define TEST_UNIQUE 100 // 前这么多个对象各有一个独有的成员名
+#define TEST_SETS 20
+
+// 简单的递增指针生成器
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static uint64_t counter = 0;
+  (void)ctx;
+
+  memset(out, 0, LMJCORE_PTR_LEN);
+  counter++;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (counter >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+static int put(lmjcore_txn *txn, const lmjcore_ptr obj, const char *name,
+               const uint8_t *value, size_t value_len) {
+  return lmjcore_obj_member_put(txn, obj, (const uint8_t *)name, strlen(name),
+                                value, value_len);
+}
+
+static int same_hists(const lmjcore_shape_report *a,
+                      const lmjcore_shape_report *b) {
+  return memcmp(&a->obj_members, &b->obj_members,
+                sizeof(lmjcore_shape_hist)) == 0 &&
+         memcmp(&a->member_name_len, &b->member_name_len,
+                sizeof(lmjcore_shape_hist)) == 0 &&
+         memcmp(&a->value_size, &b->value_size,
+                sizeof(lmjcore_shape_hist)) == 0 &&
+         memcmp(&a->set_cardinality, &b->set_cardinality,
+                sizeof(lmjcore_shape_hist)) == 0 &&
+         memcmp(&a->element_size, &b->element_size,
+                sizeof(lmjcore_shape_hist)) == 0;
+}
+
+static int top_is(const lmjcore_shape_report *report, size_t i,
+                  const char *name) {
+  return i < report->top_count && report->top[i].name_len == strlen(name) &&
+         memcmp(report->top[i].name, name, strlen(name)) == 0;
+}
+
+int main() {
+  printf("=== LMJCore 形态分析测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE,
+                        LMJCORE_ENV_NOSUBDIR | LMJCORE_ENV_NOTLS,
+                        test_ptr_generator, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+
+  // 空库
+  static lmjcore_shape_report report;
+  rc = lmjcore_env_shape(env, NULL, &report);
+  print_test_result("空库分析", rc, LMJCORE_SUCCESS);
+  print_test_result("空库无实体", (int)(report.objects + report.sets), 0);
+  print_test_result("空库无成员名", (int)report.top_count, 0);
+
+  // 每个对象有 id（8 字节）与 name（20 字节），每三个有一个 tag（3 字节），
+  // 前 TEST_UNIQUE 个另有独有的成员（1 字节）；集合 i 有 i + 1 个元素
+  static lmjcore_ptr objs[TEST_OBJECTS];
+  uint8_t id[8] = {0}, name[20] = {0}, tag[3] = {0};
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    lmjcore_obj_create(txn, objs[i]);
+    put(txn, objs[i], "id", id, sizeof(id));
+    put(txn, objs[i], "name", name, sizeof(name));
+    if (i % 3 == 0) {
+      put(txn, objs[i], "tag", tag, sizeof(tag));
+    }
+    if (i < TEST_UNIQUE) {
+      char unique[16];
+      snprintf(unique, sizeof(unique), "u%d", i);
+      put(txn, objs[i], unique, (const uint8_t *)"1", 1);
+    }
+  }
+  for (int i = 0; i < TEST_SETS; i++) {
+    lmjcore_ptr set;
+    lmjcore_set_create(txn, set);
+    for (int e = 0; e <= i; e++) {
+      char element[16];
+      snprintf(element, sizeof(element), "e%d", e);
+      lmjcore_set_add(txn, set, (const uint8_t *)element, strlen(element));
+    }
+  }
+  lmjcore_txn_commit(txn);
+
+  rc = lmjcore_env_shape(env, NULL, &report);
+  print_test_result("lmjcore_env_shape", rc, LMJCORE_SUCCESS);
+
+  // 用超过内联阈值的值覆盖一个成员，应计入溢出页
+  size_t big_len = report.inline_limit + 1;
+  uint8_t *big = calloc(1, big_len);
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  put(txn, objs[7], "name", big, big_len);
+  lmjcore_txn_commit(txn);
+  free(big);
+
+  rc = lmjcore_env_shape(env, NULL, &report);
+  print_test_result("覆盖后分析", rc, LMJCORE_SUCCESS);
+  print_test_result("对象数", (int)report.objects, TEST_OBJECTS);
+  print_test_result("集合数", (int)report.sets, TEST_SETS);
+  int members = TEST_OBJECTS * 2 + TEST_OBJECTS / 3 + TEST_UNIQUE;
+  print_test_result("成员数", (int)report.obj_members.sum, members);
+  print_test_result("最少成员", (int)report.obj_members.min, 2);
+  print_test_result("最多成员", (int)report.obj_members.max, 4);
+  print_test_result("成员名个数", (int)report.member_name_len.count, members);
+  print_test_result("成员值个数", (int)report.value_size.count, members);
+  print_test_result("8 字节的值在 [8, 16) 桶",
+                    (int)report.value_size.buckets[4], TEST_OBJECTS);
+  print_test_result("1 字节的值在 [1, 2) 桶",
+                    (int)report.value_size.buckets[1], TEST_UNIQUE);
+  print_test_result("20 字节的值在 [16, 32) 桶",
+                    (int)report.value_size.buckets[5], TEST_OBJECTS - 1);
+  print_test_result("溢出页中的值", (int)report.overflow_values, 1);
+  print_test_result("集合基数之和", (int)report.set_cardinality.sum,
+                    TEST_SETS * (TEST_SETS + 1) / 2);
+  print_test_result("集合基数范围",
+                    report.set_cardinality.min == 1 &&
+                        report.set_cardinality.max == TEST_SETS,
+                    1);
+  print_test_result("元素个数", (int)report.element_size.count,
+                    TEST_SETS * (TEST_SETS + 1) / 2);
+  print_test_result("数据版本", report.txn_id > 0, 1);
+
+  // 默认草图足够大，次数精确
+  print_test_result("最高频成员名", top_is(&report, 0, "id"), 1);
+  print_test_result("次高频成员名", top_is(&report, 1, "name"), 1);
+  print_test_result("第三高频成员名", top_is(&report, 2, "tag"), 1);
+  print_test_result("精确次数", (int)report.top[0].count, TEST_OBJECTS);
+  print_test_result("没有误差", (int)report.top[2].error, 0);
+  print_test_result("高频名字个数", (int)report.top_count,
+                    LMJCORE_SHAPE_TOP_NAMES);
+
+  // 单线程与大量区间的结果一致
+  static lmjcore_shape_report single, many;
+  lmjcore_shape_opts opts = {.threads = 1};
+  lmjcore_env_shape(env, &opts, &single);
+  opts = (lmjcore_shape_opts){.threads = 3, .ranges = 1000};
+  lmjcore_env_shape(env, &opts, &many);
+  print_test_result("单线程直方图一致", same_hists(&report, &single), 1);
+  print_test_result("多区间直方图一致", same_hists(&report, &many), 1);
+  print_test_result("多区间高频名字一致",
+                    top_is(&many, 0, "id") && top_is(&many, 1, "name") &&
+                        top_is(&many, 2, "tag") &&
+                        many.top[2].count == report.top[2].count,
+                    1);
+
+  // 很小的草图仍能找出高频名字，次数为上界且误差有界
+  opts = (lmjcore_shape_opts){.threads = 4, .sketch_size = 8};
+  static lmjcore_shape_report small;
+  rc = lmjcore_env_shape(env, &opts, &small);
+  print_test_result("小草图分析", rc, LMJCORE_SUCCESS);
+  print_test_result("小草图找出高频名字",
+                    top_is(&small, 0, "id") && top_is(&small, 1, "name"), 1);
+  print_test_result("小草图次数为上界",
+                    small.top[0].count >= TEST_OBJECTS &&
+                        small.top[0].count - small.top[0].error <=
+                            TEST_OBJECTS,
+                    1);
+  print_test_result("小草图误差有界",
+                    small.top[0].error <= (size_t)members / 8, 1);
+
+  // JSON 报告
+  lmjcore_ser_buf buf;
+  lmjcore_ser_buf_init(&buf, 0);
+  rc = lmjcore_ser_shape_report(&report, &buf);
+  print_test_result("序列化报告", rc, LMJCORE_SUCCESS);
+  char *json = malloc(buf.len + 1);
+  memcpy(json, buf.data, buf.len);
+  json[buf.len] = '\0';
+  print_test_result("JSON 对象数", strstr(json, "\"objects\":300,") != NULL, 1);
+  print_test_result(
+      "JSON 直方图",
+      strstr(json, "\"set_cardinality\":{\"count\":20,\"sum\":210,"
+                   "\"min\":1,\"max\":20,\"mean\":10.500,") != NULL,
+      1);
+  print_test_result("JSON 分桶",
+                    strstr(json, "{\"lo\":8,\"hi\":16,\"count\":300}") != NULL,
+                    1);
+  print_test_result(
+      "JSON 高频名字",
+      strstr(json, "\"top_names\":[{\"name\":\"id\",\"count\":300,"
+                   "\"error\":0}") != NULL,
+      1);
+  print_test_result("JSON 结尾", json[buf.len - 1] == '}', 1);
+  free(json);
+  print_test_result("序列化空参数", lmjcore_ser_shape_report(NULL, &buf),
+                    LMJCORE_ERROR_INVALID_PARAM);
+  lmjcore_ser_buf_free(&buf);
+
+  print_test_result("空参数", lmjcore_env_shape(env, NULL, NULL),
+                    LMJCORE_ERROR_NULL_POINTER);
+
+  lmjcore_cleanup(env);
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
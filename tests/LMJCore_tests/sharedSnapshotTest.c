@@ -0,0 +1,170 @@
+#include "lmjcore.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+// 测试配置
+#define TEST_DB_PATH "./lmjcore_db/shared_snapshot_test.mdb"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_WORKERS 4
+#define TEST_BUF_SIZE (64 * 1024)
+#define TEST_ROUNDS 20
+
+// 简单的递增指针生成器
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static uint64_t counter = 0;
+  (void)ctx;
+
+  memset(out, 0, LMJCORE_PTR_LEN);
+  counter++;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (counter >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+typedef struct {
+  lmjcore_env *env;
+  const uint8_t *set;
+  atomic_bool stop;
+  int written;
+} writer_ctx;
+
+// 持续向集合追加元素的写线程
+static void *writer_worker(void *arg) {
+  writer_ctx *ctx = arg;
+  while (!atomic_load(&ctx->stop)) {
+    lmjcore_txn *txn = NULL;
+    if (lmjcore_txn_begin(ctx->env, NULL, 0, &txn) != LMJCORE_SUCCESS) {
+      continue;
+    }
+    char value[32];
+    int len = snprintf(value, sizeof(value), "element_%06d", ctx->written);
+    lmjcore_set_add(txn, ctx->set, (const uint8_t *)value, len);
+    if (lmjcore_txn_commit(txn) == LMJCORE_SUCCESS) {
+      ctx->written++;
+    }
+  }
+  return NULL;
+}
+
+typedef struct {
+  lmjcore_txn *txn;
+  const uint8_t *set;
+  size_t count;
+  int rc;
+} reader_ctx;
+
+// 在分配到的工作事务中统计集合元素
+static void *reader_worker(void *arg) {
+  reader_ctx *ctx = arg;
+  uint8_t buf[TEST_BUF_SIZE];
+  lmjcore_result_set *result = NULL;
+  ctx->rc = lmjcore_set_get(ctx->txn, ctx->set, buf, sizeof(buf), &result);
+  if (ctx->rc == LMJCORE_SUCCESS) {
+    ctx->count = result->element_count;
+  }
+  return NULL;
+}
+
+int main() {
+  printf("=== LMJCore 共享读快照测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE,
+                        LMJCORE_ENV_NOSUBDIR | LMJCORE_ENV_NOTLS,
+                        test_ptr_generator, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+  if (rc != LMJCORE_SUCCESS) {
+    return 1;
+  }
+
+  lmjcore_ptr set;
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  lmjcore_set_create(txn, set);
+  lmjcore_txn_commit(txn);
+
+  lmjcore_shared_snapshot *snap = NULL;
+  rc = lmjcore_shared_snapshot_create(env, 0, &snap);
+  print_test_result("shared_snapshot_create(0 个工作事务)", rc,
+                    LMJCORE_ERROR_INVALID_PARAM);
+
+  // 写线程持续提交的同时反复建立共享快照
+  writer_ctx wctx = {.env = env, .set = set};
+  atomic_init(&wctx.stop, false);
+  pthread_t writer;
+  pthread_create(&writer, NULL, writer_worker, &wctx);
+
+  int consistent = 1;
+  size_t last_txn_id = 0;
+  int monotonic = 1;
+  for (int round = 0; round < TEST_ROUNDS; round++) {
+    rc = lmjcore_shared_snapshot_create(env, TEST_WORKERS, &snap);
+    if (rc != LMJCORE_SUCCESS) {
+      print_test_result("shared_snapshot_create", rc, LMJCORE_SUCCESS);
+      consistent = 0;
+      break;
+    }
+
+    size_t txn_id = 0;
+    lmjcore_shared_snapshot_txn_id(snap, &txn_id);
+    if (txn_id < last_txn_id) {
+      monotonic = 0;
+    }
+    last_txn_id = txn_id;
+
+    pthread_t readers[TEST_WORKERS];
+    reader_ctx rctx[TEST_WORKERS];
+    for (int i = 0; i < TEST_WORKERS; i++) {
+      rctx[i] = (reader_ctx){.set = set};
+      lmjcore_shared_snapshot_txn(snap, i, &rctx[i].txn);
+      pthread_create(&readers[i], NULL, reader_worker, &rctx[i]);
+    }
+    for (int i = 0; i < TEST_WORKERS; i++) {
+      pthread_join(readers[i], NULL);
+      if (rctx[i].rc != LMJCORE_SUCCESS || rctx[i].count != rctx[0].count) {
+        consistent = 0;
+      }
+    }
+
+    lmjcore_shared_snapshot_destroy(snap);
+  }
+
+  atomic_store(&wctx.stop, true);
+  pthread_join(writer, NULL);
+
+  print_test_result("所有工作线程看到同一版本", consistent, 1);
+  print_test_result("快照版本单调递增", monotonic, 1);
+  printf("写线程提交 %d 次\n", wctx.written);
+
+  // 下标越界与不可提交
+  rc = lmjcore_shared_snapshot_create(env, 2, &snap);
+  print_test_result("shared_snapshot_create", rc, LMJCORE_SUCCESS);
+  lmjcore_txn *worker = NULL;
+  rc = lmjcore_shared_snapshot_txn(snap, 2, &worker);
+  print_test_result("工作事务下标越界", rc, LMJCORE_ERROR_INVALID_PARAM);
+  lmjcore_shared_snapshot_txn(snap, 1, &worker);
+  rc = lmjcore_txn_abort(worker);
+  print_test_result("工作事务不能直接中止", rc, LMJCORE_ERROR_INVALID_PARAM);
+  rc = lmjcore_shared_snapshot_destroy(snap);
+  print_test_result("shared_snapshot_destroy", rc, LMJCORE_SUCCESS);
+
+  lmjcore_cleanup(env);
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
@@ -0,0 +1,210 @@
+#include "lmjcore.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// 测试配置
+#define TEST_DB_PATH "./lmjcore_db/snapshot_test.mdb"
+#define TEST_PLAIN_DB_PATH "./lmjcore_db/snapshot_plain.mdb"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_THREADS 4
+#define TEST_LOOPS 10000
+
+// 简单的递增指针生成器
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static uint64_t counter = 0;
+  (void)ctx;
+
+  memset(out, 0, LMJCORE_PTR_LEN);
+  counter++;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (counter >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+// 写入一个成员
+static int put_member(lmjcore_env *env, const lmjcore_ptr obj,
+                      const char *name, const char *value) {
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(env, NULL, 0, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  rc = lmjcore_obj_member_put(txn, obj, (const uint8_t *)name, strlen(name),
+                              (const uint8_t *)value, strlen(value));
+  if (rc != LMJCORE_SUCCESS) {
+    lmjcore_txn_abort(txn);
+    return rc;
+  }
+  return lmjcore_txn_commit(txn);
+}
+
+// 在快照中读取成员
+static int get_member(lmjcore_snapshot_mgr *mgr, const lmjcore_ptr obj,
+                      const char *name) {
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_snapshot_acquire(mgr, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  uint8_t buf[64];
+  size_t len = 0;
+  rc = lmjcore_obj_member_get(txn, obj, (const uint8_t *)name, strlen(name),
+                              buf, sizeof(buf), &len);
+  lmjcore_snapshot_release(mgr, txn);
+  return rc;
+}
+
+typedef struct {
+  lmjcore_snapshot_mgr *mgr;
+  const uint8_t *obj;
+  int errors;
+} worker_ctx;
+
+// 并发读线程
+static void *reader_worker(void *arg) {
+  worker_ctx *ctx = arg;
+  for (int i = 0; i < TEST_LOOPS; i++) {
+    if (get_member(ctx->mgr, ctx->obj, "name") != LMJCORE_SUCCESS) {
+      ctx->errors++;
+    }
+  }
+  return NULL;
+}
+
+int main() {
+  printf("=== LMJCore 读快照测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+  remove(TEST_PLAIN_DB_PATH);
+  remove(TEST_PLAIN_DB_PATH "-lock");
+
+  // 未启用 NOTLS 的环境不能创建管理器
+  lmjcore_env *plain_env = NULL;
+  int rc = lmjcore_init(TEST_PLAIN_DB_PATH, TEST_MAP_SIZE,
+                        LMJCORE_ENV_NOSUBDIR, test_ptr_generator, NULL,
+                        &plain_env);
+  print_test_result("lmjcore_init(无 NOTLS)", rc, LMJCORE_SUCCESS);
+  lmjcore_snapshot_mgr *mgr = NULL;
+  rc = lmjcore_snapshot_mgr_create(plain_env, NULL, &mgr);
+  print_test_result("snapshot_mgr_create(无 NOTLS)", rc,
+                    LMJCORE_ERROR_NOTLS_REQUIRED);
+  lmjcore_cleanup(plain_env);
+
+  lmjcore_env *env = NULL;
+  rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE,
+                    LMJCORE_ENV_NOSUBDIR | LMJCORE_ENV_NOTLS,
+                    test_ptr_generator, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+  if (rc != LMJCORE_SUCCESS) {
+    return 1;
+  }
+
+  lmjcore_ptr obj;
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  lmjcore_obj_create(txn, obj);
+  lmjcore_txn_commit(txn);
+  put_member(env, obj, "name", "alice");
+
+  lmjcore_snapshot_opts opts = {
+      .max_staleness_ms = 50,
+      .max_pin_ms = 100,
+      .watchdog_interval_ms = 20,
+  };
+  rc = lmjcore_snapshot_mgr_create(env, &opts, &mgr);
+  print_test_result("snapshot_mgr_create", rc, LMJCORE_SUCCESS);
+
+  // 反复获取只建立一次快照
+  for (int i = 0; i < 1000; i++) {
+    get_member(mgr, obj, "name");
+  }
+  lmjcore_snapshot_stats stats;
+  lmjcore_snapshot_mgr_stats(mgr, &stats);
+  print_test_result("重复获取复用快照", stats.renewals == 1 &&
+                                            stats.acquires == 1000,
+                    1);
+
+  // 嵌套获取得到同一快照
+  lmjcore_txn *outer = NULL, *inner = NULL;
+  lmjcore_snapshot_acquire(mgr, &outer);
+  lmjcore_snapshot_acquire(mgr, &inner);
+  print_test_result("嵌套获取", outer == inner, 1);
+  rc = lmjcore_txn_commit(inner);
+  print_test_result("快照事务不能直接提交", rc, LMJCORE_ERROR_INVALID_PARAM);
+  lmjcore_snapshot_release(mgr, inner);
+  rc = lmjcore_snapshot_release(mgr, outer);
+  print_test_result("snapshot_release", rc, LMJCORE_SUCCESS);
+  rc = lmjcore_snapshot_release(mgr, outer);
+  print_test_result("重复释放", rc, LMJCORE_ERROR_INVALID_PARAM);
+
+  // 过期时间内看到的是旧快照，过期后续期看到新数据
+  put_member(env, obj, "age", "30");
+  rc = get_member(mgr, obj, "age");
+  print_test_result("过期前读取旧快照", rc, LMJCORE_ERROR_MEMBER_NOT_FOUND);
+  usleep(60 * 1000);
+  rc = get_member(mgr, obj, "age");
+  print_test_result("过期后续期", rc, LMJCORE_SUCCESS);
+
+  // 读己之写模式下提交后立即可见
+  lmjcore_snapshot_opts fresh_opts = {.max_staleness_ms = 60000,
+                                      .renew_on_commit = true};
+  lmjcore_snapshot_mgr *fresh = NULL;
+  lmjcore_snapshot_mgr_create(env, &fresh_opts, &fresh);
+  get_member(fresh, obj, "name");
+  put_member(env, obj, "city", "paris");
+  rc = get_member(fresh, obj, "city");
+  print_test_result("renew_on_commit", rc, LMJCORE_SUCCESS);
+  lmjcore_snapshot_mgr_destroy(fresh);
+
+  // 空闲且落后的快照由看门狗回收
+  put_member(env, obj, "zip", "75000");
+  usleep(300 * 1000);
+  lmjcore_snapshot_mgr_stats(mgr, &stats);
+  print_test_result("看门狗回收空闲快照", stats.reclaims >= 1, 1);
+  rc = get_member(mgr, obj, "zip");
+  print_test_result("回收后重新获取", rc, LMJCORE_SUCCESS);
+
+  // 多线程各自持有快照
+  pthread_t threads[TEST_THREADS];
+  worker_ctx ctxs[TEST_THREADS];
+  for (int i = 0; i < TEST_THREADS; i++) {
+    ctxs[i] = (worker_ctx){.mgr = mgr, .obj = obj};
+    pthread_create(&threads[i], NULL, reader_worker, &ctxs[i]);
+  }
+  int errors = 0;
+  for (int i = 0; i < TEST_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+    errors += ctxs[i].errors;
+  }
+  print_test_result("并发读取", errors, 0);
+  lmjcore_snapshot_mgr_stats(mgr, &stats);
+  print_test_result("线程退出后释放快照槽", (int)stats.threads, 1);
+
+  // 空闲快照不会阻塞映射扩容
+  lmjcore_env_set_map_grow(env, 2.0, 0);
+  rc = lmjcore_env_map_grow(env);
+  print_test_result("空闲快照下扩容", rc, LMJCORE_SUCCESS);
+  rc = get_member(mgr, obj, "name");
+  print_test_result("扩容后读取", rc, LMJCORE_SUCCESS);
+
+  rc = lmjcore_snapshot_mgr_destroy(mgr);
+  print_test_result("snapshot_mgr_destroy", rc, LMJCORE_SUCCESS);
+  lmjcore_cleanup(env);
+
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
@@ -0,0 +1,143 @@
+#include "lmjcore.h"
+#include <stdio.h>
+#include <string.h>
+
+// 测试配置
+#define TEST_DB_PATH "./lmjcore_db/stats_test.mdb"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_OBJECTS 200
+#define TEST_SETS 50
+#define TEST_BIG_VALUE 6000
+
+// 简单的递增指针生成器
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static uint64_t counter = 0;
+  (void)ctx;
+
+  memset(out, 0, LMJCORE_PTR_LEN);
+  counter++;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (counter >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+int main() {
+  printf("=== LMJCore 存储统计测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE, LMJCORE_ENV_NOSUBDIR,
+                        test_ptr_generator, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+
+  // 空环境
+  lmjcore_storage_stats stats;
+  rc = lmjcore_env_stats(env, &stats);
+  print_test_result("空环境 env_stats", rc, LMJCORE_SUCCESS);
+  print_test_result("空环境 main 条目数", (int)stats.main.entries, 0);
+  lmjcore_storage_sample sample;
+  rc = lmjcore_env_sample(env, 0, &sample);
+  print_test_result("空环境 env_sample", rc, LMJCORE_SUCCESS);
+  print_test_result("空环境无对象", (int)sample.obj.entities, 0);
+
+  // 对象：两个小成员，每 10 个对象有一个大值；集合：三个元素
+  static uint8_t big[TEST_BIG_VALUE];
+  memset(big, 'x', sizeof(big));
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    lmjcore_ptr obj;
+    lmjcore_obj_create(txn, obj);
+    lmjcore_obj_member_put(txn, obj, (const uint8_t *)"name", 4,
+                           (const uint8_t *)"12345678", 8);
+    if (i % 10 == 0) {
+      lmjcore_obj_member_put(txn, obj, (const uint8_t *)"blob", 4, big,
+                             sizeof(big));
+    } else {
+      lmjcore_obj_member_put(txn, obj, (const uint8_t *)"blob", 4,
+                             (const uint8_t *)"abcd", 4);
+    }
+  }
+  for (int i = 0; i < TEST_SETS; i++) {
+    lmjcore_ptr set;
+    lmjcore_set_create(txn, set);
+    lmjcore_set_add(txn, set, (const uint8_t *)"a", 1);
+    lmjcore_set_add(txn, set, (const uint8_t *)"bb", 2);
+    lmjcore_set_add(txn, set, (const uint8_t *)"ccc", 3);
+  }
+  lmjcore_txn_commit(txn);
+
+  rc = lmjcore_env_stats(env, &stats);
+  print_test_result("env_stats", rc, LMJCORE_SUCCESS);
+  print_test_result("main 条目数", (int)stats.main.entries, TEST_OBJECTS * 2);
+  print_test_result("B 树深度", stats.main.depth >= 1, 1);
+  print_test_result("叶子页", stats.main.leaf_pages > 0, 1);
+  print_test_result("页大小", stats.page_size > 0, 1);
+  print_test_result("映射使用量",
+                    stats.map_used > 0 && stats.map_used <= stats.map_size, 1);
+  print_test_result("事务 ID", stats.last_txnid > 0, 1);
+  printf("main: depth=%u branch=%zu leaf=%zu overflow=%zu entries=%zu\n",
+         stats.main.depth, stats.main.branch_pages, stats.main.leaf_pages,
+         stats.main.overflow_pages, stats.main.entries);
+  printf("set:  depth=%u branch=%zu leaf=%zu overflow=%zu entries=%zu\n",
+         stats.set.depth, stats.set.branch_pages, stats.set.leaf_pages,
+         stats.set.overflow_pages, stats.set.entries);
+
+  // 全量采样：计数与平均值可以精确核对
+  rc = lmjcore_env_sample(env, TEST_OBJECTS + TEST_SETS, &sample);
+  print_test_result("env_sample", rc, LMJCORE_SUCCESS);
+  print_test_result("对象总数", (int)sample.obj.entities, TEST_OBJECTS);
+  print_test_result("集合总数", (int)sample.set.entities, TEST_SETS);
+  print_test_result("对象全部采样", (int)sample.obj.sampled, TEST_OBJECTS);
+  print_test_result("对象平均成员数", sample.obj.avg_members == 2.0, 1);
+  print_test_result("集合平均元素数", sample.set.avg_members == 3.0, 1);
+  // 成员键为指针加 4 字节成员名
+  print_test_result("对象平均键长",
+                    sample.obj.avg_key_size == LMJCORE_PTR_LEN + 4, 1);
+  print_test_result("集合平均元素长", sample.set.avg_value_size == 2.0, 1);
+  print_test_result("溢出值数", (int)sample.obj.overflow_values,
+                    TEST_OBJECTS / 10);
+  print_test_result("溢出页浪费",
+                    sample.obj.overflow_waste > 0 &&
+                        sample.obj.overflow_waste < 1,
+                    1);
+  print_test_result("集合无溢出", (int)sample.set.overflow_values, 0);
+  print_test_result("填充率范围",
+                    sample.main_fill > 0 && sample.main_fill <= 1 &&
+                        sample.set_fill > 0 && sample.set_fill <= 1,
+                    1);
+  print_test_result("内联上限", sample.inline_limit > 0 &&
+                                    sample.inline_limit < TEST_BIG_VALUE,
+                    1);
+  printf("obj: avg_value=%.1f waste=%.2f main_fill=%.2f set_fill=%.2f "
+         "inline_limit=%zu\n",
+         sample.obj.avg_value_size, sample.obj.overflow_waste,
+         sample.main_fill, sample.set_fill, sample.inline_limit);
+
+  // 抽样：样本数不超过上限，总数仍为精确值
+  rc = lmjcore_env_sample(env, 20, &sample);
+  print_test_result("抽样 env_sample", rc, LMJCORE_SUCCESS);
+  print_test_result("抽样不超过上限",
+                    sample.obj.sampled + sample.set.sampled <= 20, 1);
+  print_test_result("抽样对象总数", (int)sample.obj.entities, TEST_OBJECTS);
+
+  print_test_result("空参数", lmjcore_env_stats(env, NULL),
+                    LMJCORE_ERROR_NULL_POINTER);
+
+  lmjcore_cleanup(env);
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
@@ -0,0 +1,171 @@
+#include "lmjcore.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// 测试配置
+#define TEST_DB_PATH "./lmjcore_db/warmup_test.mdb"
+#define TEST_RANGES_PATH "./lmjcore_db/warmup_test.ranges"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_OBJECTS 2000
+
+// 递增指针生成器：类型字节之后的 1 字节由计数器打散，模拟随机指针的分布
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static uint64_t counter = 0;
+  (void)ctx;
+
+  memset(out, 0, LMJCORE_PTR_LEN);
+  counter++;
+  out[1] = (uint8_t)(counter * 97);
+  for (int i = 0; i < 8; i++) {
+    out[2 + i] = (counter >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+// 进度统计
+typedef struct {
+  atomic_int calls;     // 回调次数
+  atomic_uint phases;   // 出现过的阶段
+  atomic_int finished;  // 收到 done 的次数
+} progress_ctx;
+
+static void on_progress(lmjcore_env *env,
+                        const lmjcore_warmup_progress *progress, void *ctx) {
+  progress_ctx *pc = ctx;
+  (void)env;
+  atomic_fetch_add(&pc->calls, 1);
+  atomic_fetch_or(&pc->phases, progress->phase);
+  if (progress->done) {
+    atomic_fetch_add(&pc->finished, 1);
+  }
+}
+
+int main() {
+  printf("=== LMJCore 启动预热测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+  remove(TEST_RANGES_PATH);
+
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE, LMJCORE_ENV_NOSUBDIR,
+                        test_ptr_generator, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+
+  // 准备数据：每个对象一个成员
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    lmjcore_ptr obj;
+    lmjcore_obj_create(txn, obj);
+    lmjcore_obj_member_put(txn, obj, (const uint8_t *)"v", 1,
+                           (const uint8_t *)&i, sizeof(i));
+  }
+  lmjcore_txn_commit(txn);
+
+  // 参数检查
+  lmjcore_warmup_opts opts = {0};
+  print_test_result("未指定方式", lmjcore_warmup_start(env, &opts),
+                    LMJCORE_ERROR_INVALID_PARAM);
+  opts.modes = LMJCORE_WARMUP_RANGES;
+  print_test_result("回放缺少路径", lmjcore_warmup_start(env, &opts),
+                    LMJCORE_ERROR_NULL_POINTER);
+  print_test_result("未启动时等待", lmjcore_warmup_wait(env, NULL),
+                    LMJCORE_SUCCESS);
+
+  // 遍历 B 树：条目数与库中一致
+  progress_ctx pc = {0};
+  opts = (lmjcore_warmup_opts){.modes = LMJCORE_WARMUP_TREE,
+                               .threads = 4,
+                               .report_ms = 5,
+                               .progress = on_progress,
+                               .progress_ctx = &pc};
+  rc = lmjcore_warmup_start(env, &opts);
+  print_test_result("warmup_start(TREE)", rc, LMJCORE_SUCCESS);
+  lmjcore_warmup_progress progress;
+  rc = lmjcore_warmup_wait(env, &progress);
+  print_test_result("warmup_wait(TREE)", rc, LMJCORE_SUCCESS);
+  print_test_result("遍历全部条目", progress.keys_done == progress.keys_total,
+                    1);
+  // main 库每个对象一个成员值，set 库每个对象一个占位加一个成员名
+  print_test_result("条目总数", (int)progress.keys_total, TEST_OBJECTS * 3);
+  // 键按类型字节之后的字节切片，条目分散到两个库的全部 64 片中
+  print_test_result("遍历分散到多片", progress.slices_walked > 2, 1);
+  print_test_result("每个库都用满全部分片", (int)progress.slices_walked,
+                    2 * 64);
+  print_test_result("结束标记", progress.done, 1);
+  print_test_result("进度回调", atomic_load(&pc.calls) > 0, 1);
+  print_test_result("回调报告 TREE 阶段",
+                    (atomic_load(&pc.phases) & LMJCORE_WARMUP_TREE) != 0, 1);
+  print_test_result("结束回调一次", atomic_load(&pc.finished), 1);
+
+  // 记录驻留区间后回放，再顺序读取整个文件
+  size_t resident = 0;
+  rc = lmjcore_warmup_record(env, TEST_RANGES_PATH, &resident);
+  print_test_result("warmup_record", rc, LMJCORE_SUCCESS);
+  print_test_result("记录到驻留页", resident > 0, 1);
+  print_test_result("区间文件已生成", access(TEST_RANGES_PATH, F_OK), 0);
+
+  opts = (lmjcore_warmup_opts){
+      .modes = LMJCORE_WARMUP_RANGES | LMJCORE_WARMUP_FILE,
+      .ranges_path = TEST_RANGES_PATH,
+      .threads = 2,
+      .chunk_size = 4096};
+  rc = lmjcore_warmup_start(env, &opts);
+  print_test_result("warmup_start(RANGES|FILE)", rc, LMJCORE_SUCCESS);
+  rc = lmjcore_warmup_wait(env, &progress);
+  print_test_result("warmup_wait(RANGES|FILE)", rc, LMJCORE_SUCCESS);
+  print_test_result("读完整个文件",
+                    progress.bytes_total > 0 &&
+                        progress.bytes_done == progress.bytes_total,
+                    1);
+
+  // 首次启动尚无区间文件：跳过回放，继续遍历 B 树
+  opts = (lmjcore_warmup_opts){
+      .modes = LMJCORE_WARMUP_RANGES | LMJCORE_WARMUP_TREE,
+      .ranges_path = "./lmjcore_db/no_such.ranges"};
+  lmjcore_warmup_start(env, &opts);
+  rc = lmjcore_warmup_wait(env, &progress);
+  print_test_result("区间文件不存在", rc, LMJCORE_SUCCESS);
+  print_test_result("继续 TREE 阶段", (int)progress.keys_done,
+                    TEST_OBJECTS * 3);
+
+  // 预热期间仍可正常读写，取消后返回 LMJCORE_ERROR_CANCELLED
+  opts = (lmjcore_warmup_opts){.modes = LMJCORE_WARMUP_TREE |
+                                        LMJCORE_WARMUP_FILE,
+                               .chunk_size = 1};
+  lmjcore_warmup_start(env, &opts);
+  print_test_result("运行中重复启动", lmjcore_warmup_start(env, &opts),
+                    LMJCORE_ERROR_INVALID_PARAM);
+  lmjcore_ptr obj;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  rc = lmjcore_obj_create(txn, obj);
+  lmjcore_txn_commit(txn);
+  print_test_result("预热期间写入", rc, LMJCORE_SUCCESS);
+  lmjcore_warmup_cancel(env);
+  lmjcore_warmup_status(env, &progress);
+  // 预热可能在取消前已经完成
+  int stopped = progress.result == LMJCORE_ERROR_CANCELLED ||
+                progress.result == LMJCORE_SUCCESS;
+  print_test_result("取消预热", progress.done && stopped, 1);
+
+  // 关闭环境时自动取消未结束的预热
+  lmjcore_warmup_start(env, &opts);
+  rc = lmjcore_cleanup(env);
+  print_test_result("带预热关闭环境", rc, LMJCORE_SUCCESS);
+
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
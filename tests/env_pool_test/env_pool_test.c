@@ -0,0 +1,260 @@
+#include "lmjcore.h"
+#include "lmjcore_env_pool.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 测试配置
+#define TEST_POOL_DIR "./lmjcore_db/pool"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_THREADS 8
+#define TEST_ROUNDS 100
+#define TEST_TENANTS 6
+
+// 简单的递增指针生成器（各租户共用，原子计数）
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static atomic_uint_fast64_t counter = 0;
+  (void)ctx;
+
+  uint64_t value = atomic_fetch_add(&counter, 1) + 1;
+  memset(out, 0, LMJCORE_PTR_LEN);
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (value >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+static void remove_tenant(const char *tenant) {
+  char path[256];
+  snprintf(path, sizeof(path), TEST_POOL_DIR "/%s.mdb", tenant);
+  remove(path);
+  snprintf(path, sizeof(path), TEST_POOL_DIR "/%s.mdb-lock", tenant);
+  remove(path);
+}
+
+// 在租户环境中创建一个对象
+static int tenant_create_obj(lmjcore_pooled_env *handle, lmjcore_ptr obj) {
+  lmjcore_txn *txn = NULL;
+  int rc = lmjcore_txn_begin(lmjcore_pooled_env_get(handle), NULL, 0, &txn);
+  if (rc != LMJCORE_SUCCESS) {
+    return rc;
+  }
+  rc = lmjcore_obj_create(txn, obj);
+  if (rc != LMJCORE_SUCCESS) {
+    lmjcore_txn_abort(txn);
+    return rc;
+  }
+  return lmjcore_txn_commit(txn);
+}
+
+// 检查租户环境中的对象是否存在
+static int tenant_exists(lmjcore_pooled_env *handle, const lmjcore_ptr obj) {
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(lmjcore_pooled_env_get(handle), NULL,
+                    LMJCORE_TXN_READONLY, &txn);
+  int exist = lmjcore_entity_exist(txn, obj);
+  lmjcore_txn_abort(txn);
+  return exist;
+}
+
+typedef struct {
+  lmjcore_env_pool *pool;
+  lmjcore_pooled_env *handle;
+} release_ctx;
+
+static void *delayed_release(void *arg) {
+  release_ctx *ctx = arg;
+  usleep(50 * 1000);
+  lmjcore_env_pool_release(ctx->pool, ctx->handle);
+  return NULL;
+}
+
+typedef struct {
+  lmjcore_env_pool *pool;
+  lmjcore_pooled_env *handle;
+  int rc;
+} acquire_ctx;
+
+static void *pending_acquire(void *arg) {
+  acquire_ctx *ctx = arg;
+  ctx->rc = lmjcore_env_pool_acquire(ctx->pool, "bob", &ctx->handle);
+  return NULL;
+}
+
+typedef struct {
+  lmjcore_env_pool *pool;
+  int index;
+  int failures;
+} worker_ctx;
+
+// 多线程轮流访问多个租户
+static void *pool_worker(void *arg) {
+  worker_ctx *ctx = arg;
+  for (int i = 0; i < TEST_ROUNDS; i++) {
+    char tenant[32];
+    snprintf(tenant, sizeof(tenant), "tenant_%d",
+             (ctx->index + i) % TEST_TENANTS);
+    lmjcore_pooled_env *handle = NULL;
+    if (lmjcore_env_pool_acquire(ctx->pool, tenant, &handle) !=
+        LMJCORE_SUCCESS) {
+      ctx->failures++;
+      continue;
+    }
+    lmjcore_ptr obj;
+    if (tenant_create_obj(handle, obj) != LMJCORE_SUCCESS) {
+      ctx->failures++;
+    }
+    lmjcore_env_pool_release(ctx->pool, handle);
+  }
+  return NULL;
+}
+
+int main() {
+  printf("=== LMJCore 多租户环境池测试 ===\n\n");
+
+  mkdir(TEST_POOL_DIR, 0775);
+  const char *tenants[] = {"alice", "bob", "carol"};
+  for (int i = 0; i < 3; i++) {
+    remove_tenant(tenants[i]);
+  }
+  for (int i = 0; i < TEST_TENANTS; i++) {
+    char tenant[32];
+    snprintf(tenant, sizeof(tenant), "tenant_%d", i);
+    remove_tenant(tenant);
+  }
+
+  lmjcore_env_pool_opts opts = {
+      .max_open = 2,
+      .base_dir = TEST_POOL_DIR,
+      .map_size = TEST_MAP_SIZE,
+      .env_flags = LMJCORE_ENV_NOSUBDIR,
+      .ptr_gen = test_ptr_generator,
+  };
+  lmjcore_env_pool *pool = NULL;
+  int rc = lmjcore_env_pool_create(&opts, &pool);
+  print_test_result("env_pool_create", rc, LMJCORE_SUCCESS);
+
+  lmjcore_pooled_env *a = NULL, *b = NULL, *c = NULL, *a2 = NULL;
+  rc = lmjcore_env_pool_acquire(pool, "../evil", &a);
+  print_test_result("非法租户编号", rc, LMJCORE_ERROR_INVALID_PARAM);
+
+  // 同一租户多次获取共享同一个环境
+  lmjcore_env_pool_acquire(pool, "alice", &a);
+  lmjcore_env_pool_acquire(pool, "alice", &a2);
+  print_test_result("同租户共享环境",
+                    lmjcore_pooled_env_get(a) == lmjcore_pooled_env_get(a2), 1);
+  lmjcore_ptr alice_obj;
+  rc = tenant_create_obj(a, alice_obj);
+  print_test_result("写入 alice", rc, LMJCORE_SUCCESS);
+  lmjcore_env_pool_release(pool, a2);
+  lmjcore_env_pool_release(pool, a);
+  rc = lmjcore_env_pool_release(pool, a);
+  print_test_result("重复释放", rc, LMJCORE_ERROR_INVALID_PARAM);
+
+  // 达到上限后 LRU 关闭最久未用的 alice
+  lmjcore_env_pool_acquire(pool, "bob", &b);
+  lmjcore_env_pool_release(pool, b);
+  rc = lmjcore_env_pool_acquire(pool, "carol", &c);
+  print_test_result("acquire carol", rc, LMJCORE_SUCCESS);
+  lmjcore_env_pool_stats stats;
+  lmjcore_env_pool_stats_get(pool, &stats);
+  print_test_result("打开数不超过上限", (int)stats.open, 2);
+  print_test_result("LRU 关闭次数", (int)stats.evictions, 1);
+
+  // 重新打开 alice，数据仍在
+  rc = lmjcore_env_pool_acquire(pool, "alice", &a);
+  print_test_result("重新打开 alice", rc, LMJCORE_SUCCESS);
+  print_test_result("alice 数据保留", tenant_exists(a, alice_obj), 1);
+  lmjcore_env_pool_stats_get(pool, &stats);
+  print_test_result("关闭 bob 而非在用的 carol", (int)stats.evictions, 2);
+
+  // 全部在用且不等待
+  rc = lmjcore_env_pool_acquire(pool, "bob", &b);
+  print_test_result("全部在用", rc, LMJCORE_ERROR_POOL_FULL);
+  rc = lmjcore_env_pool_destroy(pool);
+  print_test_result("有句柄时销毁", rc, LMJCORE_ERROR_INVALID_PARAM);
+  lmjcore_env_pool_release(pool, a);
+  lmjcore_env_pool_release(pool, c);
+  rc = lmjcore_env_pool_destroy(pool);
+  print_test_result("env_pool_destroy", rc, LMJCORE_SUCCESS);
+
+  // 等待其他线程释放句柄
+  opts.wait_timeout_ms = 2000;
+  opts.max_open = 1;
+  lmjcore_env_pool_create(&opts, &pool);
+  lmjcore_env_pool_acquire(pool, "alice", &a);
+  release_ctx rctx = {.pool = pool, .handle = a};
+  pthread_t releaser;
+  pthread_create(&releaser, NULL, delayed_release, &rctx);
+  rc = lmjcore_env_pool_acquire(pool, "bob", &b);
+  pthread_join(releaser, NULL);
+  print_test_result("等待空闲后获取", rc, LMJCORE_SUCCESS);
+  lmjcore_env_pool_stats_get(pool, &stats);
+  print_test_result("等待次数", (int)stats.waits, 1);
+  lmjcore_env_pool_release(pool, b);
+  lmjcore_env_pool_destroy(pool);
+
+  // 销毁时另一线程仍在 acquire 中等待：销毁需等它退出后才能释放池
+  int destroy_ok = 0;
+  for (int round = 0; round < 20; round++) {
+    lmjcore_env_pool_create(&opts, &pool);
+    lmjcore_env_pool_acquire(pool, "alice", &a);
+    acquire_ctx actx = {.pool = pool, .handle = NULL, .rc = -1};
+    pthread_t waiter;
+    pthread_create(&waiter, NULL, pending_acquire, &actx);
+    usleep(5 * 1000);
+    lmjcore_env_pool_release(pool, a);
+    rc = lmjcore_env_pool_destroy(pool);
+    if (rc == LMJCORE_SUCCESS) {
+      // 等待者被 closing 拒绝，池已释放
+      pthread_join(waiter, NULL);
+      destroy_ok += actx.rc == LMJCORE_ERROR_INVALID_PARAM;
+      continue;
+    }
+    // 等待者先拿到了 bob，归还后再销毁
+    pthread_join(waiter, NULL);
+    if (actx.rc == LMJCORE_SUCCESS) {
+      lmjcore_env_pool_release(pool, actx.handle);
+    }
+    destroy_ok += lmjcore_env_pool_destroy(pool) == LMJCORE_SUCCESS;
+  }
+  print_test_result("销毁等待进行中的 acquire", destroy_ok, 20);
+
+  // 多线程并发访问超过上限的租户
+  opts.max_open = 3;
+  lmjcore_env_pool_create(&opts, &pool);
+  pthread_t threads[TEST_THREADS];
+  worker_ctx wctx[TEST_THREADS];
+  for (int i = 0; i < TEST_THREADS; i++) {
+    wctx[i] = (worker_ctx){.pool = pool, .index = i};
+    pthread_create(&threads[i], NULL, pool_worker, &wctx[i]);
+  }
+  int failures = 0;
+  for (int i = 0; i < TEST_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+    failures += wctx[i].failures;
+  }
+  print_test_result("并发访问失败数", failures, 0);
+  lmjcore_env_pool_stats_get(pool, &stats);
+  print_test_result("并发后打开数不超过上限", stats.open <= 3, 1);
+  print_test_result("并发后无在用环境", (int)stats.in_use, 0);
+  printf("hits=%zu opens=%zu evictions=%zu\n", stats.hits, stats.opens,
+         stats.evictions);
+  lmjcore_env_pool_destroy(pool);
+
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
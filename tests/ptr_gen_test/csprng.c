@@ -0,0 +1,107 @@
+#include "lmjcore.h"
+#include "lmjcore_csprng.h"
+#include "lmjcore_uuid_gen.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define TEST_PTR_COUNT 10000
+#define TEST_THREADS 4
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d\n", test_name, expected, result);
+  }
+}
+
+static lmjcore_ptr ptrs[TEST_PTR_COUNT];
+static uint8_t thread_out[TEST_THREADS][32];
+
+static int ptr_cmp(const void *a, const void *b) {
+  return memcmp(a, b, LMJCORE_PTR_LEN);
+}
+
+static void *thread_worker(void *arg) {
+  uint8_t *out = arg;
+  lmjcore_csprng_bytes(out, 32);
+  return NULL;
+}
+
+int main() {
+  printf("=== CSPRNG 指针生成器测试 ===\n\n");
+
+  print_test_result("csprng_bytes(NULL)", lmjcore_csprng_bytes(NULL, 1),
+                    LMJCORE_ERROR_NULL_POINTER);
+
+  // 连续生成的指针互不重复，且保留 UUIDv4 版本位
+  int version_ok = 1;
+  for (int i = 0; i < TEST_PTR_COUNT; i++) {
+    lmjcore_uuidv4_ptr_gen(NULL, ptrs[i]);
+    if ((ptrs[i][7] & 0xF0) != 0x40 || (ptrs[i][9] & 0xC0) != 0x80) {
+      version_ok = 0;
+    }
+  }
+  qsort(ptrs, TEST_PTR_COUNT, LMJCORE_PTR_LEN, ptr_cmp);
+  int duplicates = 0;
+  for (int i = 1; i < TEST_PTR_COUNT; i++) {
+    if (memcmp(ptrs[i - 1], ptrs[i], LMJCORE_PTR_LEN) == 0) {
+      duplicates++;
+    }
+  }
+  print_test_result("指针不重复", duplicates, 0);
+  print_test_result("UUIDv4 版本位", version_ok, 1);
+
+  // 跨越缓冲区边界的大块读取
+  uint8_t big[5000];
+  memset(big, 0, sizeof(big));
+  print_test_result("大块读取", lmjcore_csprng_bytes(big, sizeof(big)),
+                    LMJCORE_SUCCESS);
+  int zero_run = 0, max_zero_run = 0;
+  for (size_t i = 0; i < sizeof(big); i++) {
+    zero_run = big[i] == 0 ? zero_run + 1 : 0;
+    max_zero_run = zero_run > max_zero_run ? zero_run : max_zero_run;
+  }
+  print_test_result("输出无长段零字节", max_zero_run < 8, 1);
+
+  // 各线程独立取种，输出互不相同
+  pthread_t threads[TEST_THREADS];
+  for (int i = 0; i < TEST_THREADS; i++) {
+    pthread_create(&threads[i], NULL, thread_worker, thread_out[i]);
+  }
+  for (int i = 0; i < TEST_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  int same = 0;
+  for (int i = 0; i < TEST_THREADS; i++) {
+    for (int j = i + 1; j < TEST_THREADS; j++) {
+      same += memcmp(thread_out[i], thread_out[j], 32) == 0;
+    }
+  }
+  print_test_result("线程间输出不同", same, 0);
+
+  // fork 后子进程重新取种，不会与父进程产生相同的随机流
+  int fds[2];
+  pipe(fds);
+  pid_t pid = fork();
+  if (pid == 0) {
+    uint8_t child_out[32];
+    lmjcore_csprng_bytes(child_out, sizeof(child_out));
+    write(fds[1], child_out, sizeof(child_out));
+    _exit(0);
+  }
+  uint8_t parent_out[32], child_out[32];
+  lmjcore_csprng_bytes(parent_out, sizeof(parent_out));
+  read(fds[0], child_out, sizeof(child_out));
+  waitpid(pid, NULL, 0);
+  print_test_result("fork 后重新取种",
+                    memcmp(parent_out, child_out, sizeof(parent_out)) != 0, 1);
+
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
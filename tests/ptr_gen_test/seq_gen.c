@@ -0,0 +1,185 @@
+#include "lmjcore.h"
+#include "lmjcore_config.h"
+#include "lmjcore_seq_gen.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_DB_PATH "./lmjcore_db/seq_gen_test.mdb"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_BLOCK 256
+#define TEST_TXNS 20
+#define TEST_PER_TXN 100
+#define TEST_THREADS 4
+#define TEST_PER_THREAD 5000
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+// 8 字节大端整数
+static uint64_t be64(const uint8_t *p) {
+  uint64_t v = 0;
+  for (int i = 0; i < 8; i++) {
+    v = (v << 8) | p[i];
+  }
+  return v;
+}
+
+static uint64_t ptr_seq(const uint8_t *ptr) { return be64(ptr + 1); }
+
+static int seq_cmp(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+static lmjcore_seq_gen *open_env(lmjcore_env **env) {
+  lmjcore_seq_gen *gen = NULL;
+  lmjcore_seq_gen_create(NULL, 0, TEST_BLOCK, &gen);
+  lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE, LMJCORE_ENV_NOSUBDIR,
+               lmjcore_seq_gen_ptr, gen, env);
+  return gen;
+}
+
+static lmjcore_seq_gen *shared_gen;
+static uint64_t thread_seqs[TEST_THREADS][TEST_PER_THREAD];
+
+// 直接调用生成器，用尽时同步预留
+static void *thread_worker(void *arg) {
+  uint64_t *out = arg;
+  for (int i = 0; i < TEST_PER_THREAD;) {
+    lmjcore_ptr ptr;
+    int rc = lmjcore_seq_gen_ptr(shared_gen, ptr);
+    if (rc == LMJCORE_ERROR_PTR_EXHAUSTED) {
+      lmjcore_seq_gen_reserve(shared_gen);
+      continue;
+    }
+    out[i++] = ptr_seq(ptr);
+  }
+  return NULL;
+}
+
+int main() {
+  printf("=== 顺序指针生成器测试 ===\n\n");
+
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+
+  lmjcore_seq_gen *gen = NULL;
+  print_test_result("seq_gen_create(块过大)",
+                    lmjcore_seq_gen_create(NULL, 0, 0x80000000u, &gen),
+                    LMJCORE_ERROR_INVALID_PARAM);
+
+  lmjcore_env *env = NULL;
+  gen = open_env(&env);
+
+  // 绑定前没有可用编号
+  lmjcore_ptr ptr;
+  print_test_result("绑定前生成", lmjcore_seq_gen_ptr(gen, ptr),
+                    LMJCORE_ERROR_PTR_EXHAUSTED);
+  print_test_result("seq_gen_attach", lmjcore_seq_gen_attach(gen, env),
+                    LMJCORE_SUCCESS);
+
+  // 多个事务内连续创建对象：序号严格递增且从 1 开始
+  int ordered = 1, failed = 0;
+  uint64_t last = 0, first = 0;
+  for (int t = 0; t < TEST_TXNS; t++) {
+    lmjcore_txn *txn = NULL;
+    lmjcore_txn_begin(env, NULL, 0, &txn);
+    for (int i = 0; i < TEST_PER_TXN; i++) {
+      if (lmjcore_obj_create(txn, ptr) != LMJCORE_SUCCESS) {
+        failed++;
+        continue;
+      }
+      uint64_t seq = ptr_seq(ptr);
+      if (first == 0) {
+        first = seq;
+      }
+      if (seq <= last) {
+        ordered = 0;
+      }
+      last = seq;
+    }
+    lmjcore_txn_commit(txn);
+    lmjcore_seq_gen_reserve(gen);
+  }
+  print_test_result("创建对象失败数", failed, 0);
+  print_test_result("序号严格递增", ordered, 1);
+  print_test_result("首个序号", (int)first, 1);
+
+  // 计数器已持久化到配置对象，且不小于已发放的序号
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  uint8_t buf[8];
+  size_t size = 0;
+  int rc = lmjcore_config_get(txn, (const uint8_t *)LMJCORE_SEQ_GEN_DEFAULT_NAME,
+                              strlen(LMJCORE_SEQ_GEN_DEFAULT_NAME), buf,
+                              sizeof(buf), &size);
+  lmjcore_txn_abort(txn);
+  print_test_result("读取持久化计数器", rc, LMJCORE_SUCCESS);
+  print_test_result("计数器覆盖已发放序号", be64(buf) > last, 1);
+
+  // 单个事务消耗超过两个块：后台线程等不到写锁，返回 PTR_EXHAUSTED
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  rc = LMJCORE_SUCCESS;
+  for (int i = 0; i < TEST_BLOCK * 3 && rc == LMJCORE_SUCCESS; i++) {
+    rc = lmjcore_obj_create(txn, ptr);
+  }
+  lmjcore_txn_abort(txn);
+  print_test_result("单事务超过两个块", rc, LMJCORE_ERROR_PTR_EXHAUSTED);
+  print_test_result("seq_gen_reserve", lmjcore_seq_gen_reserve(gen),
+                    LMJCORE_SUCCESS);
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  rc = lmjcore_obj_create(txn, ptr);
+  lmjcore_txn_commit(txn);
+  print_test_result("预留后重试", rc, LMJCORE_SUCCESS);
+  last = ptr_seq(ptr);
+
+  // 多线程直接取号：全局不重复
+  shared_gen = gen;
+  pthread_t threads[TEST_THREADS];
+  for (int i = 0; i < TEST_THREADS; i++) {
+    pthread_create(&threads[i], NULL, thread_worker, thread_seqs[i]);
+  }
+  for (int i = 0; i < TEST_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  uint64_t *flat = &thread_seqs[0][0];
+  qsort(flat, TEST_THREADS * TEST_PER_THREAD, sizeof(uint64_t), seq_cmp);
+  int duplicates = 0;
+  for (int i = 1; i < TEST_THREADS * TEST_PER_THREAD; i++) {
+    if (flat[i - 1] == flat[i]) {
+      duplicates++;
+    }
+  }
+  print_test_result("线程间不重复", duplicates, 0);
+  last = flat[TEST_THREADS * TEST_PER_THREAD - 1] > last
+             ? flat[TEST_THREADS * TEST_PER_THREAD - 1]
+             : last;
+
+  print_test_result("seq_gen_destroy", lmjcore_seq_gen_destroy(gen),
+                    LMJCORE_SUCCESS);
+  lmjcore_cleanup(env);
+
+  // 重启后从持久化计数器继续，不会重复发放
+  gen = open_env(&env);
+  print_test_result("重启后 attach", lmjcore_seq_gen_attach(gen, env),
+                    LMJCORE_SUCCESS);
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  rc = lmjcore_obj_create(txn, ptr);
+  lmjcore_txn_commit(txn);
+  print_test_result("重启后创建对象", rc, LMJCORE_SUCCESS);
+  print_test_result("重启后序号大于已发放序号", ptr_seq(ptr) > last, 1);
+
+  lmjcore_seq_gen_destroy(gen);
+  lmjcore_cleanup(env);
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
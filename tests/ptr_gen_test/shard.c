@@ -0,0 +1,111 @@
+#include "lmjcore.h"
+#include "lmjcore_shard_gen.h"
+#include "lmjcore_uuid_gen.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_DB_PATH "./lmjcore_db/shard_test.mdb"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_PTR_COUNT 10000
+#define TEST_SHARD 0x1234
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+// 简单的递增指针生成器
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static uint64_t counter = 0;
+  (void)ctx;
+
+  memset(out, 0, LMJCORE_PTR_LEN);
+  counter++;
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (counter >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+int main() {
+  printf("=== 分片指针布局测试 ===\n\n");
+
+  // 读写分片字段
+  lmjcore_ptr ptr;
+  memset(ptr, 0xAB, sizeof(ptr));
+  ptr[0] = LMJCORE_OBJ;
+  uint16_t shard = 0;
+  print_test_result("ptr_shard_set", lmjcore_ptr_shard_set(ptr, 0xBEEF),
+                    LMJCORE_SUCCESS);
+  print_test_result("ptr_shard_get", lmjcore_ptr_shard_get(ptr, &shard),
+                    LMJCORE_SUCCESS);
+  print_test_result("分片编号", shard, 0xBEEF);
+  print_test_result("其余字节不变", ptr[3] == 0xAB && ptr[16] == 0xAB, 1);
+  ptr[0] = 0x7F;
+  print_test_result("非法类型字节", lmjcore_ptr_shard_get(ptr, &shard),
+                    LMJCORE_ERROR_INVALID_POINTER);
+  print_test_result("shard_ptr_gen(NULL)", lmjcore_shard_ptr_gen(NULL, ptr),
+                    LMJCORE_ERROR_INVALID_PARAM);
+
+  // 默认内层为 UUIDv7：同一分片内仍保持递增
+  lmjcore_shard_gen_ctx ctx = {.shard_id = TEST_SHARD};
+  lmjcore_ptr prev;
+  int ordered = 1, shard_ok = 1;
+  for (int i = 0; i < TEST_PTR_COUNT; i++) {
+    lmjcore_shard_ptr_gen(&ctx, ptr);
+    ptr[0] = LMJCORE_OBJ;
+    if (lmjcore_ptr_shard_get(ptr, &shard) != LMJCORE_SUCCESS ||
+        shard != TEST_SHARD) {
+      shard_ok = 0;
+    }
+    if (i > 0 && memcmp(prev, ptr, LMJCORE_PTR_LEN) >= 0) {
+      ordered = 0;
+    }
+    memcpy(prev, ptr, LMJCORE_PTR_LEN);
+  }
+  print_test_result("分片字段正确", shard_ok, 1);
+  print_test_result("分片内递增", ordered, 1);
+
+  // 包装自定义生成器：内层输出整体后移两字节
+  lmjcore_shard_gen_ctx seq_ctx = {.shard_id = 7,
+                                   .inner = test_ptr_generator};
+  lmjcore_shard_ptr_gen(&seq_ctx, ptr);
+  print_test_result("内层输出后移", ptr[10], 1);
+
+  // 作为环境的指针生成器：对象与集合都带分片编号
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE, LMJCORE_ENV_NOSUBDIR,
+                        lmjcore_shard_ptr_gen, &ctx, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+  if (rc != LMJCORE_SUCCESS) {
+    return 1;
+  }
+
+  lmjcore_txn *txn = NULL;
+  lmjcore_ptr obj, set;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  lmjcore_obj_create(txn, obj);
+  lmjcore_set_create(txn, set);
+  rc = lmjcore_txn_commit(txn);
+  print_test_result("txn_commit", rc, LMJCORE_SUCCESS);
+
+  lmjcore_ptr_shard_get(obj, &shard);
+  print_test_result("对象分片编号", shard, TEST_SHARD);
+  lmjcore_ptr_shard_get(set, &shard);
+  print_test_result("集合分片编号", shard, TEST_SHARD);
+
+  lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  print_test_result("entity_exist", lmjcore_entity_exist(txn, obj), 1);
+  lmjcore_txn_abort(txn);
+
+  lmjcore_cleanup(env);
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
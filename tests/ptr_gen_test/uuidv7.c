@@ -0,0 +1,127 @@
+#include "lmjcore.h"
+#include "lmjcore_uuid_gen.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_DB_PATH "./lmjcore_db/uuidv7_test.mdb"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_PTR_COUNT 100000
+#define TEST_THREADS 4
+#define TEST_PER_THREAD 20000
+#define TEST_OBJ_COUNT 100
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d\n", test_name, expected, result);
+  }
+}
+
+static lmjcore_ptr ptrs[TEST_PTR_COUNT];
+static lmjcore_ptr thread_ptrs[TEST_THREADS][TEST_PER_THREAD];
+static int thread_ordered[TEST_THREADS];
+
+static int ptr_cmp(const void *a, const void *b) {
+  return memcmp(a, b, LMJCORE_PTR_LEN);
+}
+
+static void *thread_worker(void *arg) {
+  int idx = (int)(size_t)arg;
+  thread_ordered[idx] = 1;
+  for (int i = 0; i < TEST_PER_THREAD; i++) {
+    lmjcore_uuidv7_ptr_gen(NULL, thread_ptrs[idx][i]);
+    if (i > 0 && ptr_cmp(thread_ptrs[idx][i - 1], thread_ptrs[idx][i]) >= 0) {
+      thread_ordered[idx] = 0;
+    }
+  }
+  return NULL;
+}
+
+int main() {
+  printf("=== UUIDv7 时间有序指针生成器测试 ===\n\n");
+
+  print_test_result("uuidv7_ptr_gen(NULL)", lmjcore_uuidv7_ptr_gen(NULL, NULL),
+                    LMJCORE_ERROR_INVALID_PARAM);
+
+  // 单线程：严格递增并保留版本位
+  int ordered = 1, version_ok = 1;
+  for (int i = 0; i < TEST_PTR_COUNT; i++) {
+    lmjcore_uuidv7_ptr_gen(NULL, ptrs[i]);
+    if ((ptrs[i][7] & 0xF0) != 0x70 || (ptrs[i][9] & 0xC0) != 0x80) {
+      version_ok = 0;
+    }
+    if (i > 0 && ptr_cmp(ptrs[i - 1], ptrs[i]) >= 0) {
+      ordered = 0;
+    }
+  }
+  print_test_result("严格递增", ordered, 1);
+  print_test_result("UUIDv7 版本位", version_ok, 1);
+
+  // 时间戳字段接近当前时间
+  uint64_t ms = 0;
+  for (int i = 0; i < 6; i++) {
+    ms = (ms << 8) | ptrs[TEST_PTR_COUNT - 1][1 + i];
+  }
+  uint64_t now = (uint64_t)time(NULL) * 1000;
+  int ts_ok = ms + 60000 > now && ms < now + 60000;
+  print_test_result("时间戳字段", ts_ok, 1);
+
+  // 多线程：各线程内递增，全局不重复
+  pthread_t threads[TEST_THREADS];
+  for (int i = 0; i < TEST_THREADS; i++) {
+    pthread_create(&threads[i], NULL, thread_worker, (void *)(size_t)i);
+  }
+  int all_ordered = 1;
+  for (int i = 0; i < TEST_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+    all_ordered &= thread_ordered[i];
+  }
+  print_test_result("线程内递增", all_ordered, 1);
+  qsort(thread_ptrs, TEST_THREADS * TEST_PER_THREAD, LMJCORE_PTR_LEN, ptr_cmp);
+  lmjcore_ptr *flat = &thread_ptrs[0][0];
+  int duplicates = 0;
+  for (int i = 1; i < TEST_THREADS * TEST_PER_THREAD; i++) {
+    if (ptr_cmp(flat[i - 1], flat[i]) == 0) {
+      duplicates++;
+    }
+  }
+  print_test_result("线程间不重复", duplicates, 0);
+
+  // 作为环境的指针生成器使用
+  remove(TEST_DB_PATH);
+  remove(TEST_DB_PATH "-lock");
+  lmjcore_env *env = NULL;
+  int rc = lmjcore_init(TEST_DB_PATH, TEST_MAP_SIZE, LMJCORE_ENV_NOSUBDIR,
+                        lmjcore_uuidv7_ptr_gen, NULL, &env);
+  print_test_result("lmjcore_init", rc, LMJCORE_SUCCESS);
+  if (rc != LMJCORE_SUCCESS) {
+    return 1;
+  }
+
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, 0, &txn);
+  int created = 0;
+  ordered = 1;
+  for (int i = 0; i < TEST_OBJ_COUNT; i++) {
+    if (lmjcore_obj_create(txn, ptrs[i]) == LMJCORE_SUCCESS) {
+      created++;
+    }
+    if (i > 0 && ptr_cmp(ptrs[i - 1], ptrs[i]) >= 0) {
+      ordered = 0;
+    }
+  }
+  rc = lmjcore_txn_commit(txn);
+  print_test_result("创建对象", created, TEST_OBJ_COUNT);
+  print_test_result("txn_commit", rc, LMJCORE_SUCCESS);
+  print_test_result("对象指针递增", ordered, 1);
+  print_test_result("类型字节", ptrs[0][0], LMJCORE_OBJ);
+
+  lmjcore_cleanup(env);
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}
@@ -1,4 +1,6 @@
 #include "result_parser.h"
+#include "result_serializer.h"
+#include "result_wire.h"
 #include "lmjcore.h"
 #include <assert.h>
 #include <stdio.h>
@@ -90,6 +92,60 @@ static void build_mock_arr_result(uint8_t *buf, size_t buf_size,
   *out_head = head;
 }
 
+// 辅助：构建模拟的数组结果缓冲区（二进制元素）
+static void build_mock_arr_result_bin(uint8_t *buf, size_t buf_size,
+                                      lmjcore_result_set **out_head,
+                                      const uint8_t *elements[],
+                                      const size_t lens[], size_t count) {
+  memset(buf, 0, buf_size);
+
+  lmjcore_result_set *head = (lmjcore_result_set *)buf;
+  head->element_count = count;
+
+  uint8_t *data_ptr = buf + buf_size;
+  for (size_t i = 0; i < count; ++i) {
+    data_ptr -= lens[i];
+    assert(data_ptr >= (uint8_t *)&head->elements[count]);
+    memcpy(data_ptr, elements[i], lens[i]);
+    head->elements[i].value_offset = data_ptr - buf;
+    head->elements[i].value_len = lens[i];
+  }
+
+  *out_head = head;
+}
+
+// 辅助：构建模拟的对象结果缓冲区（二进制值，values[i] 为 NULL 表示缺失值）
+static void build_mock_obj_result_bin(uint8_t *buf, size_t buf_size,
+                                      lmjcore_result_obj **out_head,
+                                      const char *names[],
+                                      const uint8_t *values[],
+                                      const size_t value_lens[],
+                                      size_t count) {
+  memset(buf, 0, buf_size);
+
+  lmjcore_result_obj *head = (lmjcore_result_obj *)buf;
+  head->member_count = count;
+
+  uint8_t *data_ptr = buf + buf_size;
+  for (size_t i = 0; i < count; ++i) {
+    lmjcore_member_descriptor *desc = &head->members[i];
+    if (values[i]) {
+      data_ptr -= value_lens[i];
+      memcpy(data_ptr, values[i], value_lens[i]);
+      desc->member_value.value_offset = data_ptr - buf;
+      desc->member_value.value_len = value_lens[i];
+    }
+    size_t nlen = strlen(names[i]);
+    data_ptr -= nlen;
+    memcpy(data_ptr, names[i], nlen);
+    desc->member_name.value_offset = data_ptr - buf;
+    desc->member_name.value_len = nlen;
+    assert(data_ptr >= (uint8_t *)&head->members[count]);
+  }
+
+  *out_head = head;
+}
+
 // 辅助：检查错误信息
 static void test_error_parsing() {
   uint8_t buf[256];
@@ -115,6 +171,364 @@ static void test_error_parsing() {
          LMJCORE_ERROR_ENTITY_NOT_FOUND);
 }
 
+// 辅助：检查查找索引与有序二分查找
+static void test_indexed_lookup() {
+  // LMDB dup 顺序：逐字节比较，前缀较短者在前
+  const char *names[] = {"a", "ab", "abc", "b", "ba", "city", "name", "zz"};
+  const char *values[] = {"1", "2", "3", "4", "5", "6", "7", "8"};
+  uint8_t buf[1024];
+  lmjcore_result_obj *obj_result;
+  build_mock_obj_result(buf, sizeof(buf), &obj_result, names, values, 8);
+  obj_result->sorted = true; // 有序结果走二分查找
+
+  const uint8_t *val;
+  size_t vlen;
+  for (size_t i = 0; i < 8; ++i) {
+    assert(lmjcore_parser_obj_find_member(obj_result, buf,
+                                          (const uint8_t *)names[i],
+                                          strlen(names[i]), &val,
+                                          &vlen) == LMJCORE_SUCCESS);
+    assert(vlen == 1 && val[0] == values[i][0]);
+  }
+  assert(lmjcore_parser_obj_find_member(obj_result, buf, (uint8_t *)"abd", 3,
+                                        NULL, NULL) ==
+         LMJCORE_ERROR_ENTITY_NOT_FOUND);
+
+  // arena 不足
+  uint32_t arena[64];
+  lmjcore_parser_index index;
+  assert(lmjcore_parser_index_size(8) <= sizeof(arena));
+  assert(lmjcore_parser_obj_index_build(obj_result, buf, arena, 8, &index) ==
+         LMJCORE_ERROR_BUFFER_TOO_SMALL);
+
+  assert(lmjcore_parser_obj_index_build(obj_result, buf, arena, sizeof(arena),
+                                        &index) == LMJCORE_SUCCESS);
+  for (size_t i = 0; i < 8; ++i) {
+    assert(lmjcore_parser_obj_find_member_indexed(
+               obj_result, buf, &index, (const uint8_t *)names[i],
+               strlen(names[i]), &val, &vlen) == LMJCORE_SUCCESS);
+    assert(vlen == 1 && val[0] == values[i][0]);
+  }
+  assert(lmjcore_parser_obj_find_member_indexed(obj_result, buf, &index,
+                                                (uint8_t *)"missing", 7, NULL,
+                                                NULL) ==
+         LMJCORE_ERROR_ENTITY_NOT_FOUND);
+
+  // 无序数组同样可以建立索引
+  const char *elems[] = {"cherry", "apple", "banana"};
+  lmjcore_result_set *arr_result;
+  build_mock_arr_result(buf, sizeof(buf), &arr_result, elems, 3);
+  assert(lmjcore_parser_arr_index_build(arr_result, buf, arena, sizeof(arena),
+                                        &index) == LMJCORE_SUCCESS);
+  size_t idx;
+  assert(lmjcore_parser_arr_find_element_indexed(
+             arr_result, buf, &index, (uint8_t *)"apple", 5, &idx) ==
+         LMJCORE_SUCCESS);
+  assert(idx == 1);
+  assert(lmjcore_parser_arr_find_element_indexed(
+             arr_result, buf, &index, (uint8_t *)"grape", 5, NULL) ==
+         LMJCORE_ERROR_ENTITY_NOT_FOUND);
+
+  // 索引与结果不匹配
+  arr_result->element_count = 2;
+  assert(lmjcore_parser_arr_find_element_indexed(
+             arr_result, buf, &index, (uint8_t *)"apple", 5, NULL) ==
+         LMJCORE_ERROR_INVALID_PARAM);
+}
+
+// 辅助：在每个可用的指令集级别下检查批量扫描
+static void test_scan_kernels() {
+  // 17 字节指针（以不可打印字节开头，不能用 strlen，单独构造）
+  lmjcore_ptr ptr_a, ptr_b;
+  memset(ptr_a, 0x11, sizeof(ptr_a));
+  memset(ptr_b, 0x11, sizeof(ptr_b));
+  ptr_a[0] = LMJCORE_OBJ;
+  ptr_b[0] = LMJCORE_OBJ;
+  ptr_b[16] = 0x22; // 只有最后一个字节不同
+
+  const uint8_t *elems[] = {
+      (const uint8_t *)"user:1", (const uint8_t *)"user:2",
+      (const uint8_t *)"group:1", (const uint8_t *)"user:10",
+      (const uint8_t *)"u",
+      // 长于 32 字节
+      (const uint8_t *)"user:0123456789abcdefghijklmnopqrstuvwxyz",
+      (const uint8_t *)"user:0123456789abcdefghijklmnopqrstuvwxyZ",
+      ptr_a, ptr_b, ptr_a};
+  size_t count = sizeof(elems) / sizeof(elems[0]);
+  size_t lens[sizeof(elems) / sizeof(elems[0])];
+  for (size_t i = 0; i < count; ++i) {
+    lens[i] = i >= 7 ? LMJCORE_PTR_LEN : strlen((const char *)elems[i]);
+  }
+  uint8_t buf[2048];
+  lmjcore_result_set *arr_result;
+  build_mock_arr_result_bin(buf, sizeof(buf), &arr_result, elems, lens, count);
+
+  lmjcore_parser_simd levels[] = {LMJCORE_PARSER_SIMD_SCALAR,
+                                  LMJCORE_PARSER_SIMD_SSE2,
+                                  LMJCORE_PARSER_SIMD_AVX2};
+  for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l) {
+    if (lmjcore_parser_simd_set(levels[l]) != LMJCORE_SUCCESS) {
+      printf("  跳过不支持的级别 %d\n", levels[l]);
+      continue;
+    }
+    assert(lmjcore_parser_simd_get() == levels[l]);
+
+    uint64_t bitmap[LMJCORE_PARSER_BITMAP_WORDS(10)];
+    size_t matches;
+    assert(lmjcore_parser_arr_match_prefix(arr_result, buf,
+                                           (const uint8_t *)"user:", 5, bitmap,
+                                           1, &matches) == LMJCORE_SUCCESS);
+    assert(matches == 5 && bitmap[0] == 0x6B);
+
+    assert(lmjcore_parser_arr_match_prefix(arr_result, buf, NULL, 0, bitmap, 1,
+                                           &matches) == LMJCORE_SUCCESS);
+    assert(matches == count);
+
+    assert(lmjcore_parser_arr_match_equal(arr_result, buf,
+                                          elems[6], lens[6], bitmap, 1,
+                                          &matches) == LMJCORE_SUCCESS);
+    assert(matches == 1 && bitmap[0] == 0x40);
+
+    assert(lmjcore_parser_arr_match_equal(arr_result, buf,
+                                          (const uint8_t *)"user:1", 6, bitmap,
+                                          1, &matches) == LMJCORE_SUCCESS);
+    assert(matches == 1 && bitmap[0] == 0x01);
+
+    assert(lmjcore_parser_arr_match_ptr(arr_result, buf, ptr_a, bitmap, 1,
+                                        &matches) == LMJCORE_SUCCESS);
+    assert(matches == 2 && bitmap[0] == 0x280);
+    assert(lmjcore_parser_arr_match_ptr(arr_result, buf, ptr_b, bitmap, 1,
+                                        &matches) == LMJCORE_SUCCESS);
+    assert(matches == 1 && bitmap[0] == 0x100);
+  }
+  assert(lmjcore_parser_simd_set(LMJCORE_PARSER_SIMD_AUTO) == LMJCORE_SUCCESS);
+  assert(lmjcore_parser_simd_get() != LMJCORE_PARSER_SIMD_AUTO);
+
+  // 位图不足
+  uint64_t bitmap[1];
+  assert(lmjcore_parser_arr_match_ptr(arr_result, buf, ptr_a, bitmap, 0,
+                                      NULL) == LMJCORE_ERROR_BUFFER_TOO_SMALL);
+}
+
+// 成员 id 的值已是 JSON 数字，原样输出
+static lmjcore_ser_value classify_id(void *ctx, const uint8_t *name,
+                                     size_t name_len, const uint8_t *value,
+                                     size_t value_len) {
+  (void)ctx;
+  (void)value;
+  (void)value_len;
+  if (name && name_len == 2 && memcmp(name, "id", 2) == 0) {
+    return LMJCORE_SER_VALUE_RAW;
+  }
+  return LMJCORE_SER_VALUE_AUTO;
+}
+
+static bool ser_equals(const lmjcore_ser_buf *out, const void *expect,
+                       size_t expect_len) {
+  return out->len == expect_len && memcmp(out->data, expect, expect_len) == 0;
+}
+
+// 辅助：检查 JSON / MessagePack 序列化
+static void test_serializer() {
+  lmjcore_ptr owner;
+  memset(owner, 0xab, sizeof(owner));
+  owner[0] = LMJCORE_OBJ;
+  char owner_str[LMJCORE_PTR_STRING_BUF_SIZE];
+  assert(lmjcore_ptr_to_string(owner, owner_str, sizeof(owner_str)) ==
+         LMJCORE_SUCCESS);
+
+  const char *note = "你好，世界 hello world! tab\tend";
+  const uint8_t bin[] = {0xff, 0x00, 0x01};
+  const char *names[] = {"id", "name", "note", "owner", "bin", "gone"};
+  const uint8_t *values[] = {(const uint8_t *)"42",
+                             (const uint8_t *)"Alice \"A\"\n",
+                             (const uint8_t *)note,
+                             owner,
+                             bin,
+                             NULL};
+  size_t value_lens[] = {2, 10, strlen(note), LMJCORE_PTR_LEN, sizeof(bin), 0};
+  uint8_t buf[1024];
+  lmjcore_result_obj *obj_result;
+  build_mock_obj_result_bin(buf, sizeof(buf), &obj_result, names, values,
+                            value_lens, 6);
+
+  lmjcore_ser_buf out;
+  assert(lmjcore_ser_buf_init(&out, 0) == LMJCORE_SUCCESS);
+  lmjcore_ser_opts opts = {.format = LMJCORE_SER_JSON,
+                           .classify = classify_id};
+  assert(lmjcore_ser_obj(obj_result, buf, &opts, &out) == LMJCORE_SUCCESS);
+  char expect[512];
+  int expect_len =
+      snprintf(expect, sizeof(expect),
+               "{\"id\":42,\"name\":\"Alice \\\"A\\\"\\n\","
+               "\"note\":\"你好，世界 hello world! tab\\tend\","
+               "\"owner\":\"%s\",\"bin\":\"/wAB\",\"gone\":null}",
+               owner_str);
+  assert(ser_equals(&out, expect, expect_len));
+
+  // 默认选项：id 作为字符串输出；结果追加在已有内容之后
+  size_t first_len = out.len;
+  assert(lmjcore_ser_obj(obj_result, buf, NULL, &out) == LMJCORE_SUCCESS);
+  assert(out.len == first_len + expect_len + 2);
+  assert(memcmp(out.data + first_len, "{\"id\":\"42\"", 10) == 0);
+
+  // MessagePack
+  const char *mp_names[] = {"a", "b", "c"};
+  const uint8_t *mp_values[] = {(const uint8_t *)"x", bin, NULL};
+  size_t mp_lens[] = {1, sizeof(bin), 0};
+  build_mock_obj_result_bin(buf, sizeof(buf), &obj_result, mp_names,
+                            mp_values, mp_lens, 3);
+  lmjcore_ser_buf_reset(&out);
+  opts = (lmjcore_ser_opts){.format = LMJCORE_SER_MSGPACK};
+  assert(lmjcore_ser_obj(obj_result, buf, &opts, &out) == LMJCORE_SUCCESS);
+  const uint8_t mp_expect[] = {0x83, 0xa1, 'a', 0xa1, 'x',  0xa1, 'b', 0xc4,
+                               0x03, 0xff, 0x00, 0x01, 0xa1, 'c',  0xc0};
+  assert(ser_equals(&out, mp_expect, sizeof(mp_expect)));
+
+  // 非法 UTF-8 的成员名：MessagePack 输出为 bin 键，JSON 按 \u00XX 输出
+  const char *bad_names[] = {"\xe9", "\xc3\xa9"};
+  const uint8_t *bad_values[] = {(const uint8_t *)"x", (const uint8_t *)"y"};
+  size_t bad_lens[] = {1, 1};
+  build_mock_obj_result_bin(buf, sizeof(buf), &obj_result, bad_names,
+                            bad_values, bad_lens, 2);
+  lmjcore_ser_buf_reset(&out);
+  assert(lmjcore_ser_obj(obj_result, buf, &opts, &out) == LMJCORE_SUCCESS);
+  const uint8_t mp_bad[] = {0x82, 0xc4, 0x01, 0xe9, 0xa1, 'x',
+                            0xa2, 0xc3, 0xa9, 0xa1, 'y'};
+  assert(ser_equals(&out, mp_bad, sizeof(mp_bad)));
+  lmjcore_ser_buf_reset(&out);
+  assert(lmjcore_ser_obj(obj_result, buf, NULL, &out) == LMJCORE_SUCCESS);
+  const char *json_bad = "{\"\\u00e9\":\"x\",\"\xc3\xa9\":\"y\"}";
+  assert(ser_equals(&out, json_bad, strlen(json_bad)));
+
+  // 集合：长字符串使用 str16
+  static char long_elem[301];
+  memset(long_elem, 'a', 300);
+  const char *elems[] = {"x", long_elem};
+  lmjcore_result_set *arr_result;
+  build_mock_arr_result(buf, sizeof(buf), &arr_result, elems, 2);
+  lmjcore_ser_buf_reset(&out);
+  assert(lmjcore_ser_set(arr_result, buf, &opts, &out) == LMJCORE_SUCCESS);
+  assert(out.len == 3 + 3 + 300 && out.data[0] == 0x92 && out.data[3] == 0xda &&
+         out.data[4] == 0x01 && out.data[5] == 0x2c);
+
+  lmjcore_ser_buf_reset(&out);
+  assert(lmjcore_ser_set(arr_result, buf, NULL, &out) == LMJCORE_SUCCESS);
+  assert(out.len == 2 + 3 + 1 + 302 &&
+         memcmp(out.data, "[\"x\",\"aaa", 9) == 0);
+
+  assert(lmjcore_ser_set(NULL, buf, NULL, &out) == LMJCORE_ERROR_INVALID_PARAM);
+  lmjcore_ser_buf_free(&out);
+}
+
+// 辅助：检查线上格式的编码与零拷贝读取
+static void test_wire_format() {
+  lmjcore_ptr obj_ptr;
+  memset(obj_ptr, 0x5a, sizeof(obj_ptr));
+  obj_ptr[0] = LMJCORE_OBJ;
+
+  const char *names[] = {"age", "city", "name"};
+  const uint8_t *values[] = {(const uint8_t *)"30", NULL,
+                             (const uint8_t *)"Alice"};
+  size_t value_lens[] = {2, 0, 5};
+  uint8_t buf[1024];
+  lmjcore_result_obj *obj_result;
+  build_mock_obj_result_bin(buf, sizeof(buf), &obj_result, names, values,
+                            value_lens, 3);
+  // city 缺失值，错误引用其名称
+  obj_result->error_count = 1;
+  obj_result->errors[0].error_code = LMJCORE_ERROR_MEMBER_MISSING;
+  obj_result->errors[0].element.element_offset =
+      obj_result->members[1].member_name.value_offset;
+  obj_result->errors[0].element.element_len = 4;
+  memcpy(obj_result->errors[0].entity_ptr, obj_ptr, LMJCORE_PTR_LEN);
+
+  // 先查询所需大小
+  size_t wire_len = 0;
+  assert(lmjcore_wire_encode_obj(obj_result, buf, NULL, 0, &wire_len) ==
+         LMJCORE_ERROR_BUFFER_TOO_SMALL);
+  assert(wire_len == LMJCORE_WIRE_HEADER_SIZE + LMJCORE_WIRE_ERROR_SIZE +
+                         3 * 16 + 4 + (3 + 2) + 4 + (4 + 5));
+  uint8_t wire[256];
+  size_t len = 0;
+  assert(lmjcore_wire_encode_obj(obj_result, buf, wire, sizeof(wire), &len) ==
+         LMJCORE_SUCCESS);
+  assert(len == wire_len);
+  assert(memcmp(wire, "LMJW", 4) == 0 && wire[4] == LMJCORE_WIRE_VERSION);
+
+  // 原结果被覆盖后编码仍然可读（与原缓冲区无关）
+  memset(buf, 0xee, sizeof(buf));
+  lmjcore_wire_view view;
+  assert(lmjcore_wire_open(wire, len, &view) == LMJCORE_SUCCESS);
+  assert(view.kind == LMJCORE_WIRE_KIND_OBJ && view.entry_count == 3);
+  assert(view.sorted);
+
+  const uint8_t *name, *val;
+  size_t nlen, vlen;
+  assert(lmjcore_wire_obj_get_member(&view, 2, &name, &nlen, &val, &vlen) ==
+         LMJCORE_SUCCESS);
+  assert(nlen == 4 && memcmp(name, "name", 4) == 0);
+  assert(vlen == 5 && memcmp(val, "Alice", 5) == 0);
+  assert(lmjcore_wire_obj_find_member(&view, (uint8_t *)"age", 3, &val,
+                                      &vlen) == LMJCORE_SUCCESS);
+  assert(vlen == 2 && memcmp(val, "30", 2) == 0);
+  assert(lmjcore_wire_obj_find_member(&view, (uint8_t *)"city", 4, &val,
+                                      &vlen) == LMJCORE_SUCCESS);
+  assert(val == NULL && vlen == 0);
+  assert(lmjcore_wire_obj_find_member(&view, (uint8_t *)"zip", 3, NULL,
+                                      NULL) == LMJCORE_ERROR_ENTITY_NOT_FOUND);
+  assert(lmjcore_wire_set_get_element(&view, 0, NULL, NULL) ==
+         LMJCORE_ERROR_ENTITY_TYPE_MISMATCH);
+
+  lmjcore_read_error err;
+  assert(lmjcore_wire_get_error(&view, 0, &err) == LMJCORE_SUCCESS);
+  assert(err.error_code == LMJCORE_ERROR_MEMBER_MISSING);
+  assert(err.element.element_len == 4 &&
+         memcmp(wire + err.element.element_offset, "city", 4) == 0);
+  assert(memcmp(err.entity_ptr, obj_ptr, LMJCORE_PTR_LEN) == 0);
+  assert(lmjcore_wire_get_error(&view, 1, &err) ==
+         LMJCORE_ERROR_ENTITY_NOT_FOUND);
+
+  // 集合
+  const char *elems[] = {"apple", "banana", "cherry"};
+  lmjcore_result_set *arr_result;
+  build_mock_arr_result(buf, sizeof(buf), &arr_result, elems, 3);
+  assert(lmjcore_wire_encode_set(arr_result, buf, wire, sizeof(wire), &len) ==
+         LMJCORE_SUCCESS);
+  assert(lmjcore_wire_open(wire, len, &view) == LMJCORE_SUCCESS);
+  size_t idx;
+  assert(lmjcore_wire_set_find_element(&view, (uint8_t *)"banana", 6, &idx) ==
+         LMJCORE_SUCCESS);
+  assert(idx == 1);
+  const uint8_t *el;
+  size_t elen;
+  assert(lmjcore_wire_set_get_element(&view, 2, &el, &elen) ==
+         LMJCORE_SUCCESS);
+  assert(elen == 6 && memcmp(el, "cherry", 6) == 0);
+
+  // 截断、版本不符、越界偏移均被拒绝
+  assert(lmjcore_wire_open(wire, len - 1, &view) ==
+         LMJCORE_ERROR_INVALID_PARAM);
+  wire[4] = LMJCORE_WIRE_VERSION + 1;
+  assert(lmjcore_wire_open(wire, len, &view) == LMJCORE_ERROR_INVALID_PARAM);
+  wire[4] = LMJCORE_WIRE_VERSION;
+  wire[LMJCORE_WIRE_HEADER_SIZE + 4] = 0xff; // 第一个元素的长度
+  assert(lmjcore_wire_open(wire, len, &view) == LMJCORE_ERROR_INVALID_PARAM);
+
+  // 无序集合在打开时判定为无序，改为线性查找
+  const char *unsorted[] = {"cherry", "apple", "banana"};
+  build_mock_arr_result(buf, sizeof(buf), &arr_result, unsorted, 3);
+  assert(lmjcore_wire_encode_set(arr_result, buf, wire, sizeof(wire), &len) ==
+         LMJCORE_SUCCESS);
+  assert(lmjcore_wire_open(wire, len, &view) == LMJCORE_SUCCESS);
+  assert(!view.sorted);
+  assert(lmjcore_wire_set_find_element(&view, (uint8_t *)"apple", 5, &idx) ==
+         LMJCORE_SUCCESS);
+  assert(idx == 1);
+  assert(lmjcore_wire_set_find_element(&view, (uint8_t *)"grape", 5, NULL) ==
+         LMJCORE_ERROR_ENTITY_NOT_FOUND);
+}
+
 int main(void) {
   printf("🧪 开始测试 result_parser...\n");
 
@@ -185,6 +599,18 @@ int main(void) {
   // ===== 测试错误解析 =====
   test_error_parsing();
 
+  // ===== 测试查找索引 =====
+  test_indexed_lookup();
+
+  // ===== 测试批量扫描 =====
+  test_scan_kernels();
+
+  // ===== 测试序列化 =====
+  test_serializer();
+
+  // ===== 测试线上格式 =====
+  test_wire_format();
+
   printf("✅ 所有测试通过！\n");
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "lmjcore.h"
+#include "lmjcore_tiering.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_HOT_PATH "./lmjcore_db/tier_hot.mdb"
+#define TEST_COLD_PATH "./lmjcore_db/tier_cold.mdb"
+#define TEST_MAP_SIZE (1024 * 1024 * 10) // 10MB
+#define TEST_OBJECTS 6
+#define TEST_IDLE_MS 50
+
+// 简单的递增指针生成器（冷热环境共用，原子计数）
+static int test_ptr_generator(void *ctx, uint8_t out[LMJCORE_PTR_LEN]) {
+  static atomic_uint_fast64_t counter = 0;
+  (void)ctx;
+
+  uint64_t value = atomic_fetch_add(&counter, 1) + 1;
+  memset(out, 0, LMJCORE_PTR_LEN);
+  for (int i = 0; i < 8; i++) {
+    out[1 + i] = (value >> (56 - i * 8)) & 0xFF;
+  }
+  return LMJCORE_SUCCESS;
+}
+
+// 辅助函数：打印测试结果
+static void print_test_result(const char *test_name, int result, int expected) {
+  if (result == expected) {
+    printf("[PASS] %s\n", test_name);
+  } else {
+    printf("[FAIL] %s: expected %d, got %d (%s)\n", test_name, expected, result,
+           lmjcore_strerror(result));
+  }
+}
+
+static void remove_env(const char *path) {
+  char lock[256];
+  remove(path);
+  snprintf(lock, sizeof(lock), "%s-lock", path);
+  remove(lock);
+}
+
+// 统计实体数量，并检查遍历顺序递增
+typedef struct {
+  int count;
+  int ordered;
+  lmjcore_ptr last;
+} scan_ctx;
+
+static int count_entities(void *ctx, const lmjcore_ptr ptr) {
+  scan_ctx *scan = ctx;
+  if (scan->count > 0 && memcmp(scan->last, ptr, LMJCORE_PTR_LEN) >= 0) {
+    scan->ordered = 0;
+  }
+  memcpy(scan->last, ptr, LMJCORE_PTR_LEN);
+  scan->count++;
+  return 0;
+}
+
+static int stop_at_first(void *ctx, const lmjcore_ptr ptr) {
+  (void)ctx;
+  (void)ptr;
+  return 42;
+}
+
+// 直接检查环境中的实体是否存在
+static int env_has(lmjcore_env *env, const lmjcore_ptr ptr) {
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(env, NULL, LMJCORE_TXN_READONLY, &txn);
+  int exist = lmjcore_entity_exist(txn, ptr);
+  lmjcore_txn_abort(txn);
+  return exist;
+}
+
+// 迁移直到没有可迁移的对象
+static size_t migrate_all(lmjcore_tier *tier) {
+  size_t total = 0, moved = 0;
+  do {
+    lmjcore_tier_migrate(tier, &moved);
+    total += moved;
+  } while (moved > 0);
+  return total;
+}
+
+int main() {
+  printf("=== LMJCore 冷热分层测试 ===\n\n");
+
+  remove_env(TEST_HOT_PATH);
+  remove_env(TEST_COLD_PATH);
+
+  lmjcore_env *hot = NULL, *cold = NULL;
+  lmjcore_init(TEST_HOT_PATH, TEST_MAP_SIZE, LMJCORE_ENV_NOSUBDIR,
+               test_ptr_generator, NULL, &hot);
+  lmjcore_init(TEST_COLD_PATH, TEST_MAP_SIZE, LMJCORE_ENV_NOSUBDIR,
+               test_ptr_generator, NULL, &cold);
+
+  // 准备数据：普通对象、含缺失值成员的对象、空对象和一个系统对象
+  lmjcore_ptr objs[TEST_OBJECTS];
+  lmjcore_ptr sys_obj = {LMJCORE_OBJ};
+  lmjcore_txn *txn = NULL;
+  lmjcore_txn_begin(hot, NULL, 0, &txn);
+  for (int i = 0; i < TEST_OBJECTS; i++) {
+    lmjcore_obj_create(txn, objs[i]);
+    if (i < TEST_OBJECTS - 1) {
+      char value[16];
+      int len = snprintf(value, sizeof(value), "value_%d", i);
+      lmjcore_obj_member_put(txn, objs[i], (const uint8_t *)"name", 4,
+                             (const uint8_t *)value, len);
+    }
+  }
+  lmjcore_obj_member_register(txn, objs[1], (const uint8_t *)"todo", 4);
+  lmjcore_obj_register(txn, sys_obj);
+  lmjcore_txn_commit(txn);
+
+  lmjcore_tier_opts opts = {.idle_ms = TEST_IDLE_MS, .batch = 2};
+  lmjcore_tier *tier = NULL;
+  int rc = lmjcore_tier_create(hot, cold, &opts, &tier);
+  print_test_result("tier_create", rc, LMJCORE_SUCCESS);
+
+  // 实体遍历：包含位置索引对象与系统对象，按指针字节序
+  scan_ctx scan = {.ordered = 1};
+  lmjcore_txn_begin(hot, NULL, LMJCORE_TXN_READONLY, &txn);
+  rc = lmjcore_entity_scan(txn, NULL, count_entities, &scan);
+  print_test_result("entity_scan", rc, LMJCORE_SUCCESS);
+  print_test_result("遍历实体数", scan.count, TEST_OBJECTS + 2);
+  print_test_result("遍历按指针递增", scan.ordered, 1);
+  scan = (scan_ctx){.ordered = 1};
+  lmjcore_entity_scan(txn, objs[2], count_entities, &scan);
+  print_test_result("从指定指针开始遍历", scan.count, TEST_OBJECTS - 2);
+  rc = lmjcore_entity_scan(txn, NULL, stop_at_first, NULL);
+  print_test_result("回调中止遍历", rc, 42);
+  lmjcore_txn_abort(txn);
+
+  // 刚创建时都视为热对象
+  size_t moved = 0;
+  lmjcore_tier_migrate(tier, &moved);
+  print_test_result("未空闲时不迁移", (int)moved, 0);
+
+  // 空闲后迁移，最近访问的 objs[0] 与系统对象留在热环境
+  usleep((TEST_IDLE_MS + 50) * 1000);
+  lmjcore_tier_touch(tier, objs[0]);
+  print_test_result("分批迁移空闲对象", (int)migrate_all(tier),
+                    TEST_OBJECTS - 1);
+  print_test_result("热对象仍在热层", lmjcore_tier_locate(tier, objs[0]), 1);
+  print_test_result("空闲对象在冷层", lmjcore_tier_locate(tier, objs[1]), 2);
+  print_test_result("系统对象不迁移", env_has(hot, sys_obj), 1);
+  print_test_result("热环境已删除", env_has(hot, objs[1]), 0);
+  print_test_result("冷环境已写入", env_has(cold, objs[1]), 1);
+
+  // 冷读透明回落，成员与缺失值状态保持不变
+  uint8_t buf[4096];
+  lmjcore_result_obj *result = NULL;
+  rc = lmjcore_tier_obj_get(tier, objs[1], buf, sizeof(buf), &result);
+  print_test_result("冷对象读取", rc, LMJCORE_SUCCESS);
+  print_test_result("冷对象成员数", (int)result->member_count, 3);
+  int missing = 0;
+  for (size_t i = 0; i < result->error_count; i++) {
+    missing += result->errors[i].error_code == LMJCORE_ERROR_MEMBER_MISSING;
+  }
+  print_test_result("缺失值成员保留", missing, 2);
+  print_test_result("未开启读提升", lmjcore_tier_locate(tier, objs[1]), 2);
+
+  char value[32];
+  size_t size = 0;
+  rc = lmjcore_tier_obj_member_get(tier, objs[2], (const uint8_t *)"name", 4,
+                                   (uint8_t *)value, sizeof(value), &size);
+  print_test_result("冷对象成员读取", rc, LMJCORE_SUCCESS);
+  print_test_result("冷对象成员值", size == 7 && !memcmp(value, "value_2", 7),
+                    1);
+
+  // 写入冷对象时先提升
+  rc = lmjcore_tier_obj_member_put(tier, objs[1], (const uint8_t *)"name", 4,
+                                   (const uint8_t *)"updated", 7);
+  print_test_result("写入冷对象", rc, LMJCORE_SUCCESS);
+  print_test_result("写入后在热层", lmjcore_tier_locate(tier, objs[1]), 1);
+  print_test_result("冷副本已删除", env_has(cold, objs[1]), 0);
+  lmjcore_tier_obj_member_get(tier, objs[1], (const uint8_t *)"name", 4,
+                              (uint8_t *)value, sizeof(value), &size);
+  print_test_result("写入值可读", size == 7 && !memcmp(value, "updated", 7), 1);
+  lmjcore_tier_stats stats;
+  lmjcore_tier_stats_get(tier, &stats);
+  size_t hot_hits = stats.hot_hits;
+  rc = lmjcore_tier_obj_member_get(tier, objs[1], (const uint8_t *)"todo", 4,
+                                   (uint8_t *)value, sizeof(value), &size);
+  print_test_result("提升后缺失值仍缺失", rc != LMJCORE_SUCCESS, 1);
+  lmjcore_tier_stats_get(tier, &stats);
+  print_test_result("读取失败不计热命中", (int)(stats.hot_hits - hot_hits), 0);
+
+  // 显式提升，空对象也能往返
+  print_test_result("提升空对象", lmjcore_tier_promote(tier, objs[5]),
+                    LMJCORE_SUCCESS);
+  print_test_result("空对象回到热层", lmjcore_tier_locate(tier, objs[5]), 1);
+  print_test_result("重复提升", lmjcore_tier_promote(tier, objs[5]),
+                    LMJCORE_SUCCESS);
+
+  lmjcore_ptr unknown = {LMJCORE_OBJ, 0xEE, 0xEE};
+  rc = lmjcore_tier_obj_get(tier, unknown, buf, sizeof(buf), &result);
+  print_test_result("两层都不存在", rc, LMJCORE_ERROR_ENTITY_NOT_FOUND);
+  print_test_result("不存在的位置", lmjcore_tier_locate(tier, unknown), 0);
+
+  lmjcore_tier_stats_get(tier, &stats);
+  print_test_result("冷命中次数", (int)stats.cold_hits, 2);
+  print_test_result("提升次数", (int)stats.promotions, 2);
+  print_test_result("迁移次数", (int)stats.migrations, TEST_OBJECTS - 1);
+  print_test_result("未命中次数", (int)stats.misses, 1);
+  print_test_result("tier_destroy", lmjcore_tier_destroy(tier),
+                    LMJCORE_SUCCESS);
+
+  // 位置索引持久化：重建后冷读并提升
+  opts.promote_on_read = true;
+  lmjcore_tier_create(hot, cold, &opts, &tier);
+  print_test_result("重建后仍在冷层", lmjcore_tier_locate(tier, objs[3]), 2);
+  rc = lmjcore_tier_obj_get(tier, objs[3], buf, sizeof(buf), &result);
+  print_test_result("读提升", rc == LMJCORE_SUCCESS &&
+                                  lmjcore_tier_locate(tier, objs[3]) == 1,
+                    1);
+  lmjcore_tier_destroy(tier);
+
+  // 后台线程定期迁移
+  opts = (lmjcore_tier_opts){.idle_ms = 30, .interval_ms = 20};
+  lmjcore_tier_create(hot, cold, &opts, &tier);
+  usleep(300 * 1000);
+  print_test_result("后台迁移", lmjcore_tier_locate(tier, objs[0]), 2);
+  lmjcore_tier_stats_get(tier, &stats);
+  print_test_result("后台完成迁移轮次", stats.passes > 0, 1);
+  lmjcore_tier_destroy(tier);
+
+  lmjcore_cleanup(hot);
+  lmjcore_cleanup(cold);
+  printf("\n=== 测试完成 ===\n");
+  return 0;
+}